@@ -0,0 +1,29 @@
+-- ========================================
+-- Migration 001 : Matrice d'interférences
+-- Aligne la table 'interferences' sur la table 'antenna' de production
+-- et prépare le rechargement complet par COPY (InterferenceService)
+-- ========================================
+
+CREATE TABLE IF NOT EXISTS interferences (
+    id SERIAL PRIMARY KEY,
+    antenne_source_id INTEGER NOT NULL,
+    antenne_cible_id INTEGER NOT NULL,
+    niveau_interference DECIMAL(5, 2) NOT NULL, -- en dBm reçus au site source
+    distance DECIMAL(10, 2) NOT NULL, -- en mètres
+    date_mesure TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+);
+
+-- Les clés étrangères pointent vers 'antenna' (et non l'ancienne table 'antennes')
+ALTER TABLE interferences DROP CONSTRAINT IF EXISTS interferences_antenne_source_id_fkey;
+ALTER TABLE interferences DROP CONSTRAINT IF EXISTS interferences_antenne_cible_id_fkey;
+ALTER TABLE interferences
+    ADD CONSTRAINT interferences_antenne_source_id_fkey
+    FOREIGN KEY (antenne_source_id) REFERENCES antenna(id) ON DELETE CASCADE;
+ALTER TABLE interferences
+    ADD CONSTRAINT interferences_antenne_cible_id_fkey
+    FOREIGN KEY (antenne_cible_id) REFERENCES antenna(id) ON DELETE CASCADE;
+
+-- Une seule ligne par couple orienté (source subit cible)
+CREATE UNIQUE INDEX IF NOT EXISTS idx_interference_pair ON interferences(antenne_source_id, antenne_cible_id);
+CREATE INDEX IF NOT EXISTS idx_interference_source ON interferences(antenne_source_id);
+CREATE INDEX IF NOT EXISTS idx_interference_cible ON interferences(antenne_cible_id);
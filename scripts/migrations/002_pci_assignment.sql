@@ -0,0 +1,12 @@
+-- ========================================
+-- Migration 002 : Plan PCI (FrequencyPlanningService)
+-- Une ligne par antenne colorée ; supprimée avec l'antenne
+-- ========================================
+
+CREATE TABLE IF NOT EXISTS pci_assignment (
+    antenna_id INTEGER PRIMARY KEY REFERENCES antenna(id) ON DELETE CASCADE,
+    pci SMALLINT NOT NULL CHECK (pci >= 0 AND pci < 1008),
+    assigned_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+);
+
+CREATE INDEX IF NOT EXISTS idx_pci_assignment_pci ON pci_assignment(pci);
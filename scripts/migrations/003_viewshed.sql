@@ -0,0 +1,73 @@
+-- ========================================
+-- Migration 003 : Empreintes de couverture (ViewshedService)
+-- Empreinte tenant compte des obstacles, précalculée par lancer de rayons,
+-- et marquage des antennes à recalculer par triggers
+-- ========================================
+
+ALTER TABLE antenna ADD COLUMN IF NOT EXISTS viewshed_geom geometry(MultiPolygon, 4326);
+-- NULL = empreinte à jour ; sinon date du dernier changement de voisinage
+ALTER TABLE antenna ADD COLUMN IF NOT EXISTS viewshed_dirty_at TIMESTAMPTZ;
+
+UPDATE antenna SET viewshed_dirty_at = clock_timestamp() WHERE viewshed_geom IS NULL;
+
+CREATE INDEX IF NOT EXISTS idx_antenna_viewshed_dirty ON antenna(id) WHERE viewshed_dirty_at IS NOT NULL;
+
+-- ========== ANTENNE CRÉÉE, DÉPLACÉE OU RAYON MODIFIÉ ==========
+CREATE OR REPLACE FUNCTION antenna_mark_viewshed_dirty() RETURNS trigger AS $$
+BEGIN
+    NEW.viewshed_dirty_at := clock_timestamp();
+    RETURN NEW;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS trg_antenna_viewshed_insert ON antenna;
+CREATE TRIGGER trg_antenna_viewshed_insert
+    BEFORE INSERT ON antenna
+    FOR EACH ROW EXECUTE FUNCTION antenna_mark_viewshed_dirty();
+
+DROP TRIGGER IF EXISTS trg_antenna_viewshed_update ON antenna;
+CREATE TRIGGER trg_antenna_viewshed_update
+    BEFORE UPDATE OF geom, coverage_radius ON antenna
+    FOR EACH ROW
+    WHEN (OLD.geom IS DISTINCT FROM NEW.geom OR OLD.coverage_radius IS DISTINCT FROM NEW.coverage_radius)
+    EXECUTE FUNCTION antenna_mark_viewshed_dirty();
+
+-- ========== OBSTACLE AJOUTÉ, MODIFIÉ OU SUPPRIMÉ ==========
+-- Triggers par instruction (tables de transition) : un import massif
+-- d'obstacles ne déclenche qu'un UPDATE ensembliste sur 'antenna'.
+-- Préfiltre indexé de 0,5° (~55 km), supérieur au plus grand rayon de couverture.
+CREATE OR REPLACE FUNCTION obstacle_mark_viewshed_dirty() RETURNS trigger AS $$
+BEGIN
+    IF TG_OP IN ('INSERT', 'UPDATE') THEN
+        UPDATE antenna a SET viewshed_dirty_at = clock_timestamp()
+        FROM new_rows o
+        WHERE a.geom && ST_Expand(o.geom, 0.5)
+          AND ST_DWithin(a.geom::geography, o.geom::geography, a.coverage_radius);
+    END IF;
+    IF TG_OP IN ('UPDATE', 'DELETE') THEN
+        UPDATE antenna a SET viewshed_dirty_at = clock_timestamp()
+        FROM old_rows o
+        WHERE a.geom && ST_Expand(o.geom, 0.5)
+          AND ST_DWithin(a.geom::geography, o.geom::geography, a.coverage_radius);
+    END IF;
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS trg_obstacle_viewshed_insert ON obstacle;
+CREATE TRIGGER trg_obstacle_viewshed_insert
+    AFTER INSERT ON obstacle
+    REFERENCING NEW TABLE AS new_rows
+    FOR EACH STATEMENT EXECUTE FUNCTION obstacle_mark_viewshed_dirty();
+
+DROP TRIGGER IF EXISTS trg_obstacle_viewshed_update ON obstacle;
+CREATE TRIGGER trg_obstacle_viewshed_update
+    AFTER UPDATE ON obstacle
+    REFERENCING OLD TABLE AS old_rows NEW TABLE AS new_rows
+    FOR EACH STATEMENT EXECUTE FUNCTION obstacle_mark_viewshed_dirty();
+
+DROP TRIGGER IF EXISTS trg_obstacle_viewshed_delete ON obstacle;
+CREATE TRIGGER trg_obstacle_viewshed_delete
+    AFTER DELETE ON obstacle
+    REFERENCING OLD TABLE AS old_rows
+    FOR EACH STATEMENT EXECUTE FUNCTION obstacle_mark_viewshed_dirty();
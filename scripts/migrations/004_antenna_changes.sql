@@ -0,0 +1,122 @@
+-- ========================================
+-- Migration 004 : Journal des modifications d'antennes (synchronisation delta)
+-- Version des données monotone maintenue par triggers et journal des
+-- insertions / modifications / suppressions, lu par /api/antennas/changes
+-- ========================================
+
+-- Ligne unique : version courante et dernière version purgée du journal
+CREATE TABLE IF NOT EXISTS antenna_data_version (
+    singleton BOOLEAN PRIMARY KEY DEFAULT TRUE CHECK (singleton),
+    version BIGINT NOT NULL DEFAULT 0,
+    pruned_through BIGINT NOT NULL DEFAULT 0
+);
+
+INSERT INTO antenna_data_version (singleton) VALUES (TRUE) ON CONFLICT DO NOTHING;
+
+CREATE TABLE IF NOT EXISTS antenna_change_log (
+    version BIGINT NOT NULL,
+    antenna_id INTEGER NOT NULL,
+    operation CHAR(1) NOT NULL CHECK (operation IN ('I', 'U', 'D')),
+    geom geometry(Point, 4326),       -- Position après le changement (I, U) ou dernière connue (D)
+    old_geom geometry(Point, 4326),   -- Position avant une modification (antenne sortie d'une bbox)
+    changed_at TIMESTAMPTZ NOT NULL DEFAULT clock_timestamp(),
+    PRIMARY KEY (version, antenna_id)
+);
+
+CREATE INDEX IF NOT EXISTS idx_antenna_change_log_geom ON antenna_change_log USING GIST(geom);
+CREATE INDEX IF NOT EXISTS idx_antenna_change_log_old_geom ON antenna_change_log USING GIST(old_geom);
+
+-- ========== JOURNALISATION ==========
+-- Triggers par instruction (tables de transition) : un import massif ne prend
+-- qu'une version. Le verrou de ligne sur antenna_data_version est tenu jusqu'au
+-- COMMIT : les écritures concurrentes obtiennent leurs versions dans l'ordre de
+-- validation, un client ne peut donc pas voir la version N+1 avant la version N.
+-- Seuls les attributs servis par l'API sont suivis (pas viewshed_geom / viewshed_dirty_at).
+CREATE OR REPLACE FUNCTION antenna_log_changes() RETURNS trigger AS $$
+DECLARE
+    v BIGINT;
+BEGIN
+    IF TG_OP = 'INSERT' THEN
+        IF NOT EXISTS (SELECT 1 FROM new_rows) THEN RETURN NULL; END IF;
+        UPDATE antenna_data_version SET version = version + 1 RETURNING version INTO v;
+        INSERT INTO antenna_change_log (version, antenna_id, operation, geom)
+        SELECT v, id, 'I', geom FROM new_rows;
+
+    ELSIF TG_OP = 'UPDATE' THEN
+        IF NOT EXISTS (
+            SELECT 1 FROM new_rows n JOIN old_rows o ON o.id = n.id
+            WHERE (n.geom, n.status, n.technology, n.operator_id, n.coverage_radius)
+                  IS DISTINCT FROM (o.geom, o.status, o.technology, o.operator_id, o.coverage_radius)
+        ) THEN
+            RETURN NULL;
+        END IF;
+        UPDATE antenna_data_version SET version = version + 1 RETURNING version INTO v;
+        INSERT INTO antenna_change_log (version, antenna_id, operation, geom, old_geom)
+        SELECT v, n.id, 'U', n.geom, o.geom
+        FROM new_rows n JOIN old_rows o ON o.id = n.id
+        WHERE (n.geom, n.status, n.technology, n.operator_id, n.coverage_radius)
+              IS DISTINCT FROM (o.geom, o.status, o.technology, o.operator_id, o.coverage_radius);
+
+    ELSE
+        IF NOT EXISTS (SELECT 1 FROM old_rows) THEN RETURN NULL; END IF;
+        UPDATE antenna_data_version SET version = version + 1 RETURNING version INTO v;
+        INSERT INTO antenna_change_log (version, antenna_id, operation, geom)
+        SELECT v, id, 'D', geom FROM old_rows;
+    END IF;
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS trg_antenna_log_insert ON antenna;
+CREATE TRIGGER trg_antenna_log_insert
+    AFTER INSERT ON antenna
+    REFERENCING NEW TABLE AS new_rows
+    FOR EACH STATEMENT EXECUTE FUNCTION antenna_log_changes();
+
+DROP TRIGGER IF EXISTS trg_antenna_log_update ON antenna;
+CREATE TRIGGER trg_antenna_log_update
+    AFTER UPDATE ON antenna
+    REFERENCING OLD TABLE AS old_rows NEW TABLE AS new_rows
+    FOR EACH STATEMENT EXECUTE FUNCTION antenna_log_changes();
+
+DROP TRIGGER IF EXISTS trg_antenna_log_delete ON antenna;
+CREATE TRIGGER trg_antenna_log_delete
+    AFTER DELETE ON antenna
+    REFERENCING OLD TABLE AS old_rows
+    FOR EACH STATEMENT EXECUTE FUNCTION antenna_log_changes();
+
+-- TRUNCATE ne fournit pas les lignes : le journal est vidé et tous les clients
+-- doivent se resynchroniser (410 Gone sur /api/antennas/changes)
+CREATE OR REPLACE FUNCTION antenna_log_truncate() RETURNS trigger AS $$
+BEGIN
+    UPDATE antenna_data_version SET version = version + 1, pruned_through = version + 1;
+    DELETE FROM antenna_change_log;
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS trg_antenna_log_truncate ON antenna;
+CREATE TRIGGER trg_antenna_log_truncate
+    AFTER TRUNCATE ON antenna
+    FOR EACH STATEMENT EXECUTE FUNCTION antenna_log_truncate();
+
+-- ========== RÉTENTION ==========
+-- Supprime les entrées plus anciennes que la rétention ; les clients dont la
+-- version est antérieure à pruned_through doivent recharger la vue complète
+CREATE OR REPLACE FUNCTION antenna_change_log_prune(retention INTERVAL) RETURNS BIGINT AS $$
+DECLARE
+    horizon BIGINT;
+    deleted BIGINT;
+BEGIN
+    SELECT max(version) INTO horizon
+    FROM antenna_change_log
+    WHERE changed_at < clock_timestamp() - retention;
+
+    IF horizon IS NULL THEN RETURN 0; END IF;
+
+    DELETE FROM antenna_change_log WHERE version <= horizon;
+    GET DIAGNOSTICS deleted = ROW_COUNT;
+    UPDATE antenna_data_version SET pruned_through = GREATEST(pruned_through, horizon);
+    RETURN deleted;
+END;
+$$ LANGUAGE plpgsql;
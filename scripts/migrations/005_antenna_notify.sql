@@ -0,0 +1,22 @@
+-- ========================================
+-- Migration 005 : Notification des nouvelles versions d'antennes (WebSocket)
+-- NOTIFY antenna_changes à chaque nouvelle version du journal (migration 004),
+-- écouté par ChangeFeedService pour pousser les changements aux abonnés
+-- ========================================
+
+-- La notification est délivrée au COMMIT, jamais pour une transaction annulée.
+-- Charge utile : la version seule (limite NOTIFY de 8 Ko) ; les changements
+-- sont relus dans antenna_change_log.
+CREATE OR REPLACE FUNCTION antenna_version_notify() RETURNS trigger AS $$
+BEGIN
+    PERFORM pg_notify('antenna_changes', NEW.version::text);
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS trg_antenna_version_notify ON antenna_data_version;
+CREATE TRIGGER trg_antenna_version_notify
+    AFTER UPDATE OF version ON antenna_data_version
+    FOR EACH ROW
+    WHEN (NEW.version IS DISTINCT FROM OLD.version)
+    EXECUTE FUNCTION antenna_version_notify();
@@ -0,0 +1,191 @@
+-- ========================================
+-- Migration 006 : Couverture matérialisée par tuile (/api/antennas/coverage/simplified)
+-- Union des empreintes précalculée par tuile XYZ de zoom 10 et par filtre
+-- (opérateur, technologie), recalculée uniquement pour les tuiles marquées
+-- par triggers ; une bbox est assemblée à partir des tuiles qu'elle touche.
+-- Le zoom des tuiles (10) doit rester égal à AntenneService::COVERAGE_TILE_ZOOM.
+-- ========================================
+
+-- operator_id = -1 : tous les opérateurs ; technology = '*' : toutes les technologies
+CREATE TABLE IF NOT EXISTS coverage_tile (
+    operator_id INTEGER NOT NULL,
+    technology TEXT NOT NULL,
+    x INTEGER NOT NULL,
+    y INTEGER NOT NULL,
+    geom geometry(MultiPolygon, 4326) NOT NULL,
+    antenna_count INTEGER NOT NULL,
+    computed_at TIMESTAMPTZ NOT NULL DEFAULT clock_timestamp(),
+    PRIMARY KEY (operator_id, technology, x, y)
+);
+
+CREATE INDEX IF NOT EXISTS idx_coverage_tile_xy ON coverage_tile(x, y);
+
+-- Tuiles à recalculer (toutes les variantes de filtre d'une tuile à la fois)
+CREATE TABLE IF NOT EXISTS coverage_tile_dirty (
+    x INTEGER NOT NULL,
+    y INTEGER NOT NULL,
+    marked_at TIMESTAMPTZ NOT NULL DEFAULT clock_timestamp(),
+    PRIMARY KEY (x, y)
+);
+
+-- ========== GÉOMÉTRIE DES TUILES ==========
+CREATE OR REPLACE FUNCTION coverage_tile_x(lon DOUBLE PRECISION) RETURNS INTEGER AS $$
+    SELECT LEAST(1023, GREATEST(0, floor((lon + 180.0) / 360.0 * 1024)::int));
+$$ LANGUAGE sql IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION coverage_tile_y(lat DOUBLE PRECISION) RETURNS INTEGER AS $$
+    SELECT LEAST(1023, GREATEST(0, floor(
+        (1 - ln(tan(radians(c)) + 1 / cos(radians(c))) / pi()) / 2 * 1024
+    )::int))
+    FROM (SELECT LEAST(85.0511, GREATEST(-85.0511, lat)) AS c) clamped;
+$$ LANGUAGE sql IMMUTABLE;
+
+-- Emprise englobant l'empreinte d'une antenne (cercle de rayon coverage_radius,
+-- qui contient aussi l'empreinte calculée par ViewshedService)
+CREATE OR REPLACE FUNCTION coverage_footprint_box(g geometry, radius DOUBLE PRECISION) RETURNS geometry AS $$
+    SELECT ST_Expand(g, radius / (111320.0 * GREATEST(cos(radians(ST_Y(g))), 0.01)), radius / 111320.0);
+$$ LANGUAGE sql IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION coverage_tiles_touching(box geometry) RETURNS TABLE (x INTEGER, y INTEGER) AS $$
+    SELECT tx, ty
+    FROM generate_series(coverage_tile_x(ST_XMin(box)), coverage_tile_x(ST_XMax(box))) AS tx,
+         generate_series(coverage_tile_y(ST_YMax(box)), coverage_tile_y(ST_YMin(box))) AS ty;
+$$ LANGUAGE sql IMMUTABLE;
+
+-- ========== MARQUAGE PAR TRIGGERS ==========
+-- Par instruction (tables de transition), comme le journal des modifications :
+-- ancienne et nouvelle empreinte marquées, attributs sans effet sur la couverture ignorés
+CREATE OR REPLACE FUNCTION antenna_mark_coverage_dirty() RETURNS trigger AS $$
+BEGIN
+    IF TG_OP = 'INSERT' THEN
+        INSERT INTO coverage_tile_dirty (x, y)
+        SELECT DISTINCT t.x, t.y
+        FROM new_rows n
+        CROSS JOIN LATERAL coverage_tiles_touching(coverage_footprint_box(n.geom, n.coverage_radius)) t
+        WHERE n.status = 'active'
+        ON CONFLICT DO NOTHING;
+
+    ELSIF TG_OP = 'UPDATE' THEN
+        INSERT INTO coverage_tile_dirty (x, y)
+        SELECT DISTINCT t.x, t.y
+        FROM new_rows n
+        JOIN old_rows o ON o.id = n.id
+        CROSS JOIN LATERAL (
+            SELECT * FROM coverage_tiles_touching(coverage_footprint_box(n.geom, n.coverage_radius))
+            UNION
+            SELECT * FROM coverage_tiles_touching(coverage_footprint_box(o.geom, o.coverage_radius))
+        ) t
+        WHERE (n.status = 'active' OR o.status = 'active')
+          AND (n.geom, n.status, n.technology, n.operator_id, n.coverage_radius, n.viewshed_geom)
+              IS DISTINCT FROM (o.geom, o.status, o.technology, o.operator_id, o.coverage_radius, o.viewshed_geom)
+        ON CONFLICT DO NOTHING;
+
+    ELSE
+        INSERT INTO coverage_tile_dirty (x, y)
+        SELECT DISTINCT t.x, t.y
+        FROM old_rows o
+        CROSS JOIN LATERAL coverage_tiles_touching(coverage_footprint_box(o.geom, o.coverage_radius)) t
+        WHERE o.status = 'active'
+        ON CONFLICT DO NOTHING;
+    END IF;
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS trg_antenna_coverage_insert ON antenna;
+CREATE TRIGGER trg_antenna_coverage_insert
+    AFTER INSERT ON antenna
+    REFERENCING NEW TABLE AS new_rows
+    FOR EACH STATEMENT EXECUTE FUNCTION antenna_mark_coverage_dirty();
+
+DROP TRIGGER IF EXISTS trg_antenna_coverage_update ON antenna;
+CREATE TRIGGER trg_antenna_coverage_update
+    AFTER UPDATE ON antenna
+    REFERENCING OLD TABLE AS old_rows NEW TABLE AS new_rows
+    FOR EACH STATEMENT EXECUTE FUNCTION antenna_mark_coverage_dirty();
+
+DROP TRIGGER IF EXISTS trg_antenna_coverage_delete ON antenna;
+CREATE TRIGGER trg_antenna_coverage_delete
+    AFTER DELETE ON antenna
+    REFERENCING OLD TABLE AS old_rows
+    FOR EACH STATEMENT EXECUTE FUNCTION antenna_mark_coverage_dirty();
+
+-- ========== RECALCUL ==========
+-- Recalcule au plus max_tiles tuiles marquées (toutes variantes de filtre en une
+-- passe GROUPING SETS) ; SKIP LOCKED : plusieurs instances peuvent se partager la file.
+-- Les marques sont retirées dès le début : une antenne modifiée pendant le recalcul
+-- attend la fin de la transaction pour remarquer sa tuile, recalculée au passage suivant.
+CREATE OR REPLACE FUNCTION coverage_tile_refresh(max_tiles INTEGER) RETURNS INTEGER AS $$
+DECLARE
+    xs INTEGER[];
+    ys INTEGER[];
+BEGIN
+    WITH picked AS (
+        SELECT x, y FROM coverage_tile_dirty
+        ORDER BY marked_at
+        LIMIT max_tiles
+        FOR UPDATE SKIP LOCKED
+    ),
+    taken AS (
+        DELETE FROM coverage_tile_dirty d
+        USING picked p
+        WHERE d.x = p.x AND d.y = p.y
+        RETURNING d.x, d.y
+    )
+    SELECT array_agg(x), array_agg(y) INTO xs, ys FROM taken;
+
+    IF xs IS NULL THEN RETURN 0; END IF;
+
+    DELETE FROM coverage_tile c
+    USING unnest(xs, ys) AS d(x, y)
+    WHERE c.x = d.x AND c.y = d.y;
+
+    INSERT INTO coverage_tile (operator_id, technology, x, y, geom, antenna_count)
+    WITH tiles AS (
+        SELECT d.x, d.y, ST_Transform(ST_TileEnvelope(10, d.x, d.y), 4326) AS env
+        FROM unnest(xs, ys) AS d(x, y)
+    ),
+    footprints AS (
+        -- Préfiltre indexé de 0,5° (~55 km), supérieur au plus grand rayon de couverture
+        SELECT t.x, t.y,
+               COALESCE(a.operator_id, 0) AS operator_id,
+               a.technology::text AS technology,
+               fp.g
+        FROM tiles t
+        JOIN antenna a ON a.status = 'active' AND a.geom && ST_Expand(t.env, 0.5)
+        CROSS JOIN LATERAL (
+            SELECT COALESCE(a.viewshed_geom, ST_Buffer(a.geom::geography, a.coverage_radius)::geometry) AS g
+        ) fp
+        WHERE ST_Intersects(fp.g, t.env)
+    ),
+    grouped AS (
+        SELECT x, y,
+               CASE WHEN GROUPING(operator_id) = 1 THEN -1 ELSE operator_id END AS operator_id,
+               CASE WHEN GROUPING(technology) = 1 THEN '*' ELSE technology END AS technology,
+               ST_Union(g) AS g,
+               count(*) AS n
+        FROM footprints
+        GROUP BY GROUPING SETS ((x, y), (x, y, operator_id), (x, y, technology), (x, y, operator_id, technology))
+    ),
+    clipped AS (
+        SELECT g.operator_id, g.technology, g.x, g.y, g.n,
+               ST_Multi(ST_CollectionExtract(
+                   ST_Intersection(ST_MakeValid(g.g), ST_Transform(ST_TileEnvelope(10, g.x, g.y), 4326)), 3
+               )) AS geom
+        FROM grouped g
+    )
+    SELECT operator_id, technology, x, y, geom, n
+    FROM clipped
+    WHERE NOT ST_IsEmpty(geom);
+
+    RETURN array_length(xs, 1);
+END;
+$$ LANGUAGE plpgsql;
+
+-- ========== REMPLISSAGE INITIAL ==========
+INSERT INTO coverage_tile_dirty (x, y)
+SELECT DISTINCT t.x, t.y
+FROM antenna a
+CROSS JOIN LATERAL coverage_tiles_touching(coverage_footprint_box(a.geom, a.coverage_radius)) t
+WHERE a.status = 'active'
+ON CONFLICT DO NOTHING;
@@ -0,0 +1,73 @@
+-- ========================================
+-- Migration 007 : Recalcul des tuiles de couverture par rastérisation (C++)
+-- L'union ST_Union + ST_MakeValid de coverage_tile_refresh est remplacée par
+-- AntenneService::scheduleCoverageTileRefresh : les tuiles marquées sont
+-- réservées ici, rastérisées côté application puis écrites par COPY.
+-- ========================================
+
+-- Réservation : une tuile réservée n'est pas reprise par un autre recalcul
+-- tant que la réservation n'a pas expiré (instance arrêtée en plein calcul)
+ALTER TABLE coverage_tile_dirty ADD COLUMN IF NOT EXISTS claimed_at TIMESTAMPTZ;
+
+-- ========== MARQUAGE PAR TRIGGERS ==========
+-- Identique à la migration 006, sauf qu'une tuile déjà marquée est remarquée :
+-- une modification pendant un recalcul annule la réservation, dont le résultat
+-- (calculé sur les anciennes empreintes) n'est alors pas écrit
+CREATE OR REPLACE FUNCTION antenna_mark_coverage_dirty() RETURNS trigger AS $$
+BEGIN
+    IF TG_OP = 'INSERT' THEN
+        INSERT INTO coverage_tile_dirty (x, y)
+        SELECT DISTINCT t.x, t.y
+        FROM new_rows n
+        CROSS JOIN LATERAL coverage_tiles_touching(coverage_footprint_box(n.geom, n.coverage_radius)) t
+        WHERE n.status = 'active'
+        ON CONFLICT (x, y) DO UPDATE SET marked_at = clock_timestamp(), claimed_at = NULL;
+
+    ELSIF TG_OP = 'UPDATE' THEN
+        INSERT INTO coverage_tile_dirty (x, y)
+        SELECT DISTINCT t.x, t.y
+        FROM new_rows n
+        JOIN old_rows o ON o.id = n.id
+        CROSS JOIN LATERAL (
+            SELECT * FROM coverage_tiles_touching(coverage_footprint_box(n.geom, n.coverage_radius))
+            UNION
+            SELECT * FROM coverage_tiles_touching(coverage_footprint_box(o.geom, o.coverage_radius))
+        ) t
+        WHERE (n.status = 'active' OR o.status = 'active')
+          AND (n.geom, n.status, n.technology, n.operator_id, n.coverage_radius, n.viewshed_geom)
+              IS DISTINCT FROM (o.geom, o.status, o.technology, o.operator_id, o.coverage_radius, o.viewshed_geom)
+        ON CONFLICT (x, y) DO UPDATE SET marked_at = clock_timestamp(), claimed_at = NULL;
+
+    ELSE
+        INSERT INTO coverage_tile_dirty (x, y)
+        SELECT DISTINCT t.x, t.y
+        FROM old_rows o
+        CROSS JOIN LATERAL coverage_tiles_touching(coverage_footprint_box(o.geom, o.coverage_radius)) t
+        WHERE o.status = 'active'
+        ON CONFLICT (x, y) DO UPDATE SET marked_at = clock_timestamp(), claimed_at = NULL;
+    END IF;
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+-- ========== RÉSERVATION ==========
+-- Réserve au plus max_tiles tuiles ; now() (fixe pour la transaction) sert de jeton :
+-- seules les tuiles encore réservées avec ce jeton sont écrites puis démarquées
+CREATE OR REPLACE FUNCTION coverage_tile_claim(max_tiles INTEGER, lease INTERVAL)
+RETURNS TABLE (x INTEGER, y INTEGER, claimed_at TIMESTAMPTZ) AS $$
+    WITH picked AS (
+        SELECT d.x, d.y FROM coverage_tile_dirty d
+        WHERE d.claimed_at IS NULL OR d.claimed_at < clock_timestamp() - lease
+        ORDER BY d.marked_at
+        LIMIT max_tiles
+        FOR UPDATE SKIP LOCKED
+    )
+    UPDATE coverage_tile_dirty d
+    SET claimed_at = now()
+    FROM picked p
+    WHERE d.x = p.x AND d.y = p.y
+    RETURNING d.x, d.y, d.claimed_at;
+$$ LANGUAGE sql;
+
+-- Remplacée par la rastérisation côté application
+DROP FUNCTION IF EXISTS coverage_tile_refresh(INTEGER);
@@ -0,0 +1,45 @@
+-- ========================================
+-- Migration 008 : Indicateurs de couverture par zone (ZoneKpiService)
+-- Surface et population couvertes par zone administrative, pour chaque filtre
+-- (opérateur, technologie) des tuiles de couverture. Calculées hors ligne par
+-- rastérisation ; remplace couverture_zones, jamais alimentée.
+-- ========================================
+
+-- operator_id = -1 : tous les opérateurs ; technology = '*' : toutes les technologies
+CREATE TABLE IF NOT EXISTS zone_coverage_kpi (
+    zone_id INTEGER NOT NULL REFERENCES zone(id) ON DELETE CASCADE,
+    operator_id INTEGER NOT NULL,
+    technology TEXT NOT NULL,
+    area_km2 DOUBLE PRECISION NOT NULL,
+    covered_area_km2 DOUBLE PRECISION NOT NULL,
+    population DOUBLE PRECISION NOT NULL,
+    covered_population DOUBLE PRECISION NOT NULL,
+    antenna_count INTEGER NOT NULL,
+    area_pct NUMERIC(5, 2) GENERATED ALWAYS AS (
+        CASE WHEN area_km2 > 0 THEN round((100.0 * covered_area_km2 / area_km2)::numeric, 2) END
+    ) STORED,
+    population_pct NUMERIC(5, 2) GENERATED ALWAYS AS (
+        CASE WHEN population > 0 THEN round((100.0 * covered_population / population)::numeric, 2) END
+    ) STORED,
+    computed_at TIMESTAMPTZ NOT NULL DEFAULT now(),
+    PRIMARY KEY (zone_id, operator_id, technology)
+);
+
+-- ========== VUE DE SYNTHÈSE ==========
+-- Mêmes colonnes qu'avant, alimentées par les indicateurs :
+-- couverture moyenne / max = surface couverte par opérateur (toutes technologies)
+DROP VIEW IF EXISTS vue_couverture_par_zone;
+CREATE VIEW vue_couverture_par_zone AS
+SELECT
+    z.id,
+    z.name AS zone_nom,
+    COALESCE(total.antenna_count, 0) AS nombre_antennes,
+    AVG(k.area_pct) AS couverture_moyenne,
+    MAX(k.area_pct) AS couverture_max,
+    z.density AS density
+FROM zone z
+LEFT JOIN zone_coverage_kpi total
+       ON total.zone_id = z.id AND total.operator_id = -1 AND total.technology = '*'
+LEFT JOIN zone_coverage_kpi k
+       ON k.zone_id = z.id AND k.operator_id >= 0 AND k.technology = '*'
+GROUP BY z.id, z.name, z.density, total.antenna_count;
@@ -0,0 +1,30 @@
+-- ========================================
+-- Migration 009 : Version des données de zones (ZoneStoreService)
+-- Compteur incrémenté par triggers à chaque modification de la table zone :
+-- le magasin de géométries en mémoire le sonde et se recharge s'il a changé.
+-- ========================================
+
+CREATE TABLE IF NOT EXISTS zone_data_version (
+    singleton BOOLEAN PRIMARY KEY DEFAULT TRUE CHECK (singleton),
+    version BIGINT NOT NULL DEFAULT 0
+);
+
+INSERT INTO zone_data_version (singleton) VALUES (TRUE) ON CONFLICT DO NOTHING;
+
+-- Par instruction : un import massif ne prend qu'une version
+CREATE OR REPLACE FUNCTION zone_bump_version() RETURNS trigger AS $$
+BEGIN
+    UPDATE zone_data_version SET version = version + 1;
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS trg_zone_version ON zone;
+CREATE TRIGGER trg_zone_version
+    AFTER INSERT OR UPDATE OR DELETE ON zone
+    FOR EACH STATEMENT EXECUTE FUNCTION zone_bump_version();
+
+DROP TRIGGER IF EXISTS trg_zone_version_truncate ON zone;
+CREATE TRIGGER trg_zone_version_truncate
+    AFTER TRUNCATE ON zone
+    FOR EACH STATEMENT EXECUTE FUNCTION zone_bump_version();
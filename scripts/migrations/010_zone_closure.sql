@@ -0,0 +1,184 @@
+-- ========================================
+-- Migration 010 : Fermeture des relations entre zones (OptimizationService, mode zone)
+-- Pour chaque zone hors cellules de densité :
+--   kind = 'admin' : zones administratives (commune, province, région) qui l'intersectent
+--   kind = 'cell'  : cellules density_zone rattachées (parent_id) à l'une de ces zones
+-- C'est l'ensemble que les requêtes d'optimisation résolvaient par ST_Intersects
+-- à chaque appel : leur lecture devient une jointure d'égalité indexée.
+-- Les cellules elles-mêmes ne sont pas sources (une ligne par cellule et par cellule
+-- voisine gonflerait la table) : pour une cellule ciblée, OptimizationService garde
+-- la résolution par ST_Intersects.
+-- Tenue à jour par triggers, par différence : seules les paires dont la zone
+-- modifiée est la source ou la cible, et les cellules qui en dépendent, sont touchées.
+-- ========================================
+
+CREATE TABLE IF NOT EXISTS zone_closure (
+    zone_id INTEGER NOT NULL REFERENCES zone(id) ON DELETE CASCADE,
+    related_id INTEGER NOT NULL REFERENCES zone(id) ON DELETE CASCADE,
+    kind TEXT NOT NULL CHECK (kind IN ('admin', 'cell')),
+    PRIMARY KEY (zone_id, kind, related_id)
+);
+
+CREATE INDEX IF NOT EXISTS idx_zone_closure_related ON zone_closure(related_id, kind);
+CREATE INDEX IF NOT EXISTS idx_zone_parent ON zone(parent_id);
+
+-- ========== REMPLISSAGE COMPLET ==========
+-- Remplace les lignes des zones sources données (cellules de densité ignorées) ;
+-- sert au remplissage initial, les triggers n'appliquent que des différences
+CREATE OR REPLACE FUNCTION zone_closure_refresh(ids INTEGER[]) RETURNS void AS $$
+BEGIN
+    DELETE FROM zone_closure WHERE zone_id = ANY(ids);
+
+    INSERT INTO zone_closure (zone_id, related_id, kind)
+    SELECT s.id, a.id, 'admin'
+    FROM zone s
+    JOIN zone a ON ST_Intersects(a.geom, s.geom)
+    WHERE s.id = ANY(ids)
+      AND s.type::text <> 'density_zone'
+      AND a.type::text IN ('commune', 'province', 'region');
+
+    INSERT INTO zone_closure (zone_id, related_id, kind)
+    SELECT DISTINCT c.zone_id, dz.id, 'cell'
+    FROM zone_closure c
+    JOIN zone dz ON dz.parent_id = c.related_id
+    WHERE c.zone_id = ANY(ids)
+      AND c.kind = 'admin'
+      AND dz.type::text = 'density_zone';
+END;
+$$ LANGUAGE plpgsql;
+
+-- ========== MISE À JOUR PAR DIFFÉRENCE ==========
+-- changed : zones dont geom ou type a changé (ou insérées)
+-- moved   : zones dont type ou parent_id a changé (ou insérées)
+-- Une paire admin (S, A) n'est vérifiée (ST_Intersects) que si S ou A est modifiée ;
+-- une ligne cell (S, D) suit la paire (S, parent de D). Le reste de la table n'est pas lu.
+CREATE OR REPLACE FUNCTION zone_closure_apply(changed INTEGER[], moved INTEGER[]) RETURNS void AS $$
+BEGIN
+    -- ----- Zones modifiées comme sources : paires (Z, A) -----
+    -- Disparues (Z devenue cellule, ou ne touchant plus A), avec les cellules de A
+    WITH gone AS (
+        DELETE FROM zone_closure c
+        USING zone z, zone a
+        WHERE z.id = ANY(changed)
+          AND c.zone_id = z.id AND c.kind = 'admin'
+          AND a.id = c.related_id
+          AND NOT (z.type::text <> 'density_zone'
+                   AND a.type::text IN ('commune', 'province', 'region')
+                   AND ST_Intersects(a.geom, z.geom))
+        RETURNING c.zone_id, c.related_id
+    )
+    DELETE FROM zone_closure c
+    USING gone g, zone dz
+    WHERE dz.parent_id = g.related_id
+      AND c.zone_id = g.zone_id AND c.related_id = dz.id AND c.kind = 'cell';
+
+    -- Apparues, avec les cellules de A
+    WITH added AS (
+        INSERT INTO zone_closure (zone_id, related_id, kind)
+        SELECT z.id, a.id, 'admin'
+        FROM zone z
+        JOIN zone a ON ST_Intersects(a.geom, z.geom)
+        WHERE z.id = ANY(changed)
+          AND z.type::text <> 'density_zone'
+          AND a.type::text IN ('commune', 'province', 'region')
+        ON CONFLICT DO NOTHING
+        RETURNING zone_id, related_id
+    )
+    INSERT INTO zone_closure (zone_id, related_id, kind)
+    SELECT g.zone_id, dz.id, 'cell'
+    FROM added g
+    JOIN zone dz ON dz.parent_id = g.related_id
+    WHERE dz.type::text = 'density_zone'
+    ON CONFLICT DO NOTHING;
+
+    -- ----- Zones administratives modifiées comme cibles : paires (S, Z) -----
+    -- Disparues (S ne touche plus Z, ou Z n'est plus administrative), avec les cellules de Z
+    WITH gone AS (
+        DELETE FROM zone_closure c
+        USING zone z, zone s
+        WHERE z.id = ANY(changed)
+          AND c.related_id = z.id AND c.kind = 'admin'
+          AND s.id = c.zone_id
+          AND NOT (z.type::text IN ('commune', 'province', 'region')
+                   AND ST_Intersects(s.geom, z.geom))
+        RETURNING c.zone_id, c.related_id
+    )
+    DELETE FROM zone_closure c
+    USING gone g, zone dz
+    WHERE dz.parent_id = g.related_id
+      AND c.zone_id = g.zone_id AND c.related_id = dz.id AND c.kind = 'cell';
+
+    -- Apparues, avec les cellules de Z
+    WITH added AS (
+        INSERT INTO zone_closure (zone_id, related_id, kind)
+        SELECT s.id, z.id, 'admin'
+        FROM zone z
+        JOIN zone s ON ST_Intersects(s.geom, z.geom)
+        WHERE z.id = ANY(changed)
+          AND z.type::text IN ('commune', 'province', 'region')
+          AND s.type::text <> 'density_zone'
+        ON CONFLICT DO NOTHING
+        RETURNING zone_id, related_id
+    )
+    INSERT INTO zone_closure (zone_id, related_id, kind)
+    SELECT g.zone_id, dz.id, 'cell'
+    FROM added g
+    JOIN zone dz ON dz.parent_id = g.related_id
+    WHERE dz.type::text = 'density_zone'
+    ON CONFLICT DO NOTHING;
+
+    -- ----- Cellules insérées, rattachées ailleurs, devenues / n'étant plus des cellules -----
+    DELETE FROM zone_closure
+    WHERE related_id = ANY(moved) AND kind = 'cell';
+
+    INSERT INTO zone_closure (zone_id, related_id, kind)
+    SELECT c.zone_id, d.id, 'cell'
+    FROM zone d
+    JOIN zone_closure c ON c.related_id = d.parent_id AND c.kind = 'admin'
+    WHERE d.id = ANY(moved)
+      AND d.type::text = 'density_zone'
+    ON CONFLICT DO NOTHING;
+END;
+$$ LANGUAGE plpgsql;
+
+-- ========== MAINTENANCE PAR TRIGGERS ==========
+-- Par instruction (tables de transition) : les zones insérées / modifiées sont passées
+-- à zone_closure_apply. Seules les modifications de geom, type ou parent_id comptent.
+-- Les suppressions passent par ON DELETE CASCADE.
+CREATE OR REPLACE FUNCTION zone_closure_maintain() RETURNS trigger AS $$
+DECLARE
+    changed INTEGER[];
+    moved INTEGER[];
+BEGIN
+    IF TG_OP = 'INSERT' THEN
+        SELECT array_agg(id) INTO changed FROM new_rows;
+        moved := changed;
+    ELSE
+        SELECT array_agg(n.id) FILTER (WHERE (n.geom, n.type) IS DISTINCT FROM (o.geom, o.type)),
+               array_agg(n.id) FILTER (WHERE (n.type, n.parent_id) IS DISTINCT FROM (o.type, o.parent_id))
+        INTO changed, moved
+        FROM new_rows n
+        JOIN old_rows o ON o.id = n.id;
+    END IF;
+
+    IF changed IS NOT NULL OR moved IS NOT NULL THEN
+        PERFORM zone_closure_apply(COALESCE(changed, '{}'), COALESCE(moved, '{}'));
+    END IF;
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS trg_zone_closure_insert ON zone;
+CREATE TRIGGER trg_zone_closure_insert
+    AFTER INSERT ON zone
+    REFERENCING NEW TABLE AS new_rows
+    FOR EACH STATEMENT EXECUTE FUNCTION zone_closure_maintain();
+
+DROP TRIGGER IF EXISTS trg_zone_closure_update ON zone;
+CREATE TRIGGER trg_zone_closure_update
+    AFTER UPDATE ON zone
+    REFERENCING OLD TABLE AS old_rows NEW TABLE AS new_rows
+    FOR EACH STATEMENT EXECUTE FUNCTION zone_closure_maintain();
+
+-- ========== REMPLISSAGE INITIAL ==========
+SELECT zone_closure_refresh(ARRAY(SELECT id FROM zone WHERE type::text <> 'density_zone'));
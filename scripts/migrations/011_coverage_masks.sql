@@ -0,0 +1,17 @@
+-- ========================================
+-- Migration 011 : Pyramide de masques des tuiles de couverture
+-- Les blocs de /coverage/simplified ne sont plus fusionnés par ST_Union +
+-- ST_SimplifyPreserveTopology à la requête : AntenneService assemble par OU
+-- les masques de leurs tuiles au niveau de résolution du zoom, puis les trace.
+-- masks : masques de 128, 64, ..., 1 px de côté (1 bit par pixel, lignes
+-- contiguës), concaténés du plus fin au plus grossier (2 732 octets),
+-- écrits avec la géométrie par le recalcul des tuiles.
+-- ========================================
+
+ALTER TABLE coverage_tile ADD COLUMN IF NOT EXISTS masks BYTEA;
+
+-- Tuiles existantes sans masques : remarquées pour être recalculées
+-- (signalées en attente dans metadata.stale_tiles d'ici là)
+INSERT INTO coverage_tile_dirty (x, y)
+SELECT DISTINCT x, y FROM coverage_tile WHERE masks IS NULL
+ON CONFLICT (x, y) DO UPDATE SET marked_at = clock_timestamp(), claimed_at = NULL;
@@ -2,13 +2,15 @@
 #include "../utils/Validator.h"
 #include "../utils/ErrorHandler.h"
 #include "../services/CacheService.h"
+#include "../services/ClusterIndexService.h"
+#include "../services/ChangeFeedService.h"
+#include "../services/CoverageWarmerService.h"
+#include "../utils/ClusterBinaryEncoder.h"
 #include <drogon/HttpResponse.h>
-#include <thread>
-#include <chrono>
+#include <cstdio>
 
 using namespace drogon;
 
-
 // ============================================================================
 // 1. GET CLUSTERED ANTENNAS (Sprint 1 Optimization)
 // ============================================================================
@@ -26,6 +28,9 @@ using namespace drogon;
  *  - status: Filtrer par statut (active, inactive, maintenance)
  *  - technology: Filtrer par technologie (2G, 3G, 4G, 5G)
  *  - operator_id: Filtrer par opérateur
+ *  - mode: fixed (défaut, granularité dictée par le zoom) ou adaptive (granularité
+ *          la plus fine dont le nombre de features dans la bbox tient dans budget)
+ *  - budget: Nombre maximal de features visé en mode adaptive (10-10000)
  * 
  * Retour: GeoJSON FeatureCollection avec clusters
  *  - Si cluster: geometry = centroïde, properties contient count et liste des IDs
@@ -55,6 +60,17 @@ void AntenneController::getClusteredAntennas(const HttpRequestPtr& req,
     if (zoom < 0 || zoom > 18) {
         validator.addError("zoom", "Zoom level must be between 0 and 18");
     }
+
+    // Mode adaptatif : granularité choisie selon la densité pour tenir dans un budget de features
+    std::string mode = req->getOptionalParameter<std::string>("mode").value_or("fixed");
+    int budget = req->getOptionalParameter<int>("budget").value_or(static_cast<int>(ClusterIndexService::defaultBudget()));
+    if (mode != "fixed" && mode != "adaptive") {
+        validator.addError("mode", "Mode must be one of: fixed, adaptive");
+    }
+    if (budget < 10 || budget > 10000) {
+        validator.addError("budget", "Budget must be between 10 and 10000 features");
+    }
+    bool adaptive = (mode == "adaptive");
     
     if (validator.hasErrors()) {
         auto resp = HttpResponse::newHttpResponse();
@@ -89,88 +105,80 @@ void AntenneController::getClusteredAntennas(const HttpRequestPtr& req,
         return;
     }
     
-    // ========== SPRINT 3: CACHE REDIS ==========
-    // Clé de cache basée sur bbox + zoom + filtres
-    std::string cacheKey = "clusters:bbox:" + 
-                          std::to_string(minLat) + ":" + std::to_string(minLon) + ":" + 
-                          std::to_string(maxLat) + ":" + std::to_string(maxLon) + 
-                          ":z:" + std::to_string(zoom);
-    
-    if (!status.empty()) cacheKey += ":st:" + status;
-    if (!technology.empty()) cacheKey += ":tech:" + technology;
-    if (operator_id >= 0) cacheKey += ":op:" + std::to_string(operator_id);
-    
-    // Vérification cache
-    auto cached = CacheService::getInstance().getCachedClusters(cacheKey);
-    if (cached) {
-        LOG_INFO << "✅ Cache HIT: " << cacheKey;
-        
-        auto resp = HttpResponse::newHttpJsonResponse(*cached);
-        resp->addHeader("Content-Type", "application/geo+json");
-        resp->addHeader("X-Cache", "HIT");
-        resp->addHeader("Cache-Control", "public, max-age=120");
-        callback(resp);
-        return;
+    // Zoom effectif de l'index : niveau le plus détaillé (<= zoom) dont la bbox tient dans le budget
+    int clusterZoom = zoom;
+    if (adaptive) {
+        int level = ClusterIndexService::adaptiveZoom(minLat, minLon, maxLat, maxLon, zoom, budget,
+                                                      status, technology, operator_id);
+        if (level >= 0) clusterZoom = level;
     }
-    
-    LOG_INFO << "❌ Cache MISS: " << cacheKey;
-    
-    // ========== VERROUILLAGE POUR ÉVITER LES CALCULS CONCURRENTS ==========
-    std::string lockKey = "lock:" + cacheKey;
-    bool hasLock = CacheService::getInstance().tryLock(lockKey, 60);
-    
-    if (!hasLock) {
-        // Si lock pas acquis, attendre un peu et revérifier le cache
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        auto retryCached = CacheService::getInstance().getCachedClusters(cacheKey);
-        if (retryCached) {
-            LOG_INFO << "🔄 Cache HIT after lock retry: " << cacheKey;
-            auto resp = HttpResponse::newHttpJsonResponse(*retryCached);
-            resp->addHeader("Content-Type", "application/geo+json");
-            resp->addHeader("X-Cache", "HIT-RETRY");
+
+    // ========== FORMAT BINAIRE (négocié via Accept) ==========
+    // Servi depuis l'index uniquement ; sinon repli GeoJSON (le client lit Content-Type)
+    std::string accept = req->getHeader("Accept");
+    if (accept.find(ClusterBinaryEncoder::CONTENT_TYPE) != std::string::npos) {
+        std::string binary;
+        if (ClusterIndexService::queryBinary(minLat, minLon, maxLat, maxLon, clusterZoom, status, technology, operator_id, binary)) {
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setBody(std::move(binary));
+            resp->setContentTypeString(ClusterBinaryEncoder::CONTENT_TYPE);
+            resp->addHeader("X-Cache", "INDEX");
+            resp->addHeader("Vary", "Accept");
             resp->addHeader("Cache-Control", "public, max-age=120");
             callback(resp);
             return;
         }
-        // Sinon, procéder sans lock pour éviter le blocage
-        LOG_WARN << "⚠️ Proceeding without lock for: " << cacheKey;
     }
-    
-    // ========== APPEL AU SERVICE ==========
+
+    // ========== INDEX EN MÉMOIRE (pyramide de KD-trees) ==========
+    // Requête en quelques microsecondes : plus rapide qu'un aller-retour Redis
+    Json::Value indexed;
+    if (ClusterIndexService::query(minLat, minLon, maxLat, maxLon, clusterZoom, status, technology, operator_id, indexed)) {
+        indexed["metadata"]["zoom"] = zoom;
+        indexed["metadata"]["mode"] = mode;
+        if (adaptive) indexed["metadata"]["budget"] = budget;
+        indexed["metadata"]["bbox"]["minLat"] = minLat;
+        indexed["metadata"]["bbox"]["minLon"] = minLon;
+        indexed["metadata"]["bbox"]["maxLat"] = maxLat;
+        indexed["metadata"]["bbox"]["maxLon"] = maxLon;
+
+        auto resp = HttpResponse::newHttpJsonResponse(indexed);
+        resp->setContentTypeString("application/geo+json");
+        resp->addHeader("X-Cache", "INDEX");
+        resp->addHeader("Vary", "Accept");
+        resp->addHeader("Cache-Control", "public, max-age=120");
+        callback(resp);
+        return;
+    }
+
+    // ========== REPLI SQL + CACHE PAR FRAGMENTS ==========
+    // Tant que l'index du filtre n'est pas construit : fragments de grille en cache Redis,
+    // seuls les fragments manquants sont calculés (cf. AntenneService::getClusteredAntennas)
+    // En mode adaptatif, le niveau de grille vient de l'histogramme de densité (si un snapshot est chargé)
+    int gridLevel = adaptive ? ClusterIndexService::adaptiveGridLevel(minLat, minLon, maxLat, maxLon, budget) : -1;
+    if (gridLevel < 0) gridLevel = AntenneService::gridLevelForZoom(zoom);
+
     AntenneService::getClusteredAntennas(
-        minLat, minLon, maxLat, maxLon, zoom, status, technology, operator_id,
-        [callback, zoom, minLat, minLon, maxLat, maxLon, cacheKey, hasLock, lockKey](const Json::Value& geojson, const std::string& err) {
+        minLat, minLon, maxLat, maxLon, zoom, gridLevel, status, technology, operator_id,
+        [callback](const std::string& geojson, const Json::Value& metadata, const std::string& err) {
             if (err.empty()) {
-                // Ajout de métadonnées utiles pour le debug et le monitoring
-                Json::Value response = geojson;
-                response["metadata"]["zoom"] = zoom;
-                response["metadata"]["bbox"] = Json::Value(Json::objectValue);
-                response["metadata"]["bbox"]["minLat"] = minLat;
-                response["metadata"]["bbox"]["minLon"] = minLon;
-                response["metadata"]["bbox"]["maxLat"] = maxLat;
-                response["metadata"]["bbox"]["maxLon"] = maxLon;
-                
-                // Sprint 3: Mise en cache (TTL 1h pour clusters)
-                CacheService::getInstance().cacheClusters(cacheKey, response);
-                LOG_INFO << "💾 Cached clusters: " << cacheKey;
-                
-                // Libérer le verrou
-                if (hasLock) {
-                    CacheService::getInstance().unlock(lockKey);
-                }
-                
-                auto resp = HttpResponse::newHttpJsonResponse(response);
-                resp->addHeader("Content-Type", "application/geo+json");
-                resp->addHeader("X-Cache", "MISS");
+                // HIT : tous les fragments en cache, PARTIAL : une partie, MISS : aucun
+                auto total = metadata["fragments"]["total"].asUInt64();
+                auto cached = metadata["fragments"]["cached"].asUInt64();
+                const char* cacheState = (total > 0 && cached == total) ? "HIT"
+                                       : (cached > 0 ? "PARTIAL" : "MISS");
+
+                // Corps déjà sérialisé (métadonnées incluses) : pas de passage par Json::Value
+                auto resp = HttpResponse::newHttpResponse();
+                resp->setBody(geojson);
+                resp->setContentTypeString("application/geo+json");
+                resp->addHeader("X-Cache", cacheState);
+                resp->addHeader("X-Total-Features", metadata["total_features"].asString());
+                resp->addHeader("Vary", "Accept");
                 resp->addHeader("Cache-Control", "public, max-age=120");
                 
                 callback(resp);
             } else {
-                // Libérer le verrou en cas d'erreur
-                if (hasLock) {
-                    CacheService::getInstance().unlock(lockKey);
-                }
-                
                 auto errorDetails = ErrorHandler::analyzePostgresError(err);
                 ErrorHandler::logError("AntenneController::getClusteredAntennas", errorDetails);
                 auto resp = ErrorHandler::createErrorResponse(errorDetails);
@@ -225,22 +233,24 @@ void AntenneController::getSimplifiedCoverage(
     }
     
     // ========== SPRINT 3: CACHE REDIS ==========
-    // Clé de cache : coverage simplifiée par bbox + zoom + filtres
-    std::string cacheKey = "coverage:simplified:bbox:" + 
-                          std::to_string(minLat) + ":" + std::to_string(minLon) + ":" + 
-                          std::to_string(maxLat) + ":" + std::to_string(maxLon) + 
+    // Clé de cache : plage de tuiles de couverture + zoom + filtres
+    // (la réponse ne dépend que des tuiles touchées : deux bbox voisines partagent l'entrée)
+    auto tiles = AntenneService::coverageTileRange(minLat, minLon, maxLat, maxLon);
+    std::string cacheKey = "coverage:simplified:tiles:" +
+                          std::to_string(tiles.minX) + ":" + std::to_string(tiles.minY) + ":" +
+                          std::to_string(tiles.maxX) + ":" + std::to_string(tiles.maxY) +
                           ":z:" + std::to_string(zoom);
     
     if (operator_id >= 0) cacheKey += ":op:" + std::to_string(operator_id);
     if (!technology.empty()) cacheKey += ":tech:" + technology;
     
     // Vérification cache (TTL 5min - stable car basé sur antennes actives)
-    auto cached = CacheService::getInstance().getJson(cacheKey);
+    // GeoJSON compressé une fois au remplissage, servi tel quel (ni reparsing ni recompression)
+    auto cached = CacheService::getInstance().getCompressed(cacheKey);
     if (cached) {
         LOG_INFO << "✅ Coverage Cache HIT: " << cacheKey;
         
-        auto resp = HttpResponse::newHttpJsonResponse(*cached);
-        resp->addHeader("Content-Type", "application/geo+json");
+        auto resp = CacheService::encodedResponse(req, *cached, "application/geo+json");
         resp->addHeader("X-Cache", "HIT");
         resp->addHeader("Cache-Control", "public, max-age=300"); // 5min
         callback(resp);
@@ -252,15 +262,27 @@ void AntenneController::getSimplifiedCoverage(
     // ========== APPEL AU SERVICE ==========
     AntenneService::getSimplifiedCoverage(
         minLat, minLon, maxLat, maxLon, zoom, operator_id, technology,
-        [callback, cacheKey](const Json::Value& geojson, const std::string& err) {
+        [req, callback, cacheKey](const std::string& geojson, const Json::Value& metadata, const std::string& err) {
             if (err.empty()) {
                 // Sprint 3: Mise en cache (TTL 5min pour coverage)
-                CacheService::getInstance().set(cacheKey, geojson.toStyledString(), 300);
-                LOG_INFO << "💾 Cached coverage: " << cacheKey;
+                // Le texte assemblé est compressé une seule fois, pour le cache et cette réponse
+                auto entry = CacheService::compress(geojson);
+                CacheService::getInstance().setCompressed(cacheKey, entry, 300);
+                LOG_INFO << "💾 Cached coverage: " << cacheKey << " (" << entry.encoding << ", "
+                         << geojson.size() << " -> " << entry.body.size() << " bytes)";
                 
-                auto resp = HttpResponse::newHttpJsonResponse(geojson);
-                resp->addHeader("Content-Type", "application/geo+json");
-                resp->addHeader("X-Cache", "MISS");
+                // Réponse absente mais blocs en cache (préchauffés) : HIT, une partie : PARTIAL
+                auto total = metadata["blocks"]["total"].asUInt64();
+                auto cachedBlocks = metadata["blocks"]["cached"].asUInt64();
+                std::string cacheStatus = "MISS";
+                if (total > 0 && cachedBlocks == total) {
+                    cacheStatus = "HIT";
+                } else if (cachedBlocks > 0) {
+                    cacheStatus = "PARTIAL";
+                }
+
+                auto resp = CacheService::encodedResponse(req, entry, "application/geo+json");
+                resp->addHeader("X-Cache", cacheStatus);
                 resp->addHeader("Cache-Control", "public, max-age=300");
                 
                 callback(resp);
@@ -272,4 +294,312 @@ void AntenneController::getSimplifiedCoverage(
             }
         }
     );
-}
\ No newline at end of file
+}
+
+// ============================================================================
+// MEMBRES D'UN CLUSTER (expansion à la demande)
+// ============================================================================
+/**
+ * Les clusters ne transportent que des comptes agrégés : leurs membres sont
+ * paginés ici, ce qui garde les réponses à bas zoom de taille constante.
+ *
+ * Identifiants :
+ *  - "k<niveau>.<début>.<version>" : nœud de la pyramide en mémoire (ClusterIndexService),
+ *    valable pour la version des données qui l'a produit
+ *  - "g<niveau>.<gx>.<gy>" : cellule de grille du repli SQL
+ *
+ * Paramètres optionnels : offset (défaut 0), limit (1-1000, défaut 100),
+ * status / technology / operator_id identiques à la requête d'origine
+ */
+void AntenneController::getClusterLeaves(const HttpRequestPtr& req,
+                                         std::function<void (const HttpResponsePtr &)> &&callback,
+                                         const std::string& clusterId) {
+    int offset = req->getOptionalParameter<int>("offset").value_or(0);
+    int limit = req->getOptionalParameter<int>("limit").value_or(100);
+    std::string status = req->getOptionalParameter<std::string>("status").value_or("");
+    std::string technology = req->getOptionalParameter<std::string>("technology").value_or("");
+    int operator_id = req->getOptionalParameter<int>("operator_id").value_or(-1);
+
+    Validator::ErrorCollector validator;
+    if (offset < 0) {
+        validator.addError("offset", "offset must be >= 0");
+    }
+    if (limit < 1 || limit > 1000) {
+        validator.addError("limit", "limit must be between 1 and 1000");
+    }
+    if (!status.empty() && !Validator::isValidStatus(status)) {
+        validator.addError("status", "Invalid status. Must be one of: active, inactive, maintenance");
+    }
+    if (!technology.empty() && !Validator::isValidTechnology(technology)) {
+        validator.addError("technology", "Invalid technology. Must be one of: 2G, 3G, 4G, 5G");
+    }
+
+    // Décodage de l'identifiant
+    int level = -1;
+    unsigned int leafBegin = 0;
+    long long version = 0;
+    long long gx = 0, gy = 0;
+    char tail = 0;
+    bool indexId = !clusterId.empty() && clusterId[0] == 'k' &&
+                   std::sscanf(clusterId.c_str(), "k%d.%u.%lld%c", &level, &leafBegin, &version, &tail) == 3;
+    bool gridId = !clusterId.empty() && clusterId[0] == 'g' &&
+                  std::sscanf(clusterId.c_str(), "g%d.%lld.%lld%c", &level, &gx, &gy, &tail) == 3 &&
+                  level >= 0 && level < AntenneService::CLUSTER_GRID_LEVELS;
+    if (!indexId && !gridId) {
+        validator.addError("cluster_id", "Invalid cluster id");
+    }
+
+    if (validator.hasErrors()) {
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(k400BadRequest);
+        resp->setBody(validator.getErrorsAsJson());
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        callback(resp);
+        return;
+    }
+
+    // ========== INDEX EN MÉMOIRE ==========
+    if (indexId) {
+        Json::Value page;
+        switch (ClusterIndexService::getLeaves(level, leafBegin, std::to_string(version),
+                                               status, technology, operator_id, offset, limit, page)) {
+            case ClusterIndexService::Lookup::Found: {
+                auto resp = HttpResponse::newHttpJsonResponse(page);
+                resp->addHeader("X-Cache", "INDEX");
+                callback(resp);
+                return;
+            }
+            case ClusterIndexService::Lookup::NotFound:
+                callback(ErrorHandler::createGenericErrorResponse("Unknown cluster id", k404NotFound));
+                return;
+            case ClusterIndexService::Lookup::Expired:
+                callback(ErrorHandler::createGenericErrorResponse(
+                    "Expired cluster id (data changed since it was issued), reload the clusters", k410Gone));
+                return;
+            case ClusterIndexService::Lookup::Unavailable: {
+                // Index du filtre en cours de (re)construction
+                auto resp = ErrorHandler::createGenericErrorResponse(
+                    "Cluster index is being rebuilt, retry shortly", k503ServiceUnavailable);
+                resp->addHeader("Retry-After", "1");
+                callback(resp);
+                return;
+            }
+        }
+    }
+
+    // ========== CELLULE DE GRILLE (SQL) ==========
+    AntenneService::getGridClusterLeaves(level, gx, gy, status, technology, operator_id, offset, limit,
+        [callback, clusterId](const Json::Value& page, const std::string& err) {
+            if (!err.empty()) {
+                auto errorDetails = ErrorHandler::analyzePostgresError(err);
+                ErrorHandler::logError("AntenneController::getClusterLeaves", errorDetails);
+                callback(ErrorHandler::createErrorResponse(errorDetails));
+                return;
+            }
+
+            Json::Value response = page;
+            response["cluster_id"] = clusterId;
+            callback(HttpResponse::newHttpJsonResponse(response));
+        });
+}
+
+// ============================================================================
+// TUILES VECTORIELLES DES CLUSTERS (MVT)
+// ============================================================================
+/**
+ * Tuile Mapbox Vector Tile z/x/y (couche "antennas")
+ *
+ * Contrairement à /clustered (bbox libre), les URLs de tuiles sont en nombre fini :
+ * elles se partagent entre clients et se cachent côté navigateur / CDN.
+ *
+ * Paramètres optionnels (query string) : status, technology, operator_id
+ *
+ * Réponse : application/vnd.mapbox-vector-tile (corps vide si aucune antenne)
+ */
+void AntenneController::getClusterTile(const HttpRequestPtr& req,
+                                       std::function<void (const HttpResponsePtr &)> &&callback,
+                                       int z, int x, int y) {
+    // ========== VALIDATION DES PARAMÈTRES ==========
+    Validator::ErrorCollector validator;
+
+    if (z < 0 || z > 22) {
+        validator.addError("z", "Zoom level must be between 0 and 22");
+    } else {
+        long long tiles = 1LL << z;
+        if (x < 0 || x >= tiles || y < 0 || y >= tiles) {
+            validator.addError("tile", "x and y must be between 0 and 2^z - 1");
+        }
+    }
+
+    if (validator.hasErrors()) {
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(k400BadRequest);
+        resp->setBody(validator.getErrorsAsJson());
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        callback(resp);
+        return;
+    }
+
+    std::string status = req->getOptionalParameter<std::string>("status").value_or("");
+    std::string technology = req->getOptionalParameter<std::string>("technology").value_or("");
+    int operator_id = req->getOptionalParameter<int>("operator_id").value_or(-1);
+
+    if (!status.empty() && !Validator::isValidStatus(status)) {
+        callback(ErrorHandler::createGenericErrorResponse(
+            "Invalid status. Must be one of: active, inactive, maintenance", k400BadRequest));
+        return;
+    }
+    if (!technology.empty() && !Validator::isValidTechnology(technology)) {
+        callback(ErrorHandler::createGenericErrorResponse(
+            "Invalid technology. Must be one of: 2G, 3G, 4G, 5G", k400BadRequest));
+        return;
+    }
+
+    auto tileResponse = [req](const CacheService::CompressedEntry& tile, const char* cacheState) {
+        auto resp = CacheService::encodedResponse(req, tile, "application/vnd.mapbox-vector-tile");
+        resp->addHeader("X-Cache", cacheState);
+        resp->addHeader("Cache-Control", "public, max-age=120");
+        return resp;
+    };
+
+    // ========== INDEX EN MÉMOIRE ==========
+    // Encodage direct depuis la pyramide : pas de passage par Redis (ni de compression)
+    std::string tile;
+    if (ClusterIndexService::encodeTile(z, x, y, status, technology, operator_id, tile)) {
+        callback(tileResponse({"identity", std::move(tile)}, "INDEX"));
+        return;
+    }
+
+    // ========== REPLI SQL + CACHE REDIS ==========
+    // Clé sous "clusters:" : purgée par invalidateAntennaCache()
+    std::string cacheKey = "clusters:tiles:" + std::to_string(z) + ":" + std::to_string(x) + ":" + std::to_string(y);
+    if (!status.empty()) cacheKey += ":st:" + status;
+    if (!technology.empty()) cacheKey += ":tech:" + technology;
+    if (operator_id >= 0) cacheKey += ":op:" + std::to_string(operator_id);
+
+    // Tuile compressée au remplissage (les MVT ne sont pas compressées par la couche HTTP)
+    auto cached = CacheService::getInstance().getCompressed(cacheKey);
+    if (cached) {
+        callback(tileResponse(*cached, "HIT"));
+        return;
+    }
+
+    AntenneService::getClusterTile(z, x, y, status, technology, operator_id,
+        [callback, cacheKey, tileResponse](const std::string& tile, const std::string& err) {
+            if (!err.empty()) {
+                auto errorDetails = ErrorHandler::analyzePostgresError(err);
+                ErrorHandler::logError("AntenneController::getClusterTile", errorDetails);
+                callback(ErrorHandler::createErrorResponse(errorDetails));
+                return;
+            }
+
+            auto entry = CacheService::compress(tile);
+            CacheService::getInstance().setCompressed(cacheKey, entry, 3600);
+            callback(tileResponse(entry, "MISS"));
+        });
+}
+
+// ============================================================================
+// 3. ÉTAT DE L'INDEX DE CLUSTERING
+// ============================================================================
+void AntenneController::getClusterIndexStatus(const HttpRequestPtr& req,
+                                              std::function<void (const HttpResponsePtr &)> &&callback) {
+    auto resp = HttpResponse::newHttpJsonResponse(ClusterIndexService::getStatus());
+    callback(resp);
+}
+
+// ============================================================================
+// SYNCHRONISATION DELTA
+// ============================================================================
+/**
+ * Un client qui garde une copie locale (vue, bbox) se synchronise en
+ * kilo-octets au lieu de recharger clusters et couverture après chaque édition :
+ *  1. Chargement initial, puis GET /api/antennas/changes?since=0 pour obtenir la version
+ *  2. Périodiquement : since = version reçue ; appliquer upserted[] et deleted[]
+ *  3. has_more = true : rappeler aussitôt avec la nouvelle version
+ *  4. 410 Gone : journal purgé au-delà de 'since', recharger la vue complète
+ */
+void AntenneController::getChanges(const HttpRequestPtr& req,
+                                   std::function<void (const HttpResponsePtr &)> &&callback,
+                                   long long since) {
+    // ========== VALIDATION ==========
+    Validator::ErrorCollector validator;
+
+    if (since < 0) {
+        validator.addError("since", "Version must be a non-negative integer");
+    }
+
+    auto minLat = req->getOptionalParameter<double>("minLat");
+    auto minLon = req->getOptionalParameter<double>("minLon");
+    auto maxLat = req->getOptionalParameter<double>("maxLat");
+    auto maxLon = req->getOptionalParameter<double>("maxLon");
+    int provided = (minLat ? 1 : 0) + (minLon ? 1 : 0) + (maxLat ? 1 : 0) + (maxLon ? 1 : 0);
+    bool hasBbox = (provided == 4);
+
+    if (provided != 0 && provided != 4) {
+        validator.addError("bbox", "Provide all of minLat, minLon, maxLat, maxLon or none");
+    } else if (hasBbox) {
+        if (!Validator::isValidLatitude(*minLat) || !Validator::isValidLatitude(*maxLat)) {
+            validator.addError("latitude", "Latitudes must be between -90 and +90 degrees");
+        }
+        if (!Validator::isValidLongitude(*minLon) || !Validator::isValidLongitude(*maxLon)) {
+            validator.addError("longitude", "Longitudes must be between -180 and +180 degrees");
+        }
+        if (*minLat >= *maxLat || *minLon >= *maxLon) {
+            validator.addError("bbox", "minLat/minLon must be less than maxLat/maxLon");
+        }
+    }
+
+    int limit = req->getOptionalParameter<int>("limit").value_or(1000);
+    if (limit < 1 || limit > 10000) {
+        validator.addError("limit", "Limit must be between 1 and 10000");
+    }
+
+    if (validator.hasErrors()) {
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(k400BadRequest);
+        resp->setBody(validator.getErrorsAsJson());
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        callback(resp);
+        return;
+    }
+
+    AntenneService::getChanges(since, hasBbox,
+        minLat.value_or(0), minLon.value_or(0), maxLat.value_or(0), maxLon.value_or(0), limit,
+        [callback](const Json::Value& result, const std::string& err) {
+            if (!err.empty()) {
+                auto errorDetails = ErrorHandler::analyzePostgresError(err);
+                ErrorHandler::logError("AntenneController::getChanges", errorDetails);
+                callback(ErrorHandler::createErrorResponse(errorDetails));
+                return;
+            }
+
+            if (result["resync_required"].asBool()) {
+                Json::Value body;
+                body["error"] = "Change log no longer covers this version, reload the full view";
+                body["current_version"] = result["current_version"];
+                auto resp = HttpResponse::newHttpJsonResponse(body);
+                resp->setStatusCode(k410Gone);
+                callback(resp);
+                return;
+            }
+
+            auto resp = HttpResponse::newHttpJsonResponse(result);
+            resp->addHeader("X-Data-Version", result["version"].asString());
+            resp->addHeader("Cache-Control", "no-cache");
+            callback(resp);
+        });
+}
+
+void AntenneController::getChangeFeedStatus(const HttpRequestPtr& req,
+                                            std::function<void (const HttpResponsePtr &)> &&callback) {
+    callback(HttpResponse::newHttpJsonResponse(ChangeFeedService::getStatus()));
+}
+
+// ============================================================================
+// ÉTAT DU PRÉCHAUFFAGE DE LA COUVERTURE
+// ============================================================================
+void AntenneController::getCoverageWarmerStatus(const HttpRequestPtr& req,
+                                                std::function<void (const HttpResponsePtr &)> &&callback) {
+    callback(HttpResponse::newHttpJsonResponse(CoverageWarmerService::getStatus()));
+}
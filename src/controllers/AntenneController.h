@@ -12,6 +12,24 @@ public:
         
         // NOUVEAU : Simplified Coverage (Sprint 4 Performance + Filtres)
         ADD_METHOD_TO(AntenneController::getSimplifiedCoverage, "/api/antennas/coverage/simplified?minLat={1}&minLon={2}&maxLat={3}&maxLon={4}&zoom={5}", Get);
+
+        // État du préchauffage des blocs de couverture
+        ADD_METHOD_TO(AntenneController::getCoverageWarmerStatus, "/api/antennas/coverage/warmer", Get);
+
+        // Membres d'un cluster, paginés (expansion à la demande)
+        ADD_METHOD_TO(AntenneController::getClusterLeaves, "/api/antennas/clusters/{1}/leaves", Get);
+
+        // Tuiles vectorielles (Mapbox Vector Tile) des antennes et clusters
+        ADD_METHOD_TO(AntenneController::getClusterTile, "/api/antennas/tiles/{1}/{2}/{3}.mvt", Get);
+
+        // État de l'index de clustering en mémoire
+        ADD_METHOD_TO(AntenneController::getClusterIndexStatus, "/api/antennas/clustered/index", Get);
+
+        // Synchronisation delta : antennes modifiées depuis une version des données
+        ADD_METHOD_TO(AntenneController::getChanges, "/api/antennas/changes?since={1}", Get);
+
+        // État du flux WebSocket /ws/antennas (abonnés, version diffusée)
+        ADD_METHOD_TO(AntenneController::getChangeFeedStatus, "/api/antennas/changes/feed", Get);
     METHOD_LIST_END
 
     // ========== CLUSTERING (Sprint 1 Optimization) ==========
@@ -23,7 +41,37 @@ public:
     
     // ========== SIMPLIFIED COVERAGE (Sprint 4 Performance) ==========
     // Couverture simplifiée ultra-optimisée pour navigation fluide
-    // Utilise ST_Union + ST_Simplify + cache Redis
+    // Tuiles de couverture précalculées (coverage_tile), assemblées par blocs alignés
+    // (OU des masques, tracé en C++) mis en cache Redis par bloc
     void getSimplifiedCoverage(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback,
                               double minLat, double minLon, double maxLat, double maxLon, int zoom);
+
+    // ========== MEMBRES D'UN CLUSTER ==========
+    // Pagination des antennes d'un cluster_id (index en mémoire "k..." ou grille SQL "g...")
+    // Paramètres optionnels : offset, limit, et les filtres de la requête d'origine
+    void getClusterLeaves(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback,
+                          const std::string& clusterId);
+
+    // ========== TUILES VECTORIELLES (MVT) ==========
+    // Tuile z/x/y des clusters : URL finie, cacheable par le navigateur / CDN
+    // Index en mémoire si disponible, sinon ST_AsMVT + cache Redis
+    void getClusterTile(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback,
+                        int z, int x, int y);
+
+    // ========== INDEX DE CLUSTERING ==========
+    // Version des données, index construits par filtre, hits / replis SQL
+    void getClusterIndexStatus(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
+
+    // ========== SYNCHRONISATION DELTA ==========
+    // Insertions / modifications / suppressions depuis 'since' (journal tenu par triggers)
+    // Paramètres optionnels : minLat, minLon, maxLat, maxLon (tous ou aucun), limit
+    void getChanges(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback,
+                    long long since);
+
+    // Abonnés WebSocket, notifications LISTEN reçues, lots envoyés
+    void getChangeFeedStatus(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
+
+    // ========== PRÉCHAUFFAGE DE LA COUVERTURE ==========
+    // Passage en cours, lots restants, blocs calculés lors du dernier passage
+    void getCoverageWarmerStatus(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
 };
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "AntenneWebSocket.h"
+#include "../utils/Validator.h"
+
+#include <json/json.h>
+#include <memory>
+#include <sstream>
+
+namespace {
+    void sendJson(const WebSocketConnectionPtr& conn, const Json::Value& msg) {
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+        conn->send(Json::writeString(builder, msg));
+    }
+
+    void sendError(const WebSocketConnectionPtr& conn, const std::string& message) {
+        Json::Value msg;
+        msg["type"] = "error";
+        msg["message"] = message;
+        sendJson(conn, msg);
+    }
+}
+
+void AntenneWebSocket::handleNewConnection(const HttpRequestPtr& req, const WebSocketConnectionPtr& conn) {
+    // Aucun abonnement tant que le client n'a pas envoyé sa bbox
+}
+
+void AntenneWebSocket::handleConnectionClosed(const WebSocketConnectionPtr& conn) {
+    ChangeFeedService::unsubscribe(conn);
+}
+
+void AntenneWebSocket::handleNewMessage(const WebSocketConnectionPtr& conn, std::string&& message,
+                                        const WebSocketMessageType& type) {
+    if (type != WebSocketMessageType::Text) return;
+
+    Json::Value request;
+    Json::CharReaderBuilder reader;
+    std::string errors;
+    std::istringstream stream(message);
+    if (!Json::parseFromStream(reader, stream, &request, &errors) || !request.isObject()) {
+        sendError(conn, "Invalid JSON message");
+        return;
+    }
+
+    std::string action = request.get("action", "").asString();
+    if (action == "unsubscribe") {
+        ChangeFeedService::unsubscribe(conn);
+        return;
+    }
+    if (action != "subscribe") {
+        sendError(conn, "Unknown action. Must be one of: subscribe, unsubscribe");
+        return;
+    }
+
+    // ========== VALIDATION DE L'ABONNEMENT ==========
+    for (const char* key : {"minLat", "minLon", "maxLat", "maxLon"}) {
+        if (!request[key].isNumeric()) {
+            sendError(conn, std::string("Missing or invalid ") + key);
+            return;
+        }
+    }
+
+    ChangeFeedService::Subscription sub;
+    sub.minLat = request["minLat"].asDouble();
+    sub.minLon = request["minLon"].asDouble();
+    sub.maxLat = request["maxLat"].asDouble();
+    sub.maxLon = request["maxLon"].asDouble();
+    sub.status = request.get("status", "").asString();
+    sub.technology = request.get("technology", "").asString();
+    sub.operator_id = request.get("operator_id", -1).asInt();
+
+    if (!Validator::isValidLatitude(sub.minLat) || !Validator::isValidLatitude(sub.maxLat) ||
+        !Validator::isValidLongitude(sub.minLon) || !Validator::isValidLongitude(sub.maxLon) ||
+        sub.minLat >= sub.maxLat || sub.minLon >= sub.maxLon) {
+        sendError(conn, "Invalid bounding box");
+        return;
+    }
+    if (!sub.status.empty() && !Validator::isValidStatus(sub.status)) {
+        sendError(conn, "Invalid status. Must be one of: active, inactive, maintenance");
+        return;
+    }
+    if (!sub.technology.empty() && !Validator::isValidTechnology(sub.technology)) {
+        sendError(conn, "Invalid technology. Must be one of: 2G, 3G, 4G, 5G");
+        return;
+    }
+
+    Json::Value ack;
+    ack["type"] = "subscribed";
+    ack["version"] = static_cast<Json::Int64>(ChangeFeedService::subscribe(conn, sub));
+    sendJson(conn, ack);
+}
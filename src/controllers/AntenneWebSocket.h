@@ -0,0 +1,29 @@
+#pragma once
+#include <drogon/WebSocketController.h>
+#include "../services/ChangeFeedService.h"
+
+using namespace drogon;
+
+/**
+ * Flux temps réel des modifications d'antennes (remplace le sondage des tableaux de bord)
+ *
+ * Client → serveur (texte JSON) :
+ *   {"action": "subscribe", "minLat", "minLon", "maxLat", "maxLon", "status"?, "technology"?, "operator_id"?}
+ *   {"action": "unsubscribe"}
+ * Serveur → client :
+ *   {"type": "subscribed", "version"}
+ *   {"type": "changes", "version", "upserted": [...], "deleted": [...], "changed_extent": [...]}
+ *   {"type": "resync", "version"}   trop de changements d'un coup : recharger la vue
+ *   {"type": "error", "message"}
+ */
+class AntenneWebSocket : public drogon::WebSocketController<AntenneWebSocket> {
+public:
+    WS_PATH_LIST_BEGIN
+        WS_PATH_ADD("/ws/antennas");
+    WS_PATH_LIST_END
+
+    void handleNewMessage(const WebSocketConnectionPtr& conn, std::string&& message,
+                          const WebSocketMessageType& type) override;
+    void handleNewConnection(const HttpRequestPtr& req, const WebSocketConnectionPtr& conn) override;
+    void handleConnectionClosed(const WebSocketConnectionPtr& conn) override;
+};
@@ -0,0 +1,58 @@
+#include "CoverageController.h"
+#include "../utils/ErrorHandler.h"
+
+// ============================================================================
+// 1. RECALCUL DES EMPREINTES DE COUVERTURE
+// ============================================================================
+/**
+ * Route: POST /api/coverage/viewshed/rebuild?mode={dirty|full}
+ *
+ * - dirty (défaut) : antennes marquées par les triggers (antenne ou obstacle modifié)
+ * - full : toutes les antennes actives
+ *
+ * Job asynchrone : réponse 202, suivi via GET /api/coverage/viewshed/status.
+ */
+void CoverageController::rebuildViewsheds(const HttpRequestPtr& req,
+                                          std::function<void (const HttpResponsePtr &)> &&callback) {
+    std::string mode = req->getOptionalParameter<std::string>("mode").value_or("dirty");
+
+    if (mode != "dirty" && mode != "full") {
+        auto resp = ErrorHandler::createGenericErrorResponse(
+            "Mode must be 'dirty' or 'full'", k400BadRequest);
+        callback(resp);
+        return;
+    }
+
+    bool started = ViewshedService::recompute(mode == "full",
+        [](const Json::Value& stats, const std::string& err) {
+            if (!err.empty()) {
+                LOG_ERROR << "Viewshed recompute failed: " << err;
+            }
+        });
+
+    if (!started) {
+        auto resp = ErrorHandler::createGenericErrorResponse(
+            "A viewshed recompute is already running", k409Conflict);
+        callback(resp);
+        return;
+    }
+
+    LOG_INFO << "🏔️ Viewshed recompute started (" << mode << ")";
+
+    Json::Value body;
+    body["success"] = true;
+    body["message"] = "Viewshed recompute started";
+    body["mode"] = mode;
+    auto resp = HttpResponse::newHttpJsonResponse(body);
+    resp->setStatusCode(k202Accepted);
+    callback(resp);
+}
+
+// ============================================================================
+// 2. ÉTAT DU DERNIER RECALCUL
+// ============================================================================
+void CoverageController::getViewshedStatus(const HttpRequestPtr& req,
+                                           std::function<void (const HttpResponsePtr &)> &&callback) {
+    auto resp = HttpResponse::newHttpJsonResponse(ViewshedService::getStatus());
+    callback(resp);
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <drogon/HttpController.h>
+#include "../services/ViewshedService.h"
+
+using namespace drogon;
+
+class CoverageController : public drogon::HttpController<CoverageController> {
+public:
+    METHOD_LIST_BEGIN
+        // Recalcul des empreintes de couverture (?mode=dirty|full)
+        ADD_METHOD_TO(CoverageController::rebuildViewsheds, "/api/coverage/viewshed/rebuild", Post);
+        ADD_METHOD_TO(CoverageController::getViewshedStatus, "/api/coverage/viewshed/status", Get);
+    METHOD_LIST_END
+
+    void rebuildViewsheds(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
+    void getViewshedStatus(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
+};
@@ -0,0 +1,97 @@
+#include "InterferenceController.h"
+#include "../utils/ErrorHandler.h"
+
+// ============================================================================
+// 1. RECALCUL DE LA MATRICE D'INTERFÉRENCES
+// ============================================================================
+/**
+ * Route: POST /api/interferences/rebuild?maxDistance={mètres}
+ *
+ * Job batch asynchrone : la réponse 202 est renvoyée immédiatement,
+ * l'avancement est consultable via GET /api/interferences/status.
+ */
+void InterferenceController::rebuild(const HttpRequestPtr& req,
+                                     std::function<void (const HttpResponsePtr &)> &&callback) {
+    double maxDistance = req->getOptionalParameter<double>("maxDistance")
+                             .value_or(InterferenceService::configuredMaxDistance());
+
+    if (maxDistance <= 0 || maxDistance > 50000) {
+        auto resp = ErrorHandler::createGenericErrorResponse(
+            "maxDistance must be between 0 and 50000 meters", k400BadRequest);
+        callback(resp);
+        return;
+    }
+
+    bool started = InterferenceService::rebuildMatrix(maxDistance,
+        [](const Json::Value& stats, const std::string& err) {
+            if (!err.empty()) {
+                LOG_ERROR << "Interference rebuild failed: " << err;
+            }
+        });
+
+    if (!started) {
+        auto resp = ErrorHandler::createGenericErrorResponse(
+            "An interference rebuild is already running", k409Conflict);
+        callback(resp);
+        return;
+    }
+
+    LOG_INFO << "📶 Interference rebuild started (maxDistance: " << maxDistance << " m)";
+
+    Json::Value body;
+    body["success"] = true;
+    body["message"] = "Interference matrix rebuild started";
+    body["max_distance_m"] = maxDistance;
+    auto resp = HttpResponse::newHttpJsonResponse(body);
+    resp->setStatusCode(k202Accepted);
+    callback(resp);
+}
+
+// ============================================================================
+// 2. ÉTAT DU DERNIER RECALCUL
+// ============================================================================
+void InterferenceController::getStatus(const HttpRequestPtr& req,
+                                       std::function<void (const HttpResponsePtr &)> &&callback) {
+    auto resp = HttpResponse::newHttpJsonResponse(InterferenceService::getStatus());
+    callback(resp);
+}
+
+// ============================================================================
+// 3. INTERFÉRENCES D'UNE ANTENNE
+// ============================================================================
+/**
+ * Route: GET /api/antennas/{id}/interferences?limit={n}
+ *
+ * Lecture de la matrice pré-calculée (index idx_interference_source)
+ * au lieu d'un calcul géométrique O(N²) à la volée.
+ */
+void InterferenceController::getByAntenna(const HttpRequestPtr& req,
+                                          std::function<void (const HttpResponsePtr &)> &&callback,
+                                          int antennaId) {
+    int limit = req->getOptionalParameter<int>("limit").value_or(100);
+    if (limit < 1) limit = 100;
+    if (limit > 1000) limit = 1000;
+
+    InterferenceService::getByAntenna(antennaId, limit,
+        [callback, antennaId](const std::vector<InterferenceModel>& list, const std::string& err) {
+            if (err.empty()) {
+                Json::Value arr(Json::arrayValue);
+                for (const auto& item : list) {
+                    arr.append(item.toJson());
+                }
+
+                Json::Value body;
+                body["antenna_id"] = antennaId;
+                body["count"] = static_cast<int>(list.size());
+                body["interferences"] = arr;
+
+                auto resp = HttpResponse::newHttpJsonResponse(body);
+                callback(resp);
+            } else {
+                auto errorDetails = ErrorHandler::analyzePostgresError(err);
+                ErrorHandler::logError("InterferenceController::getByAntenna", errorDetails);
+                auto resp = ErrorHandler::createErrorResponse(errorDetails);
+                callback(resp);
+            }
+        });
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <drogon/HttpController.h>
+#include "../services/InterferenceService.h"
+
+using namespace drogon;
+
+class InterferenceController : public drogon::HttpController<InterferenceController> {
+public:
+    METHOD_LIST_BEGIN
+        // Lancement du recalcul batch de la matrice (?maxDistance=mètres)
+        ADD_METHOD_TO(InterferenceController::rebuild, "/api/interferences/rebuild", Post);
+        ADD_METHOD_TO(InterferenceController::getStatus, "/api/interferences/status", Get);
+
+        // Interférences subies par une antenne (lecture indexée de la matrice)
+        ADD_METHOD_TO(InterferenceController::getByAntenna, "/api/antennas/{1}/interferences", Get);
+    METHOD_LIST_END
+
+    void rebuild(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
+    void getStatus(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
+    void getByAntenna(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback, int antennaId);
+};
@@ -83,10 +83,11 @@ void ObstacleController::getByBoundingBox(const HttpRequestPtr& req, std::functi
     }
 
     // Query database
-    ObstacleService::getByBoundingBox(minLon, minLat, maxLon, maxLat, zoom, type, [callback](const Json::Value& geojson, const std::string& err) {
+    ObstacleService::getByBoundingBox(minLon, minLat, maxLon, maxLat, zoom, type, [callback](const std::string& geojson, const std::string& err) {
         if (err.empty()) {
-            auto resp = HttpResponse::newHttpJsonResponse(geojson);
-            resp->addHeader("Content-Type", "application/geo+json");
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setBody(geojson);
+            resp->setContentTypeString("application/geo+json");
             callback(resp);
         } else {
             auto errorDetails = ErrorHandler::analyzePostgresError(err);
@@ -0,0 +1,118 @@
+#include "PlanningController.h"
+#include "../services/InterferenceService.h"
+#include "../utils/Validator.h"
+#include "../utils/ErrorHandler.h"
+
+// ============================================================================
+// 1. PLAN PCI COURANT
+// ============================================================================
+/**
+ * Route: GET /api/planning/pci?operator_id={id}&technology={tech}
+ *
+ * Retourne les PCI attribués par la dernière planification.
+ */
+void PlanningController::getPciPlan(const HttpRequestPtr& req,
+                                    std::function<void (const HttpResponsePtr &)> &&callback) {
+    int operator_id = req->getOptionalParameter<int>("operator_id").value_or(-1);
+    std::string technology = req->getOptionalParameter<std::string>("technology").value_or("");
+
+    if (!technology.empty() && !Validator::isValidTechnology(technology)) {
+        auto resp = ErrorHandler::createGenericErrorResponse(
+            "Invalid technology. Must be one of: 2G, 3G, 4G, 5G",
+            k400BadRequest
+        );
+        callback(resp);
+        return;
+    }
+
+    FrequencyPlanningService::getAssignments(operator_id, technology,
+        [callback](const std::vector<PciAssignment>& list, const std::string& err) {
+            if (err.empty()) {
+                Json::Value arr(Json::arrayValue);
+                for (const auto& item : list) {
+                    arr.append(item.toJson());
+                }
+
+                Json::Value body;
+                body["count"] = static_cast<int>(list.size());
+                body["assignments"] = arr;
+
+                auto resp = HttpResponse::newHttpJsonResponse(body);
+                callback(resp);
+            } else {
+                auto errorDetails = ErrorHandler::analyzePostgresError(err);
+                ErrorHandler::logError("PlanningController::getPciPlan", errorDetails);
+                auto resp = ErrorHandler::createErrorResponse(errorDetails);
+                callback(resp);
+            }
+        });
+}
+
+// ============================================================================
+// 2. LANCEMENT D'UNE PLANIFICATION
+// ============================================================================
+/**
+ * Route: POST /api/planning/pci/run?mode={full|incremental}&neighborDistance={mètres}
+ *
+ * - full : recoloration complète du graphe
+ * - incremental : seules les antennes sans PCI (nouvelles antennes) sont colorées
+ *
+ * Job asynchrone : réponse 202, suivi via GET /api/planning/pci/status.
+ */
+void PlanningController::runPciPlanning(const HttpRequestPtr& req,
+                                        std::function<void (const HttpResponsePtr &)> &&callback) {
+    std::string mode = req->getOptionalParameter<std::string>("mode").value_or("incremental");
+    double neighborDistance = req->getOptionalParameter<double>("neighborDistance")
+                                  .value_or(InterferenceService::configuredMaxDistance());
+
+    Validator::ErrorCollector validator;
+    if (mode != "full" && mode != "incremental") {
+        validator.addError("mode", "Mode must be 'full' or 'incremental'");
+    }
+    if (neighborDistance <= 0 || neighborDistance > 50000) {
+        validator.addError("neighborDistance", "neighborDistance must be between 0 and 50000 meters");
+    }
+    if (validator.hasErrors()) {
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(k400BadRequest);
+        resp->setBody(validator.getErrorsAsJson());
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        callback(resp);
+        return;
+    }
+
+    bool incremental = (mode == "incremental");
+    bool started = FrequencyPlanningService::plan(incremental, neighborDistance,
+        [](const Json::Value& stats, const std::string& err) {
+            if (!err.empty()) {
+                LOG_ERROR << "PCI planning failed: " << err;
+            }
+        });
+
+    if (!started) {
+        auto resp = ErrorHandler::createGenericErrorResponse(
+            "A PCI planning run is already in progress", k409Conflict);
+        callback(resp);
+        return;
+    }
+
+    LOG_INFO << "📻 PCI planning started (" << mode << ", neighborDistance: " << neighborDistance << " m)";
+
+    Json::Value body;
+    body["success"] = true;
+    body["message"] = "PCI planning started";
+    body["mode"] = mode;
+    body["neighbor_distance_m"] = neighborDistance;
+    auto resp = HttpResponse::newHttpJsonResponse(body);
+    resp->setStatusCode(k202Accepted);
+    callback(resp);
+}
+
+// ============================================================================
+// 3. ÉTAT DE LA DERNIÈRE PLANIFICATION
+// ============================================================================
+void PlanningController::getPciStatus(const HttpRequestPtr& req,
+                                      std::function<void (const HttpResponsePtr &)> &&callback) {
+    auto resp = HttpResponse::newHttpJsonResponse(FrequencyPlanningService::getStatus());
+    callback(resp);
+}
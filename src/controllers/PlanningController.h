@@ -0,0 +1,21 @@
+#pragma once
+#include <drogon/HttpController.h>
+#include "../services/FrequencyPlanningService.h"
+
+using namespace drogon;
+
+class PlanningController : public drogon::HttpController<PlanningController> {
+public:
+    METHOD_LIST_BEGIN
+        // Plan PCI courant (?operator_id=...&technology=...)
+        ADD_METHOD_TO(PlanningController::getPciPlan, "/api/planning/pci", Get);
+
+        // Lancement d'une planification (?mode=full|incremental&neighborDistance=mètres)
+        ADD_METHOD_TO(PlanningController::runPciPlanning, "/api/planning/pci/run", Post);
+        ADD_METHOD_TO(PlanningController::getPciStatus, "/api/planning/pci/status", Get);
+    METHOD_LIST_END
+
+    void getPciPlan(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
+    void runPciPlanning(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
+    void getPciStatus(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
+};
@@ -1,4 +1,7 @@
 #include "SimulationController.h"
+#include "../services/SignalCacheService.h"
+#include "../utils/Geohash.h"
+#include "../utils/GeoUtils.h"
 
 // Vérification du signal radio à une position donnée
 void SimulationController::checkSignal(const HttpRequestPtr& req,
@@ -31,9 +34,45 @@ void SimulationController::checkSignal(const HttpRequestPtr& req,
         technology = params.at("technology");
     }
 
+    // ========== CACHE (cellule geohash + filtres) ==========
+    // Le signal est évalué au centre de la cellule : même résultat pour tous les clics
+    // de la cellule. La réponse donne la position évaluée (location), le clic
+    // (requested_location) et la taille de la cellule : la résolution est explicite
+    auto& cache = SignalCacheService::getInstance();
+    std::string cell = Geohash::encode(lat, lon, cache.precision());
+    std::string cacheKey = cache.makeKey(cell, operatorId, technology);
+
+    double cellLat, cellLon;
+    Geohash::decodeCenter(cell, cellLat, cellLon);
+    double dLat, dLon;
+    Geohash::cellSize(cache.precision(), dLat, dLon);
+
+    Json::Value position;
+    position["location"]["lat"] = cellLat;
+    position["location"]["lon"] = cellLon;
+    position["requested_location"]["lat"] = lat;
+    position["requested_location"]["lon"] = lon;
+    position["cell"] = cell;
+    position["cell_size_m"]["lat"] = std::round(dLat * GeoUtils::METERS_PER_DEGREE_LAT);
+    position["cell_size_m"]["lon"] = std::round(dLon * GeoUtils::METERS_PER_DEGREE_LAT *
+                                                std::cos(cellLat * GeoUtils::PI / 180.0));
+
+    SignalCacheService::Tier tier;
+    SignalCacheService::Generation generation;
+    auto cached = cache.get(cacheKey, tier, generation);
+    if (cached) {
+        Json::Value result = *cached;
+        for (const auto& name : position.getMemberNames()) result[name] = position[name];
+
+        auto resp = HttpResponse::newHttpJsonResponse(result);
+        resp->addHeader("X-Cache", tier == SignalCacheService::Tier::Local ? "HIT-LOCAL" : "HIT");
+        callback(resp);
+        return;
+    }
+
     // Appel du service
-    SimulationService::checkSignalAtPosition(lat, lon, operatorId, technology,
-        [callback, lat, lon](const std::vector<SignalReport>& reports, const std::string& err) {
+    SimulationService::checkSignalAtPosition(cellLat, cellLon, operatorId, technology,
+        [callback, position, cacheKey, generation](const std::vector<SignalReport>& reports, const std::string& err) {
             if (err.empty()) {
                 // Tri par puissance décroissante
                 auto sortedReports = reports;
@@ -49,13 +88,18 @@ void SimulationController::checkSignal(const HttpRequestPtr& req,
                 }
 
                 Json::Value result;
-                result["location"]["lat"] = lat;
-                result["location"]["lon"] = lon;
                 result["antennas_visible"] = (int)sortedReports.size();
                 result["network_quality"] = sortedReports.empty() ? "Aucun Service" : sortedReports[0].signal_quality;
                 result["details"] = jsonArr;
 
+                // Mise en cache sans les positions (propres à chaque requête), sauf
+                // si une invalidation est survenue pendant le calcul
+                SignalCacheService::getInstance().put(cacheKey, result, generation);
+
+                for (const auto& name : position.getMemberNames()) result[name] = position[name];
+
                 auto resp = HttpResponse::newHttpJsonResponse(result);
+                resp->addHeader("X-Cache", "MISS");
                 callback(resp);
             } else {
                 auto resp = HttpResponse::newHttpResponse();
@@ -65,4 +109,51 @@ void SimulationController::checkSignal(const HttpRequestPtr& req,
             }
         }
     );
-}
\ No newline at end of file
+}
+
+// Invalidation du cache de signal (antenne ajoutée / déplacée / supprimée)
+// Body : { "lat": ..., "lon": ..., "radius": 5000 } ou { "all": true }
+void SimulationController::invalidateCache(const HttpRequestPtr& req,
+                                           std::function<void (const HttpResponsePtr &)> &&callback) {
+    auto json = req->getJsonObject();
+    if (!json) {
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(k400BadRequest);
+        resp->setBody("Invalid JSON");
+        callback(resp);
+        return;
+    }
+
+    auto& cache = SignalCacheService::getInstance();
+    Json::Value body;
+    body["success"] = true;
+
+    if ((*json).get("all", false).asBool()) {
+        cache.invalidateAll();
+        body["scope"] = "all";
+    } else {
+        if (!(*json).isMember("lat") || !(*json).isMember("lon")) {
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setStatusCode(k400BadRequest);
+            resp->setBody("Missing required fields: lat and lon (or all: true)");
+            callback(resp);
+            return;
+        }
+        double lat = (*json)["lat"].asDouble();
+        double lon = (*json)["lon"].asDouble();
+        // Une antenne influence toutes les simulations dans son rayon de recherche
+        double radius = (*json).get("radius", SimulationService::SEARCH_RADIUS_M).asDouble();
+
+        body["scope"] = "area";
+        body["local_entries_removed"] = static_cast<Json::UInt64>(cache.invalidateAround(lat, lon, radius));
+    }
+
+    auto resp = HttpResponse::newHttpJsonResponse(body);
+    callback(resp);
+}
+
+void SimulationController::getCacheStats(const HttpRequestPtr& req,
+                                         std::function<void (const HttpResponsePtr &)> &&callback) {
+    auto resp = HttpResponse::newHttpJsonResponse(SignalCacheService::getInstance().getStats());
+    callback(resp);
+}
@@ -9,8 +9,16 @@ public:
     METHOD_LIST_BEGIN
         // Endpoint : /api/simulation/check?lat=...&lon=...&operatorId=...&technology=...
         ADD_METHOD_TO(SimulationController::checkSignal, "/api/simulation/check", Get);
+
+        // Cache des simulations (cellules geohash)
+        ADD_METHOD_TO(SimulationController::invalidateCache, "/api/simulation/cache/invalidate", Post);
+        ADD_METHOD_TO(SimulationController::getCacheStats, "/api/simulation/cache/stats", Get);
     METHOD_LIST_END
 
     void checkSignal(const HttpRequestPtr& req,
                      std::function<void (const HttpResponsePtr &)> &&callback);
+    void invalidateCache(const HttpRequestPtr& req,
+                         std::function<void (const HttpResponsePtr &)> &&callback);
+    void getCacheStats(const HttpRequestPtr& req,
+                       std::function<void (const HttpResponsePtr &)> &&callback);
 };
\ No newline at end of file
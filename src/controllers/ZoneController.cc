@@ -1,9 +1,150 @@
 #include "ZoneController.h"
 #include "../services/CacheService.h"
+#include "../utils/ErrorHandler.h"
+#include "../utils/Geometry.h"
+#include "../utils/Validator.h"
+#include <trantor/net/TcpConnection.h>
+#include <atomic>
 
-// 1. Read By Type
+namespace {
+    /**
+     * Contrôle de flux d'une réponse en streaming
+     *
+     * ResponseStream n'indique pas quand un morceau est parti : on compare les octets
+     * confiés au flux aux octets que la connexion a réellement écrits sur la socket
+     * (bytesSent, lu dans la boucle de la connexion). whenDrained rappelle dès que
+     * moins de maxBuffered octets restent en attente, en re-sondant sinon ; un client
+     * qui ne lit plus rien pendant stallTimeout secondes (ou déconnecté) reçoit false.
+     * L'encadrement chunked n'est pas compté : l'écart ne fait qu'avancer l'envoi.
+     */
+    class StreamFlow : public std::enable_shared_from_this<StreamFlow> {
+    public:
+        StreamFlow(std::weak_ptr<trantor::TcpConnection> conn, size_t maxBuffered, double stallTimeout)
+            : conn_(std::move(conn)), maxBuffered_(maxBuffered), stallTimeout_(stallTimeout) {
+            // Appelé depuis la boucle de la connexion (callback du flux)
+            if (auto c = conn_.lock()) baseline_ = c->bytesSent();
+        }
+
+        void queued(size_t bytes) { queued_ += bytes; }
+
+        void whenDrained(std::function<void(bool)> next) {
+            auto conn = conn_.lock();
+            if (!conn || !conn->connected()) {
+                next(false);
+                return;
+            }
+            auto self = shared_from_this();
+            conn->getLoop()->runInLoop([self, next = std::move(next)]() mutable {
+                self->poll(std::move(next), 0, trantor::Date::now());
+            });
+        }
+
+    private:
+        static constexpr double POLL_INTERVAL_S = 0.02;
+
+        void poll(std::function<void(bool)> next, size_t lastWritten, trantor::Date lastProgress) {
+            auto conn = conn_.lock();
+            if (!conn || !conn->connected()) {
+                next(false);
+                return;
+            }
+            size_t written = conn->bytesSent() - baseline_;
+            if (queued_.load() <= written + maxBuffered_) {
+                next(true);
+                return;
+            }
+            auto now = trantor::Date::now();
+            if (written != lastWritten) {
+                lastProgress = now;
+            } else if (now.microSecondsSinceEpoch() - lastProgress.microSecondsSinceEpoch() > stallTimeout_ * 1e6) {
+                next(false);
+                return;
+            }
+            auto self = shared_from_this();
+            conn->getLoop()->runAfter(POLL_INTERVAL_S, [self, next = std::move(next), written, lastProgress]() mutable {
+                self->poll(std::move(next), written, lastProgress);
+            });
+        }
+
+        std::weak_ptr<trantor::TcpConnection> conn_;
+        size_t maxBuffered_;
+        double stallTimeout_;
+        size_t baseline_ = 0;
+        std::atomic<size_t> queued_{0};
+    };
+
+    /**
+     * Vue optionnelle (?minLat=&minLon=&maxLat=&maxLon=) : les 4 bornes ou aucune
+     * Retourne false (réponse 400 envoyée) si elle est invalide
+     */
+    bool parseViewport(const HttpRequestPtr& req, const std::function<void (const HttpResponsePtr &)>& callback,
+                       std::optional<ZoneService::Viewport>& viewport) {
+        Validator::ErrorCollector validator;
+        auto minLat = req->getOptionalParameter<double>("minLat");
+        auto minLon = req->getOptionalParameter<double>("minLon");
+        auto maxLat = req->getOptionalParameter<double>("maxLat");
+        auto maxLon = req->getOptionalParameter<double>("maxLon");
+        int provided = (minLat ? 1 : 0) + (minLon ? 1 : 0) + (maxLat ? 1 : 0) + (maxLon ? 1 : 0);
+
+        if (provided != 0 && provided != 4) {
+            validator.addError("bbox", "Provide all of minLat, minLon, maxLat, maxLon or none");
+        } else if (provided == 4) {
+            if (!Validator::isValidLatitude(*minLat) || !Validator::isValidLatitude(*maxLat)) {
+                validator.addError("latitude", "Latitudes must be between -90 and +90 degrees");
+            }
+            if (!Validator::isValidLongitude(*minLon) || !Validator::isValidLongitude(*maxLon)) {
+                validator.addError("longitude", "Longitudes must be between -180 and +180 degrees");
+            }
+            if (*minLat >= *maxLat || *minLon >= *maxLon) {
+                validator.addError("bbox", "minLat/minLon must be less than maxLat/maxLon");
+            }
+        }
+
+        if (validator.hasErrors()) {
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setStatusCode(k400BadRequest);
+            resp->setBody(validator.getErrorsAsJson());
+            resp->setContentTypeCode(CT_APPLICATION_JSON);
+            callback(resp);
+            return false;
+        }
+        if (provided == 4) viewport = ZoneService::clipBox(*minLat, *minLon, *maxLat, *maxLon);
+        return true;
+    }
+
+    // Résultat de géocodage inverse : point + chaîne des zones (de la plus fine à la racine)
+    Json::Value locatedJson(double lat, double lon, const std::vector<ZoneLocateService::LocatedZone>& chain) {
+        Json::Value item;
+        item["lat"] = lat;
+        item["lon"] = lon;
+        Json::Value zones(Json::arrayValue);
+        for (const auto& z : chain) {
+            Json::Value zone;
+            zone["id"] = z.id;
+            zone["name"] = z.name;
+            zone["type"] = z.type;
+            zones.append(zone);
+        }
+        item["zones"] = zones;
+        return item;
+    }
+
+    HttpResponsePtr locateUnavailable() {
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(k503ServiceUnavailable);
+        resp->setBody(R"({"error": "Zone locate index is loading, retry shortly"})");
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        resp->addHeader("Retry-After", "10");
+        return resp;
+    }
+}
+
+// 1. Read By Type (?minLat=&minLon=&maxLat=&maxLon= : zones de la vue, découpées)
 void ZoneController::getByType(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback, const std::string& type) {
-    ZoneService::getByType(type, [callback](const std::vector<ZoneModel>& list, const std::string& err) {
+    std::optional<ZoneService::Viewport> viewport;
+    if (!parseViewport(req, callback, viewport)) return;
+
+    ZoneService::getByType(type, viewport, [callback](const std::vector<ZoneModel>& list, const std::string& err) {
         if(err.empty()){
             Json::Value arr(Json::arrayValue);
             for(auto &z : list) arr.append(z.toJson());
@@ -27,6 +168,10 @@ void ZoneController::getByType(const HttpRequestPtr& req, std::function<void (co
  * Paramètres:
  * - type (path): Type de zone (country, region, province, commune, etc.)
  * - zoom (query): Niveau de zoom Leaflet (0-18) pour adapter la simplification
+ * - minLat, minLon, maxLat, maxLon (query, optionnels): vue courante ; seules les
+ *   zones qui l'intersectent sont renvoyées, découpées à la vue + marge
+ * - format (query, optionnel): topojson pour la couche entière en TopoJSON (frontières
+ *   partagées envoyées une fois), servie par le magasin en mémoire uniquement
  * 
  * Réponse: JSON array de zones avec géométries simplifiées selon le zoom
  * 
@@ -50,21 +195,84 @@ void ZoneController::getByTypeSimplified(
         return;
     }
     
-    // Sprint 3: Vérifier cache Redis
-    std::string cacheKey = "type:" + type + ":zoom:" + std::to_string(zoom);
-    auto cached = CacheService::getInstance().getCachedZones(cacheKey);
-    if (cached) {
-        LOG_INFO << "✅ Cache HIT (zones): " << cacheKey;
-        auto resp = HttpResponse::newHttpJsonResponse(*cached);
-        resp->addHeader("X-Cache", "HIT");
+    std::optional<ZoneService::Viewport> viewport;
+    if (!parseViewport(req, callback, viewport)) return;
+
+    std::string format = req->getOptionalParameter<std::string>("format").value_or("json");
+    if (format == "topojson") {
+        if (viewport) {
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setStatusCode(k400BadRequest);
+            resp->setBody(R"({"error": "format=topojson returns the whole layer and does not accept a bounding box"})");
+            resp->setContentTypeCode(CT_APPLICATION_JSON);
+            callback(resp);
+            return;
+        }
+        // Topologie construite au chargement du magasin : pas de repli SQL
+        auto topo = ZoneStoreService::getTopology(type, zoom);
+        if (!topo) {
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setStatusCode(k503ServiceUnavailable);
+            resp->setBody(R"({"error": "TopoJSON is not available for this zone type yet, zone store not loaded"})");
+            resp->setContentTypeCode(CT_APPLICATION_JSON);
+            resp->addHeader("Retry-After", "60");
+            callback(resp);
+            return;
+        }
+        auto resp = CacheService::encodedResponse(req, *topo, "application/json");
+        resp->addHeader("X-Cache", "MEMORY");
+        resp->addHeader("Cache-Control", "public, max-age=3600");
         callback(resp);
         return;
     }
-    
-    LOG_INFO << "❌ Cache MISS (zones): " << cacheKey;
+    if (format != "json") {
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(k400BadRequest);
+        resp->setBody(R"({"error": "Invalid format. Must be json or topojson"})");
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        callback(resp);
+        return;
+    }
+
+    if (viewport) {
+        // Vue : découpage en mémoire si le type est dans le magasin (pas de cache, emprises libres)
+        std::string body;
+        if (ZoneStoreService::getSimplifiedInBox(type, zoom, *viewport, body)) {
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setBody(std::move(body));
+            resp->setContentTypeCode(CT_APPLICATION_JSON);
+            resp->addHeader("X-Cache", "MEMORY");
+            callback(resp);
+            return;
+        }
+    } else {
+        // Magasin en mémoire : réponse sérialisée et compressée au chargement
+        auto stored = ZoneStoreService::getSimplified(type, zoom);
+        if (stored) {
+            auto resp = CacheService::encodedResponse(req, *stored, "application/json");
+            resp->addHeader("X-Cache", "MEMORY");
+            resp->addHeader("Cache-Control", "public, max-age=3600");
+            callback(resp);
+            return;
+        }
+    }
+
+    // Sprint 3: Vérifier cache Redis (types hors magasin, magasin pas encore chargé ; vue entière seulement)
+    std::string cacheKey = viewport ? "" : "type:" + type + ":zoom:" + std::to_string(zoom);
+    if (!cacheKey.empty()) {
+        auto cached = CacheService::getInstance().getCachedZones(cacheKey);
+        if (cached) {
+            LOG_INFO << "✅ Cache HIT (zones): " << cacheKey;
+            auto resp = HttpResponse::newHttpJsonResponse(*cached);
+            resp->addHeader("X-Cache", "HIT");
+            callback(resp);
+            return;
+        }
+        LOG_INFO << "❌ Cache MISS (zones): " << cacheKey;
+    }
     
     // Appel au service avec simplification
-    ZoneService::getByTypeSimplified(type, zoom, 
+    ZoneService::getByTypeSimplified(type, zoom, viewport,
         [callback, zoom, cacheKey](const std::vector<ZoneModel>& list, const std::string& err) {
             if(err.empty()){
                 Json::Value arr(Json::arrayValue);
@@ -73,11 +281,13 @@ void ZoneController::getByTypeSimplified(
                 }
                 
                 // Sprint 3: Mettre en cache Redis (TTL 1h)
-                CacheService::getInstance().cacheZones(cacheKey, arr);
-                LOG_INFO << "💾 Cached (zones): " << cacheKey;
+                if (!cacheKey.empty()) {
+                    CacheService::getInstance().cacheZones(cacheKey, arr);
+                    LOG_INFO << "💾 Cached (zones): " << cacheKey;
+                }
                 
                 auto resp = HttpResponse::newHttpJsonResponse(arr);
-                resp->addHeader("X-Cache", "MISS");
+                resp->addHeader("X-Cache", cacheKey.empty() ? "BYPASS" : "MISS");
                 resp->addHeader("Cache-Control", "public, max-age=3600");
                 
                 callback(resp);
@@ -91,7 +301,58 @@ void ZoneController::getByTypeSimplified(
     );
 }
 
+/**
+ * Export GeoJSON de toutes les zones
+ *
+ * Route: GET /api/zones/geojson[?stream=false]
+ *
+ * Par défaut, réponse chunked écrite par lots, sans parsing de la géométrie. Le lot
+ * suivant n'est lu qu'une fois le précédent parti vers le client (StreamFlow,
+ * custom_config.zone_geojson.max_buffered_kb / stall_timeout_s) : mémoire bornée par
+ * export, aucune connexion du pool tenue entre deux lots. Exports simultanés plafonnés
+ * (max_concurrent_streams) : au-delà, 503.
+ * Une erreur en cours de route coupe la réponse avant la
+ * fermeture de la collection : le client reçoit un JSON incomplet, donc invalide.
+ * stream=false : ancienne réponse construite en entier (Content-Length connu).
+ */
 void ZoneController::getGeoJSON(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback) {
+    if (req->getOptionalParameter<bool>("stream").value_or(true)) {
+        auto slot = ZoneService::reserveGeoJsonStream();
+        if (!slot) {
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setStatusCode(k503ServiceUnavailable);
+            resp->setBody(R"({"error": "Too many concurrent GeoJSON exports, retry shortly"})");
+            resp->setContentTypeCode(CT_APPLICATION_JSON);
+            resp->addHeader("Retry-After", "10");
+            callback(resp);
+            return;
+        }
+        const Json::Value& config = app().getCustomConfig()["zone_geojson"];
+        size_t maxBuffered = static_cast<size_t>(std::max(16, config.get("max_buffered_kb", 256).asInt())) * 1024;
+        double stallTimeout = config.get("stall_timeout_s", 60.0).asDouble();
+
+        std::weak_ptr<trantor::TcpConnection> conn = req->getConnectionPtr();
+
+        // La place est tenue par le callback de fin, libéré avec l'export
+        auto resp = HttpResponse::newAsyncStreamResponse([slot, conn, maxBuffered, stallTimeout](ResponseStreamPtr stream) mutable {
+            std::shared_ptr<ResponseStream> out(std::move(stream));
+            auto flow = std::make_shared<StreamFlow>(conn, maxBuffered, stallTimeout);
+            ZoneService::streamAllGeoJSON(
+                [out, flow](const std::string& chunk) {
+                    flow->queued(chunk.size());
+                    return out->send(chunk);
+                },
+                [flow](std::function<void(bool)> next) { flow->whenDrained(std::move(next)); },
+                [out, slot = std::move(slot)](const std::string& err) {
+                    if (!err.empty()) LOG_ERROR << "Zones GeoJSON stream aborted: " << err;
+                    out->close();
+                });
+        });
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        callback(resp);
+        return;
+    }
+
     ZoneService::getAllGeoJSON([callback](const Json::Value& json, const std::string& err) {
         if (err.empty()) {
             auto resp = HttpResponse::newHttpJsonResponse(json);
@@ -115,17 +376,18 @@ void ZoneController::getGeoJSON(const HttpRequestPtr& req, std::function<void (c
  * Route: GET /api/zones/search?type={type}&query={query}&limit={limit}
  * 
  * Paramètres:
- * - type (query): Type de zone (country, region, province, commune)
+ * - type (query, optionnel): Type de zone (country, region, province, commune) ; absent = tous
  * - query (query): Texte de recherche (nom de la zone)
  * - limit (query, optionnel): Nombre max de résultats (défaut: 10)
  * 
- * Cache: Redis avec TTL 1h (zones changent rarement)
+ * Index en mémoire (ZoneSearchService) : trigrammes sur les noms normalisés
+ * (accents, variantes arabes), classement par type puis population, pas de requête SQL.
+ * Repli SQL (ILIKE + cache Redis TTL 1h) tant que l'index n'est pas chargé.
  * 
  * Avantages:
- * - Recherche ILIKE insensible à la casse et aux accents
- * - Cache intelligent par type et query
- * - Limité à 10 résultats pour performance
- * - Pas de géométrie complète (seulement id, name, bounds)
+ * - Insensible à la casse et aux accents
+ * - Limité à 50 résultats
+ * - Pas de géométrie complète (seulement id, name, bbox [minLon, minLat, maxLon, maxLat])
  */
 void ZoneController::searchZones(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback) {
     auto params = req->getParameters();
@@ -137,19 +399,23 @@ void ZoneController::searchZones(const HttpRequestPtr& req, std::function<void (
     
     LOG_INFO << "Search zones - type: '" << type << "', query: '" << query << "', limit: " << limit;
     
-    if (type.empty()) {
+    // Limiter le nombre de résultats
+    if (limit > 50) limit = 50;
+    if (limit < 1) limit = 10;
+    
+    // Index en mémoire : éléments de réponse sérialisés au chargement
+    std::string body;
+    if (ZoneSearchService::search(type, query, limit, body)) {
         auto resp = HttpResponse::newHttpResponse();
-        resp->setStatusCode(k400BadRequest);
-        resp->setBody(R"({"error": "Missing required parameter: type"})");
+        resp->setBody(std::move(body));
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        resp->addHeader("X-Cache", "MEMORY");
+        resp->addHeader("Cache-Control", "public, max-age=3600");
         callback(resp);
         return;
     }
     
-    // Limiter le nombre de résultats
-    if (limit > 50) limit = 50;
-    if (limit < 1) limit = 10;
-    
-    // Sprint 3: Vérifier cache Redis
+    // Sprint 3: Vérifier cache Redis (index pas encore chargé)
     std::string cacheKey = "search:" + type + ":" + query + ":" + std::to_string(limit);
     auto cached = CacheService::getInstance().getCachedZones(cacheKey);
     if (cached) {
@@ -173,8 +439,17 @@ void ZoneController::searchZones(const HttpRequestPtr& req, std::function<void (
                     item["name"] = z.name;
                     item["type"] = z.type;
                     item["density"] = z.density;
-                    // Calculer les bounds depuis la géométrie
-                    // Format simplifié sans géométrie complète pour performance
+                    item["parent_id"] = z.parent_id;
+                    // Bounds depuis l'enveloppe (même format que l'index en mémoire)
+                    Json::Value bbox(Json::arrayValue);
+                    Shape envelope;
+                    if (Geometry::fromWkt(z.wkt_geometry, envelope)) {
+                        bbox.append(envelope.minX);
+                        bbox.append(envelope.minY);
+                        bbox.append(envelope.maxX);
+                        bbox.append(envelope.maxY);
+                    }
+                    item["bbox"] = bbox;
                     arr.append(item);
                 }
                 
@@ -194,4 +469,191 @@ void ZoneController::searchZones(const HttpRequestPtr& req, std::function<void (
             }
         }
     );
-}
\ No newline at end of file
+}
+
+
+// ============================================================================
+//  4. INDICATEURS DE COUVERTURE PAR ZONE
+// ============================================================================
+/**
+ * Surface et population couvertes d'une zone, par opérateur et technologie
+ *
+ * Route: GET /api/zones/{id}/kpis?operator_id={id}&technology={tech}
+ *
+ * Paramètres (optionnels):
+ * - operator_id: -1 = tous les opérateurs confondus
+ * - technology: '*' = toutes les technologies confondues
+ *
+ * Indicateurs précalculés par ZoneKpiService (table zone_coverage_kpi) :
+ * lecture d'une seule clé primaire, cache Redis purgé à chaque recalcul.
+ */
+void ZoneController::getZoneKpis(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback, int zoneId) {
+    std::optional<int> operatorId;
+    std::optional<std::string> technology;
+    auto opParam = req->getOptionalParameter<std::string>("operator_id");
+    if (opParam) {
+        try {
+            operatorId = std::stoi(*opParam);
+        } catch (const std::exception&) {
+            callback(ErrorHandler::createGenericErrorResponse("operator_id must be an integer", k400BadRequest));
+            return;
+        }
+    }
+    auto techParam = req->getOptionalParameter<std::string>("technology");
+    if (techParam && !techParam->empty()) technology = *techParam;
+
+    std::string cacheKey = "kpis:" + std::to_string(zoneId) + ":" +
+                           (operatorId ? std::to_string(*operatorId) : "") + ":" + technology.value_or("");
+    auto cached = CacheService::getInstance().getCachedZones(cacheKey);
+    if (cached) {
+        auto resp = HttpResponse::newHttpJsonResponse(*cached);
+        resp->addHeader("X-Cache", "HIT");
+        callback(resp);
+        return;
+    }
+
+    ZoneKpiService::getZoneKpis(zoneId, operatorId, technology,
+        [callback, cacheKey, zoneId](const Json::Value& result, bool found, const std::string& err) {
+            if (!err.empty()) {
+                callback(ErrorHandler::createGenericErrorResponse(err, k500InternalServerError));
+                return;
+            }
+            if (!found) {
+                callback(ErrorHandler::createGenericErrorResponse(
+                    "Zone " + std::to_string(zoneId) + " not found", k404NotFound));
+                return;
+            }
+
+            CacheService::getInstance().cacheZones(cacheKey, result);
+            auto resp = HttpResponse::newHttpJsonResponse(result);
+            resp->addHeader("X-Cache", "MISS");
+            callback(resp);
+        });
+}
+
+/**
+ * Route: POST /api/zones/kpis/recompute
+ *
+ * Job asynchrone : réponse 202, suivi via GET /api/zones/kpis/status.
+ */
+void ZoneController::recomputeKpis(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback) {
+    bool started = ZoneKpiService::recompute([](const Json::Value& stats, const std::string& err) {
+        if (!err.empty()) {
+            LOG_ERROR << "Zone KPI recompute failed: " << err;
+        }
+    });
+
+    if (!started) {
+        callback(ErrorHandler::createGenericErrorResponse(
+            "A zone KPI recompute is already running", k409Conflict));
+        return;
+    }
+
+    Json::Value body;
+    body["success"] = true;
+    body["message"] = "Zone KPI recompute started";
+    auto resp = HttpResponse::newHttpJsonResponse(body);
+    resp->setStatusCode(k202Accepted);
+    callback(resp);
+}
+
+void ZoneController::getKpiStatus(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback) {
+    callback(HttpResponse::newHttpJsonResponse(ZoneKpiService::getStatus()));
+}
+
+void ZoneController::getStoreStatus(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback) {
+    callback(HttpResponse::newHttpJsonResponse(ZoneStoreService::getStatus()));
+}
+
+void ZoneController::getSearchStatus(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback) {
+    callback(HttpResponse::newHttpJsonResponse(ZoneSearchService::getStatus()));
+}
+
+// ============================================================================
+//  GÉOCODAGE INVERSE
+// ============================================================================
+/**
+ * Zones contenant un point : la plus fine (commune...) puis ses parents
+ *
+ * Route: GET /api/zones/locate?lat={lat}&lon={lon}
+ *
+ * Index en mémoire (ZoneLocateService) : pas de requête SQL ; 503 tant qu'il n'est pas chargé.
+ * Réponse : { "lat", "lon", "zones": [{ "id", "name", "type" }, ...] } (vide hors zones)
+ */
+void ZoneController::locate(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback,
+                            double lat, double lon) {
+    if (!Validator::isValidLatitude(lat) || !Validator::isValidLongitude(lon)) {
+        Validator::ErrorCollector validator;
+        validator.addError("coordinates", "Latitude must be between -90 and +90, longitude between -180 and +180");
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(k400BadRequest);
+        resp->setBody(validator.getErrorsAsJson());
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        callback(resp);
+        return;
+    }
+
+    std::vector<ZoneLocateService::LocatedZone> chain;
+    if (!ZoneLocateService::locate(lat, lon, chain)) {
+        callback(locateUnavailable());
+        return;
+    }
+    callback(HttpResponse::newHttpJsonResponse(locatedJson(lat, lon, chain)));
+}
+
+/**
+ * Géocodage inverse d'un lot de points
+ *
+ * Route: POST /api/zones/locate/batch
+ * Body : { "points": [{ "lat": 33.57, "lon": -7.59 }, ...] } (custom_config.zone_locate.max_batch)
+ * Réponse : { "results": [...] } dans l'ordre des points ; point invalide -> "error"
+ */
+void ZoneController::locateBatch(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback) {
+    auto json = req->getJsonObject();
+    if (!json || !(*json)["points"].isArray()) {
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(k400BadRequest);
+        resp->setBody(R"({"error": "Expected a JSON body with a points array"})");
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        callback(resp);
+        return;
+    }
+
+    const auto& points = (*json)["points"];
+    Json::ArrayIndex maxBatch = app().getCustomConfig()["zone_locate"].get("max_batch", 10000).asUInt();
+    if (points.size() > maxBatch) {
+        auto resp = HttpResponse::newHttpResponse();
+        resp->setStatusCode(k400BadRequest);
+        resp->setBody(R"({"error": "Too many points, max )" + std::to_string(maxBatch) + R"("})");
+        resp->setContentTypeCode(CT_APPLICATION_JSON);
+        callback(resp);
+        return;
+    }
+
+    Json::Value results(Json::arrayValue);
+    std::vector<ZoneLocateService::LocatedZone> chain;
+    for (const auto& p : points) {
+        bool numeric = p.isObject() && p["lat"].isNumeric() && p["lon"].isNumeric();
+        double lat = numeric ? p["lat"].asDouble() : 0.0;
+        double lon = numeric ? p["lon"].asDouble() : 0.0;
+        if (!numeric || !Validator::isValidLatitude(lat) || !Validator::isValidLongitude(lon)) {
+            Json::Value item;
+            item["error"] = "Invalid coordinates";
+            results.append(item);
+            continue;
+        }
+        if (!ZoneLocateService::locate(lat, lon, chain)) {
+            callback(locateUnavailable());
+            return;
+        }
+        results.append(locatedJson(lat, lon, chain));
+    }
+
+    Json::Value body;
+    body["results"] = results;
+    callback(HttpResponse::newHttpJsonResponse(body));
+}
+
+void ZoneController::getLocateStatus(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback) {
+    callback(HttpResponse::newHttpJsonResponse(ZoneLocateService::getStatus()));
+}
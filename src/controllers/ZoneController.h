@@ -2,6 +2,10 @@
 #include <drogon/HttpController.h>
 #include "../services/ZoneService.h"
 #include "../services/CacheService.h"
+#include "../services/ZoneKpiService.h"
+#include "../services/ZoneStoreService.h"
+#include "../services/ZoneSearchService.h"
+#include "../services/ZoneLocateService.h"
 using namespace drogon;
 
 class ZoneController : public drogon::HttpController<ZoneController> {
@@ -11,10 +15,28 @@ public:
         ADD_METHOD_TO(ZoneController::getByTypeSimplified, "/api/zones/type/{1}/simplified?zoom={2}", Get);
         ADD_METHOD_TO(ZoneController::getGeoJSON, "/api/zones/geojson", Get);
         ADD_METHOD_TO(ZoneController::searchZones, "/api/zones/search", Get);
+        ADD_METHOD_TO(ZoneController::getStoreStatus, "/api/zones/store/status", Get);
+        ADD_METHOD_TO(ZoneController::getSearchStatus, "/api/zones/search/status", Get);
+        // Géocodage inverse (?lat=&lon=, ou lot de points en POST)
+        ADD_METHOD_TO(ZoneController::locate, "/api/zones/locate?lat={1}&lon={2}", Get);
+        ADD_METHOD_TO(ZoneController::locateBatch, "/api/zones/locate/batch", Post);
+        ADD_METHOD_TO(ZoneController::getLocateStatus, "/api/zones/locate/status", Get);
+        // Indicateurs de couverture (?operator_id=&technology=)
+        ADD_METHOD_TO(ZoneController::getZoneKpis, "/api/zones/{1}/kpis", Get);
+        ADD_METHOD_TO(ZoneController::recomputeKpis, "/api/zones/kpis/recompute", Post);
+        ADD_METHOD_TO(ZoneController::getKpiStatus, "/api/zones/kpis/status", Get);
     METHOD_LIST_END
 
     void getByType(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback, const std::string& type);
     void getByTypeSimplified(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback, const std::string& type, int zoom);
     void getGeoJSON(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
     void searchZones(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
+    void getStoreStatus(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
+    void getSearchStatus(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
+    void locate(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback, double lat, double lon);
+    void locateBatch(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
+    void getLocateStatus(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
+    void getZoneKpis(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback, int zoneId);
+    void recomputeKpis(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
+    void getKpiStatus(const HttpRequestPtr& req, std::function<void (const HttpResponsePtr &)> &&callback);
 };
\ No newline at end of file
@@ -1,6 +1,16 @@
 ﻿#include <drogon/drogon.h>
 #include <iostream>
 #include "services/CacheService.h"
+#include "services/ViewshedService.h"
+#include "services/ClusterIndexService.h"
+#include "services/AntenneService.h"
+#include "services/ChangeFeedService.h"
+#include "services/CoverageWarmerService.h"
+#include "services/ZoneKpiService.h"
+#include "services/ZoneStoreService.h"
+#include "services/ZoneSearchService.h"
+#include "services/ZoneLocateService.h"
+#include "services/ZoneSnapshotService.h"
 
 int main() {
     // Pas de buffering pour voir les logs tout de suite
@@ -29,6 +39,27 @@ int main() {
         resp->addHeader("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Requested-With");
     });
 
+    // Tâches de fond démarrées une fois la boucle principale lancée :
+    // - recalcul périodique des empreintes de couverture (antennes marquées par les triggers)
+    // - index de clustering en mémoire (chargement initial + sondage de version)
+    // - purge du journal des modifications d'antennes (synchronisation delta)
+    // - LISTEN des nouvelles versions et diffusion WebSocket (/ws/antennas)
+    // - recalcul des tuiles de couverture marquées par les triggers
+    // - préchauffage des blocs de couverture (zooms courants, territoire configuré)
+    drogon::app().registerBeginningAdvice([]() {
+        ViewshedService::scheduleRefresh();
+        ClusterIndexService::start();
+        AntenneService::scheduleChangeLogPrune();
+        ChangeFeedService::start();
+        AntenneService::scheduleCoverageTileRefresh();
+        CoverageWarmerService::start();
+        ZoneKpiService::scheduleRefresh();
+        ZoneStoreService::start();
+        ZoneSearchService::start();
+        ZoneLocateService::start();
+        ZoneSnapshotService::start();   // Après les abonnements des trois index de zones
+    });
+
     // Démarrer le serveur web Drogon
     drogon::app().run();
     return 0;
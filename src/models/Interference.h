@@ -0,0 +1,23 @@
+#pragma once
+#include <drogon/drogon.h>
+#include <string>
+
+// Structure représentant une interférence entre deux antennes voisines
+// Correspond à la table 'interferences' (matrice pré-calculée)
+struct InterferenceModel {
+    int source_id = -1;        // Antenne victime (antenne_source_id)
+    int target_id = -1;        // Antenne interférente (antenne_cible_id)
+    double level_dbm = 0.0;    // Puissance reçue de l'interférente au site source (niveau_interference)
+    double distance_m = 0.0;   // Distance entre les deux sites en mètres
+    std::string measured_at;   // Date du calcul (date_mesure)
+
+    Json::Value toJson() const {
+        Json::Value ret;
+        ret["source_id"] = source_id;
+        ret["target_id"] = target_id;
+        ret["level_dbm"] = level_dbm;
+        ret["distance_m"] = distance_m;
+        if (!measured_at.empty()) ret["measured_at"] = measured_at;
+        return ret;
+    }
+};
@@ -0,0 +1,21 @@
+#pragma once
+#include <drogon/drogon.h>
+#include <string>
+
+// Affectation PCI (Physical Cell Identity) d'une antenne
+// Correspond à la table 'pci_assignment' produite par le planificateur
+struct PciAssignment {
+    int antenna_id = -1;
+    int pci = -1;
+    int operator_id = 0;
+    std::string technology;
+
+    Json::Value toJson() const {
+        Json::Value ret;
+        ret["antenna_id"] = antenna_id;
+        ret["pci"] = pci;
+        ret["operator_id"] = operator_id;
+        ret["technology"] = technology;
+        return ret;
+    }
+};
@@ -1,8 +1,25 @@
 #include "AntenneService.h"
+#include "CacheService.h"
+#include "CoverageWarmerService.h"
 #include "../utils/ErrorHandler.h"
+#include "../utils/GeoUtils.h"
+#include "../utils/CoverageRaster.h"
+#include "../utils/Geometry.h"
+#include "../utils/Parallel.h"
+#include "../utils/PgCopy.h"
 
 #include <json/json.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
 #include <optional>
+#include <set>
 #include <string>
 
 using namespace drogon;
@@ -17,8 +34,10 @@ using namespace drogon::orm;
  * Principe:
  * 1. ST_SnapToGrid arrondit les coordonnées sur une grille, regroupant les points proches
  * 2. La taille de grille diminue avec le zoom (plus de détails = grille plus fine)
- * 3. Les clusters (count > 1) retournent un centroïde + metadata (count, ids)
- * 4. Les antennes seules (count = 1) retournent leurs données complètes
+ * 3. Les clusters (count > 1) retournent un centroïde, un cluster_id et des comptes agrégés
+ *    par statut / technologie / opérateur : taille constante quel que soit le nombre de
+ *    membres, énumérés à la demande via getGridClusterLeaves
+ * 4. Les antennes seules (count = 1) retournent en plus leur antenna_id
  * 
  * Calcul de la taille de grille:
  * - Zoom 0-5 (monde/continents): 1.0° (~111 km)
@@ -26,34 +45,215 @@ using namespace drogon::orm;
  * - Zoom 9-11 (régions): 0.1° (~11 km)
  * - Zoom 12-14 (villes): 0.01° (~1.1 km)
  * - Zoom 15-18 (quartiers): 0.001° (~111 m)
+ *
+ * Cache par fragments:
+ * La grille est découpée en fragments fixes de FRAGMENT_CELLS x FRAGMENT_CELLS cellules,
+ * alignés sur gridSize et indépendants de la bbox demandée. Les clusters de chaque
+ * fragment sont mis en cache séparément (clé sans zoom : partagée par les zooms de
+ * même grille). Une requête lit tous ses fragments en un MGET, ne calcule que les
+ * manquants en une seule requête SQL, puis assemble la réponse : un déplacement de
+ * carte réutilise l'essentiel des fragments de la vue précédente.
+ *
+ * Format d'un fragment (texte produit par PostgreSQL, jamais reparsé en JSON) :
+ * une ligne par cluster "<lon> <lat> <c|s>\t<Feature GeoJSON>". L'assemblage ne lit
+ * que le préfixe (filtrage bbox, comptage) et recopie les features telles quelles.
  */
+namespace {
+    // Fragment = bloc de FRAGMENT_CELLS x FRAGMENT_CELLS cellules de grille
+    constexpr int FRAGMENT_CELLS = 16;
+    // Au-delà (bbox démesurée pour le zoom), calcul direct sur la bbox sans cache
+    constexpr long long MAX_FRAGMENTS = 1024;
+    constexpr int FRAGMENT_TTL = 3600;
+
+    // Tailles de grille par niveau (cluster_id "g<niveau>.<gx>.<gy>")
+    constexpr double GRID_SIZES[AntenneService::CLUSTER_GRID_LEVELS] = {
+        1.0,    // Zoom monde/continents: ~111 km
+        0.5,    // Zoom pays: ~55 km
+        0.1,    // Zoom régions: ~11 km
+        0.01,   // Zoom villes: ~1.1 km
+        0.001   // Zoom quartiers: ~111 m
+    };
+
+    // Index de fragment d'un indice de cellule (division entière vers -infini)
+    long long fragmentOf(long long cell) {
+        return cell >= 0 ? cell / FRAGMENT_CELLS : -((-cell + FRAGMENT_CELLS - 1) / FRAGMENT_CELLS);
+    }
+
+    std::string fragmentKey(double gridSize, long long fx, long long fy, const std::string& status,
+                            const std::string& technology, int operator_id) {
+        std::string key = "clusters:frag:g:" + std::to_string(gridSize) +
+                          ":" + std::to_string(fx) + ":" + std::to_string(fy);
+        if (!status.empty()) key += ":st:" + status;
+        if (!technology.empty()) key += ":tech:" + technology;
+        if (operator_id >= 0) key += ":op:" + std::to_string(operator_id);
+        return key;
+    }
+}
+
+double AntenneService::gridSizeForLevel(int level) {
+    return GRID_SIZES[std::max(0, std::min(level, CLUSTER_GRID_LEVELS - 1))];
+}
+
+int AntenneService::gridLevelForZoom(int zoom) {
+    // Plus le zoom est élevé, plus la grille est fine
+    if (zoom <= 5) return 0;
+    if (zoom <= 8) return 1;
+    if (zoom <= 11) return 2;
+    if (zoom <= 14) return 3;
+    return 4;
+}
+
 void AntenneService::getClusteredAntennas(
     double minLat, double minLon, double maxLat, double maxLon,
-    int zoom, const std::string& status, const std::string& technology, int operator_id,
-    std::function<void(const Json::Value&, const std::string&)> callback) 
+    int zoom, int gridLevel, const std::string& status, const std::string& technology, int operator_id,
+    std::function<void(const std::string&, const Json::Value&, const std::string&)> callback) 
 {
     auto client = app().getDbClient();
-    
-    // Calcul de la taille de grille selon le zoom
-    // Plus le zoom est élevé, plus la grille est fine
-    double gridSize;
-    if (zoom <= 5) {
-        gridSize = 1.0;      // Zoom monde/continents: ~111 km
-    } else if (zoom <= 8) {
-        gridSize = 0.5;      // Zoom pays: ~55 km
-    } else if (zoom <= 11) {
-        gridSize = 0.1;      // Zoom régions: ~11 km
-    } else if (zoom <= 14) {
-        gridSize = 0.01;     // Zoom villes: ~1.1 km
-    } else {
-        gridSize = 0.001;    // Zoom quartiers: ~111 m
+    double gridSize = gridSizeForLevel(gridLevel);
+
+    // ========== FRAGMENTS COUVRANT LA BBOX ==========
+    // Cellule d'indice g : points arrondis sur g * gridSize (ST_SnapToGrid)
+    long long fxMin = fragmentOf(std::llround(minLon / gridSize));
+    long long fxMax = fragmentOf(std::llround(maxLon / gridSize));
+    long long fyMin = fragmentOf(std::llround(minLat / gridSize));
+    long long fyMax = fragmentOf(std::llround(maxLat / gridSize));
+    long long fragmentCount = (fxMax - fxMin + 1) * (fyMax - fyMin + 1);
+    bool useFragments = fragmentCount <= MAX_FRAGMENTS;
+
+    std::vector<std::pair<long long, long long>> fragments;
+    std::vector<std::string> keys;
+    std::vector<std::optional<std::string>> cached;
+    if (useFragments) {
+        for (long long fy = fyMin; fy <= fyMax; ++fy) {
+            for (long long fx = fxMin; fx <= fxMax; ++fx) {
+                fragments.emplace_back(fx, fy);
+                keys.push_back(fragmentKey(gridSize, fx, fy, status, technology, operator_id));
+            }
+        }
+        cached = CacheService::getInstance().mget(keys);
     }
-    
+
+    // Fragments absents du cache, et leur emprise englobante pour la requête SQL
+    std::vector<size_t> missing;
+    long long mxMin = 0, mxMax = -1, myMin = 0, myMax = -1;
+    for (size_t i = 0; i < fragments.size(); ++i) {
+        if (cached[i]) continue;
+        auto [fx, fy] = fragments[i];
+        if (missing.empty()) {
+            mxMin = mxMax = fx;
+            myMin = myMax = fy;
+        } else {
+            mxMin = std::min(mxMin, fx); mxMax = std::max(mxMax, fx);
+            myMin = std::min(myMin, fy); myMax = std::max(myMax, fy);
+        }
+        missing.push_back(i);
+    }
+
+    // ========== ASSEMBLAGE DE LA RÉPONSE ==========
+    // Clusters dont le centroïde est dans la bbox élargie d'une demi-cellule ;
+    // features recopiées sans parsing, métadonnées sérialisées puis insérées
+    auto shared = std::make_shared<std::vector<std::optional<std::string>>>(std::move(cached));
+    auto compose = [callback, shared, zoom, gridLevel, gridSize, minLat, minLon, maxLat, maxLon,
+                    total = fragments.size(), hits = fragments.size() - missing.size()]() {
+        size_t capacity = 256;
+        for (const auto& fragment : *shared) {
+            if (fragment) capacity += fragment->size();
+        }
+        std::string body;
+        body.reserve(capacity);
+        body += R"({"type":"FeatureCollection","features":[)";
+
+        double pad = gridSize / 2;
+        int clusterCount = 0;
+        int singleCount = 0;
+
+        for (const auto& fragment : *shared) {
+            if (!fragment) continue;
+            const char* p = fragment->data();
+            const char* end = p + fragment->size();
+            while (p < end) {
+                const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                if (!eol) eol = end;
+                const char* tab = static_cast<const char*>(std::memchr(p, '\t', eol - p));
+
+                char* afterLon = nullptr;
+                char* next = nullptr;
+                double lon = std::strtod(p, &afterLon);
+                double lat = std::strtod(afterLon, &next);
+                bool valid = tab && afterLon != p && next != afterLon && next < tab;
+
+                if (valid && lon >= minLon - pad && lon <= maxLon + pad && lat >= minLat - pad && lat <= maxLat + pad) {
+                    if (std::memchr(next, 'c', tab - next)) {
+                        clusterCount++;
+                    } else {
+                        singleCount++;
+                    }
+                    if (clusterCount + singleCount > 1) body += ',';
+                    body.append(tab + 1, eol);
+                }
+                p = eol + 1;
+            }
+        }
+
+        // Ajout de métadonnées pour debug/monitoring
+        Json::Value metadata;
+        metadata["cluster_method"] = "ST_SnapToGrid";
+        metadata["grid_size"] = gridSize;
+        metadata["grid_level"] = gridLevel;
+        metadata["zoom_level"] = zoom;
+        metadata["bbox"]["minLat"] = minLat;
+        metadata["bbox"]["minLon"] = minLon;
+        metadata["bbox"]["maxLat"] = maxLat;
+        metadata["bbox"]["maxLon"] = maxLon;
+        metadata["total_features"] = clusterCount + singleCount;
+        metadata["clusters"] = clusterCount;
+        metadata["singles"] = singleCount;
+        metadata["fragments"]["total"] = static_cast<Json::UInt64>(total);
+        metadata["fragments"]["cached"] = static_cast<Json::UInt64>(hits);
+
+        Json::StreamWriterBuilder writer;
+        writer["indentation"] = "";
+        body += R"(],"metadata":)";
+        body += Json::writeString(writer, metadata);
+        body += '}';
+
+        LOG_INFO << "Clustering: " << (clusterCount + singleCount) << " features ("
+                 << clusterCount << " clusters, " << singleCount
+                 << " singles) at zoom " << zoom << ", grid " << gridSize
+                 << ", fragments " << hits << "/" << total << " cached";
+
+        callback(body, metadata, "");
+    };
+
+    if (useFragments && missing.empty()) {
+        compose();
+        return;
+    }
+
+    // ========== REQUÊTE SQL GROUPÉE DES FRAGMENTS MANQUANTS ==========
+    // Emprise : fragments manquants (leurs cellules complètes), ou la bbox en mode direct
+    double envMinLon = minLon, envMinLat = minLat, envMaxLon = maxLon, envMaxLat = maxLat;
+    std::string fragmentJoin;
+    if (useFragments) {
+        envMinLon = (mxMin * FRAGMENT_CELLS - 0.5) * gridSize;
+        envMaxLon = ((mxMax + 1) * FRAGMENT_CELLS - 0.5) * gridSize;
+        envMinLat = (myMin * FRAGMENT_CELLS - 0.5) * gridSize;
+        envMaxLat = ((myMax + 1) * FRAGMENT_CELLS - 0.5) * gridSize;
+
+        fragmentJoin = "JOIN (VALUES ";
+        for (size_t i = 0; i < missing.size(); ++i) {
+            if (i > 0) fragmentJoin += ", ";
+            fragmentJoin += "(" + std::to_string(fragments[missing[i]].first) + ", " +
+                            std::to_string(fragments[missing[i]].second) + ")";
+        }
+        fragmentJoin += ") AS wanted(fx, fy) USING (fx, fy)";
+    }
+
     // Construction de la clause WHERE pour les filtres
     std::vector<std::string> whereClauses;
     whereClauses.push_back("geom && ST_MakeEnvelope($1, $2, $3, $4, 4326)");
     
-    int paramIndex = 5; // Les 4 premiers params sont minLon, minLat, maxLon, maxLat
+    int paramIndex = 5; // Les 4 premiers params sont l'emprise (minLon, minLat, maxLon, maxLat)
     std::string statusParam, techParam;
     int operatorParam = 0;
     
@@ -77,7 +277,10 @@ void AntenneService::getClusteredAntennas(
     }
     
     // Requête SQL avec clustering
-    // Utilise ST_SnapToGrid pour regrouper les points proches
+    // Utilise ST_SnapToGrid pour regrouper les points proches, une ligne par fragment
+    // Comptes par statut / technologie / opérateur en un passage (GROUPING SETS)
+    std::string gridStr = std::to_string(gridSize);
+    std::string cellsStr = std::to_string(FRAGMENT_CELLS);
     std::string sql = R"(
         WITH snapped AS (
             SELECT 
@@ -85,46 +288,60 @@ void AntenneService::getClusteredAntennas(
                 coverage_radius,
                 status,
                 technology,
-                installation_date,
-                operator_id,
+                COALESCE(operator_id, 0) AS operator_id,
                 geom,
-                ST_SnapToGrid(geom, )" + std::to_string(gridSize) + R"() AS grid_point
+                round(ST_X(ST_SnapToGrid(geom, )" + gridStr + R"()) / )" + gridStr + R"()::bigint AS gx,
+                round(ST_Y(ST_SnapToGrid(geom, )" + gridStr + R"()) / )" + gridStr + R"()::bigint AS gy
             FROM antenna
             WHERE )" + whereClause + R"(
         ),
+        counts AS (
+            SELECT gx, gy, status::text AS s, technology::text AS t, operator_id AS o, COUNT(*) AS n,
+                   GROUPING(status, technology, operator_id) AS g
+            FROM snapped
+            GROUP BY GROUPING SETS ((gx, gy, status), (gx, gy, technology), (gx, gy, operator_id))
+        ),
+        breakdown AS (
+            SELECT gx, gy,
+                   json_object_agg(s, n) FILTER (WHERE g = 3) AS status_counts,
+                   json_object_agg(t, n) FILTER (WHERE g = 5) AS technology_counts,
+                   json_object_agg(o, n) FILTER (WHERE g = 6) AS operator_counts
+            FROM counts
+            GROUP BY gx, gy
+        ),
         clusters AS (
             SELECT 
-                grid_point,
+                gx, gy,
+                floor(gx / )" + cellsStr + R"(.0)::bigint AS fx,
+                floor(gy / )" + cellsStr + R"(.0)::bigint AS fy,
                 COUNT(*) as point_count,
-                ARRAY_AGG(id) as antenna_ids,
-                ST_AsGeoJSON(ST_Centroid(ST_Collect(geom)))::json as centroid_geojson,
-                -- Pour les clusters, on agrège les métadonnées
-                ARRAY_AGG(status::text) as statuses,
-                ARRAY_AGG(technology::text) as technologies,
-                ARRAY_AGG(operator_id) as operator_ids,
+                MIN(id) as antenna_id,
+                ST_Centroid(ST_Collect(geom)) as centroid,
                 AVG(coverage_radius) as avg_radius
             FROM snapped
-            GROUP BY grid_point
+            GROUP BY gx, gy
         )
-        SELECT json_build_object(
-            'type', 'FeatureCollection',
-            'features', COALESCE(json_agg(
-                json_build_object(
-                    'type', 'Feature',
-                    'geometry', centroid_geojson,
-                    'properties', json_build_object(
-                        'cluster', CASE WHEN point_count > 1 THEN true ELSE false END,
-                        'point_count', point_count,
-                        'antenna_ids', antenna_ids,
-                        'avg_radius', ROUND(avg_radius::numeric, 2),
-                        'statuses', statuses,
-                        'technologies', technologies,
-                        'operator_ids', operator_ids
-                    )
+        SELECT fx, fy, string_agg(
+            ST_X(centroid) || ' ' || ST_Y(centroid) || ' ' ||
+            CASE WHEN point_count > 1 THEN 'c' ELSE 's' END || E'\t' ||
+            json_build_object(
+                'type', 'Feature',
+                'geometry', ST_AsGeoJSON(centroid)::json,
+                'properties', json_build_object(
+                    'cluster', CASE WHEN point_count > 1 THEN true ELSE false END,
+                    'cluster_id', 'g)" + std::to_string(gridLevel) + R"(.' || gx || '.' || gy,
+                    'point_count', point_count,
+                    'antenna_id', CASE WHEN point_count = 1 THEN antenna_id END,
+                    'avg_radius', ROUND(avg_radius::numeric, 2),
+                    'status_counts', status_counts,
+                    'technology_counts', technology_counts,
+                    'operator_counts', operator_counts
                 )
-            ), '[]'::json)
-        ) as geojson
-        FROM clusters
+            )::text,
+            E'\n'
+        ) as features
+        FROM clusters JOIN breakdown USING (gx, gy) )" + fragmentJoin + R"(
+        GROUP BY fx, fy
     )";
     
     // ========== EXÉCUTION AVEC PARAMÈTRES DYNAMIQUES ==========
@@ -133,231 +350,1288 @@ void AntenneService::getClusteredAntennas(
     auto executeQuery = [&](auto&&... args) {
         client->execSqlAsync(
             sql,
-            [callback, zoom, gridSize](const Result& r) {
-                if (!r.empty() && !r[0]["geojson"].isNull()) {
-                    std::string geojsonStr = r[0]["geojson"].as<std::string>();
-                    Json::Value geojson;
-                    Json::Reader reader;
-                    
-                    if (reader.parse(geojsonStr, geojson)) {
-                        // Ajout de métadonnées pour debug/monitoring
-                        if (!geojson.isMember("metadata")) {
-                            geojson["metadata"] = Json::Value(Json::objectValue);
-                        }
-                        geojson["metadata"]["cluster_method"] = "ST_SnapToGrid";
-                        geojson["metadata"]["grid_size"] = gridSize;
-                        geojson["metadata"]["zoom_level"] = zoom;
-                        
-                        int totalFeatures = geojson["features"].size();
-                        int clusterCount = 0;
-                        int singleCount = 0;
-                        
-                        for (const auto& feature : geojson["features"]) {
-                            if (feature["properties"]["cluster"].asBool()) {
-                                clusterCount++;
-                            } else {
-                                singleCount++;
-                            }
-                        }
-                        
-                        geojson["metadata"]["total_features"] = totalFeatures;
-                        geojson["metadata"]["clusters"] = clusterCount;
-                        geojson["metadata"]["singles"] = singleCount;
-                        
-                        LOG_INFO << "Clustering: " << totalFeatures << " features (" 
-                                 << clusterCount << " clusters, " << singleCount 
-                                 << " singles) at zoom " << zoom << ", grid " << gridSize;
-                        
-                        callback(geojson, "");
-                    } else {
-                        auto errorDetails = ErrorHandler::analyzePostgresError("Failed to parse GeoJSON response");
-                        ErrorHandler::logError("AntenneService::getClusteredAntennas", errorDetails);
-                        callback(Json::Value(), errorDetails.userMessage);
+            [compose, shared, fragments, keys, missing, useFragments](const Result& r) {
+                if (!useFragments) {
+                    // Mode direct : fragments de bord partiels, non mis en cache
+                    for (const auto& row : r) {
+                        shared->push_back(row["features"].as<std::string>());
                     }
-                } else {
-                    // Pas de résultats, retourner FeatureCollection vide
-                    Json::Value emptyCollection;
-                    emptyCollection["type"] = "FeatureCollection";
-                    emptyCollection["features"] = Json::Value(Json::arrayValue);
-                    emptyCollection["metadata"] = Json::Value(Json::objectValue);
-                    emptyCollection["metadata"]["total_features"] = 0;
-                    callback(emptyCollection, "");
+                    compose();
+                    return;
+                }
+
+                std::map<std::pair<long long, long long>, std::string> computed;
+                for (const auto& row : r) {
+                    computed[{row["fx"].as<long long>(), row["fy"].as<long long>()}] = row["features"].as<std::string>();
+                }
+
+                // Fragments vides mis en cache aussi ("") pour ne pas les recalculer
+                std::vector<std::pair<std::string, std::string>> toCache;
+                toCache.reserve(missing.size());
+                for (size_t i : missing) {
+                    auto it = computed.find(fragments[i]);
+                    std::string features = (it != computed.end()) ? std::move(it->second) : "";
+                    toCache.emplace_back(keys[i], features);
+                    (*shared)[i] = std::move(features);
                 }
+                CacheService::getInstance().mset(toCache, FRAGMENT_TTL);
+                compose();
             },
             [callback](const DrogonDbException& e) {
                 auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
                 ErrorHandler::logError("AntenneService::getClusteredAntennas", errorDetails);
-                callback(Json::Value(), errorDetails.userMessage);
+                callback("", Json::Value(), errorDetails.userMessage);
             },
             std::forward<decltype(args)>(args)...
         );
     };
     
     // ========== APPEL AVEC LES BONS PARAMÈTRES SELON LES FILTRES ==========
-    // On doit passer les paramètres dans l'ordre: bbox, puis filtres optionnels
+    // On doit passer les paramètres dans l'ordre: emprise, puis filtres optionnels
     if (!status.empty() && !technology.empty() && operator_id >= 0) {
-        executeQuery(minLon, minLat, maxLon, maxLat, statusParam, techParam, operatorParam);
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat, statusParam, techParam, operatorParam);
     } else if (!status.empty() && !technology.empty()) {
-        executeQuery(minLon, minLat, maxLon, maxLat, statusParam, techParam);
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat, statusParam, techParam);
     } else if (!status.empty() && operator_id >= 0) {
-        executeQuery(minLon, minLat, maxLon, maxLat, statusParam, operatorParam);
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat, statusParam, operatorParam);
     } else if (!technology.empty() && operator_id >= 0) {
-        executeQuery(minLon, minLat, maxLon, maxLat, techParam, operatorParam);
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat, techParam, operatorParam);
     } else if (!status.empty()) {
-        executeQuery(minLon, minLat, maxLon, maxLat, statusParam);
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat, statusParam);
     } else if (!technology.empty()) {
-        executeQuery(minLon, minLat, maxLon, maxLat, techParam);
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat, techParam);
     } else if (operator_id >= 0) {
-        executeQuery(minLon, minLat, maxLon, maxLat, operatorParam);
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat, operatorParam);
     } else {
-        executeQuery(minLon, minLat, maxLon, maxLat);
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat);
     }
 }
 
 // ============================================================================
-// 12. GET SIMPLIFIED COVERAGE (Ultra-optimisé + Filtres operator/technology)
+// MEMBRES D'UN CLUSTER DE GRILLE (pagination)
 // ============================================================================
-void AntenneService::getSimplifiedCoverage(
-    double minLat, double minLon, double maxLat, double maxLon, int zoom,
-    int operator_id, const std::string& technology,
+void AntenneService::getGridClusterLeaves(
+    int gridLevel, long long gx, long long gy,
+    const std::string& status, const std::string& technology, int operator_id,
+    int offset, int limit,
     std::function<void(const Json::Value&, const std::string&)> callback)
 {
     auto client = app().getDbClient();
-    
-    // Calcul du seuil de simplification basé sur le zoom
-    // Zoom bas = simplification agressive, zoom haut = plus de détails
-    double tolerance;
-    if (zoom <= 6) {
-        tolerance = 0.05;  // ~5.5 km - Simplification maximale
-    } else if (zoom <= 8) {
-        tolerance = 0.02;  // ~2.2 km
-    } else if (zoom <= 10) {
-        tolerance = 0.01;  // ~1.1 km
-    } else if (zoom <= 12) {
-        tolerance = 0.005; // ~550 m
-    } else {
-        tolerance = 0.001; // ~111 m - Détails fins
-    }
-    
-    // Construction des clauses WHERE pour les filtres
+    double gridSize = gridSizeForLevel(gridLevel);
+
+    // Cellule (gx, gy) : même arrondi que ST_SnapToGrid dans getClusteredAntennas
+    std::string gridStr = std::to_string(gridSize);
     std::vector<std::string> whereClauses;
-    whereClauses.push_back("status = 'active'");
-    whereClauses.push_back("ST_Intersects(geom, ST_MakeEnvelope($1, $2, $3, $4, 4326))");
-    
-    int paramIndex = 7; // $1-$6 déjà utilisés
-    std::string operatorFilter, techFilter;
-    
-    if (operator_id >= 0) {
-        whereClauses.push_back("operator_id = $" + std::to_string(paramIndex++));
-        operatorFilter = std::to_string(operator_id);
+    whereClauses.push_back("geom && ST_MakeEnvelope($1, $2, $3, $4, 4326)");
+    whereClauses.push_back("round(ST_X(ST_SnapToGrid(geom, " + gridStr + ")) / " + gridStr + ")::bigint = " + std::to_string(gx));
+    whereClauses.push_back("round(ST_Y(ST_SnapToGrid(geom, " + gridStr + ")) / " + gridStr + ")::bigint = " + std::to_string(gy));
+
+    int paramIndex = 5; // Les 4 premiers params sont l'emprise de la cellule
+    if (!status.empty()) {
+        whereClauses.push_back("status = $" + std::to_string(paramIndex++) + "::antenna_status");
     }
     if (!technology.empty()) {
         whereClauses.push_back("technology = $" + std::to_string(paramIndex++) + "::technology_type");
-        techFilter = technology;
     }
-    
-    std::string whereClause = whereClauses[0];
-    for (size_t i = 1; i < whereClauses.size(); i++) {
-        whereClause += " AND " + whereClauses[i];
+    if (operator_id >= 0) {
+        whereClauses.push_back("operator_id = $" + std::to_string(paramIndex++));
     }
-    
-    // Stratégie d'optimisation :
-    // 1. ST_Buffer crée les cercles de couverture
-    // 2. ST_Union fusionne tous les cercles en 1 seule géométrie
-    // 3. ST_Simplify réduit drastiquement les points (Douglas-Peucker)
-    // 4. ST_MakeValid corrige les auto-intersections éventuelles
-    // 5. Filtre par bbox pour limiter la zone calculée
-    // 6. Filtres optionnels operator_id et technology
-    
+
+    std::string whereClause;
+    for (size_t i = 0; i < whereClauses.size(); ++i) {
+        if (i > 0) whereClause += " AND ";
+        whereClause += whereClauses[i];
+    }
+
+    // Total compté sur l'ensemble non paginé : une ligne (id NULL) même au-delà de la dernière page
     std::string sql = R"(
-        WITH coverage_raw AS (
-            SELECT ST_Union(
-                ST_Buffer(geom::geography, coverage_radius)::geometry
-            ) as geom
+        WITH members AS (
+            SELECT id, coverage_radius, status::text AS status, technology::text AS technology,
+                   operator_id, ST_X(geom) AS longitude, ST_Y(geom) AS latitude
             FROM antenna
             WHERE )" + whereClause + R"(
-        ),
-        coverage_simplified AS (
-            SELECT ST_MakeValid(
-                ST_Simplify(geom, $5)
-            ) as geom
-            FROM coverage_raw
-            WHERE geom IS NOT NULL
         )
-        SELECT 
-            json_build_object(
-                'type', 'FeatureCollection',
-                'features', COALESCE(
-                    json_agg(
-                        json_build_object(
-                            'type', 'Feature',
-                            'geometry', ST_AsGeoJSON(geom)::json,
-                            'properties', json_build_object(
-                                'type', 'coverage',
-                                'zoom', $6::integer,
-                                'tolerance', $5::double precision
-                            )
-                        )
-                    ),
-                    '[]'::json
-                ),
-                'metadata', json_build_object(
-                    'zoom', $6::integer,
-                    'simplification_tolerance', $5::double precision,
-                    'bbox', json_build_object(
-                        'minLon', $1, 'minLat', $2,
-                        'maxLon', $3, 'maxLat', $4
-                    )
-                )
-            ) as geojson
-        FROM coverage_simplified
-    )";
-    
-    // Exécution avec les bons paramètres selon les filtres
-    auto executeQuery = [&](auto&&... params) {
-        client->execSqlAsync(sql,
-            [callback, zoom](const Result &r) {
-                if (!r.empty() && !r[0]["geojson"].isNull()) {
-                    std::string jsonStr = r[0]["geojson"].as<std::string>();
-                    Json::Value result;
-                    Json::CharReaderBuilder builder;
-                    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
-                    std::string errs;
-                    
-                    if (reader->parse(jsonStr.c_str(), jsonStr.c_str() + jsonStr.length(), &result, &errs)) {
-                        LOG_INFO << "✅ Simplified coverage generated for zoom " << zoom;
-                        callback(result, "");
-                    } else {
-                        auto errorDetails = ErrorHandler::analyzePostgresError("Failed to parse coverage GeoJSON");
-                        ErrorHandler::logError("AntenneService::getSimplifiedCoverage", errorDetails);
-                        callback(Json::Value(), errorDetails.userMessage);
-                    }
-                } else {
-                    // Pas de couverture dans cette bbox
-                    Json::Value emptyCollection;
-                    emptyCollection["type"] = "FeatureCollection";
-                    emptyCollection["features"] = Json::Value(Json::arrayValue);
-                    emptyCollection["metadata"]["zoom"] = zoom;
-                    callback(emptyCollection, "");
+        SELECT t.total, m.*
+        FROM (SELECT COUNT(*) AS total FROM members) t
+        LEFT JOIN LATERAL (
+            SELECT * FROM members
+            ORDER BY id
+            OFFSET )" + std::to_string(offset) + R"( LIMIT )" + std::to_string(limit) + R"(
+        ) m ON TRUE
+        ORDER BY m.id)";
+
+    // Emprise de la cellule (marge infime pour les points sur la frontière, tranchés par l'arrondi)
+    double eps = gridSize * 1e-6;
+    double envMinLon = (gx - 0.5) * gridSize - eps;
+    double envMaxLon = (gx + 0.5) * gridSize + eps;
+    double envMinLat = (gy - 0.5) * gridSize - eps;
+    double envMaxLat = (gy + 0.5) * gridSize + eps;
+
+    auto executeQuery = [&](auto&&... args) {
+        client->execSqlAsync(
+            sql,
+            [callback, offset, limit](const Result& r) {
+                Json::Value out;
+                out["offset"] = offset;
+                out["limit"] = limit;
+                out["total"] = r.empty() ? 0 : r[0]["total"].as<int>();
+                out["leaves"] = Json::Value(Json::arrayValue);
+                for (const auto& row : r) {
+                    if (row["id"].isNull()) continue;
+                    Antenna a;
+                    a.id = row["id"].as<int>();
+                    a.coverage_radius = row["coverage_radius"].as<double>();
+                    a.status = row["status"].as<std::string>();
+                    a.technology = row["technology"].as<std::string>();
+                    a.operator_id = row["operator_id"].isNull() ? 0 : row["operator_id"].as<int>();
+                    a.longitude = row["longitude"].as<double>();
+                    a.latitude = row["latitude"].as<double>();
+                    out["leaves"].append(a.toJson());
                 }
+                callback(out, "");
             },
             [callback](const DrogonDbException& e) {
                 auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
-                ErrorHandler::logError("AntenneService::getSimplifiedCoverage", errorDetails);
+                ErrorHandler::logError("AntenneService::getGridClusterLeaves", errorDetails);
                 callback(Json::Value(), errorDetails.userMessage);
             },
-            std::forward<decltype(params)>(params)...
+            std::forward<decltype(args)>(args)...
         );
     };
-    
-    // Appeler avec les bons paramètres selon filtres
-    if (operator_id >= 0 && !technology.empty()) {
-        executeQuery(minLon, minLat, maxLon, maxLat, tolerance, zoom, operator_id, technology);
+
+    if (!status.empty() && !technology.empty() && operator_id >= 0) {
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat, status, technology, operator_id);
+    } else if (!status.empty() && !technology.empty()) {
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat, status, technology);
+    } else if (!status.empty() && operator_id >= 0) {
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat, status, operator_id);
+    } else if (!technology.empty() && operator_id >= 0) {
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat, technology, operator_id);
+    } else if (!status.empty()) {
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat, status);
+    } else if (!technology.empty()) {
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat, technology);
     } else if (operator_id >= 0) {
-        executeQuery(minLon, minLat, maxLon, maxLat, tolerance, zoom, operator_id);
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat, operator_id);
+    } else {
+        executeQuery(envMinLon, envMinLat, envMaxLon, envMaxLat);
+    }
+}
+
+// ============================================================================
+// TUILE VECTORIELLE DES CLUSTERS (ST_AsMVT)
+// ============================================================================
+void AntenneService::getClusterTile(
+    int z, int x, int y, const std::string& status, const std::string& technology, int operator_id,
+    std::function<void(const std::string&, const std::string&)> callback)
+{
+    auto client = app().getDbClient();
+
+    // Cellule de regroupement : 64 px d'une tuile de 256 px, en mètres Web Mercator
+    double cellSize = 40075016.686 / std::ldexp(1.0, z) / 256.0 * 64.0;
+
+    std::vector<std::string> whereClauses;
+    whereClauses.push_back("a.geom && ST_Transform(b.env_buffered, 4326)");
+
+    int paramIndex = 4; // Les 3 premiers params sont z, x, y
+    if (!status.empty()) {
+        whereClauses.push_back("a.status = $" + std::to_string(paramIndex++) + "::antenna_status");
+    }
+    if (!technology.empty()) {
+        whereClauses.push_back("a.technology = $" + std::to_string(paramIndex++) + "::technology_type");
+    }
+    if (operator_id >= 0) {
+        whereClauses.push_back("a.operator_id = $" + std::to_string(paramIndex++));
+    }
+
+    std::string whereClause;
+    for (size_t i = 0; i < whereClauses.size(); ++i) {
+        if (i > 0) whereClause += " AND ";
+        whereClause += whereClauses[i];
+    }
+
+    // Les propriétés NULL (attributs des clusters) sont omises par ST_AsMVT
+    std::string sql = R"(
+        WITH bounds AS (
+            SELECT ST_TileEnvelope($1, $2, $3) AS env,
+                   ST_TileEnvelope($1, $2, $3, margin => 64.0 / 4096) AS env_buffered
+        ),
+        clusters AS (
+            SELECT
+                COUNT(*) AS point_count,
+                ST_Centroid(ST_Collect(ST_Transform(a.geom, 3857))) AS centroid,
+                AVG(a.coverage_radius) AS avg_radius,
+                MIN(a.id) AS antenna_id,
+                MIN(a.status::text) AS status,
+                MIN(a.technology::text) AS technology,
+                MIN(a.operator_id) AS operator_id
+            FROM antenna a, bounds b
+            WHERE )" + whereClause + R"(
+            GROUP BY ST_SnapToGrid(ST_Transform(a.geom, 3857), )" + std::to_string(cellSize) + R"()
+        ),
+        features AS (
+            SELECT
+                ST_AsMVTGeom(c.centroid, b.env, 4096, 64, true) AS geom,
+                CASE WHEN c.point_count = 1 THEN c.antenna_id END AS feature_id,
+                c.point_count > 1 AS cluster,
+                c.point_count,
+                ROUND(c.avg_radius::numeric, 2)::float8 AS avg_radius,
+                CASE WHEN c.point_count = 1 THEN c.antenna_id END AS antenna_id,
+                CASE WHEN c.point_count = 1 THEN c.status END AS status,
+                CASE WHEN c.point_count = 1 THEN c.technology END AS technology,
+                CASE WHEN c.point_count = 1 THEN c.operator_id END AS operator_id
+            FROM clusters c, bounds b
+        )
+        SELECT ST_AsMVT(features, 'antennas', 4096, 'geom', 'feature_id') AS tile
+        FROM features
+        WHERE geom IS NOT NULL
+    )";
+
+    auto executeQuery = [&](auto&&... args) {
+        client->execSqlAsync(
+            sql,
+            [callback](const Result& r) {
+                std::string tile;
+                if (!r.empty() && !r[0]["tile"].isNull()) {
+                    auto bytes = r[0]["tile"].as<std::vector<char>>();
+                    tile.assign(bytes.begin(), bytes.end());
+                }
+                callback(tile, "");
+            },
+            [callback](const DrogonDbException& e) {
+                auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+                ErrorHandler::logError("AntenneService::getClusterTile", errorDetails);
+                callback("", errorDetails.userMessage);
+            },
+            std::forward<decltype(args)>(args)...
+        );
+    };
+
+    // Paramètres dans l'ordre : tuile, puis filtres optionnels
+    if (!status.empty() && !technology.empty() && operator_id >= 0) {
+        executeQuery(z, x, y, status, technology, operator_id);
+    } else if (!status.empty() && !technology.empty()) {
+        executeQuery(z, x, y, status, technology);
+    } else if (!status.empty() && operator_id >= 0) {
+        executeQuery(z, x, y, status, operator_id);
+    } else if (!technology.empty() && operator_id >= 0) {
+        executeQuery(z, x, y, technology, operator_id);
+    } else if (!status.empty()) {
+        executeQuery(z, x, y, status);
     } else if (!technology.empty()) {
-        executeQuery(minLon, minLat, maxLon, maxLat, tolerance, zoom, technology);
+        executeQuery(z, x, y, technology);
+    } else if (operator_id >= 0) {
+        executeQuery(z, x, y, operator_id);
+    } else {
+        executeQuery(z, x, y);
+    }
+}
+
+// ============================================================================
+// 12. GET SIMPLIFIED COVERAGE (Ultra-optimisé + Filtres operator/technology)
+// ============================================================================
+/**
+ * Cache par blocs (même principe que les fragments de clusters) :
+ * un bloc est un carré aligné de coverageBlockSpan(zoom) x coverageBlockSpan(zoom)
+ * tuiles de couverture, indépendant de la bbox demandée. Une requête lit ses blocs
+ * en un MGET, calcule les manquants à partir des tuiles et assemble la réponse ;
+ * CoverageWarmerService précalcule les blocs du territoire pour les zooms courants.
+ *
+ * Assemblage sans union vectorielle : chaque tuile stocke une pyramide de masques
+ * (coverage_tile.masks, migration 011) ; un bloc est le OU de ses masques au niveau
+ * de résolution du zoom, tracé puis simplifié en C++ (cf. computeCoverageBlocks).
+ *
+ * Format d'un bloc (texte assemblé une fois, jamais reparsé en JSON) :
+ * "<tuiles en attente de recalcul>\n<Feature GeoJSON, ou vide si aucune couverture>"
+ */
+namespace {
+    // Au-delà (bbox démesurée pour le zoom), assemblage direct sans cache de blocs
+    constexpr size_t MAX_COVERAGE_BLOCKS = 256;
+    // Blocs calculés à la demande / par le préchauffage. Les blocs touchés par un recalcul
+    // de tuiles sont purgés ; le TTL borne la durée de vie d'un bloc qui aurait échappé à la purge
+    constexpr int COVERAGE_BLOCK_TTL = 3600;
+    constexpr int COVERAGE_WARM_TTL = 6 * 3600;
+
+    /**
+     * Génération du cache de blocs (compteur Redis partagé entre instances)
+     *
+     * Incrémentée par chaque recalcul de tuiles avant sa purge. Un calcul de blocs
+     * lit la génération avant sa requête et n'écrit pas ses blocs si elle a changé
+     * entre-temps : ils peuvent avoir été assemblés à partir des anciennes tuiles.
+     */
+    const std::string COVERAGE_GENERATION_KEY = "coverage:generation";
+
+    // Pyramide de masques d'une tuile : niveaux de 128, 64, ..., 1 px de côté,
+    // CoverageRaster::packed() concaténés du plus fin au plus grossier
+    constexpr int COVERAGE_MASK_MAX = 128;
+    // Résolution d'assemblage : un bloc ~ une tuile XYZ de 256 px, une vue directe ~ 1024 px
+    constexpr int COVERAGE_BLOCK_PIXELS = 256;
+    constexpr int COVERAGE_VIEW_PIXELS = 1024;
+
+    size_t coverageMaskOffset(int size) {
+        size_t offset = 0;
+        for (int s = COVERAGE_MASK_MAX; s > size; s /= 2) offset += CoverageRaster::packedSize(s, s);
+        return offset;
+    }
+
+    // Niveau de la pyramide (px par tuile) pour extent tuiles de côté dans budget pixels
+    int coverageMaskSize(int extent, int budget) {
+        int size = 1;
+        while (size < COVERAGE_MASK_MAX && size * 2 * extent <= budget) size *= 2;
+        return size;
+    }
+
+    // Côté du raster des tuiles (custom_config.coverage_tiles.raster_size)
+    int coverageRasterSize() {
+        return std::max(64, app().getCustomConfig()["coverage_tiles"].get("raster_size", 512).asInt());
+    }
+
+    // Pixels par tuile d'un bloc : géométrie stockée (raster complet) pour un bloc
+    // d'une tuile, sinon niveau de la pyramide
+    int coverageBlockPixels(int span) {
+        return span == 1 ? coverageRasterSize() : coverageMaskSize(span, COVERAGE_BLOCK_PIXELS);
+    }
+
+    // Seuil de simplification (un demi-pixel) en degrés de longitude, size px par tuile
+    double coverageTolerance(int size) {
+        return 180.0 / std::ldexp(static_cast<double>(size), AntenneService::COVERAGE_TILE_ZOOM);
+    }
+
+    std::string coverageBlockKey(int zoom, int bx, int by, int operator_id, const std::string& technology) {
+        std::string key = "coverage:simplified:block:z:" + std::to_string(zoom) +
+                          ":" + std::to_string(bx) + ":" + std::to_string(by);
+        if (operator_id >= 0) key += ":op:" + std::to_string(operator_id);
+        if (!technology.empty()) key += ":tech:" + technology;
+        return key;
+    }
+
+    // Emprise de découpe d'une réponse hors cache (bbox demandée)
+    struct CoverageClip {
+        double minLon, minLat, maxLon, maxLat;
+    };
+
+    // Tuile lue pour un bloc : GeoJSON stocké ou masque (hexadécimal) selon le mode
+    struct CoverageTileData {
+        int x, y;
+        std::string data;
+    };
+
+    void hexToBytes(const std::string& hex, std::string& out) {
+        auto nibble = [](char c) { return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10; };
+        out.resize(hex.size() / 2);
+        for (size_t i = 0; i < out.size(); ++i) {
+            out[i] = static_cast<char>((nibble(hex[2 * i]) << 4) | nibble(hex[2 * i + 1]));
+        }
+    }
+
+    // OU des masques (size px par tuile) des tuiles [x0, x1] x [y0, y1], tracé puis
+    // simplifié à un demi-pixel, en degrés. Le cadre n'est pas simplifié : deux blocs
+    // voisins partagent exactement les sommets de leur frontière commune
+    std::vector<Polygon2> assembleCoverageMasks(int x0, int y0, int x1, int y1, int size,
+                                                const std::vector<CoverageTileData>& tiles) {
+        CoverageRaster raster((x1 - x0 + 1) * size, (y1 - y0 + 1) * size);
+        std::string bits;
+        for (const auto& t : tiles) {
+            hexToBytes(t.data, bits);
+            raster.orPacked((t.x - x0) * size, (t.y - y0) * size, size, size, bits);
+        }
+
+        TileProjection proj(AntenneService::COVERAGE_TILE_ZOOM, x0, y0, size);
+        auto polygons = raster.trace();
+        for (auto& poly : polygons) {
+            for (auto& ring : poly.rings) {
+                ring = raster.simplifyTraced(ring, 0.5);
+                for (auto& p : ring) p = proj.toLonLat(p);
+            }
+        }
+        return polygons;
+    }
+
+    /**
+     * Calcule des blocs de span x span tuiles (limités aux tuiles de range) ;
+     * retourne un fragment par bloc, dans l'ordre de blocks
+     *
+     * - Une requête indexée lit les tuiles des blocs et les tuiles en attente de recalcul
+     * - span = 1 : le bloc est une tuile, sa géométrie stockée est reprise telle quelle
+     * - Sinon : niveau size des pyramides de masques, assemblé par assembleCoverageMasks
+     *   hors des threads I/O (aucune union ni simplification côté PostgreSQL)
+     * - clip (mode direct, un seul bloc couvrant toute la grille) : découpe à la bbox
+     */
+    void computeCoverageBlocks(
+        int zoom, int span, int size, const std::vector<std::pair<int, int>>& blocks,
+        const AntenneService::TileRange& range, std::optional<CoverageClip> clip,
+        int operator_id, const std::string& technology,
+        std::function<void(std::vector<std::string>, const std::string&)> callback)
+    {
+        const bool stored = span == 1;
+        std::string data = stored
+            ? std::string("ST_AsGeoJSON(geom, 7)")
+            : "encode(substring(masks FROM " + std::to_string(coverageMaskOffset(size) + 1) + " FOR " +
+              std::to_string(CoverageRaster::packedSize(size, size)) + "), 'hex')";
+
+        // Filtres operator_id / technology = choix de la variante de tuile (-1 / '*' = tous)
+        std::string sql = R"(
+            SELECT x, y, )" + data + R"( AS data, false AS stale
+            FROM coverage_tile
+            WHERE operator_id = $5 AND technology = $6
+              AND x BETWEEN $1 AND $3 AND y BETWEEN $2 AND $4
+              AND )" + (stored ? "NOT ST_IsEmpty(geom)" : "masks IS NOT NULL") + R"(
+            UNION ALL
+            -- Tuiles en attente de recalcul : couverture de la version précédente
+            SELECT x, y, NULL, true
+            FROM coverage_tile_dirty
+            WHERE x BETWEEN $1 AND $3 AND y BETWEEN $2 AND $4
+        )";
+
+        app().getDbClient()->execSqlAsync(sql,
+            [callback, blocks, range, clip, zoom, span, size, stored](const Result& r) {
+                std::map<std::pair<int, int>, size_t> slots;
+                for (size_t i = 0; i < blocks.size(); ++i) slots[blocks[i]] = i;
+
+                auto stale = std::make_shared<std::vector<long long>>(blocks.size(), 0);
+                auto tiles = std::make_shared<std::vector<std::vector<CoverageTileData>>>(blocks.size());
+                for (const auto& row : r) {
+                    int x = row["x"].as<int>();
+                    int y = row["y"].as<int>();
+                    auto it = slots.find({x / span, y / span});
+                    if (it == slots.end()) continue;
+                    if (row["stale"].as<bool>()) {
+                        (*stale)[it->second]++;
+                    } else {
+                        (*tiles)[it->second].push_back({x, y, row["data"].as<std::string>()});
+                    }
+                }
+
+                Parallel::runInBackground([callback, blocks, range, clip, zoom, span, size, stored, stale, tiles]() {
+                    char properties[128];
+                    int n = std::snprintf(properties, sizeof(properties),
+                                          R"(,"properties":{"type":"coverage","zoom":%d,"tolerance":%.9g}})",
+                                          zoom, coverageTolerance(size));
+                    const std::string featureEnd(properties, n);
+
+                    std::vector<std::string> fragments(blocks.size());
+                    Parallel::forRange(blocks.size(), [&](size_t begin, size_t end) {
+                        for (size_t i = begin; i < end; ++i) {
+                            std::string geometry;
+                            if (stored) {
+                                if (!(*tiles)[i].empty()) geometry = std::move((*tiles)[i][0].data);
+                            } else {
+                                const auto& [bx, by] = blocks[i];
+                                auto polygons = assembleCoverageMasks(
+                                    std::max(range.minX, bx * span), std::max(range.minY, by * span),
+                                    std::min(range.maxX, (bx + 1) * span - 1), std::min(range.maxY, (by + 1) * span - 1),
+                                    size, (*tiles)[i]);
+                                if (clip) {
+                                    polygons = Geometry::clipPolygons(polygons, clip->minLon, clip->minLat,
+                                                                      clip->maxLon, clip->maxLat);
+                                }
+                                if (!polygons.empty()) geometry = Geometry::polygonsToGeoJson(polygons);
+                            }
+
+                            auto& fragment = fragments[i];
+                            fragment = std::to_string((*stale)[i]) + "\n";
+                            if (geometry.empty()) continue;
+                            fragment += R"({"type":"Feature","geometry":)";
+                            fragment += geometry;
+                            fragment += featureEnd;
+                        }
+                    });
+                    callback(std::move(fragments), "");
+                });
+            },
+            [callback](const DrogonDbException& e) {
+                auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+                ErrorHandler::logError("AntenneService::computeCoverageBlocks", errorDetails);
+                callback({}, errorDetails.userMessage);
+            },
+            range.minX, range.minY, range.maxX, range.maxY,
+            operator_id >= 0 ? operator_id : -1, technology.empty() ? std::string("*") : technology);
+    }
+
+    // Tuiles couvertes par un ensemble de blocs (emprise englobante, bornée à la grille)
+    AntenneService::TileRange blockTiles(int span, const std::vector<std::pair<int, int>>& blocks) {
+        const int last = (1 << AntenneService::COVERAGE_TILE_ZOOM) - 1;
+        AntenneService::TileRange r{blocks[0].first, blocks[0].second, blocks[0].first, blocks[0].second};
+        for (const auto& [bx, by] : blocks) {
+            r.minX = std::min(r.minX, bx); r.maxX = std::max(r.maxX, bx);
+            r.minY = std::min(r.minY, by); r.maxY = std::max(r.maxY, by);
+        }
+        return {r.minX * span, r.minY * span,
+                std::min(last, (r.maxX + 1) * span - 1), std::min(last, (r.maxY + 1) * span - 1)};
+    }
+}
+
+int AntenneService::coverageBlockSpan(int zoom) {
+    // Un bloc ~ une tuile XYZ du zoom demandé (au plus fin : une tuile de couverture)
+    return 1 << std::max(0, std::min(COVERAGE_TILE_ZOOM, COVERAGE_TILE_ZOOM - zoom));
+}
+
+std::vector<std::pair<int, int>> AntenneService::coverageBlocksTouching(
+    int zoom, const std::vector<std::pair<int, int>>& tiles)
+{
+    // Un bloc ne lit que ses propres tuiles (cf. computeCoverageBlocks)
+    const int span = coverageBlockSpan(zoom);
+    std::set<std::pair<int, int>> blocks;
+    for (const auto& [x, y] : tiles) {
+        blocks.emplace(x / span, y / span);
+    }
+    return {blocks.begin(), blocks.end()};
+}
+
+void AntenneService::getSimplifiedCoverage(
+    double minLat, double minLon, double maxLat, double maxLon, int zoom,
+    int operator_id, const std::string& technology,
+    std::function<void(const std::string&, const Json::Value&, const std::string&)> callback)
+{
+    // Tuiles matérialisées touchées par la bbox (coverage_tile, migration 006) :
+    // plus d'union des empreintes à la requête, seulement un assemblage de tuiles
+    TileRange tiles = coverageTileRange(minLat, minLon, maxLat, maxLon);
+
+    // ========== BLOCS COUVRANT LA BBOX ==========
+    int span = coverageBlockSpan(zoom);
+    TileRange blockRange{tiles.minX / span, tiles.minY / span, tiles.maxX / span, tiles.maxY / span};
+    size_t blockCount = static_cast<size_t>(blockRange.maxX - blockRange.minX + 1) *
+                        static_cast<size_t>(blockRange.maxY - blockRange.minY + 1);
+    bool useBlocks = blockCount <= MAX_COVERAGE_BLOCKS;
+
+    // Pixels par tuile : ceux du bloc, ou de la vue entière en mode direct
+    int extent = std::max(tiles.maxX - tiles.minX, tiles.maxY - tiles.minY) + 1;
+    int size = useBlocks ? coverageBlockPixels(span) : coverageMaskSize(extent, COVERAGE_VIEW_PIXELS);
+    double tolerance = coverageTolerance(size);
+
+    std::vector<std::pair<int, int>> blocks;
+    std::vector<std::string> keys;
+    std::vector<std::optional<std::string>> cached;
+    if (useBlocks) {
+        for (int by = blockRange.minY; by <= blockRange.maxY; ++by) {
+            for (int bx = blockRange.minX; bx <= blockRange.maxX; ++bx) {
+                blocks.emplace_back(bx, by);
+                keys.push_back(coverageBlockKey(zoom, bx, by, operator_id, technology));
+            }
+        }
+        // Génération lue dans le même MGET que les blocs
+        keys.push_back(COVERAGE_GENERATION_KEY);
+        cached = CacheService::getInstance().mget(keys);
+        keys.pop_back();
+    }
+    std::optional<std::string> generation;
+    if (!cached.empty()) {
+        generation = std::move(cached.back());
+        cached.pop_back();
+    }
+
+    std::vector<size_t> missing;
+    std::vector<std::pair<int, int>> missingBlocks;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (cached[i]) continue;
+        missing.push_back(i);
+        missingBlocks.push_back(blocks[i]);
+    }
+
+    // ========== ASSEMBLAGE DE LA RÉPONSE ==========
+    // Features recopiées sans parsing, métadonnées sérialisées puis insérées
+    auto shared = std::make_shared<std::vector<std::optional<std::string>>>(std::move(cached));
+    auto compose = [callback, shared, zoom, tolerance, tiles, span,
+                    total = blocks.size(), hits = blocks.size() - missing.size()]() {
+        size_t capacity = 256;
+        for (const auto& fragment : *shared) {
+            if (fragment) capacity += fragment->size();
+        }
+        std::string body;
+        body.reserve(capacity);
+        body += R"({"type":"FeatureCollection","features":[)";
+
+        long long staleTiles = 0;
+        int features = 0;
+        for (const auto& fragment : *shared) {
+            if (!fragment) continue;
+            staleTiles += std::strtoll(fragment->c_str(), nullptr, 10);
+            size_t eol = fragment->find('\n');
+            if (eol == std::string::npos || eol + 1 == fragment->size()) continue;
+            if (features++ > 0) body += ',';
+            body.append(*fragment, eol + 1, std::string::npos);
+        }
+
+        Json::Value metadata;
+        metadata["zoom"] = zoom;
+        metadata["simplification_tolerance"] = tolerance;
+        metadata["tiles"]["z"] = COVERAGE_TILE_ZOOM;
+        metadata["tiles"]["minX"] = tiles.minX;
+        metadata["tiles"]["minY"] = tiles.minY;
+        metadata["tiles"]["maxX"] = tiles.maxX;
+        metadata["tiles"]["maxY"] = tiles.maxY;
+        metadata["blocks"]["span"] = span;
+        metadata["blocks"]["total"] = static_cast<Json::UInt64>(total);
+        metadata["blocks"]["cached"] = static_cast<Json::UInt64>(hits);
+        // Tuiles en attente de recalcul : couverture de la version précédente
+        metadata["stale_tiles"] = static_cast<Json::Int64>(staleTiles);
+
+        Json::StreamWriterBuilder writer;
+        writer["indentation"] = "";
+        body += R"(],"metadata":)";
+        body += Json::writeString(writer, metadata);
+        body += '}';
+
+        LOG_INFO << "✅ Simplified coverage assembled for zoom " << zoom << ": " << features
+                 << " features, blocks " << hits << "/" << total << " cached";
+        callback(body, metadata, "");
+    };
+
+    if (useBlocks && missing.empty()) {
+        compose();
+        return;
+    }
+
+    if (!useBlocks) {
+        // Mode direct : un seul bloc couvrant toute la grille, limité aux tuiles de la bbox, non mis en cache
+        computeCoverageBlocks(zoom, 1 << COVERAGE_TILE_ZOOM, size, {{0, 0}}, tiles,
+                              CoverageClip{minLon, minLat, maxLon, maxLat}, operator_id, technology,
+            [callback, compose, shared](std::vector<std::string> fragments, const std::string& err) {
+                if (!err.empty()) {
+                    callback("", Json::Value(), err);
+                    return;
+                }
+                shared->push_back(std::move(fragments[0]));
+                compose();
+            });
+        return;
+    }
+
+    // ========== CALCUL GROUPÉ DES BLOCS MANQUANTS ==========
+    computeCoverageBlocks(zoom, span, size, missingBlocks, blockTiles(span, missingBlocks), std::nullopt,
+                          operator_id, technology,
+        [callback, compose, shared, keys, missing, generation](std::vector<std::string> fragments, const std::string& err) {
+            if (!err.empty()) {
+                callback("", Json::Value(), err);
+                return;
+            }
+            // Blocs sans couverture mis en cache aussi, pour ne pas les recalculer
+            std::vector<std::pair<std::string, std::string>> toCache;
+            toCache.reserve(missing.size());
+            for (size_t k = 0; k < missing.size(); ++k) {
+                toCache.emplace_back(keys[missing[k]], fragments[k]);
+                (*shared)[missing[k]] = std::move(fragments[k]);
+            }
+            auto& cache = CacheService::getInstance();
+            if (cache.get(COVERAGE_GENERATION_KEY) == generation) {
+                cache.mset(toCache, COVERAGE_BLOCK_TTL);
+            }
+            compose();
+        });
+}
+
+void AntenneService::warmCoverageBlocks(
+    int zoom, const std::vector<std::pair<int, int>>& blocks, int operator_id, const std::string& technology,
+    std::function<void(int, const std::string&)> callback)
+{
+    if (blocks.empty()) {
+        callback(0, "");
+        return;
+    }
+
+    std::vector<std::string> keys;
+    keys.reserve(blocks.size());
+    for (const auto& [bx, by] : blocks) {
+        keys.push_back(coverageBlockKey(zoom, bx, by, operator_id, technology));
+    }
+    keys.push_back(COVERAGE_GENERATION_KEY);
+    auto cached = CacheService::getInstance().mget(keys);
+    keys.pop_back();
+    std::optional<std::string> generation = cached.empty() ? std::nullopt : std::move(cached.back());
+
+    std::vector<std::pair<int, int>> missingBlocks;
+    std::vector<std::string> missingKeys;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (cached[i]) continue;
+        missingBlocks.push_back(blocks[i]);
+        missingKeys.push_back(keys[i]);
+    }
+    if (missingBlocks.empty()) {
+        callback(0, "");
+        return;
+    }
+
+    int span = coverageBlockSpan(zoom);
+    computeCoverageBlocks(zoom, span, coverageBlockPixels(span), missingBlocks, blockTiles(span, missingBlocks),
+                          std::nullopt, operator_id, technology,
+        [callback, missingKeys, generation](std::vector<std::string> fragments, const std::string& err) {
+            if (!err.empty()) {
+                callback(0, err);
+                return;
+            }
+            // Recalcul de tuiles pendant la requête : blocs peut-être périmés, non écrits
+            // (le préchauffage déclenché par ce recalcul les reprendra)
+            auto& cache = CacheService::getInstance();
+            if (cache.get(COVERAGE_GENERATION_KEY) != generation) {
+                callback(0, "");
+                return;
+            }
+            std::vector<std::pair<std::string, std::string>> toCache;
+            toCache.reserve(missingKeys.size());
+            for (size_t k = 0; k < missingKeys.size(); ++k) {
+                toCache.emplace_back(missingKeys[k], std::move(fragments[k]));
+            }
+            cache.mset(toCache, COVERAGE_WARM_TTL);
+            callback(static_cast<int>(toCache.size()), "");
+        });
+}
+
+// ============================================================================
+// TUILES DE COUVERTURE MATÉRIALISÉES
+// ============================================================================
+AntenneService::TileRange AntenneService::coverageTileRange(double minLat, double minLon, double maxLat, double maxLon) {
+    const double n = std::ldexp(1.0, COVERAGE_TILE_ZOOM);
+    auto tileX = [n](double lon) {
+        int x = static_cast<int>(std::floor((lon + 180.0) / 360.0 * n));
+        return std::max(0, std::min(static_cast<int>(n) - 1, x));
+    };
+    auto tileY = [n](double lat) {
+        double c = std::max(-85.0511, std::min(85.0511, lat)) * GeoUtils::PI / 180.0;
+        int y = static_cast<int>(std::floor((1.0 - std::log(std::tan(c) + 1.0 / std::cos(c)) / GeoUtils::PI) / 2.0 * n));
+        return std::max(0, std::min(static_cast<int>(n) - 1, y));
+    };
+    // Les y croissent vers le sud
+    return {tileX(minLon), tileY(maxLat), tileX(maxLon), tileY(minLat)};
+}
+
+namespace {
+    std::atomic<bool> coverageRefreshRunning{false};
+
+    // Empreinte d'une antenne active : polygones précalculés (ViewshedService) ou disque
+    struct CoverageFootprint {
+        int operator_id;
+        std::string technology;
+        double lon, lat, radius;
+        std::vector<Polygon2> viewshed;   // Vide tant que l'empreinte n'est pas calculée
+        double minLon, minLat, maxLon, maxLat;
+    };
+
+    // Pyramide de masques d'une variante (cf. COVERAGE_MASK_MAX), en hexadécimal pour COPY
+    std::string coverageMaskPyramid(const CoverageRaster& mask) {
+        static const char digits[] = "0123456789abcdef";
+        std::string hex;
+        hex.reserve(2 * coverageMaskOffset(0));
+        CoverageRaster level = mask.downsample(COVERAGE_MASK_MAX, COVERAGE_MASK_MAX);
+        for (int size = COVERAGE_MASK_MAX; size >= 1; size /= 2) {
+            if (size < COVERAGE_MASK_MAX) level = level.downsample(size, size);
+            for (unsigned char c : level.packed()) {
+                hex += digits[c >> 4];
+                hex += digits[c & 15];
+            }
+        }
+        return hex;
+    }
+
+    // Rastérise une tuile (un masque par variante de filtre) et ajoute ses lignes COPY :
+    // operator_id, technology, x, y, antenna_count, WKT, pyramide de masques
+    void rasterizeCoverageTile(int x, int y, int size,
+                               const std::vector<const CoverageFootprint*>& footprints, std::string& out) {
+        TileProjection proj(AntenneService::COVERAGE_TILE_ZOOM, x, y, size);
+
+        struct Variant {
+            CoverageRaster mask;
+            int antennas = 0;
+            explicit Variant(int size) : mask(size, size) {}
+        };
+        std::map<std::pair<int, std::string>, Variant> variants;
+
+        std::vector<CoverageRaster::Span> spans;
+        for (const auto* f : footprints) {
+            spans.clear();
+            if (f->viewshed.empty()) {
+                Point2 c = proj.toPixel(f->lon, f->lat);
+                CoverageRaster::diskSpans(c.x, c.y, proj.metersToPixels(f->radius, f->lat), size, size, spans);
+            } else {
+                for (const auto& poly : f->viewshed) {
+                    Polygon2 local;
+                    for (const auto& ring : poly.rings) {
+                        Ring r;
+                        r.reserve(ring.size());
+                        for (const auto& p : ring) r.push_back(proj.toPixel(p.x, p.y));
+                        local.rings.push_back(std::move(r));
+                    }
+                    CoverageRaster::polygonSpans(local, size, size, spans);
+                }
+            }
+            if (spans.empty()) continue; // Empreinte hors de la tuile
+
+            // Spans calculés une fois, OU dans les 4 variantes : tous, opérateur, technologie, les deux
+            const std::pair<int, std::string> keys[] = {
+                {-1, "*"}, {f->operator_id, "*"}, {-1, f->technology}, {f->operator_id, f->technology}};
+            for (const auto& k : keys) {
+                auto& v = variants.try_emplace(k, size).first->second;
+                v.mask.fill(spans);
+                v.antennas++;
+            }
+        }
+
+        for (auto& [key, v] : variants) {
+            auto polygons = v.mask.trace();
+            for (auto& poly : polygons) {
+                for (auto& ring : poly.rings) {
+                    // Escaliers du raster supprimés à un demi-pixel près, bord de tuile intact
+                    ring = v.mask.simplifyTraced(ring, 0.5);
+                    for (auto& p : ring) p = proj.toLonLat(p);
+                }
+            }
+            out += std::to_string(key.first);
+            out += '\t';
+            out += key.second;
+            out += '\t';
+            out += std::to_string(x);
+            out += '\t';
+            out += std::to_string(y);
+            out += '\t';
+            out += std::to_string(v.antennas);
+            out += '\t';
+            out += Geometry::polygonsToWkt(polygons);
+            out += '\t';
+            out += coverageMaskPyramid(v.mask);
+            out += '\n';
+        }
+    }
+
+    // Un lot : réserve au plus batchTiles tuiles marquées, les rastérise et les écrit.
+    // Retourne le nombre de tuiles réservées (0 = file vide)
+    int refreshCoverageBatch(std::vector<std::pair<int, int>>& refreshed,
+                             const orm::DbClientPtr& client, const std::string& connInfo,
+                             int batchTiles, int rasterSize, double leaseSeconds) {
+        auto claimed = client->execSqlSync(
+            "SELECT x, y, claimed_at::text AS token FROM coverage_tile_claim($1, make_interval(secs => $2))",
+            batchTiles, leaseSeconds);
+        if (claimed.empty()) return 0;
+        std::string token = claimed[0]["token"].as<std::string>();
+
+        // ========== EMPREINTES À PORTÉE ==========
+        // Préfiltre indexé de 0,5° (~55 km), supérieur au plus grand rayon de couverture
+        auto rows = client->execSqlSync(std::string(R"(
+            SELECT COALESCE(a.operator_id, 0) AS operator_id,
+                   a.technology::text AS technology,
+                   ST_X(a.geom) AS lon, ST_Y(a.geom) AS lat,
+                   a.coverage_radius,
+                   ST_AsGeoJSON(a.viewshed_geom, 7) AS viewshed
+            FROM antenna a
+            WHERE a.status = 'active'
+              AND EXISTS (
+                  SELECT 1 FROM coverage_tile_dirty d
+                  WHERE d.claimed_at = $1::timestamptz
+                    AND a.geom && ST_Expand(ST_Transform(ST_TileEnvelope()") +
+                std::to_string(AntenneService::COVERAGE_TILE_ZOOM) + R"(, d.x, d.y), 4326), 0.5)
+              )
+        )", token);
+
+        std::vector<CoverageFootprint> footprints(rows.size());
+        std::vector<std::string> rawViewsheds(rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            auto row = rows[i];
+            auto& f = footprints[i];
+            f.operator_id = row["operator_id"].as<int>();
+            f.technology = row["technology"].as<std::string>();
+            f.lon = row["lon"].as<double>();
+            f.lat = row["lat"].as<double>();
+            f.radius = row["coverage_radius"].as<double>();
+            if (!row["viewshed"].isNull()) rawViewsheds[i] = row["viewshed"].as<std::string>();
+        }
+
+        // Parsing GeoJSON des empreintes en parallèle (chaque thread écrit ses propres cases)
+        Parallel::forRange(footprints.size(), [&](size_t begin, size_t end) {
+            Json::CharReaderBuilder builder;
+            std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+            for (size_t i = begin; i < end; ++i) {
+                auto& f = footprints[i];
+                const auto& s = rawViewsheds[i];
+                Json::Value geom;
+                std::string errs;
+                Shape shape;
+                if (!s.empty() && reader->parse(s.c_str(), s.c_str() + s.size(), &geom, &errs) &&
+                    Geometry::fromGeoJson(geom, shape)) {
+                    f.viewshed = std::move(shape.polygons);
+                }
+                // Le disque de rayon coverage_radius contient aussi l'empreinte calculée
+                double dLat = GeoUtils::metersToDegreesLat(f.radius);
+                double dLon = GeoUtils::metersToDegreesLon(f.radius, f.lat);
+                f.minLon = f.lon - dLon;
+                f.maxLon = f.lon + dLon;
+                f.minLat = f.lat - dLat;
+                f.maxLat = f.lat + dLat;
+            }
+        });
+
+        BoxIndex index(0.25);
+        for (size_t i = 0; i < footprints.size(); ++i) {
+            const auto& f = footprints[i];
+            index.insert(i, f.minLon, f.minLat, f.maxLon, f.maxLat);
+        }
+
+        // ========== RASTÉRISATION (parallèle, une tuile par itération) ==========
+        size_t workers = Parallel::workerCount();
+        std::vector<std::string> buffers(workers);
+        std::atomic<size_t> slot{0};
+
+        Parallel::forRange(claimed.size(), [&](size_t begin, size_t end) {
+            auto& out = buffers[slot++ % workers];
+            std::vector<const CoverageFootprint*> candidates;
+            for (size_t i = begin; i < end; ++i) {
+                int x = claimed[i]["x"].as<int>();
+                int y = claimed[i]["y"].as<int>();
+                TileProjection proj(AntenneService::COVERAGE_TILE_ZOOM, x, y, rasterSize);
+                Point2 nw = proj.toLonLat({0, 0});
+                Point2 se = proj.toLonLat({static_cast<double>(rasterSize), static_cast<double>(rasterSize)});
+
+                candidates.clear();
+                for (size_t idx : index.query(nw.x, se.y, se.x, nw.y)) {
+                    const auto& f = footprints[idx];
+                    if (f.maxLon < nw.x || f.minLon > se.x || f.maxLat < se.y || f.minLat > nw.y) continue;
+                    candidates.push_back(&f);
+                }
+                rasterizeCoverageTile(x, y, rasterSize, candidates, out);
+            }
+        });
+
+        // ========== PERSISTANCE ==========
+        // COPY dans une table temporaire ; seules les tuiles encore réservées avec ce jeton
+        // sont écrites (une tuile remarquée pendant le calcul le sera au lot suivant)
+        PgCopy copy(connInfo);
+        copy.exec("BEGIN");
+        copy.exec("CREATE TEMP TABLE coverage_load (operator_id INTEGER, technology TEXT, x INTEGER, y INTEGER, "
+                  "antenna_count INTEGER, wkt TEXT, masks TEXT) ON COMMIT DROP");
+        copy.begin("COPY coverage_load (operator_id, technology, x, y, antenna_count, wkt, masks) FROM STDIN");
+        for (const auto& buf : buffers) {
+            copy.putLine(buf);
+        }
+        copy.end();
+        copy.exec("CREATE TEMP TABLE coverage_owned (x INTEGER, y INTEGER) ON COMMIT DROP");
+        copy.exec("WITH done AS ("
+                  "    DELETE FROM coverage_tile_dirty WHERE claimed_at = '" + token + "'::timestamptz "
+                  "    RETURNING x, y"
+                  ") INSERT INTO coverage_owned SELECT x, y FROM done");
+        copy.exec("DELETE FROM coverage_tile c USING coverage_owned o WHERE c.x = o.x AND c.y = o.y");
+        // Polygones tracés valides par construction ; ST_MakeValid seulement si la
+        // simplification a rapproché deux contours jusqu'à les faire se toucher
+        copy.exec("INSERT INTO coverage_tile (operator_id, technology, x, y, geom, antenna_count, masks) "
+                  "SELECT l.operator_id, l.technology, l.x, l.y, "
+                  "       CASE WHEN ST_IsValid(g.geom) THEN g.geom "
+                  "            ELSE ST_Multi(ST_CollectionExtract(ST_MakeValid(g.geom), 3)) END, "
+                  "       l.antenna_count, decode(l.masks, 'hex') "
+                  "FROM coverage_load l "
+                  "JOIN coverage_owned o ON o.x = l.x AND o.y = l.y "
+                  "CROSS JOIN LATERAL (SELECT ST_GeomFromText(l.wkt, 4326) AS geom) g");
+        copy.exec("COMMIT");
+
+        for (const auto& row : claimed) {
+            refreshed.emplace_back(row["x"].as<int>(), row["y"].as<int>());
+        }
+        return static_cast<int>(claimed.size());
+    }
+}
+
+namespace {
+    /**
+     * Purge du cache de couverture après un recalcul de tuiles
+     *
+     * - Génération incrémentée d'abord : un calcul de blocs en vol n'écrira pas
+     * - Blocs de tous les zooms et de toutes les variantes de filtre qui contiennent
+     *   une tuile recalculée, supprimés par clé
+     * - Réponses assemblées (TTL 5 min) : purgées en entier, reconstruites depuis les blocs
+     */
+    void purgeCoverageBlocks(const orm::DbClientPtr& client, const std::vector<std::pair<int, int>>& tiles) {
+        auto& cache = CacheService::getInstance();
+        cache.incr(COVERAGE_GENERATION_KEY);
+
+        // Variantes de filtre : aucun, opérateur (0 = sans opérateur), technologie, les deux
+        std::vector<int> operators = {-1, 0};
+        std::vector<std::string> technologies = {""};
+        try {
+            auto r = client->execSqlSync(R"(
+                SELECT 'op' AS kind, id::text AS value FROM operator
+                UNION ALL
+                SELECT 'tech', unnest(enum_range(NULL::technology_type))::text
+            )");
+            for (const auto& row : r) {
+                if (row["kind"].as<std::string>() == "op") {
+                    operators.push_back(std::stoi(row["value"].as<std::string>()));
+                } else {
+                    technologies.push_back(row["value"].as<std::string>());
+                }
+            }
+        } catch (const DrogonDbException& e) {
+            // Variantes inconnues : purge complète
+            auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+            ErrorHandler::logError("AntenneService::purgeCoverageBlocks", errorDetails);
+            cache.delPattern("coverage:simplified:*");
+            return;
+        }
+
+        std::vector<std::string> keys;
+        for (int zoom = 0; zoom <= 18; ++zoom) {
+            for (const auto& [bx, by] : AntenneService::coverageBlocksTouching(zoom, tiles)) {
+                for (int op : operators) {
+                    for (const auto& tech : technologies) {
+                        keys.push_back(coverageBlockKey(zoom, bx, by, op, tech));
+                    }
+                }
+            }
+        }
+        cache.del(keys);
+        cache.delPattern("coverage:simplified:tiles:*");
+        LOG_INFO << "🗑️ Coverage cache: " << keys.size() << " block keys purged for "
+                 << tiles.size() << " refreshed tiles";
+    }
+}
+
+void AntenneService::scheduleCoverageTileRefresh() {
+    const Json::Value& config = app().getCustomConfig()["coverage_tiles"];
+    double interval = config.get("refresh_interval_s", 30.0).asDouble();
+    int batchTiles = std::max(1, config.get("batch_tiles", 64).asInt());
+    int rasterSize = coverageRasterSize();
+    double leaseSeconds = config.get("claim_lease_s", 300.0).asDouble();
+    if (interval <= 0) return;
+
+    auto run = [batchTiles, rasterSize, leaseSeconds]() {
+        // Ignoré si le passage précédent n'a pas fini de vider la file
+        if (coverageRefreshRunning.exchange(true)) return;
+
+        auto client = app().getDbClient();
+        std::string connInfo = client->connectionInfo();
+        Parallel::runInBackground([client, connInfo, batchTiles, rasterSize, leaseSeconds]() {
+            auto startedAt = std::chrono::steady_clock::now();
+            int total = 0;
+            std::vector<std::pair<int, int>> refreshed;
+            try {
+                // Lots successifs jusqu'à épuiser la file
+                int tiles;
+                do {
+                    tiles = refreshCoverageBatch(refreshed, client, connInfo, batchTiles, rasterSize, leaseSeconds);
+                    total += tiles;
+                } while (tiles >= batchTiles);
+            } catch (const DrogonDbException& e) {
+                auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+                ErrorHandler::logError("AntenneService::refreshCoverageTiles", errorDetails);
+            } catch (const std::exception& e) {
+                auto errorDetails = ErrorHandler::analyzePostgresError(e.what());
+                ErrorHandler::logError("AntenneService::refreshCoverageTiles", errorDetails);
+            }
+
+            if (!refreshed.empty()) {
+                // Blocs assemblés à partir des anciennes tuiles : purge ciblée puis préchauffage
+                purgeCoverageBlocks(client, refreshed);
+                CoverageWarmerService::trigger(refreshed);
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - startedAt).count();
+                LOG_INFO << "🗺️ Coverage tiles rasterized: " << total << " in " << elapsed << " ms";
+            }
+            coverageRefreshRunning = false;
+        });
+    };
+    run();
+    app().getLoop()->runEvery(interval, run);
+    LOG_INFO << "🗺️ Coverage tile refresh every " << interval << " s (" << batchTiles << " tiles per batch, "
+             << rasterSize << " px raster)";
+}
+
+// ============================================================================
+// SNAPSHOT DES ANTENNES (matrice d'interférences, calculs batch)
+// ============================================================================
+void AntenneService::getAllAntennas(
+    bool activeOnly,
+    std::function<void(const std::vector<Antenna>&, const std::string&)> callback)
+{
+    auto client = app().getDbClient();
+
+    std::string sql = R"(
+        SELECT
+            id,
+            coverage_radius,
+            status::text AS status,
+            technology::text AS technology,
+            operator_id,
+            ST_X(geom) AS longitude,
+            ST_Y(geom) AS latitude
+        FROM antenna
+    )";
+    if (activeOnly) {
+        sql += " WHERE status = 'active'";
+    }
+    sql += " ORDER BY id";
+
+    client->execSqlAsync(sql,
+        [callback](const Result& r) {
+            std::vector<Antenna> list;
+            list.reserve(r.size());
+            for (auto row : r) {
+                Antenna a;
+                a.id = row["id"].as<int>();
+                a.coverage_radius = row["coverage_radius"].as<double>();
+                a.status = row["status"].as<std::string>();
+                a.technology = row["technology"].as<std::string>();
+                a.operator_id = row["operator_id"].isNull() ? 0 : row["operator_id"].as<int>();
+                a.longitude = row["longitude"].as<double>();
+                a.latitude = row["latitude"].as<double>();
+                list.push_back(a);
+            }
+            callback(list, "");
+        },
+        [callback](const DrogonDbException& e) {
+            auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+            ErrorHandler::logError("AntenneService::getAllAntennas", errorDetails);
+            callback({}, errorDetails.userMessage);
+        });
+}
+
+// ============================================================================
+// SYNCHRONISATION DELTA
+// ============================================================================
+/**
+ * Changements depuis 'since', lus dans antenna_change_log (migration 004)
+ *
+ * Page : on prend les versions suivantes jusqu'à environ 'limit' entrées du
+ * journal, sans jamais couper une version (un import massif tient en une).
+ * Les antennes touchées sont jointes à leur état courant : présente = upsert,
+ * absente (ou hors bbox) = suppression. Cet état peut être plus récent que la
+ * page : les upserts étant idempotents, le client converge à la page suivante.
+ */
+void AntenneService::getChanges(
+    long long since, bool hasBbox,
+    double minLat, double minLon, double maxLat, double maxLon, int limit,
+    std::function<void(const Json::Value&, const std::string&)> callback)
+{
+    auto client = app().getDbClient();
+
+    // $1 = since, $2 = limit, [$3..$6 = minLon, minLat, maxLon, maxLat]
+    std::string envelope = "ST_MakeEnvelope($3, $4, $5, $6, 4326)";
+    std::string sql = R"(
+        WITH state AS (
+            SELECT version, pruned_through FROM antenna_data_version
+        ),
+        bound AS (
+            -- Version de la (limit + 1)-ième entrée : la page s'arrête juste avant,
+            -- sauf si la première version dépasse à elle seule la limite
+            SELECT CASE
+                WHEN nxt.version IS NULL THEN (SELECT version FROM state)
+                ELSE GREATEST(nxt.version - 1, $1 + 1)
+            END AS upto
+            FROM (
+                SELECT (
+                    SELECT version FROM antenna_change_log
+                    WHERE version > $1 ORDER BY version OFFSET $2 LIMIT 1
+                ) AS version
+            ) nxt
+        ),
+        touched AS (
+            SELECT DISTINCT l.antenna_id
+            FROM antenna_change_log l, bound
+            WHERE l.version > $1 AND l.version <= bound.upto
+    )";
+    if (hasBbox) {
+        sql += " AND (l.geom && " + envelope + " OR l.old_geom && " + envelope + ")";
+    }
+    sql += R"(
+        )
+        SELECT
+            state.version AS current_version,
+            state.pruned_through,
+            LEAST(bound.upto, state.version) AS upto,
+            t.antenna_id,
+            (a.id IS NOT NULL)";
+    if (hasBbox) sql += " AND a.geom && " + envelope;
+    sql += R"( AS present,
+            a.coverage_radius,
+            a.status::text AS status,
+            a.technology::text AS technology,
+            a.operator_id,
+            o.name AS operator_name,
+            ST_X(a.geom) AS longitude,
+            ST_Y(a.geom) AS latitude
+        FROM state
+        CROSS JOIN bound
+        LEFT JOIN (
+            touched t
+            LEFT JOIN antenna a ON a.id = t.antenna_id
+            LEFT JOIN operator o ON o.id = a.operator_id
+        ) ON TRUE
+        ORDER BY t.antenna_id
+    )";
+
+    auto onResult = [callback, since](const Result& r) {
+        Json::Value result;
+        if (r.empty()) {
+            callback(result, "Change log is not initialized (migration 004)");
+            return;
+        }
+
+        long long current = r[0]["current_version"].as<long long>();
+        long long pruned = r[0]["pruned_through"].as<long long>();
+        result["current_version"] = static_cast<Json::Int64>(current);
+
+        // Journal purgé au-delà de 'since', ou version venant d'une autre base
+        if (since < pruned || since > current) {
+            result["resync_required"] = true;
+            callback(result, "");
+            return;
+        }
+
+        long long upto = std::max(since, r[0]["upto"].as<long long>());
+        result["since"] = static_cast<Json::Int64>(since);
+        result["version"] = static_cast<Json::Int64>(upto);
+        result["has_more"] = upto < current;
+
+        Json::Value upserted(Json::arrayValue);
+        Json::Value deleted(Json::arrayValue);
+        for (auto row : r) {
+            if (row["antenna_id"].isNull()) continue;
+            int id = row["antenna_id"].as<int>();
+            if (!row["present"].as<bool>()) {
+                deleted.append(id);
+                continue;
+            }
+            Antenna a;
+            a.id = id;
+            a.coverage_radius = row["coverage_radius"].as<double>();
+            a.status = row["status"].as<std::string>();
+            a.technology = row["technology"].as<std::string>();
+            a.operator_id = row["operator_id"].isNull() ? 0 : row["operator_id"].as<int>();
+            a.operatorName = row["operator_name"].isNull() ? "" : row["operator_name"].as<std::string>();
+            a.longitude = row["longitude"].as<double>();
+            a.latitude = row["latitude"].as<double>();
+            upserted.append(a.toJson());
+        }
+        result["upserted"] = upserted;
+        result["deleted"] = deleted;
+        callback(result, "");
+    };
+    auto onError = [callback](const DrogonDbException& e) {
+        auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+        ErrorHandler::logError("AntenneService::getChanges", errorDetails);
+        callback(Json::Value(), errorDetails.userMessage);
+    };
+
+    if (hasBbox) {
+        client->execSqlAsync(sql, onResult, onError, since, limit, minLon, minLat, maxLon, maxLat);
     } else {
-        executeQuery(minLon, minLat, maxLon, maxLat, tolerance, zoom);
+        client->execSqlAsync(sql, onResult, onError, since, limit);
     }
-}
\ No newline at end of file
+}
+
+void AntenneService::scheduleChangeLogPrune() {
+    const Json::Value& config = app().getCustomConfig()["change_log"];
+    int retentionDays = config.get("retention_days", 7).asInt();
+    double interval = config.get("prune_interval_s", 3600.0).asDouble();
+    if (retentionDays <= 0 || interval <= 0) return;
+
+    app().getLoop()->runEvery(interval, [retentionDays]() {
+        app().getDbClient()->execSqlAsync(
+            "SELECT antenna_change_log_prune(make_interval(days => $1)) AS deleted",
+            [](const Result& r) {
+                long long deleted = r.empty() ? 0 : r[0]["deleted"].as<long long>();
+                if (deleted > 0) {
+                    LOG_INFO << "🧹 Pruned " << deleted << " antenna change log entries";
+                }
+            },
+            [](const DrogonDbException& e) {
+                auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+                ErrorHandler::logError("AntenneService::scheduleChangeLogPrune", errorDetails);
+            },
+            retentionDays);
+    });
+    LOG_INFO << "🧾 Antenna change log retention: " << retentionDays << " days";
+}
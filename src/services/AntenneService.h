@@ -1,6 +1,7 @@
 #pragma once
 #include "../models/Antenne.h"
 #include <drogon/drogon.h>
+#include <utility>
 #include <vector>
 #include <string>
 #include <functional>
@@ -12,29 +13,120 @@ public:
      * Clustering backend optimisé utilisant ST_SnapToGrid de PostGIS
      *
      * @param minLat, minLon, maxLat, maxLon - Bounding box de la vue
-     * @param zoom - Niveau de zoom Leaflet (0-18) pour calculer la taille de grille
+     * @param zoom - Niveau de zoom Leaflet (0-18)
+     * @param gridLevel - Niveau de grille (cf. gridLevelForZoom, ou choisi selon la densité)
      * @param status - Filtre optionnel par statut (vide = tous)
      * @param technology - Filtre optionnel par technologie (vide = tous)
      * @param operator_id - Filtre optionnel par opérateur (0 = tous)
-     * @param callback - Retourne GeoJSON avec clusters ou erreur
+     * @param callback - Retourne le GeoJSON sérialisé (corps HTTP prêt à l'emploi, métadonnées
+     *                   incluses), ces métadonnées séparément (en-têtes), ou erreur
      */
     static void getClusteredAntennas(double minLat, double minLon, double maxLat, double maxLon,
-                                    int zoom, const std::string& status,
+                                    int zoom, int gridLevel, const std::string& status,
                                     const std::string& technology, int operator_id,
-                                    std::function<void(const Json::Value&, const std::string&)> callback);
+                                    std::function<void(const std::string&, const Json::Value&, const std::string&)> callback);
+
+    // Niveaux de grille du clustering SQL (1° à 0.001°, du plus grossier au plus fin)
+    static constexpr int CLUSTER_GRID_LEVELS = 5;
+    static double gridSizeForLevel(int level);
+    // Niveau de grille fixe associé à un zoom
+    static int gridLevelForZoom(int zoom);
+
+    /**
+     * Membres d'un cluster de grille (cluster_id "g<niveau>.<gx>.<gy>"), paginés par id
+     *
+     * @param gridLevel, gx, gy - Niveau de grille et indices de cellule du cluster_id
+     * @param status, technology, operator_id - Mêmes filtres que la requête de clustering
+     * @param offset, limit - Pagination
+     * @param callback - Retourne {offset, limit, total, leaves[]} ou erreur
+     */
+    static void getGridClusterLeaves(int gridLevel, long long gx, long long gy,
+                                     const std::string& status, const std::string& technology, int operator_id,
+                                     int offset, int limit,
+                                     std::function<void(const Json::Value&, const std::string&)> callback);
+
+    // ========== TUILES VECTORIELLES (MVT) ==========
+    /**
+     * Tuile Mapbox Vector Tile z/x/y des antennes regroupées (repli SQL de l'index en mémoire)
+     *
+     * Regroupement ST_SnapToGrid en Web Mercator (cellule de 64 px au zoom z),
+     * encodage ST_AsMVTGeom + ST_AsMVT, couche "antennas"
+     *
+     * @param z, x, y - Coordonnées de tuile XYZ
+     * @param status, technology, operator_id - Filtres optionnels (vide / -1 = tous)
+     * @param callback - Retourne la tuile encodée (vide si aucune antenne) ou erreur
+     */
+    static void getClusterTile(int z, int x, int y, const std::string& status,
+                               const std::string& technology, int operator_id,
+                               std::function<void(const std::string&, const std::string&)> callback);
 
     // ========== SIMPLIFIED COVERAGE (Sprint 4 Performance + Filtres) ==========
     /**
-     * Calcul ultra-optimisé de la zone de couverture totale
-     * Utilise ST_Union + ST_Simplify pour une navigation fluide
+     * Zone de couverture totale d'une bbox, assemblée à partir des tuiles matérialisées
+     * (union des empreintes par tuile et par filtre, cf. coverage_tile) : OU de leurs
+     * masques à la résolution du zoom, tracé et simplifié en C++, par blocs alignés
+     * mis en cache séparément (cf. coverageBlockSpan)
      *
      * @param minLat, minLon, maxLat, maxLon - Bounding box de la vue
-     * @param zoom - Niveau de zoom pour ajuster la simplification
+     * @param zoom - Niveau de zoom pour ajuster la résolution d'assemblage
      * @param operator_id - Filtre optionnel par opérateur (0 = tous)
      * @param technology - Filtre optionnel par technologie ("" = toutes)
-     * @param callback - Retourne GeoJSON simplifié ou erreur
+     * @param callback - Retourne le GeoJSON simplifié (features sérialisées une fois,
+     *                   sans reparsing), ses métadonnées (blocs en cache) ou erreur
      */
     static void getSimplifiedCoverage(double minLat, double minLon, double maxLat, double maxLon, int zoom,
                                      int operator_id, const std::string& technology,
-                                     std::function<void(const Json::Value&, const std::string&)> callback);
+                                     std::function<void(const std::string&, const Json::Value&, const std::string&)> callback);
+
+    // Côté d'un bloc de couverture en tuiles de couverture (~ une tuile XYZ du zoom, au moins 1)
+    static int coverageBlockSpan(int zoom);
+
+    // Blocs (bx, by) d'un zoom qui contiennent au moins une de ces tuiles de couverture
+    static std::vector<std::pair<int, int>> coverageBlocksTouching(int zoom, const std::vector<std::pair<int, int>>& tiles);
+
+    // Préchauffage : calcule et met en cache les blocs (bx, by) absents du cache pour un
+    // zoom et un filtre ; retourne le nombre de blocs calculés
+    static void warmCoverageBlocks(int zoom, const std::vector<std::pair<int, int>>& blocks,
+                                   int operator_id, const std::string& technology,
+                                   std::function<void(int, const std::string&)> callback);
+
+    // Tuiles de couverture : grille XYZ de zoom fixe (doit rester égal à celui de la migration 006)
+    static constexpr int COVERAGE_TILE_ZOOM = 10;
+    struct TileRange { int minX, minY, maxX, maxY; };
+    // Tuiles touchées par une bbox (aussi la clé de cache : indépendante des décimales de la bbox)
+    static TileRange coverageTileRange(double minLat, double minLon, double maxLat, double maxLon);
+
+    // Recalcul périodique des tuiles marquées par les triggers (custom_config.coverage_tiles)
+    static void scheduleCoverageTileRefresh();
+
+    // ========== SNAPSHOT EN MÉMOIRE (traitements batch) ==========
+    /**
+     * Charge toutes les antennes (coordonnées + attributs radio) pour les calculs en mémoire
+     *
+     * @param activeOnly - true pour ne garder que les antennes au statut 'active'
+     * @param callback - Retourne la liste des antennes ou erreur
+     */
+    static void getAllAntennas(bool activeOnly,
+                               std::function<void(const std::vector<Antenna>&, const std::string&)> callback);
+
+    // ========== SYNCHRONISATION DELTA (journal antenna_change_log) ==========
+    /**
+     * Antennes insérées, modifiées ou supprimées depuis une version des données
+     *
+     * Une antenne modifiée plusieurs fois n'apparaît qu'une fois, avec son état courant.
+     * Avec une bbox, une antenne sortie de la bbox est rapportée comme supprimée.
+     *
+     * @param since - Version connue du client (0 = jamais synchronisé)
+     * @param hasBbox, minLat, minLon, maxLat, maxLon - Restriction géographique optionnelle
+     * @param limit - Nombre d'entrées du journal visé par page (une version n'est jamais coupée)
+     * @param callback - Retourne {since, version, current_version, has_more, upserted[], deleted[]},
+     *                   ou {resync_required: true, current_version} si le journal ne couvre plus
+     *                   'since' (purgé, ou version inconnue), ou erreur
+     */
+    static void getChanges(long long since, bool hasBbox,
+                           double minLat, double minLon, double maxLat, double maxLon, int limit,
+                           std::function<void(const Json::Value&, const std::string&)> callback);
+
+    // Purge périodique du journal au-delà de la rétention (custom_config.change_log)
+    static void scheduleChangeLogPrune();
 };
\ No newline at end of file
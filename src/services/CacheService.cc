@@ -1,7 +1,11 @@
 #include "CacheService.h"
 #include <drogon/drogon.h>
+#include <drogon/utils/Utilities.h>
 #include <thread>
 #include <chrono>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 
 using namespace drogon;
 
@@ -68,6 +72,144 @@ std::optional<std::string> CacheService::get(const std::string& key) {
     return std::nullopt;
 }
 
+std::vector<std::optional<std::string>> CacheService::mget(const std::vector<std::string>& keys) {
+    std::vector<std::optional<std::string>> result(keys.size());
+    if (!redis_ || keys.empty()) return result;
+    try {
+        std::vector<OptionalString> values;
+        values.reserve(keys.size());
+        redis_->mget(keys.begin(), keys.end(), std::back_inserter(values));
+        for (size_t i = 0; i < values.size() && i < result.size(); ++i) {
+            if (values[i]) result[i] = *values[i];
+        }
+    } catch (const Error& e) {
+        LOG_WARN << "Redis MGET error (" << keys.size() << " keys): " << e.what();
+    }
+    return result;
+}
+
+void CacheService::mset(const std::vector<std::pair<std::string, std::string>>& entries, int ttl_seconds) {
+    if (!redis_ || entries.empty()) return;
+    try {
+        // SET ... EX par clé dans un pipeline : MSET ne gère pas de TTL (ttl <= 0 : sans expiration)
+        auto pipe = redis_->pipeline();
+        for (const auto& [key, value] : entries) {
+            if (ttl_seconds > 0) {
+                pipe.set(key, value, std::chrono::seconds(ttl_seconds));
+            } else {
+                pipe.set(key, value);
+            }
+        }
+        pipe.exec();
+    } catch (const Error& e) {
+        LOG_WARN << "Redis MSET error (" << entries.size() << " keys): " << e.what();
+    }
+}
+
+// ============================================================================
+// ENTRÉES PRÉCOMPRESSÉES
+// ============================================================================
+// Stockage : "<encodage>\n<octets>" sous une seule clé (une lecture Redis par hit)
+namespace {
+    // En dessous, l'en-tête gzip / brotli et la décompression coûtent plus qu'ils ne rapportent
+    constexpr size_t MIN_COMPRESS_SIZE = 1024;
+
+    std::string trim(const std::string& s) {
+        size_t b = 0, e = s.size();
+        while (b < e && std::isspace(static_cast<unsigned char>(s[b]))) ++b;
+        while (e > b && std::isspace(static_cast<unsigned char>(s[e - 1]))) --e;
+        return s.substr(b, e - b);
+    }
+}
+
+CacheService::CompressedEntry CacheService::compress(const std::string& value) {
+    if (value.size() >= MIN_COMPRESS_SIZE) {
+#ifdef USE_BROTLI
+        std::string br = drogon::utils::brotliCompress(value.data(), value.size());
+        if (!br.empty() && br.size() < value.size()) return {"br", std::move(br)};
+#endif
+        std::string gz = drogon::utils::gzipCompress(value.data(), value.size());
+        if (!gz.empty() && gz.size() < value.size()) return {"gzip", std::move(gz)};
+    }
+    return {"identity", value};
+}
+
+std::string CacheService::CompressedEntry::decompressed() const {
+#ifdef USE_BROTLI
+    if (encoding == "br") return drogon::utils::brotliDecompress(body.data(), body.size());
+#endif
+    if (encoding == "gzip") return drogon::utils::gzipDecompress(body.data(), body.size());
+    return body;
+}
+
+bool CacheService::accepts(const std::string& acceptEncoding, const std::string& encoding) {
+    if (encoding == "identity") return true;
+
+    // Le codage nommé prime sur "*" quel que soit l'ordre ("*;q=0, gzip" accepte gzip)
+    bool wildcard = false;
+    bool wildcardAccepted = false;
+    size_t pos = 0;
+    while (pos <= acceptEncoding.size()) {
+        size_t comma = acceptEncoding.find(',', pos);
+        if (comma == std::string::npos) comma = acceptEncoding.size();
+        std::string item = acceptEncoding.substr(pos, comma - pos);
+        pos = comma + 1;
+
+        size_t semi = item.find(';');
+        std::string coding = trim(item.substr(0, semi));
+        if (coding != encoding && coding != "*") continue;
+
+        // "gzip;q=0" : refus explicite
+        bool accepted = true;
+        if (semi != std::string::npos) {
+            std::string param = trim(item.substr(semi + 1));
+            if (param.rfind("q=", 0) == 0 && std::strtod(param.c_str() + 2, nullptr) <= 0.0) accepted = false;
+        }
+        if (coding == encoding) return accepted;
+        wildcard = true;
+        wildcardAccepted = accepted;
+    }
+    return wildcard && wildcardAccepted;
+}
+
+drogon::HttpResponsePtr CacheService::encodedResponse(const drogon::HttpRequestPtr& req,
+                                                      const CompressedEntry& entry,
+                                                      const std::string& contentType) {
+    auto resp = drogon::HttpResponse::newHttpResponse();
+    if (accepts(req->getHeader("Accept-Encoding"), entry.encoding)) {
+        resp->setBody(entry.body);
+        if (entry.encoding != "identity") resp->addHeader("Content-Encoding", entry.encoding);
+    } else {
+        resp->setBody(entry.decompressed());
+    }
+    resp->setContentTypeString(contentType);
+    resp->addHeader("Vary", "Accept-Encoding");
+    return resp;
+}
+
+void CacheService::setCompressed(const std::string& key, const CompressedEntry& entry, int ttl_seconds) {
+    std::string value;
+    value.reserve(entry.encoding.size() + 1 + entry.body.size());
+    value += entry.encoding;
+    value += '\n';
+    value += entry.body;
+    set(key, value, ttl_seconds);
+}
+
+std::optional<CacheService::CompressedEntry> CacheService::getCompressed(const std::string& key) {
+    auto cached = get(key);
+    if (!cached) return std::nullopt;
+
+    // Entrée écrite par set() (ancien format) : traitée comme absente, elle sera réécrite
+    size_t nl = cached->find('\n');
+    std::string encoding = nl == std::string::npos ? "" : cached->substr(0, nl);
+    if (encoding != "identity" && encoding != "gzip" && encoding != "br") {
+        LOG_WARN << "Malformed compressed cache entry for key '" << key << "'";
+        return std::nullopt;
+    }
+    return CompressedEntry{std::move(encoding), cached->substr(nl + 1)};
+}
+
 void CacheService::setJson(const std::string& key, const Json::Value& data, int ttl_seconds) {
     Json::StreamWriterBuilder builder;
     builder["indentation"] = "";
@@ -101,6 +243,29 @@ void CacheService::del(const std::string& key) {
     }
 }
 
+void CacheService::del(const std::vector<std::string>& keys) {
+    if (!redis_ || keys.empty()) return;
+    constexpr size_t BATCH = 1000;
+    try {
+        for (size_t i = 0; i < keys.size(); i += BATCH) {
+            auto last = keys.begin() + std::min(keys.size(), i + BATCH);
+            redis_->del(keys.begin() + i, last);
+        }
+    } catch (const Error& e) {
+        LOG_WARN << "Redis DEL error (" << keys.size() << " keys): " << e.what();
+    }
+}
+
+long long CacheService::incr(const std::string& key) {
+    if (!redis_) return 0;
+    try {
+        return redis_->incr(key);
+    } catch (const Error& e) {
+        LOG_WARN << "Redis INCR error for key '" << key << "': " << e.what();
+        return 0;
+    }
+}
+
 void CacheService::delPattern(const std::string& pattern) {
     if (!redis_) return;
     try {
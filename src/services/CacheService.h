@@ -2,6 +2,8 @@
 #include <string>
 #include <optional>
 #include <memory>
+#include <utility>
+#include <vector>
 #include <sw/redis++/redis++.h>
 #include <json/json.h>
 #include <drogon/drogon.h>
@@ -29,8 +31,37 @@ public:
     void set(const std::string& key, const std::string& value, int ttl_seconds = 300);
     std::optional<std::string> get(const std::string& key);
     void del(const std::string& key);
+    // Suppression groupée (DEL par paquets de clés)
+    void del(const std::vector<std::string>& keys);
+    // Compteur atomique partagé entre instances ; 0 si Redis est indisponible
+    long long incr(const std::string& key);
+
+    // Lecture / écriture groupées (un aller-retour Redis) ; nullopt = clé absente
+    std::vector<std::optional<std::string>> mget(const std::vector<std::string>& keys);
+    void mset(const std::vector<std::pair<std::string, std::string>>& entries, int ttl_seconds = 300);
     void delPattern(const std::string& pattern);
     
+    // Entrées précompressées : compressées une fois au remplissage, servies telles quelles
+    // (Content-Encoding) à chaque hit au lieu d'être recompressées par la couche HTTP
+    struct CompressedEntry {
+        std::string encoding;   // "br", "gzip" ou "identity" (corps trop petit pour gagner à la compression)
+        std::string body;
+
+        // Corps d'origine, pour un client qui n'accepte pas l'encodage stocké
+        std::string decompressed() const;
+    };
+    static CompressedEntry compress(const std::string& value);
+    // Vrai si l'en-tête Accept-Encoding du client accepte cet encodage (q=0 exclu)
+    static bool accepts(const std::string& acceptEncoding, const std::string& encoding);
+
+    // Octets servis tels quels avec Content-Encoding si le client accepte l'encodage stocké,
+    // décompressés sinon
+    static drogon::HttpResponsePtr encodedResponse(const drogon::HttpRequestPtr& req, const CompressedEntry& entry,
+                                                   const std::string& contentType);
+
+    void setCompressed(const std::string& key, const CompressedEntry& entry, int ttl_seconds = 300);
+    std::optional<CompressedEntry> getCompressed(const std::string& key);
+
     // Cache JSON
     void setJson(const std::string& key, const Json::Value& data, int ttl_seconds = 300);
     std::optional<Json::Value> getJson(const std::string& key);
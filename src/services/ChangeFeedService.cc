@@ -0,0 +1,428 @@
+#include "ChangeFeedService.h"
+#include "SignalCacheService.h"
+#include "SimulationService.h"
+#include "../models/Antenne.h"
+#include "../utils/ErrorHandler.h"
+#include "../utils/Parallel.h"
+
+#include <drogon/orm/DbListener.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace {
+    const char* CHANNEL = "antenna_changes";
+
+    struct Subscriber {
+        ChangeFeedService::Subscription subscription;
+        // Changements en attente du prochain lot, coalescés par antenne
+        std::map<int, Json::Value> upserted;
+        std::set<int> deleted;
+        double extent[4] = {0, 0, 0, 0};  // minLon, minLat, maxLon, maxLat des positions touchées
+        bool hasExtent = false;
+        bool overflow = false;            // Trop de changements : le client doit recharger sa vue
+    };
+
+    // Antenne touchée par une page du journal : état courant + positions journalisées
+    struct Change {
+        int id;
+        bool present;
+        Antenna antenna;
+        std::vector<std::pair<double, double>> positions;
+    };
+
+    // Paramètres lus au démarrage (custom_config.change_feed)
+    bool enabled = false;
+    size_t maxPending = 5000;
+    int pageSize = 5000;
+
+    std::mutex feedMutex;
+    std::map<WebSocketConnectionPtr, Subscriber> subscribers;
+    long long lastVersion = -1;   // -1 : pas encore lue
+    DbListenerPtr listener;
+
+    std::atomic<bool> fetching{false};
+    std::atomic<bool> fetchAgain{false};
+    std::atomic<uint64_t> notifications{0};
+    std::atomic<uint64_t> batches{0};
+    std::atomic<uint64_t> resyncs{0};
+
+    bool inBox(const ChangeFeedService::Subscription& s, double lon, double lat) {
+        return lon >= s.minLon && lon <= s.maxLon && lat >= s.minLat && lat <= s.maxLat;
+    }
+
+    bool matches(const ChangeFeedService::Subscription& s, const Antenna& a) {
+        return (s.status.empty() || a.status == s.status) &&
+               (s.technology.empty() || a.technology == s.technology) &&
+               (s.operator_id < 0 || a.operator_id == s.operator_id);
+    }
+
+    void grow(Subscriber& sub, double lon, double lat) {
+        if (!sub.hasExtent) {
+            sub.extent[0] = sub.extent[2] = lon;
+            sub.extent[1] = sub.extent[3] = lat;
+            sub.hasExtent = true;
+            return;
+        }
+        sub.extent[0] = std::min(sub.extent[0], lon);
+        sub.extent[1] = std::min(sub.extent[1], lat);
+        sub.extent[2] = std::max(sub.extent[2], lon);
+        sub.extent[3] = std::max(sub.extent[3], lat);
+    }
+
+    // "lon lat,lon lat,..." (string_agg côté SQL)
+    std::vector<std::pair<double, double>> parsePositions(const std::string& text) {
+        std::vector<std::pair<double, double>> out;
+        const char* p = text.c_str();
+        while (*p) {
+            char* end = nullptr;
+            double lon = std::strtod(p, &end);
+            if (end == p) break;
+            p = end;
+            double lat = std::strtod(p, &end);
+            if (end == p) break;
+            out.emplace_back(lon, lat);
+            p = end;
+            if (*p == ',') ++p;
+        }
+        return out;
+    }
+
+    // Répartit une page de changements entre les abonnés (appelé sous feedMutex)
+    void dispatch(const std::vector<Change>& changes) {
+        for (auto& [conn, sub] : subscribers) {
+            if (sub.overflow) continue;
+            const auto& s = sub.subscription;
+
+            for (const auto& c : changes) {
+                bool touched = false;
+                for (const auto& [lon, lat] : c.positions) {
+                    if (inBox(s, lon, lat)) {
+                        touched = true;
+                        grow(sub, lon, lat);
+                    }
+                }
+                bool visible = c.present && inBox(s, c.antenna.longitude, c.antenna.latitude) && matches(s, c.antenna);
+                if (visible) {
+                    sub.upserted[c.id] = c.antenna.toJson();
+                    sub.deleted.erase(c.id);
+                } else if (touched) {
+                    // Supprimée, sortie de la bbox ou ne correspondant plus aux filtres
+                    sub.upserted.erase(c.id);
+                    sub.deleted.insert(c.id);
+                }
+            }
+
+            if (sub.upserted.size() + sub.deleted.size() > maxPending) {
+                sub.overflow = true;
+                sub.upserted.clear();
+                sub.deleted.clear();
+            }
+        }
+    }
+
+    // Tous les abonnés rechargent leur vue (journal purgé au-delà de la dernière version diffusée)
+    void resyncAll() {
+        for (auto& [conn, sub] : subscribers) {
+            sub.overflow = true;
+            sub.upserted.clear();
+            sub.deleted.clear();
+        }
+    }
+
+    /**
+     * Simulations de signal périmées par une page de changements : cellules à moins
+     * du rayon de recherche de chaque position journalisée (ancienne et nouvelle).
+     * Journal purgé (resync) : tout le cache. Purges Redis hors du thread de la base.
+     */
+    void invalidateSignalCache(const std::vector<Change>& changes, bool resync) {
+        std::vector<std::pair<double, double>> positions;
+        if (!resync) {
+            for (const auto& c : changes) {
+                positions.insert(positions.end(), c.positions.begin(), c.positions.end());
+            }
+            if (positions.empty()) return;
+        }
+        Parallel::runInBackground([positions = std::move(positions), resync]() {
+            auto& cache = SignalCacheService::getInstance();
+            if (resync) {
+                cache.invalidateAll();
+            } else {
+                cache.invalidateAround(positions, SimulationService::SEARCH_RADIUS_M);
+            }
+        });
+    }
+
+    void fetchChanges();
+
+    void fetchDone(bool more) {
+        if (more) fetchAgain = true;
+        fetching = false;
+        if (fetchAgain.load()) fetchChanges();
+    }
+
+    /**
+     * Relit le journal depuis la dernière version diffusée (une page à la fois)
+     *
+     * Une seule lecture en vol : une notification reçue pendant la lecture
+     * déclenche une relecture à la fin, sans requêtes concurrentes.
+     * fetchAgain est posé avant le test de fetching et consommé par la lecture
+     * qui démarre : une demande arrivée pendant que la lecture en cours se
+     * termine est reprise par fetchDone ou par l'appelant, jamais perdue.
+     */
+    void fetchChanges() {
+        fetchAgain = true;
+        if (fetching.exchange(true)) return;
+        fetchAgain = false;
+
+        long long since;
+        {
+            std::lock_guard<std::mutex> lock(feedMutex);
+            since = lastVersion;
+        }
+
+        // Première lecture : seulement la version courante (pas d'historique à diffuser)
+        if (since < 0) {
+            app().getDbClient()->execSqlAsync(
+                "SELECT version FROM antenna_data_version",
+                [](const Result& r) {
+                    if (!r.empty()) {
+                        std::lock_guard<std::mutex> lock(feedMutex);
+                        lastVersion = r[0]["version"].as<long long>();
+                    }
+                    fetchDone(false);
+                },
+                [](const DrogonDbException& e) {
+                    auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+                    ErrorHandler::logError("ChangeFeedService::fetchChanges", errorDetails);
+                    fetchDone(false);
+                });
+            return;
+        }
+
+        // Même pagination que AntenneService::getChanges, avec toutes les positions
+        // journalisées de chaque antenne (ancienne et nouvelle) pour le filtrage par bbox
+        std::string sql = R"(
+            WITH state AS (
+                SELECT version, pruned_through FROM antenna_data_version
+            ),
+            bound AS (
+                SELECT CASE
+                    WHEN nxt.version IS NULL THEN (SELECT version FROM state)
+                    ELSE GREATEST(nxt.version - 1, $1 + 1)
+                END AS upto
+                FROM (
+                    SELECT (
+                        SELECT version FROM antenna_change_log
+                        WHERE version > $1 ORDER BY version OFFSET $2 LIMIT 1
+                    ) AS version
+                ) nxt
+            ),
+            touched AS (
+                SELECT l.antenna_id,
+                       string_agg(ST_X(p.g)::text || ' ' || ST_Y(p.g)::text, ',') AS positions
+                FROM antenna_change_log l
+                CROSS JOIN bound
+                CROSS JOIN LATERAL (VALUES (l.geom), (l.old_geom)) AS p(g)
+                WHERE l.version > $1 AND l.version <= bound.upto AND p.g IS NOT NULL
+                GROUP BY l.antenna_id
+            )
+            SELECT
+                state.version AS current_version,
+                state.pruned_through,
+                LEAST(bound.upto, state.version) AS upto,
+                t.antenna_id,
+                t.positions,
+                a.id IS NOT NULL AS present,
+                a.coverage_radius,
+                a.status::text AS status,
+                a.technology::text AS technology,
+                a.operator_id,
+                o.name AS operator_name,
+                ST_X(a.geom) AS longitude,
+                ST_Y(a.geom) AS latitude
+            FROM state
+            CROSS JOIN bound
+            LEFT JOIN (
+                touched t
+                LEFT JOIN antenna a ON a.id = t.antenna_id
+                LEFT JOIN operator o ON o.id = a.operator_id
+            ) ON TRUE
+        )";
+
+        app().getDbClient()->execSqlAsync(sql,
+            [since](const Result& r) {
+                if (r.empty()) {
+                    fetchDone(false);
+                    return;
+                }
+                long long current = r[0]["current_version"].as<long long>();
+                long long pruned = r[0]["pruned_through"].as<long long>();
+                long long upto = std::max(since, r[0]["upto"].as<long long>());
+
+                std::vector<Change> changes;
+                changes.reserve(r.size());
+                for (auto row : r) {
+                    if (row["antenna_id"].isNull()) continue;
+                    Change c;
+                    c.id = row["antenna_id"].as<int>();
+                    c.present = row["present"].as<bool>();
+                    c.positions = parsePositions(row["positions"].as<std::string>());
+                    if (c.present) {
+                        Antenna& a = c.antenna;
+                        a.id = c.id;
+                        a.coverage_radius = row["coverage_radius"].as<double>();
+                        a.status = row["status"].as<std::string>();
+                        a.technology = row["technology"].as<std::string>();
+                        a.operator_id = row["operator_id"].isNull() ? 0 : row["operator_id"].as<int>();
+                        a.operatorName = row["operator_name"].isNull() ? "" : row["operator_name"].as<std::string>();
+                        a.longitude = row["longitude"].as<double>();
+                        a.latitude = row["latitude"].as<double>();
+                    }
+                    changes.push_back(std::move(c));
+                }
+
+                bool more = false;
+                bool resync = false;
+                {
+                    std::lock_guard<std::mutex> lock(feedMutex);
+                    if (since < pruned || since > current) {
+                        if (enabled) resyncAll();
+                        lastVersion = current;
+                        resync = true;
+                    } else {
+                        if (enabled) dispatch(changes);
+                        lastVersion = upto;
+                        more = upto < current;
+                    }
+                }
+                invalidateSignalCache(changes, resync);
+                fetchDone(more);
+            },
+            [](const DrogonDbException& e) {
+                auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+                ErrorHandler::logError("ChangeFeedService::fetchChanges", errorDetails);
+                fetchDone(false);
+            },
+            since, pageSize);
+    }
+
+    // Envoie à chaque abonné ses changements en attente (un message par abonné et par lot)
+    void flush() {
+        std::vector<std::pair<WebSocketConnectionPtr, std::string>> outgoing;
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+        {
+            std::lock_guard<std::mutex> lock(feedMutex);
+            for (auto& [conn, sub] : subscribers) {
+                Json::Value msg;
+                if (sub.overflow) {
+                    msg["type"] = "resync";
+                    msg["version"] = static_cast<Json::Int64>(lastVersion);
+                    sub.overflow = false;
+                    resyncs++;
+                } else if (!sub.upserted.empty() || !sub.deleted.empty()) {
+                    msg["type"] = "changes";
+                    msg["version"] = static_cast<Json::Int64>(lastVersion);
+                    Json::Value upserted(Json::arrayValue);
+                    for (auto& [id, antenna] : sub.upserted) upserted.append(std::move(antenna));
+                    Json::Value deleted(Json::arrayValue);
+                    for (int id : sub.deleted) deleted.append(id);
+                    msg["upserted"] = upserted;
+                    msg["deleted"] = deleted;
+                    // Emprise des positions touchées : zone de couverture à rafraîchir
+                    if (sub.hasExtent) {
+                        for (double v : sub.extent) msg["changed_extent"].append(v);
+                    }
+                    sub.upserted.clear();
+                    sub.deleted.clear();
+                    sub.hasExtent = false;
+                } else {
+                    continue;
+                }
+                outgoing.emplace_back(conn, Json::writeString(builder, msg));
+            }
+        }
+        for (auto& [conn, text] : outgoing) {
+            if (conn->connected()) conn->send(text);
+        }
+        if (!outgoing.empty()) batches += outgoing.size();
+    }
+}
+
+// ============================================================================
+// DÉMARRAGE
+// ============================================================================
+void ChangeFeedService::start() {
+    const auto& config = app().getCustomConfig()["change_feed"];
+    enabled = config.get("enabled", true).asBool();
+
+    maxPending = std::max(1u, config.get("max_pending", 5000).asUInt());
+    pageSize = std::max(1, config.get("page_size", 5000).asInt());
+    double batchInterval = std::max(50, config.get("batch_interval_ms", 500).asInt()) / 1000.0;
+    double pollInterval = config.get("fallback_poll_s", 30.0).asDouble();
+
+    listener = DbListener::newPgListener(app().getDbClient()->connectionInfo(), app().getLoop());
+    if (listener) {
+        listener->listen(CHANNEL, [](std::string) {
+            notifications++;
+            fetchChanges();
+        });
+    } else {
+        LOG_WARN << "⚠️ Change feed: LISTEN unavailable, falling back to polling";
+    }
+
+    // Le journal est lu même sans diffusion : c'est lui qui invalide le cache de signal
+    // (les antennes sont écrites directement en base, sans passer par l'API)
+    fetchChanges();
+    // Secours si une notification est perdue (reconnexion de l'écouteur)
+    if (pollInterval > 0) {
+        app().getLoop()->runEvery(pollInterval, []() { fetchChanges(); });
+    }
+    if (!enabled) {
+        LOG_INFO << "📣 Change feed broadcast disabled (journal read for signal cache invalidation only)";
+        return;
+    }
+    app().getLoop()->runEvery(batchInterval, []() { flush(); });
+    LOG_INFO << "📣 Change feed enabled (LISTEN " << CHANNEL << ", batches every "
+             << batchInterval * 1000 << " ms)";
+}
+
+// ============================================================================
+// ABONNEMENTS
+// ============================================================================
+long long ChangeFeedService::subscribe(const WebSocketConnectionPtr& conn, const Subscription& subscription) {
+    std::lock_guard<std::mutex> lock(feedMutex);
+    // Changements en attente de l'ancienne bbox abandonnés : le client recharge sa nouvelle vue
+    Subscriber& sub = subscribers[conn];
+    sub = Subscriber();
+    sub.subscription = subscription;
+    return lastVersion;
+}
+
+void ChangeFeedService::unsubscribe(const WebSocketConnectionPtr& conn) {
+    std::lock_guard<std::mutex> lock(feedMutex);
+    subscribers.erase(conn);
+}
+
+Json::Value ChangeFeedService::getStatus() {
+    Json::Value status;
+    status["enabled"] = enabled;
+    status["listening"] = listener != nullptr;
+    status["notifications"] = static_cast<Json::UInt64>(notifications.load());
+    status["batches_sent"] = static_cast<Json::UInt64>(batches.load());
+    status["resyncs"] = static_cast<Json::UInt64>(resyncs.load());
+
+    std::lock_guard<std::mutex> lock(feedMutex);
+    status["version"] = static_cast<Json::Int64>(lastVersion);
+    status["subscribers"] = static_cast<Json::UInt64>(subscribers.size());
+    return status;
+}
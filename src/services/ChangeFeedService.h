@@ -0,0 +1,40 @@
+#pragma once
+#include <drogon/drogon.h>
+#include <drogon/WebSocketController.h>
+#include <string>
+
+/**
+ * Diffusion des modifications d'antennes aux clients WebSocket (/ws/antennas)
+ *
+ * Remplace le sondage périodique de /api/antennas/clustered par les tableaux de bord :
+ * - LISTEN antenna_changes : notification émise au COMMIT par le trigger de
+ *   antenna_data_version (migration 005), charge utile = nouvelle version
+ * - Les changements sont relus dans antenna_change_log depuis la dernière version
+ *   diffusée : des notifications regroupées ou perdues ne font perdre aucun changement
+ * - Par abonné (bbox + filtres) : changements coalescés par antenne, envoyés par lots
+ * - Chaque page relue invalide aussi le cache des simulations de signal autour
+ *   des positions touchées (SignalCacheService), abonnés ou non ; le journal est
+ *   lu même avec enabled=false (seuls les lots WebSocket sont coupés)
+ */
+class ChangeFeedService {
+public:
+    struct Subscription {
+        double minLat = 0;
+        double minLon = 0;
+        double maxLat = 0;
+        double maxLon = 0;
+        std::string status;        // Vide = tous
+        std::string technology;    // Vide = toutes
+        int operator_id = -1;      // -1 = tous
+    };
+
+    // LISTEN + sondage de secours, lots périodiques si enabled (custom_config.change_feed)
+    static void start();
+
+    // Remplace l'abonnement de la connexion (déplacement de la carte) ; retourne la version courante
+    static long long subscribe(const drogon::WebSocketConnectionPtr& conn, const Subscription& subscription);
+    static void unsubscribe(const drogon::WebSocketConnectionPtr& conn);
+
+    // Abonnés, version diffusée, notifications reçues, lots envoyés (pour monitoring)
+    static Json::Value getStatus();
+};
@@ -0,0 +1,552 @@
+#include "ClusterIndexService.h"
+#include "AntenneService.h"
+#include "CacheService.h"
+#include "../utils/ClusterBinaryEncoder.h"
+#include "../utils/ClusterPyramid.h"
+#include "../utils/DensityHistogram.h"
+#include "../utils/LeafCounts.h"
+#include "../utils/MvtEncoder.h"
+#include "../utils/ErrorHandler.h"
+#include "../utils/Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace {
+    struct Filter {
+        std::string status;
+        std::string technology;
+        int operator_id = -1;
+
+        std::string key() const {
+            return "st:" + (status.empty() ? "*" : status) +
+                   "|tech:" + (technology.empty() ? "*" : technology) +
+                   "|op:" + (operator_id >= 0 ? std::to_string(operator_id) : "*");
+        }
+
+        bool matches(const Antenna& a) const {
+            return (status.empty() || a.status == status) &&
+                   (technology.empty() || a.technology == technology) &&
+                   (operator_id < 0 || a.operator_id == operator_id);
+        }
+    };
+
+    struct Snapshot {
+        std::string version;
+        std::vector<Antenna> antennas;
+        std::string loadedAt;
+        // Cellules occupées par niveau de grille SQL (mode adaptatif du repli SQL)
+        std::shared_ptr<const DensityHistogram> density;
+    };
+
+    struct IndexEntry {
+        Filter filter;
+        std::shared_ptr<const ClusterPyramid> pyramid;
+        std::shared_ptr<const LeafCounts> counts;
+        std::chrono::steady_clock::time_point lastUsed;
+    };
+
+    // Paramètres lus au démarrage (custom_config.cluster_index)
+    bool enabled = false;
+    int maxZoom = 16;
+    double radiusPx = 60.0;
+    size_t maxIndexes = 32;
+    size_t adaptiveBudget = 500;
+
+    std::mutex stateMutex;
+    std::shared_ptr<const Snapshot> snapshot;
+    std::map<std::string, IndexEntry> indexes;
+    std::set<std::string> pending;
+
+    std::atomic<bool> reloading{false};
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> fallbacks{0};
+    std::atomic<uint64_t> reloads{0};
+
+    // Pyramide du filtre + répartitions précalculées de ses nœuds
+    IndexEntry buildIndex(const Snapshot& snap, const Filter& filter) {
+        std::vector<ClusterPyramid::Input> points;
+        points.reserve(snap.antennas.size());
+        for (size_t i = 0; i < snap.antennas.size(); ++i) {
+            const auto& a = snap.antennas[i];
+            if (filter.matches(a)) {
+                points.push_back({a.longitude, a.latitude, a.coverage_radius, static_cast<uint32_t>(i)});
+            }
+        }
+        IndexEntry entry;
+        entry.filter = filter;
+        entry.pyramid = std::make_shared<const ClusterPyramid>(points, maxZoom, radiusPx);
+        const ClusterPyramid& pyramid = *entry.pyramid;
+        entry.counts = std::make_shared<const LeafCounts>(pyramid.pointCount(), [&](uint32_t k) -> const Antenna& {
+            return snap.antennas[pyramid.leaf(k)];
+        });
+        entry.lastUsed = std::chrono::steady_clock::now();
+        return entry;
+    }
+
+    // Appelé sous verrou : retire les index les moins récemment utilisés au-delà de maxIndexes
+    void evictLocked() {
+        while (indexes.size() > maxIndexes) {
+            auto oldest = indexes.begin();
+            for (auto it = indexes.begin(); it != indexes.end(); ++it) {
+                if (it->second.lastUsed < oldest->second.lastUsed) oldest = it;
+            }
+            indexes.erase(oldest);
+        }
+    }
+
+    void scheduleBuild(std::shared_ptr<const Snapshot> snap, const Filter& filter) {
+        Parallel::runInBackground([snap, filter]() {
+            auto entry = buildIndex(*snap, filter);
+            std::lock_guard<std::mutex> lock(stateMutex);
+            pending.erase(filter.key());
+            // Snapshot remplacé entre-temps : l'index est obsolète
+            if (snapshot != snap) return;
+            entry.lastUsed = std::chrono::steady_clock::now();
+            indexes[filter.key()] = entry;
+            evictLocked();
+            LOG_INFO << "🧭 Cluster index built for " << filter.key() << " (" << entry.pyramid->pointCount() << " antennas)";
+        });
+    }
+
+    void reload(const std::string& version) {
+        if (reloading.exchange(true)) return;
+
+        AntenneService::getAllAntennas(false,
+            [version](const std::vector<Antenna>& antennas, const std::string& err) {
+                if (!err.empty()) {
+                    LOG_ERROR << "Cluster index reload failed: " << err;
+                    reloading = false;
+                    return;
+                }
+
+                Parallel::runInBackground([version, antennas]() {
+                    auto startedAt = std::chrono::steady_clock::now();
+                    auto snap = std::make_shared<Snapshot>();
+                    snap->version = version;
+                    snap->antennas = antennas;
+                    snap->loadedAt = trantor::Date::now().toFormattedString(false);
+
+                    std::vector<std::pair<double, double>> positions;
+                    positions.reserve(antennas.size());
+                    for (const auto& a : antennas) positions.emplace_back(a.longitude, a.latitude);
+                    std::vector<double> cellSizes;
+                    for (int level = 0; level < AntenneService::CLUSTER_GRID_LEVELS; ++level) {
+                        cellSizes.push_back(AntenneService::gridSizeForLevel(level));
+                    }
+                    snap->density = std::make_shared<const DensityHistogram>(positions, cellSizes);
+
+                    // Reconstruction des filtres déjà en service + filtre sans restriction
+                    std::vector<Filter> filters = {Filter()};
+                    bool firstLoad;
+                    {
+                        std::lock_guard<std::mutex> lock(stateMutex);
+                        firstLoad = (snapshot == nullptr);
+                        for (const auto& [key, entry] : indexes) {
+                            if (key != filters[0].key()) filters.push_back(entry.filter);
+                        }
+                    }
+
+                    std::vector<IndexEntry> built(filters.size());
+                    Parallel::forRange(filters.size(), [&](size_t begin, size_t end) {
+                        for (size_t i = begin; i < end; ++i) built[i] = buildIndex(*snap, filters[i]);
+                    });
+
+                    {
+                        std::lock_guard<std::mutex> lock(stateMutex);
+                        std::map<std::string, IndexEntry> fresh;
+                        for (auto& entry : built) {
+                            fresh[entry.filter.key()] = std::move(entry);
+                        }
+                        snapshot = snap;
+                        indexes = std::move(fresh);
+                        pending.clear();
+                    }
+                    reloads++;
+                    reloading = false;
+
+                    // Les réponses SQL mises en cache décrivent l'ancienne version
+                    if (!firstLoad) {
+                        CacheService::getInstance().invalidateAntennaCache();
+                    }
+
+                    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - startedAt).count();
+                    LOG_INFO << "🧭 Cluster index loaded: " << antennas.size() << " antennas, "
+                             << filters.size() << " filter(s) in " << elapsed << " ms";
+                });
+            });
+    }
+
+    double round2(double v) {
+        return std::round(v * 100.0) / 100.0;
+    }
+
+    // Identifiant : niveau + début de la plage de feuilles + version des données
+    // (la même plage désigne un autre nœud après un rechargement)
+    std::string clusterId(int level, const ClusterPyramid::Node& node, const std::string& version) {
+        return "k" + std::to_string(level) + "." + std::to_string(node.leafBegin) + "." + version;
+    }
+
+    // Index du filtre s'il est prêt ; sinon construction planifiée et repli SQL
+    bool acquire(const Filter& filter,
+                 std::shared_ptr<const Snapshot>& snap,
+                 std::shared_ptr<const ClusterPyramid>& pyramid,
+                 std::shared_ptr<const LeafCounts>* counts = nullptr)
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (!snapshot) {
+            fallbacks++;
+            return false;
+        }
+        std::string key = filter.key();
+        auto it = indexes.find(key);
+        if (it == indexes.end()) {
+            if (pending.insert(key).second) {
+                scheduleBuild(snapshot, filter);
+            }
+            fallbacks++;
+            return false;
+        }
+        it->second.lastUsed = std::chrono::steady_clock::now();
+        snap = snapshot;
+        pyramid = it->second.pyramid;
+        if (counts) *counts = it->second.counts;
+        return true;
+    }
+}
+
+// ============================================================================
+// DÉMARRAGE
+// ============================================================================
+void ClusterIndexService::start() {
+    const auto& config = app().getCustomConfig()["cluster_index"];
+    enabled = config.get("enabled", true).asBool();
+    if (!enabled) return;
+
+    maxZoom = std::max(0, std::min(20, config.get("max_zoom", 16).asInt()));
+    radiusPx = config.get("radius_px", 60.0).asDouble();
+    maxIndexes = std::max(1u, config.get("max_indexes", 32).asUInt());
+    adaptiveBudget = std::max(10u, config.get("adaptive_budget", 500).asUInt());
+    double pollInterval = config.get("poll_interval_s", 30.0).asDouble();
+
+    checkVersion();
+    if (pollInterval > 0) {
+        app().getLoop()->runEvery(pollInterval, []() { checkVersion(); });
+    }
+    LOG_INFO << "🧭 Cluster index enabled (max zoom " << maxZoom << ", radius " << radiusPx
+             << " px, version poll every " << pollInterval << " s)";
+}
+
+// ============================================================================
+// VERSION DES DONNÉES
+// ============================================================================
+void ClusterIndexService::checkVersion() {
+    if (!enabled || reloading) return;
+
+    // Version tenue par les triggers du journal des modifications (migration 004) :
+    // lecture d'une ligne au lieu d'une somme de contrôle sur toute la table
+    std::string sql = "SELECT version::text AS version FROM antenna_data_version";
+
+    app().getDbClient()->execSqlAsync(sql,
+        [](const Result& r) {
+            std::string version = r.empty() ? "" : r[0]["version"].as<std::string>();
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                if (snapshot && snapshot->version == version) return;
+            }
+            reload(version);
+        },
+        [](const DrogonDbException& e) {
+            auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+            ErrorHandler::logError("ClusterIndexService::checkVersion", errorDetails);
+        });
+}
+
+// ============================================================================
+// REQUÊTE BBOX + ZOOM
+// ============================================================================
+bool ClusterIndexService::query(double minLat, double minLon, double maxLat, double maxLon, int zoom,
+                                const std::string& status, const std::string& technology, int operator_id,
+                                Json::Value& out)
+{
+    if (!enabled) return false;
+
+    std::shared_ptr<const Snapshot> snap;
+    std::shared_ptr<const ClusterPyramid> pyramid;
+    std::shared_ptr<const LeafCounts> counts;
+    if (!acquire(Filter{status, technology, operator_id}, snap, pyramid, &counts)) return false;
+
+    // ========== CONSTRUCTION DU GEOJSON (même format que ST_SnapToGrid) ==========
+    Json::Value features(Json::arrayValue);
+    int clusterCount = 0;
+    int singleCount = 0;
+
+    const int level = pyramid->levelFor(zoom);
+    pyramid->query(zoom, minLon, minLat, maxLon, maxLat, [&](const ClusterPyramid::Node& node) {
+        // Comptes agrégés plutôt que la liste des membres (cf. getLeaves)
+        LeafCounts::Breakdown b = counts->range(node.leafBegin, node.leafBegin + node.count);
+        Json::Value statusCounts(Json::objectValue), techCounts(Json::objectValue), operatorCounts(Json::objectValue);
+        for (const auto& [key, n] : b.status) statusCounts[key] = n;
+        for (const auto& [key, n] : b.technology) techCounts[key] = n;
+        for (const auto& [key, n] : b.op) operatorCounts[std::to_string(key)] = n;
+
+        Json::Value feature;
+        feature["type"] = "Feature";
+        feature["geometry"]["type"] = "Point";
+        feature["geometry"]["coordinates"].append(node.lon());
+        feature["geometry"]["coordinates"].append(node.lat());
+
+        Json::Value& props = feature["properties"];
+        props["cluster"] = node.isCluster();
+        props["cluster_id"] = clusterId(level, node, snap->version);
+        props["point_count"] = node.count;
+        props["antenna_id"] = node.isCluster() ? Json::Value() : Json::Value(snap->antennas[pyramid->leaf(node.leafBegin)].id);
+        props["avg_radius"] = round2(node.avgRadius());
+        props["status_counts"] = statusCounts;
+        props["technology_counts"] = techCounts;
+        props["operator_counts"] = operatorCounts;
+
+        if (node.isCluster()) clusterCount++; else singleCount++;
+        features.append(feature);
+    });
+
+    out = Json::Value(Json::objectValue);
+    out["type"] = "FeatureCollection";
+    out["features"] = features;
+    out["metadata"]["cluster_method"] = "kdtree_pyramid";
+    out["metadata"]["radius_px"] = pyramid->radiusPx();
+    out["metadata"]["zoom_level"] = zoom;
+    out["metadata"]["cluster_level"] = level;
+    out["metadata"]["data_version"] = snap->version;
+    out["metadata"]["total_features"] = clusterCount + singleCount;
+    out["metadata"]["clusters"] = clusterCount;
+    out["metadata"]["singles"] = singleCount;
+
+    hits++;
+    return true;
+}
+
+// ============================================================================
+// MODE ADAPTATIF (budget de features)
+// ============================================================================
+size_t ClusterIndexService::defaultBudget() {
+    return adaptiveBudget;
+}
+
+int ClusterIndexService::adaptiveZoom(double minLat, double minLon, double maxLat, double maxLon, int zoom, size_t budget,
+                                      const std::string& status, const std::string& technology, int operator_id)
+{
+    if (!enabled) return -1;
+
+    std::shared_ptr<const Snapshot> snap;
+    std::shared_ptr<const ClusterPyramid> pyramid;
+    if (!acquire(Filter{status, technology, operator_id}, snap, pyramid)) return -1;
+
+    // Du niveau demandé vers les plus grossiers : le premier qui tient dans le budget
+    for (int level = pyramid->levelFor(zoom); level > 0; --level) {
+        if (pyramid->count(level, minLon, minLat, maxLon, maxLat, budget) <= budget) return level;
+    }
+    return 0;
+}
+
+int ClusterIndexService::adaptiveGridLevel(double minLat, double minLon, double maxLat, double maxLon, size_t budget) {
+    std::shared_ptr<const Snapshot> snap;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        snap = snapshot;
+    }
+    if (!snap || !snap->density) return -1;
+    return snap->density->finestWithin(minLon, minLat, maxLon, maxLat, budget);
+}
+
+// ============================================================================
+// FORMAT BINAIRE COLONNAIRE
+// ============================================================================
+bool ClusterIndexService::queryBinary(double minLat, double minLon, double maxLat, double maxLon, int zoom,
+                                      const std::string& status, const std::string& technology, int operator_id,
+                                      std::string& out)
+{
+    if (!enabled) return false;
+
+    std::shared_ptr<const Snapshot> snap;
+    std::shared_ptr<const ClusterPyramid> pyramid;
+    std::shared_ptr<const LeafCounts> counts;
+    if (!acquire(Filter{status, technology, operator_id}, snap, pyramid, &counts)) return false;
+
+    ClusterBinaryEncoder encoder;
+    int clusterCount = 0;
+    const int level = pyramid->levelFor(zoom);
+
+    pyramid->query(zoom, minLon, minLat, maxLon, maxLat, [&](const ClusterPyramid::Node& node) {
+        int32_t antennaId = node.isCluster() ? 0 : snap->antennas[pyramid->leaf(node.leafBegin)].id;
+        encoder.addFeature(node.lon(), node.lat(), node.count, round2(node.avgRadius()), antennaId, node.leafBegin);
+
+        LeafCounts::Breakdown b = counts->range(node.leafBegin, node.leafBegin + node.count);
+        for (const auto& [key, n] : b.status) encoder.addStatusCount(key, n);
+        for (const auto& [key, n] : b.technology) encoder.addTechnologyCount(key, n);
+        for (const auto& [key, n] : b.op) encoder.addOperatorCount(key, n);
+        if (node.isCluster()) clusterCount++;
+    });
+
+    Json::Value metadata;
+    metadata["cluster_method"] = "kdtree_pyramid";
+    metadata["radius_px"] = pyramid->radiusPx();
+    metadata["zoom_level"] = zoom;
+    metadata["cluster_level"] = level;
+    metadata["data_version"] = snap->version;
+    metadata["total_features"] = static_cast<Json::UInt64>(encoder.featureCount());
+    metadata["clusters"] = clusterCount;
+    metadata["singles"] = static_cast<Json::UInt64>(encoder.featureCount() - clusterCount);
+    metadata["bbox"]["minLat"] = minLat;
+    metadata["bbox"]["minLon"] = minLon;
+    metadata["bbox"]["maxLat"] = maxLat;
+    metadata["bbox"]["maxLon"] = maxLon;
+
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    out = encoder.encode(Json::writeString(writer, metadata));
+
+    hits++;
+    return true;
+}
+
+// ============================================================================
+// TUILE VECTORIELLE (MVT)
+// ============================================================================
+bool ClusterIndexService::encodeTile(int z, int x, int y,
+                                     const std::string& status, const std::string& technology, int operator_id,
+                                     std::string& out)
+{
+    if (!enabled) return false;
+
+    std::shared_ptr<const Snapshot> snap;
+    std::shared_ptr<const ClusterPyramid> pyramid;
+    if (!acquire(Filter{status, technology, operator_id}, snap, pyramid)) return false;
+
+    MvtEncoder::Layer layer("antennas", TILE_EXTENT);
+    const int level = pyramid->levelFor(z);
+    const double scale = std::ldexp(1.0, z);
+    const double buffer = static_cast<double>(TILE_BUFFER) / TILE_EXTENT;
+
+    // Emprise de la tuile (+ buffer) en Mercator normalisé
+    pyramid->queryMercator(z, (x - buffer) / scale, (y - buffer) / scale,
+                              (x + 1 + buffer) / scale, (y + 1 + buffer) / scale,
+        [&](const ClusterPyramid::Node& node) {
+            int32_t px = static_cast<int32_t>(std::lround((ClusterPyramid::lngX(node.lon()) * scale - x) * TILE_EXTENT));
+            int32_t py = static_cast<int32_t>(std::lround((ClusterPyramid::latY(node.lat()) * scale - y) * TILE_EXTENT));
+
+            MvtEncoder::Properties props;
+            props.emplace_back("cluster", node.isCluster());
+            props.emplace_back("cluster_id", clusterId(level, node, snap->version));
+            props.emplace_back("point_count", static_cast<int64_t>(node.count));
+            props.emplace_back("avg_radius", round2(node.avgRadius()));
+
+            uint64_t featureId = 0;
+            if (!node.isCluster()) {
+                const auto& a = snap->antennas[pyramid->leaf(node.leafBegin)];
+                featureId = static_cast<uint64_t>(a.id);
+                props.emplace_back("antenna_id", static_cast<int64_t>(a.id));
+                props.emplace_back("status", a.status);
+                props.emplace_back("technology", a.technology);
+                props.emplace_back("operator_id", static_cast<int64_t>(a.operator_id));
+            }
+            layer.addPoint(featureId, px, py, props);
+        });
+
+    out = MvtEncoder::encodeTile({layer});
+    hits++;
+    return true;
+}
+
+// ============================================================================
+// MEMBRES D'UN CLUSTER (pagination)
+// ============================================================================
+ClusterIndexService::Lookup ClusterIndexService::getLeaves(int level, uint32_t leafBegin, const std::string& version,
+                                                           const std::string& status, const std::string& technology,
+                                                           int operator_id, int offset, int limit,
+                                                           Json::Value& out)
+{
+    if (!enabled) return Lookup::Unavailable;
+
+    std::shared_ptr<const Snapshot> snap;
+    std::shared_ptr<const ClusterPyramid> pyramid;
+    if (!acquire(Filter{status, technology, operator_id}, snap, pyramid)) return Lookup::Unavailable;
+    if (version != snap->version) return Lookup::Expired;
+    if (level < 0 || level > pyramid->maxZoom() + 1) return Lookup::NotFound;
+
+    // Les plages de feuilles d'un niveau sont disjointes : leafBegin identifie le nœud
+    const ClusterPyramid::Node* node = nullptr;
+    for (const auto& n : pyramid->nodes(level)) {
+        if (n.leafBegin == leafBegin) {
+            node = &n;
+            break;
+        }
+    }
+    if (!node) return Lookup::NotFound;
+
+    out = Json::Value(Json::objectValue);
+    out["cluster_id"] = clusterId(level, *node, snap->version);
+    out["data_version"] = snap->version;
+    out["offset"] = offset;
+    out["limit"] = limit;
+    out["total"] = node->count;
+    out["leaves"] = Json::Value(Json::arrayValue);
+
+    uint32_t first = node->leafBegin + std::min<uint32_t>(offset, node->count);
+    uint32_t last = std::min<uint32_t>(node->leafBegin + node->count, first + limit);
+    for (uint32_t k = first; k < last; ++k) {
+        out["leaves"].append(snap->antennas[pyramid->leaf(k)].toJson());
+    }
+
+    hits++;
+    return Lookup::Found;
+}
+
+Json::Value ClusterIndexService::getStatus() {
+    Json::Value status;
+    status["enabled"] = enabled;
+    status["reloading"] = reloading.load();
+    status["hits"] = static_cast<Json::UInt64>(hits.load());
+    status["sql_fallbacks"] = static_cast<Json::UInt64>(fallbacks.load());
+    status["reloads"] = static_cast<Json::UInt64>(reloads.load());
+
+    std::lock_guard<std::mutex> lock(stateMutex);
+    if (snapshot) {
+        status["data_version"] = snapshot->version;
+        status["loaded_at"] = snapshot->loadedAt;
+        status["antennas"] = static_cast<Json::UInt64>(snapshot->antennas.size());
+        if (snapshot->density) {
+            Json::Value cells(Json::arrayValue);
+            for (int level = 0; level < snapshot->density->levels(); ++level) {
+                Json::Value item;
+                item["grid_size"] = snapshot->density->cellSize(level);
+                item["occupied_cells"] = static_cast<Json::UInt64>(snapshot->density->cellCount(level));
+                cells.append(item);
+            }
+            status["density"] = cells;
+        }
+    }
+    status["adaptive_budget"] = static_cast<Json::UInt64>(adaptiveBudget);
+    Json::Value list(Json::arrayValue);
+    for (const auto& [key, entry] : indexes) {
+        Json::Value item;
+        item["filter"] = key;
+        item["antennas"] = static_cast<Json::UInt64>(entry.pyramid->pointCount());
+        list.append(item);
+    }
+    status["indexes"] = list;
+    Json::Value building(Json::arrayValue);
+    for (const auto& key : pending) building.append(key);
+    status["building"] = building;
+    return status;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <drogon/drogon.h>
+#include <cstdint>
+#include <string>
+
+/**
+ * Index de clustering en mémoire pour /api/antennas/clustered
+ *
+ * Remplace ST_SnapToGrid + GROUP BY + json_agg par une pyramide de clusters
+ * (un KD-tree par niveau de zoom, cf. ClusterPyramid) construite une fois par
+ * version des données et par combinaison de filtres (statut, technologie, opérateur).
+ *
+ * - Version des données : antenna_data_version (tenue par triggers) sondée périodiquement
+ * - Changement de version : nouveau snapshot et reconstruction des index en arrière-plan,
+ *   les anciens index continuent de répondre jusqu'à la bascule
+ * - Filtre jamais demandé : construction lancée en arrière-plan, l'appelant se rabat sur SQL
+ */
+class ClusterIndexService {
+public:
+    // Chargement initial + sondage de version (custom_config.cluster_index)
+    static void start();
+
+    /**
+     * Clusters d'une bbox à un zoom donné, au même format GeoJSON que le chemin SQL
+     *
+     * @return false si l'index de ce filtre n'est pas (encore) disponible :
+     *         sa construction est alors planifiée et l'appelant doit utiliser SQL
+     */
+    static bool query(double minLat, double minLon, double maxLat, double maxLon, int zoom,
+                      const std::string& status, const std::string& technology, int operator_id,
+                      Json::Value& out);
+
+    /**
+     * Même requête que query(), encodée au format binaire colonnaire (cf. ClusterBinaryEncoder) :
+     * coordonnées quantifiées int32, énumérations en dictionnaire, listes d'ids en varints
+     *
+     * @return false si l'index de ce filtre n'est pas (encore) disponible
+     */
+    static bool queryBinary(double minLat, double minLon, double maxLat, double maxLon, int zoom,
+                            const std::string& status, const std::string& technology, int operator_id,
+                            std::string& out);
+
+    /**
+     * Tuile vectorielle (MVT) z/x/y des clusters, couche "antennas"
+     *
+     * Même regroupement que query() au zoom z ; points du buffer de tuile inclus.
+     * Propriétés : cluster, point_count, avg_radius (+ antenna_id, status,
+     * technology, operator_id pour les antennes isolées).
+     *
+     * @return false si l'index de ce filtre n'est pas (encore) disponible
+     */
+    static bool encodeTile(int z, int x, int y,
+                           const std::string& status, const std::string& technology, int operator_id,
+                           std::string& out);
+
+    // Géométrie des tuiles : 4096 unités, buffer de 64 unités (symboles en bord de tuile)
+    static constexpr uint32_t TILE_EXTENT = 4096;
+    static constexpr uint32_t TILE_BUFFER = 64;
+
+    // ========== MODE ADAPTATIF ==========
+    // Budget de features par réponse par défaut (custom_config.cluster_index.adaptive_budget)
+    static size_t defaultBudget();
+
+    /**
+     * Niveau de la pyramide le plus détaillé (<= zoom) dont la bbox tient dans le budget
+     *
+     * @return -1 si l'index de ce filtre n'est pas (encore) disponible
+     */
+    static int adaptiveZoom(double minLat, double minLon, double maxLat, double maxLon, int zoom, size_t budget,
+                            const std::string& status, const std::string& technology, int operator_id);
+
+    /**
+     * Niveau de grille SQL le plus fin dont la bbox tient dans le budget, d'après
+     * l'histogramme de densité du dernier snapshot (toutes antennes, sans filtre :
+     * majorant du nombre de features filtrées)
+     *
+     * @return -1 si aucun snapshot n'est chargé
+     */
+    static int adaptiveGridLevel(double minLat, double minLon, double maxLat, double maxLon, size_t budget);
+
+    enum class Lookup { Unavailable, NotFound, Expired, Found };
+
+    /**
+     * Membres d'un cluster (cluster_id "k<niveau>.<début de plage>.<version>"), dans l'ordre de la pyramide
+     *
+     * Les feuilles d'un cluster étant contiguës, une page est une simple tranche.
+     * Les filtres doivent être ceux de la requête qui a produit le cluster_id.
+     *
+     * @return Unavailable si l'index du filtre n'est pas prêt, Expired si la version
+     *         des données a changé depuis l'émission de l'identifiant, NotFound si
+     *         l'identifiant ne correspond à aucun nœud
+     */
+    static Lookup getLeaves(int level, uint32_t leafBegin, const std::string& version,
+                            const std::string& status, const std::string& technology, int operator_id,
+                            int offset, int limit, Json::Value& out);
+
+    // Compare la version courante de la table et recharge si elle a changé
+    static void checkVersion();
+
+    // Version, index construits, hits / replis SQL (pour monitoring)
+    static Json::Value getStatus();
+};
@@ -0,0 +1,267 @@
+#include "CoverageWarmerService.h"
+#include "AntenneService.h"
+#include "../utils/ErrorHandler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace {
+    // Lot de blocs d'un même zoom et d'un même filtre, calculés en une requête
+    struct Job {
+        int zoom;
+        int operator_id;          // -1 = tous
+        std::string technology;   // Vide = toutes
+        std::vector<std::pair<int, int>> blocks;
+    };
+
+    // Paramètres lus au démarrage (custom_config.coverage_warmer)
+    bool enabled = false;
+    int minZoom = 5;
+    int maxZoom = 12;
+    double minLat = 0, minLon = 0, maxLat = 0, maxLon = 0;
+    int maxConcurrent = 2;
+    int blocksPerQuery = 16;
+
+    // Tuiles recalculées à reprendre (vide + !full : passage complet)
+    using TileSet = std::set<std::pair<int, int>>;
+
+    std::mutex warmerMutex;
+    std::deque<Job> queue;
+    int inFlight = 0;
+    bool running = false;
+    bool rerun = false;
+    bool rerunFull = false;       // Passage suivant : tout le territoire
+    TileSet rerunTiles;           // Sinon : blocs de ces tuiles seulement
+
+    // Statistiques du passage en cours / du dernier passage
+    uint64_t runs = 0;
+    size_t jobsTotal = 0;
+    uint64_t blocksChecked = 0;
+    uint64_t blocksComputed = 0;
+    uint64_t failures = 0;
+    std::chrono::steady_clock::time_point startedAt;
+    Json::Value lastRun;
+
+    void run(std::shared_ptr<const TileSet> tiles);
+
+    void finish() {
+        // Appelé sous warmerMutex
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startedAt).count();
+        lastRun = Json::Value();
+        lastRun["finished_at"] = trantor::Date::now().toFormattedString(false);
+        lastRun["jobs"] = static_cast<Json::UInt64>(jobsTotal);
+        lastRun["blocks_checked"] = static_cast<Json::UInt64>(blocksChecked);
+        lastRun["blocks_computed"] = static_cast<Json::UInt64>(blocksComputed);
+        lastRun["failures"] = static_cast<Json::UInt64>(failures);
+        lastRun["duration_ms"] = static_cast<Json::Int64>(elapsed);
+        running = false;
+
+        LOG_INFO << "🔥 Coverage warm-up done: " << blocksComputed << "/" << blocksChecked
+                 << " blocks computed in " << elapsed << " ms";
+
+        if (rerun) {
+            std::shared_ptr<const TileSet> next;
+            if (!rerunFull) next = std::make_shared<const TileSet>(std::move(rerunTiles));
+            rerun = false;
+            rerunFull = false;
+            rerunTiles.clear();
+            app().getLoop()->queueInLoop([next]() { run(next); });
+        }
+    }
+
+    // Lance des lots tant que la limite de concurrence le permet
+    void dispatch() {
+        std::vector<Job> launch;
+        {
+            std::lock_guard<std::mutex> lock(warmerMutex);
+            while (inFlight < maxConcurrent && !queue.empty()) {
+                launch.push_back(std::move(queue.front()));
+                queue.pop_front();
+                inFlight++;
+            }
+            if (launch.empty() && inFlight == 0 && running) {
+                finish();
+                return;
+            }
+        }
+
+        for (auto& job : launch) {
+            size_t count = job.blocks.size();
+            AntenneService::warmCoverageBlocks(job.zoom, job.blocks, job.operator_id, job.technology,
+                [count](int computed, const std::string& err) {
+                    {
+                        std::lock_guard<std::mutex> lock(warmerMutex);
+                        inFlight--;
+                        blocksChecked += count;
+                        blocksComputed += computed;
+                        if (!err.empty()) failures++;
+                    }
+                    // Relance différée : un lot entièrement en cache rappelle immédiatement
+                    app().getLoop()->queueInLoop([]() { dispatch(); });
+                });
+        }
+    }
+
+    // File des lots : zooms croissants, puis filtres, puis lignes de blocs ;
+    // tiles : seulement les blocs du territoire qui lisent ces tuiles
+    void buildJobs(const std::vector<int>& operators, const std::vector<std::string>& technologies,
+                   const std::shared_ptr<const TileSet>& tiles) {
+        std::vector<std::pair<int, std::string>> filters = {{-1, ""}};
+        for (int op : operators) filters.emplace_back(op, "");
+        for (const auto& tech : technologies) filters.emplace_back(-1, tech);
+
+        auto extent = AntenneService::coverageTileRange(minLat, minLon, maxLat, maxLon);
+        std::vector<std::pair<int, int>> refreshed;
+        if (tiles) refreshed.assign(tiles->begin(), tiles->end());
+
+        std::lock_guard<std::mutex> lock(warmerMutex);
+        queue.clear();
+        for (int zoom = minZoom; zoom <= maxZoom; ++zoom) {
+            int span = AntenneService::coverageBlockSpan(zoom);
+            std::vector<std::pair<int, int>> blocks;
+            if (tiles) {
+                for (const auto& [bx, by] : AntenneService::coverageBlocksTouching(zoom, refreshed)) {
+                    if (bx >= extent.minX / span && bx <= extent.maxX / span &&
+                        by >= extent.minY / span && by <= extent.maxY / span) {
+                        blocks.emplace_back(bx, by);
+                    }
+                }
+            } else {
+                for (int by = extent.minY / span; by <= extent.maxY / span; ++by) {
+                    for (int bx = extent.minX / span; bx <= extent.maxX / span; ++bx) {
+                        blocks.emplace_back(bx, by);
+                    }
+                }
+            }
+            for (const auto& [op, tech] : filters) {
+                Job job{zoom, op, tech, {}};
+                for (const auto& block : blocks) {
+                    job.blocks.push_back(block);
+                    if (static_cast<int>(job.blocks.size()) == blocksPerQuery) {
+                        queue.push_back(job);
+                        job.blocks.clear();
+                    }
+                }
+                if (!job.blocks.empty()) queue.push_back(std::move(job));
+            }
+        }
+        jobsTotal = queue.size();
+    }
+
+    void run(std::shared_ptr<const TileSet> tiles) {
+        {
+            std::lock_guard<std::mutex> lock(warmerMutex);
+            if (running) {
+                // Passage enchaîné à la fin : complet si l'un des passages demandés l'est
+                rerun = true;
+                if (!tiles) rerunFull = true;
+                else rerunTiles.insert(tiles->begin(), tiles->end());
+                return;
+            }
+            running = true;
+            runs++;
+            blocksChecked = 0;
+            blocksComputed = 0;
+            failures = 0;
+            startedAt = std::chrono::steady_clock::now();
+        }
+
+        // Filtres à préchauffer : opérateurs existants et technologies de l'enum
+        app().getDbClient()->execSqlAsync(R"(
+            SELECT 'op' AS kind, id::text AS value FROM operator
+            UNION ALL
+            SELECT 'tech', unnest(enum_range(NULL::technology_type))::text
+        )",
+            [tiles](const Result& r) {
+                std::vector<int> operators;
+                std::vector<std::string> technologies;
+                for (const auto& row : r) {
+                    if (row["kind"].as<std::string>() == "op") {
+                        operators.push_back(std::stoi(row["value"].as<std::string>()));
+                    } else {
+                        technologies.push_back(row["value"].as<std::string>());
+                    }
+                }
+                buildJobs(operators, technologies, tiles);
+                LOG_INFO << "🔥 Coverage warm-up started: zooms " << minZoom << "-" << maxZoom << ", "
+                         << (tiles ? std::to_string(tiles->size()) + " refreshed tiles, " : std::string())
+                         << operators.size() << " operators, " << technologies.size() << " technologies, "
+                         << jobsTotal << " batches";
+                dispatch();
+            },
+            [](const DrogonDbException& e) {
+                auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+                ErrorHandler::logError("CoverageWarmerService::run", errorDetails);
+                std::lock_guard<std::mutex> lock(warmerMutex);
+                failures++;
+                finish();
+            });
+    }
+}
+
+void CoverageWarmerService::start() {
+    const Json::Value& config = app().getCustomConfig()["coverage_warmer"];
+    enabled = config.get("enabled", true).asBool();
+    if (!enabled) return;
+
+    minZoom = std::max(0, config.get("min_zoom", 5).asInt());
+    maxZoom = std::min(18, config.get("max_zoom", 12).asInt());
+    maxConcurrent = std::max(1, config.get("max_concurrent", 2).asInt());
+    blocksPerQuery = std::max(1, config.get("blocks_per_query", 16).asInt());
+
+    // Emprise du territoire (défaut : Maroc)
+    const Json::Value& extent = config["extent"];
+    minLat = extent.get("minLat", 20.7).asDouble();
+    minLon = extent.get("minLon", -17.2).asDouble();
+    maxLat = extent.get("maxLat", 35.95).asDouble();
+    maxLon = extent.get("maxLon", -0.95).asDouble();
+
+    double delay = config.get("startup_delay_s", 10.0).asDouble();
+    double interval = config.get("interval_s", 3600.0).asDouble();
+
+    // Laisse passer le premier recalcul des tuiles avant le préchauffage initial
+    app().getLoop()->runAfter(delay, []() { run(nullptr); });
+    // Filet de sécurité (redémarrage ou éviction Redis) : seuls les blocs absents sont recalculés
+    if (interval > 0) {
+        app().getLoop()->runEvery(interval, []() { run(nullptr); });
+    }
+    LOG_INFO << "🔥 Coverage warm-up: zooms " << minZoom << "-" << maxZoom << ", "
+             << maxConcurrent << " concurrent queries, every " << interval << " s";
+}
+
+void CoverageWarmerService::trigger(const std::vector<std::pair<int, int>>& tiles) {
+    if (!enabled || tiles.empty()) return;
+    auto set = std::make_shared<const TileSet>(tiles.begin(), tiles.end());
+    app().getLoop()->queueInLoop([set]() { run(set); });
+}
+
+Json::Value CoverageWarmerService::getStatus() {
+    std::lock_guard<std::mutex> lock(warmerMutex);
+    Json::Value status;
+    status["enabled"] = enabled;
+    status["running"] = running;
+    status["runs"] = static_cast<Json::UInt64>(runs);
+    status["zooms"]["min"] = minZoom;
+    status["zooms"]["max"] = maxZoom;
+    status["max_concurrent"] = maxConcurrent;
+    status["queued_batches"] = static_cast<Json::UInt64>(queue.size());
+    status["in_flight"] = inFlight;
+    if (running) {
+        status["progress"]["batches"] = static_cast<Json::UInt64>(jobsTotal);
+        status["progress"]["blocks_checked"] = static_cast<Json::UInt64>(blocksChecked);
+        status["progress"]["blocks_computed"] = static_cast<Json::UInt64>(blocksComputed);
+    }
+    if (!lastRun.isNull()) status["last_run"] = lastRun;
+    return status;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <drogon/drogon.h>
+#include <json/json.h>
+#include <utility>
+#include <vector>
+
+/**
+ * Préchauffage du cache de couverture (/api/antennas/coverage/simplified)
+ *
+ * Précalcule les blocs de couverture (cf. AntenneService::coverageBlockSpan) du
+ * territoire configuré, pour chaque zoom courant et chaque filtre (tous, par
+ * opérateur, par technologie) : une requête dans cette plage ne fait plus
+ * qu'assembler des blocs en cache, même juste après une modification des données.
+ * - Au démarrage et périodiquement : tout le territoire
+ * - Après un recalcul de tuiles : seulement les blocs qui lisent les tuiles recalculées
+ *   (ceux que la purge ciblée a supprimés)
+ * - Seuls les blocs absents du cache sont calculés
+ * - Concurrence bornée : au plus max_concurrent requêtes SQL en vol, le pool de
+ *   connexions reste disponible pour le trafic utilisateur
+ */
+class CoverageWarmerService {
+public:
+    // Préchauffage initial + périodique (custom_config.coverage_warmer)
+    static void start();
+
+    // Passage limité aux blocs des tuiles de couverture recalculées (x, y) ; pendant
+    // un passage, un second est enchaîné à la fin (les blocs déjà écrits ont pu être purgés)
+    static void trigger(const std::vector<std::pair<int, int>>& tiles);
+
+    // Passage en cours, file restante, blocs calculés (pour monitoring)
+    static Json::Value getStatus();
+};
@@ -0,0 +1,236 @@
+#include "FrequencyPlanningService.h"
+#include "AntenneService.h"
+#include "InterferenceService.h"
+#include "../utils/ErrorHandler.h"
+#include "../utils/GraphColoring.h"
+#include "../utils/Parallel.h"
+#include "../utils/PgCopy.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace {
+    std::atomic<bool> planRunning{false};
+    std::mutex statusMutex;
+    Json::Value lastPlan(Json::nullValue);
+
+    void recordPlan(const Json::Value& stats) {
+        std::lock_guard<std::mutex> lock(statusMutex);
+        lastPlan = stats;
+    }
+}
+
+int FrequencyPlanningService::paletteSizeFor(const std::string& technology) {
+    return (technology == "5G") ? 1008 : 504;
+}
+
+// ============================================================================
+// PLANIFICATION PCI
+// ============================================================================
+bool FrequencyPlanningService::plan(
+    bool incremental, double neighborDistance,
+    std::function<void(const Json::Value&, const std::string&)> callback)
+{
+    bool expected = false;
+    if (!planRunning.compare_exchange_strong(expected, true)) {
+        return false;
+    }
+
+    auto startedAt = std::chrono::steady_clock::now();
+    auto client = app().getDbClient();
+    std::string connInfo = client->connectionInfo();
+
+    AntenneService::getAllAntennas(true,
+        [callback, incremental, neighborDistance, startedAt, client, connInfo]
+        (const std::vector<Antenna>& antennas, const std::string& err) {
+            if (!err.empty()) {
+                planRunning = false;
+                callback(Json::Value(), err);
+                return;
+            }
+
+            Parallel::runInBackground([callback, incremental, neighborDistance, startedAt, client, connInfo, antennas]() {
+                Json::Value stats;
+                stats["mode"] = incremental ? "incremental" : "full";
+                stats["started_at"] = trantor::Date::now().toFormattedString(false);
+                stats["neighbor_distance_m"] = neighborDistance;
+                stats["antennas"] = static_cast<Json::UInt64>(antennas.size());
+
+                try {
+                    // ========== GRAPHE D'ADJACENCE (CSR) ==========
+                    // Même technologie (même bande) et même opérateur (mêmes porteuses)
+                    auto pairs = InterferenceService::buildNeighborGraph(antennas, neighborDistance, true);
+                    std::vector<std::pair<uint32_t, uint32_t>> edges;
+                    edges.reserve(pairs.size());
+                    for (const auto& p : pairs) {
+                        if (antennas[p.a].operator_id != antennas[p.b].operator_id) continue;
+                        edges.emplace_back(static_cast<uint32_t>(p.a), static_cast<uint32_t>(p.b));
+                    }
+                    CsrGraph graph = CsrGraph::fromEdges(antennas.size(), edges);
+                    stats["edges"] = static_cast<Json::UInt64>(edges.size());
+
+                    std::vector<int32_t> colors(antennas.size(), GraphColoring::UNCOLORED);
+                    std::vector<int32_t> palette(antennas.size());
+                    std::vector<bool> fixed(antennas.size(), false);
+                    for (size_t i = 0; i < antennas.size(); ++i) {
+                        palette[i] = paletteSizeFor(antennas[i].technology);
+                    }
+
+                    // ========== MODE INCRÉMENTAL : PCI EXISTANTS FIGÉS ==========
+                    if (incremental) {
+                        auto existing = client->execSqlSync("SELECT antenna_id, pci FROM pci_assignment");
+                        std::unordered_map<int, int> current;
+                        current.reserve(existing.size());
+                        for (auto row : existing) {
+                            current[row["antenna_id"].as<int>()] = row["pci"].as<int>();
+                        }
+                        for (size_t i = 0; i < antennas.size(); ++i) {
+                            auto it = current.find(antennas[i].id);
+                            if (it != current.end() && it->second < palette[i]) {
+                                colors[i] = it->second;
+                                fixed[i] = true;
+                            }
+                        }
+                    }
+
+                    auto result = GraphColoring::colorSpeculative(graph, colors, palette, fixed);
+
+                    // Conflits résiduels (voisins partageant le même PCI)
+                    size_t conflicts = 0;
+                    for (const auto& e : edges) {
+                        if (colors[e.first] == colors[e.second]) conflicts++;
+                    }
+
+                    // ========== PERSISTANCE ==========
+                    PgCopy copy(connInfo);
+                    copy.exec("BEGIN");
+                    char line[64];
+                    long rows = 0;
+                    if (!incremental) {
+                        copy.exec("DELETE FROM pci_assignment");
+                        copy.begin("COPY pci_assignment (antenna_id, pci) FROM STDIN");
+                        for (size_t i = 0; i < antennas.size(); ++i) {
+                            if (colors[i] < 0) continue;
+                            int n = std::snprintf(line, sizeof(line), "%d\t%d\n", antennas[i].id, colors[i]);
+                            copy.putLine(std::string(line, n));
+                        }
+                        rows = copy.end();
+                    } else {
+                        // Table de travail : seules les lignes des PCI figés sont conservées.
+                        // Les autres (antenne retirée, PCI hors palette après un changement
+                        // de technologie) sont supprimées avant l'insertion des nouveaux PCI.
+                        copy.exec("CREATE TEMP TABLE pci_stage (antenna_id INTEGER, pci SMALLINT, fixed BOOLEAN) "
+                                  "ON COMMIT DROP");
+                        copy.begin("COPY pci_stage (antenna_id, pci, fixed) FROM STDIN");
+                        for (size_t i = 0; i < antennas.size(); ++i) {
+                            if (colors[i] < 0) continue;
+                            int n = std::snprintf(line, sizeof(line), "%d\t%d\t%s\n",
+                                                  antennas[i].id, colors[i], fixed[i] ? "t" : "f");
+                            copy.putLine(std::string(line, n));
+                            if (!fixed[i]) rows++;
+                        }
+                        copy.end();
+                        copy.exec("DELETE FROM pci_assignment p WHERE NOT EXISTS "
+                                  "(SELECT 1 FROM pci_stage s WHERE s.antenna_id = p.antenna_id AND s.fixed)");
+                        copy.exec("INSERT INTO pci_assignment (antenna_id, pci) "
+                                  "SELECT antenna_id, pci FROM pci_stage WHERE NOT fixed");
+                    }
+                    copy.exec("COMMIT");
+
+                    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - startedAt).count();
+                    stats["rounds"] = result.rounds;
+                    stats["colored"] = static_cast<Json::UInt64>(result.recolored);
+                    stats["written"] = static_cast<Json::Int64>(rows);
+                    stats["max_pci"] = result.maxColor;
+                    stats["saturated"] = static_cast<Json::UInt64>(result.residualConflicts);
+                    stats["conflicts"] = static_cast<Json::UInt64>(conflicts);
+                    stats["duration_ms"] = static_cast<Json::Int64>(elapsed);
+
+                    LOG_INFO << "📻 PCI plan (" << (incremental ? "incremental" : "full") << "): "
+                             << result.recolored << " antennas colored in " << result.rounds
+                             << " rounds, " << conflicts << " conflicts, " << elapsed << " ms";
+
+                    recordPlan(stats);
+                    planRunning = false;
+                    callback(stats, "");
+                } catch (const DrogonDbException& e) {
+                    auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+                    ErrorHandler::logError("FrequencyPlanningService::plan", errorDetails);
+                    stats["error"] = errorDetails.userMessage;
+                    recordPlan(stats);
+                    planRunning = false;
+                    callback(Json::Value(), errorDetails.userMessage);
+                } catch (const std::exception& e) {
+                    auto errorDetails = ErrorHandler::analyzePostgresError(e.what());
+                    ErrorHandler::logError("FrequencyPlanningService::plan", errorDetails);
+                    stats["error"] = errorDetails.userMessage;
+                    recordPlan(stats);
+                    planRunning = false;
+                    callback(Json::Value(), errorDetails.userMessage);
+                }
+            });
+        });
+
+    return true;
+}
+
+Json::Value FrequencyPlanningService::getStatus() {
+    Json::Value status;
+    status["running"] = planRunning.load();
+    {
+        std::lock_guard<std::mutex> lock(statusMutex);
+        status["last_plan"] = lastPlan;
+    }
+    return status;
+}
+
+// ============================================================================
+// LECTURE DU PLAN COURANT
+// ============================================================================
+void FrequencyPlanningService::getAssignments(
+    int operator_id, const std::string& technology,
+    std::function<void(const std::vector<PciAssignment>&, const std::string&)> callback)
+{
+    auto client = app().getDbClient();
+
+    std::string sql = R"(
+        SELECT
+            p.antenna_id,
+            p.pci,
+            a.operator_id,
+            a.technology::text AS technology
+        FROM pci_assignment p
+        JOIN antenna a ON a.id = p.antenna_id
+        WHERE ($1 < 0 OR a.operator_id = $1)
+          AND ($2 = '' OR a.technology::text = $2)
+        ORDER BY p.antenna_id
+    )";
+
+    client->execSqlAsync(sql,
+        [callback](const Result& r) {
+            std::vector<PciAssignment> list;
+            list.reserve(r.size());
+            for (auto row : r) {
+                PciAssignment p;
+                p.antenna_id = row["antenna_id"].as<int>();
+                p.pci = row["pci"].as<int>();
+                p.operator_id = row["operator_id"].isNull() ? 0 : row["operator_id"].as<int>();
+                p.technology = row["technology"].as<std::string>();
+                list.push_back(p);
+            }
+            callback(list, "");
+        },
+        [callback](const DrogonDbException& e) {
+            auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+            ErrorHandler::logError("FrequencyPlanningService::getAssignments", errorDetails);
+            callback({}, errorDetails.userMessage);
+        },
+        operator_id, technology);
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "../models/PciAssignment.h"
+#include <drogon/drogon.h>
+#include <vector>
+#include <string>
+#include <functional>
+
+class FrequencyPlanningService {
+public:
+    // Nombre de PCI disponibles par technologie (LTE : 504, NR : 1008)
+    static int paletteSizeFor(const std::string& technology);
+
+    // ========== PLANIFICATION PCI (coloration de graphe) ==========
+    /**
+     * Calcule un plan PCI sans collision entre cellules voisines
+     *
+     * 1. Graphe d'adjacence en mémoire (CSR) : antennes actives de même
+     *    technologie et même opérateur à moins de neighborDistance mètres
+     * 2. Coloration parallèle spéculative avec résolution des conflits
+     * 3. Persistance dans 'pci_assignment' via COPY
+     *
+     * Mode incrémental : les PCI déjà attribués sont conservés, seules les
+     * antennes sans affectation (nouvelles antennes) sont colorées. Les lignes
+     * des antennes retirées ou dont le PCI sort de la palette sont remplacées.
+     *
+     * Retourne false si une planification est déjà en cours.
+     */
+    static bool plan(bool incremental, double neighborDistance,
+                     std::function<void(const Json::Value&, const std::string&)> callback);
+
+    // État de la dernière planification (pour monitoring)
+    static Json::Value getStatus();
+
+    /**
+     * Lecture du plan courant
+     *
+     * @param operator_id - Filtre optionnel par opérateur (-1 = tous)
+     * @param technology - Filtre optionnel par technologie ("" = toutes)
+     */
+    static void getAssignments(int operator_id, const std::string& technology,
+                               std::function<void(const std::vector<PciAssignment>&, const std::string&)> callback);
+};
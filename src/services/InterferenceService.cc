@@ -0,0 +1,232 @@
+#include "InterferenceService.h"
+#include "AntenneService.h"
+#include "../utils/ErrorHandler.h"
+#include "../utils/RadioModel.h"
+#include "../utils/SpatialGrid.h"
+#include "../utils/Parallel.h"
+#include "../utils/PgCopy.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace {
+    std::atomic<bool> rebuildRunning{false};
+    std::mutex statusMutex;
+    Json::Value lastRun(Json::nullValue);
+
+    void recordRun(const Json::Value& stats) {
+        std::lock_guard<std::mutex> lock(statusMutex);
+        lastRun = stats;
+    }
+}
+
+// ============================================================================
+// GRAPHE DE VOISINAGE (grille spatiale)
+// ============================================================================
+std::vector<NeighborPair> InterferenceService::buildNeighborGraph(
+    const std::vector<Antenna>& antennas, double maxDistanceMeters, bool sameTechnologyOnly)
+{
+    if (antennas.empty() || maxDistanceMeters <= 0) return {};
+
+    // Latitude de référence pour la conversion mètres -> degrés de longitude
+    double refLat = 0.0;
+    for (const auto& a : antennas) refLat += a.latitude;
+    refLat /= antennas.size();
+
+    SpatialGrid grid(maxDistanceMeters, refLat);
+    for (size_t i = 0; i < antennas.size(); ++i) {
+        grid.insert(i, antennas[i].latitude, antennas[i].longitude);
+    }
+
+    // Chaque thread collecte ses arêtes localement, fusion à la fin
+    size_t workers = Parallel::workerCount();
+    std::vector<std::vector<NeighborPair>> partial(workers);
+    std::atomic<size_t> slot{0};
+
+    Parallel::forRange(antennas.size(), [&](size_t begin, size_t end) {
+        auto& out = partial[slot++ % workers];
+        for (size_t i = begin; i < end; ++i) {
+            const auto& src = antennas[i];
+            grid.forEachWithin(src.latitude, src.longitude, maxDistanceMeters,
+                [&](const SpatialGrid::Entry& e, double d) {
+                    if (e.index <= i) return; // Paire déjà émise depuis l'autre extrémité
+                    if (sameTechnologyOnly && antennas[e.index].technology != src.technology) return;
+                    out.push_back({i, e.index, d});
+                });
+        }
+    });
+
+    std::vector<NeighborPair> pairs;
+    size_t total = 0;
+    for (const auto& p : partial) total += p.size();
+    pairs.reserve(total);
+    for (auto& p : partial) pairs.insert(pairs.end(), p.begin(), p.end());
+    return pairs;
+}
+
+double InterferenceService::configuredMaxDistance() {
+    const auto& config = app().getCustomConfig();
+    return config["interference"].get("max_distance_m", 5000.0).asDouble();
+}
+
+// ============================================================================
+// RECALCUL DE LA MATRICE D'INTERFÉRENCES
+// ============================================================================
+bool InterferenceService::rebuildMatrix(
+    double maxDistanceMeters,
+    std::function<void(const Json::Value&, const std::string&)> callback)
+{
+    bool expected = false;
+    if (!rebuildRunning.compare_exchange_strong(expected, true)) {
+        return false;
+    }
+
+    auto startedAt = std::chrono::steady_clock::now();
+    std::string connInfo = app().getDbClient()->connectionInfo();
+
+    AntenneService::getAllAntennas(true,
+        [callback, maxDistanceMeters, startedAt, connInfo](const std::vector<Antenna>& antennas, const std::string& err) {
+            if (!err.empty()) {
+                rebuildRunning = false;
+                callback(Json::Value(), err);
+                return;
+            }
+
+            // Le calcul et le COPY sont bloquants : exécution hors des threads I/O
+            Parallel::runInBackground([callback, maxDistanceMeters, startedAt, connInfo, antennas]() {
+                Json::Value stats;
+                stats["started_at"] = trantor::Date::now().toFormattedString(false);
+                stats["max_distance_m"] = maxDistanceMeters;
+                stats["antennas"] = static_cast<Json::UInt64>(antennas.size());
+
+                try {
+                    auto pairs = buildNeighborGraph(antennas, maxDistanceMeters, true);
+                    stats["pairs"] = static_cast<Json::UInt64>(pairs.size());
+
+                    // Niveaux d'interférence calculés en parallèle, lignes COPY pré-formatées
+                    size_t workers = Parallel::workerCount();
+                    std::vector<std::string> buffers(workers);
+                    std::atomic<size_t> slot{0};
+
+                    Parallel::forRange(pairs.size(), [&](size_t begin, size_t end) {
+                        auto& out = buffers[slot++ % workers];
+                        char line[128];
+                        for (size_t k = begin; k < end; ++k) {
+                            const auto& p = pairs[k];
+                            const auto& a = antennas[p.a];
+                            const auto& b = antennas[p.b];
+                            double distKm = std::max(p.distance_m, 1.0) / 1000.0;
+
+                            // Puissance reçue de b au site de a, et réciproquement
+                            double levelAtA = RadioModel::receivedPower(b.technology, distKm, false);
+                            double levelAtB = RadioModel::receivedPower(a.technology, distKm, false);
+
+                            if (levelAtA > RadioModel::DETECTION_THRESHOLD_DBM) {
+                                int n = std::snprintf(line, sizeof(line), "%d\t%d\t%.2f\t%.2f\n",
+                                                      a.id, b.id, levelAtA, p.distance_m);
+                                out.append(line, n);
+                            }
+                            if (levelAtB > RadioModel::DETECTION_THRESHOLD_DBM) {
+                                int n = std::snprintf(line, sizeof(line), "%d\t%d\t%.2f\t%.2f\n",
+                                                      b.id, a.id, levelAtB, p.distance_m);
+                                out.append(line, n);
+                            }
+                        }
+                    });
+
+                    // Remplacement atomique : les lecteurs voient l'ancienne ou la nouvelle matrice
+                    PgCopy copy(connInfo);
+                    copy.exec("BEGIN");
+                    copy.exec("DELETE FROM interferences");
+                    copy.begin("COPY interferences (antenne_source_id, antenne_cible_id, "
+                               "niveau_interference, distance) FROM STDIN");
+                    for (const auto& buf : buffers) {
+                        copy.putLine(buf);
+                    }
+                    long rows = copy.end();
+                    copy.exec("COMMIT");
+
+                    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - startedAt).count();
+                    stats["rows"] = static_cast<Json::Int64>(rows);
+                    stats["duration_ms"] = static_cast<Json::Int64>(elapsed);
+
+                    LOG_INFO << "📶 Interference matrix rebuilt: " << antennas.size() << " antennas, "
+                             << pairs.size() << " neighbor pairs, " << rows << " rows in " << elapsed << " ms";
+
+                    recordRun(stats);
+                    rebuildRunning = false;
+                    callback(stats, "");
+                } catch (const std::exception& e) {
+                    auto errorDetails = ErrorHandler::analyzePostgresError(e.what());
+                    ErrorHandler::logError("InterferenceService::rebuildMatrix", errorDetails);
+                    stats["error"] = errorDetails.userMessage;
+                    recordRun(stats);
+                    rebuildRunning = false;
+                    callback(Json::Value(), errorDetails.userMessage);
+                }
+            });
+        });
+
+    return true;
+}
+
+Json::Value InterferenceService::getStatus() {
+    Json::Value status;
+    status["running"] = rebuildRunning.load();
+    {
+        std::lock_guard<std::mutex> lock(statusMutex);
+        status["last_run"] = lastRun;
+    }
+    return status;
+}
+
+// ============================================================================
+// INTERFÉRENCES D'UNE ANTENNE (lookup indexé)
+// ============================================================================
+void InterferenceService::getByAntenna(
+    int antennaId, int limit,
+    std::function<void(const std::vector<InterferenceModel>&, const std::string&)> callback)
+{
+    auto client = app().getDbClient();
+
+    std::string sql = R"(
+        SELECT
+            antenne_source_id,
+            antenne_cible_id,
+            niveau_interference::double precision AS niveau,
+            distance::double precision AS distance,
+            date_mesure::text AS date_mesure
+        FROM interferences
+        WHERE antenne_source_id = $1
+        ORDER BY niveau_interference DESC
+        LIMIT $2
+    )";
+
+    client->execSqlAsync(sql,
+        [callback](const Result& r) {
+            std::vector<InterferenceModel> list;
+            list.reserve(r.size());
+            for (auto row : r) {
+                InterferenceModel m;
+                m.source_id = row["antenne_source_id"].as<int>();
+                m.target_id = row["antenne_cible_id"].as<int>();
+                m.level_dbm = row["niveau"].as<double>();
+                m.distance_m = row["distance"].as<double>();
+                m.measured_at = row["date_mesure"].isNull() ? "" : row["date_mesure"].as<std::string>();
+                list.push_back(m);
+            }
+            callback(list, "");
+        },
+        [callback](const DrogonDbException& e) {
+            auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+            ErrorHandler::logError("InterferenceService::getByAntenna", errorDetails);
+            callback({}, errorDetails.userMessage);
+        },
+        antennaId, limit);
+}
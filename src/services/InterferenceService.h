@@ -0,0 +1,63 @@
+#pragma once
+#include "../models/Antenne.h"
+#include "../models/Interference.h"
+#include <drogon/drogon.h>
+#include <vector>
+#include <string>
+#include <functional>
+
+// Arête du graphe de voisinage (indices dans le vecteur d'antennes source)
+struct NeighborPair {
+    size_t a;
+    size_t b;
+    double distance_m;
+};
+
+class InterferenceService {
+public:
+    // ========== GRAPHE DE VOISINAGE ==========
+    /**
+     * Construit le graphe de voisinage des antennes via une grille spatiale
+     *
+     * Chaque paire (a, b) avec a < b n'apparaît qu'une fois.
+     * Complexité ~O(N·k) au lieu de O(N²), k = nombre moyen de voisins.
+     *
+     * @param antennas - Snapshot des antennes
+     * @param maxDistanceMeters - Distance max entre deux voisins
+     * @param sameTechnologyOnly - true pour ne relier que des antennes de même technologie (même bande)
+     */
+    static std::vector<NeighborPair> buildNeighborGraph(const std::vector<Antenna>& antennas,
+                                                        double maxDistanceMeters,
+                                                        bool sameTechnologyOnly);
+
+    // Distance max par défaut (custom_config.interference.max_distance_m, 5 km sinon)
+    static double configuredMaxDistance();
+
+    // ========== MATRICE D'INTERFÉRENCES (job batch) ==========
+    /**
+     * Recalcule entièrement la table 'interferences'
+     *
+     * 1. Snapshot des antennes actives
+     * 2. Graphe de voisinage par grille spatiale (même technologie)
+     * 3. Niveaux d'interférence calculés en parallèle (modèle FSPL)
+     * 4. Remplacement transactionnel de la table via COPY
+     *
+     * Le job tourne en arrière-plan ; le callback reçoit les statistiques d'exécution.
+     * Retourne false si un recalcul est déjà en cours.
+     */
+    static bool rebuildMatrix(double maxDistanceMeters,
+                              std::function<void(const Json::Value&, const std::string&)> callback);
+
+    // État du dernier recalcul (pour monitoring)
+    static Json::Value getStatus();
+
+    // ========== LECTURE INDEXÉE ==========
+    /**
+     * Interférences subies par une antenne (lookup sur idx_interference_source)
+     *
+     * @param antennaId - Antenne victime
+     * @param limit - Nombre max de lignes (triées par niveau décroissant)
+     */
+    static void getByAntenna(int antennaId, int limit,
+                             std::function<void(const std::vector<InterferenceModel>&, const std::string&)> callback);
+};
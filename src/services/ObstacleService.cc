@@ -5,7 +5,7 @@
 #include <memory>
 #include <optional>
 
-void ObstacleService::getByBoundingBox(double minLon, double minLat, double maxLon, double maxLat, int zoom, const std::optional<std::string>& type, const std::function<void(const Json::Value&, const std::string&)>& callback) {
+void ObstacleService::getByBoundingBox(double minLon, double minLat, double maxLon, double maxLat, int zoom, const std::optional<std::string>& type, const std::function<void(const std::string&, const std::string&)>& callback) {
     auto dbClient = drogon::app().getDbClient();
 
     // Ajustement de la tolérance de simplification selon le niveau de zoom pour optimiser les performances
@@ -28,18 +28,19 @@ void ObstacleService::getByBoundingBox(double minLon, double minLat, double maxL
     LOG_INFO << "Obstacles query: zoom=" << zoom << ", tolerance=" << tolerance << ", limit=" << limit;
 
     // Construction de la requête SQL avec simplification géométrique et limitation du nombre de résultats
-    std::string sql = R"(SELECT jsonb_build_object(
+    // Le GeoJSON est produit en texte par PostgreSQL et transmis tel quel au corps HTTP
+    std::string sql = R"(SELECT json_build_object(
         'type', 'FeatureCollection',
-        'features', jsonb_agg(jsonb_build_object(
+        'features', COALESCE(json_agg(json_build_object(
             'type', 'Feature',
-            'geometry', ST_AsGeoJSON(ST_Simplify(t.geom, )" + std::to_string(tolerance) + R"())::jsonb,
-            'properties', jsonb_build_object(
+            'geometry', ST_AsGeoJSON(ST_Simplify(t.geom, )" + std::to_string(tolerance) + R"())::json,
+            'properties', json_build_object(
                 'id', t.id,
                 'type', t.type,
                 'geom_type', t.geom_type
             )
-        ))
-    ) AS geojson
+        )), '[]'::json)
+    )::text AS geojson
     FROM (
         SELECT id, type, geom_type, geom
         FROM obstacle
@@ -48,82 +49,29 @@ void ObstacleService::getByBoundingBox(double minLon, double minLat, double maxL
         LIMIT )" + std::to_string(limit) + R"(
     ) t)";
 
-    if (type.has_value()) {
+    auto executeQuery = [&](auto&&... params) {
         dbClient->execSqlAsync(
             sql,
             [callback](const drogon::orm::Result& result) {
-                        if (!result.empty()) {
-                            const auto& row = result[0];
-                            std::string geoString = row["geojson"].as<std::string>();
-                            Json::CharReaderBuilder builder;
-                            std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
-                            Json::Value parsed;
-                            std::string errs;
-                            if (reader->parse(geoString.c_str(), geoString.c_str() + geoString.length(), &parsed, &errs)) {
-                                // S'assurer que 'features' est toujours un tableau (jsonb_agg retourne null si pas de résultats)
-                                if (parsed.isObject() && parsed["features"].isNull()) {
-                                    parsed["features"] = Json::Value(Json::arrayValue);
-                                }
-                                callback(parsed, "");
-                            } else {
-                                LOG_ERROR << "ObstacleService::getByBoundingBox - Failed to parse GeoJSON: " << errs;
-                                Json::Value emptyGeoJSON;
-                                emptyGeoJSON["type"] = "FeatureCollection";
-                                emptyGeoJSON["features"] = Json::Value(Json::arrayValue);
-                                callback(emptyGeoJSON, "");
-                            }
-                        } else {
-                            // Retourner une collection GeoJSON vide si aucun résultat
-                            Json::Value emptyGeoJSON;
-                            emptyGeoJSON["type"] = "FeatureCollection";
-                            emptyGeoJSON["features"] = Json::Value(Json::arrayValue);
-                            callback(emptyGeoJSON, "");
-                        }
-            },
-            [callback](const drogon::orm::DrogonDbException& e) {
-                // Gestion des erreurs de base de données
-                callback(Json::Value(), e.base().what());
-            },
-            minLon, minLat, maxLon, maxLat, type.value()
-        );
-    } else {
-        // Requête sans filtrage par type
-        dbClient->execSqlAsync(
-            sql,
-            [callback](const drogon::orm::Result& result) {
-                        if (!result.empty()) {
-                    const auto& row = result[0];
-                    std::string geoString = row["geojson"].as<std::string>();
-                    Json::CharReaderBuilder builder;
-                    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
-                    Json::Value parsed;
-                    std::string errs;
-                    if (reader->parse(geoString.c_str(), geoString.c_str() + geoString.length(), &parsed, &errs)) {
-                                // S'assurer que 'features' est un tableau pour la conformité GeoJSON
-                                if (parsed.isObject() && parsed["features"].isNull()) {
-                                    parsed["features"] = Json::Value(Json::arrayValue);
-                                }
-                                callback(parsed, "");
-                    } else {
-                        LOG_ERROR << "ObstacleService::getByBoundingBox - Failed to parse GeoJSON: " << errs;
-                        Json::Value emptyGeoJSON;
-                        emptyGeoJSON["type"] = "FeatureCollection";
-                        emptyGeoJSON["features"] = Json::Value(Json::arrayValue);
-                        callback(emptyGeoJSON, "");
-                    }
+                if (!result.empty() && !result[0]["geojson"].isNull()) {
+                    callback(result[0]["geojson"].as<std::string>(), "");
                 } else {
-                    // Collection GeoJSON vide si aucun obstacle trouvé
-                    Json::Value emptyGeoJSON;
-                    emptyGeoJSON["type"] = "FeatureCollection";
-                    emptyGeoJSON["features"] = Json::Value(Json::arrayValue);
-                    callback(emptyGeoJSON, "");
+                    // Retourner une collection GeoJSON vide si aucun résultat
+                    callback(R"({"type":"FeatureCollection","features":[]})", "");
                 }
             },
             [callback](const drogon::orm::DrogonDbException& e) {
                 // Gestion des erreurs de base de données
-                callback(Json::Value(), e.base().what());
+                callback("", e.base().what());
             },
-            minLon, minLat, maxLon, maxLat
+            std::forward<decltype(params)>(params)...
         );
+    };
+
+    if (type.has_value()) {
+        executeQuery(minLon, minLat, maxLon, maxLat, type.value());
+    } else {
+        // Requête sans filtrage par type
+        executeQuery(minLon, minLat, maxLon, maxLat);
     }
 }
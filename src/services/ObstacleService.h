@@ -7,6 +7,6 @@
 
 class ObstacleService {
 public:
-    // GET OBSTACLES BY BOUNDING BOX
-    static void getByBoundingBox(double minLon, double minLat, double maxLon, double maxLat, int zoom, const std::optional<std::string>& type, const std::function<void(const Json::Value&, const std::string&)>& callback);
+    // GET OBSTACLES BY BOUNDING BOX (GeoJSON sérialisé par PostgreSQL, transmis sans reparsing)
+    static void getByBoundingBox(double minLon, double minLat, double maxLon, double maxLat, int zoom, const std::optional<std::string>& type, const std::function<void(const std::string&, const std::string&)>& callback);
 };
\ No newline at end of file
@@ -26,22 +26,31 @@ void OptimizationService::optimizeGreedy(const OptimizationRequest& req,
         // Fallback sur génération de points si pas de données de densité
         sql = R"(
             WITH target_zone AS (
-                SELECT id, geom, COALESCE(density, 100.0) as density
+                SELECT id, geom, type, COALESCE(density, 100.0) as density
                 FROM zone 
                 WHERE id = $1
             ),
             -- Utiliser les density_zones enfants si disponibles
+            -- (zone_closure, migration 010 : cellules des zones administratives qui intersectent la cible)
             density_cells AS (
                 SELECT 
                     ST_Centroid(dz.geom) as pt,
                     dz.density
-                FROM zone dz
-                WHERE dz.type = 'density_zone'
-                  AND dz.parent_id IN (
-                      SELECT z.id FROM zone z, target_zone t 
-                      WHERE ST_Intersects(z.geom, t.geom)
-                        AND z.type IN ('commune', 'province', 'region')
-                  )
+                FROM (
+                    SELECT dz.geom, dz.density
+                    FROM zone_closure c
+                    JOIN zone dz ON dz.id = c.related_id
+                    WHERE c.zone_id = $1
+                      AND c.kind = 'cell'
+                    UNION ALL
+                    -- Cellule de densité ciblée (pas source de la fermeture) : résolution spatiale
+                    SELECT dz.geom, dz.density
+                    FROM target_zone t
+                    JOIN zone z ON ST_Intersects(z.geom, t.geom)
+                               AND z.type IN ('commune', 'province', 'region')
+                    JOIN zone dz ON dz.parent_id = z.id AND dz.type = 'density_zone'
+                    WHERE t.type = 'density_zone'
+                ) dz
                 ORDER BY dz.density DESC NULLS LAST
                 LIMIT 200
             ),
@@ -311,23 +320,31 @@ void OptimizationService::optimizeKMeans(const OptimizationRequest& req,
         
         sql = R"(
             WITH target_zone AS (
-                SELECT id, geom, COALESCE(density, 100.0) as density
+                SELECT id, geom, type, COALESCE(density, 100.0) as density
                 FROM zone 
                 WHERE id = $1
             ),
-            -- Récupérer les density_zones dans la zone cible
+            -- Récupérer les density_zones dans la zone cible (zone_closure, migration 010)
             density_cells AS (
                 SELECT 
                     ST_X(ST_Centroid(dz.geom)) as lon,
                     ST_Y(ST_Centroid(dz.geom)) as lat,
                     COALESCE(dz.density, 100.0) as weight
-                FROM zone dz
-                WHERE dz.type = 'density_zone'
-                  AND dz.parent_id IN (
-                      SELECT z.id FROM zone z, target_zone t 
-                      WHERE ST_Intersects(z.geom, t.geom)
-                        AND z.type IN ('commune', 'province', 'region')
-                  )
+                FROM (
+                    SELECT dz.geom, dz.density
+                    FROM zone_closure c
+                    JOIN zone dz ON dz.id = c.related_id
+                    WHERE c.zone_id = $1
+                      AND c.kind = 'cell'
+                    UNION ALL
+                    -- Cellule de densité ciblée (pas source de la fermeture) : résolution spatiale
+                    SELECT dz.geom, dz.density
+                    FROM target_zone t
+                    JOIN zone z ON ST_Intersects(z.geom, t.geom)
+                               AND z.type IN ('commune', 'province', 'region')
+                    JOIN zone dz ON dz.parent_id = z.id AND dz.type = 'density_zone'
+                    WHERE t.type = 'density_zone'
+                ) dz
                 ORDER BY dz.density DESC NULLS LAST
                 LIMIT 500
             ),
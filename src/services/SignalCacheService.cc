@@ -0,0 +1,187 @@
+#include "SignalCacheService.h"
+#include "CacheService.h"
+#include "../utils/Geohash.h"
+#include <algorithm>
+#include <set>
+#include <vector>
+
+using namespace drogon;
+
+SignalCacheService& SignalCacheService::getInstance() {
+    static SignalCacheService instance;
+    return instance;
+}
+
+SignalCacheService::SignalCacheService() {
+    const auto& config = app().getCustomConfig()["simulation"]["cache"];
+    precision_ = std::clamp(config.get("precision", 7).asInt(), INVALIDATION_PRECISION, 9);
+    localTtlSeconds_ = config.get("local_ttl_s", 60).asInt();
+    redisTtlSeconds_ = config.get("redis_ttl_s", 600).asInt();
+    maxLocalEntries_ = config.get("local_max_entries", 50000).asUInt();
+}
+
+std::string SignalCacheService::makeKey(const std::string& cell, std::optional<int> operatorId,
+                                        const std::optional<std::string>& technology) const {
+    return "signal:" + cell +
+           ":op:" + (operatorId ? std::to_string(*operatorId) : std::string("all")) +
+           ":tech:" + (technology ? *technology : std::string("all"));
+}
+
+// ============================================================================
+// LECTURE / ÉCRITURE
+// ============================================================================
+std::optional<Json::Value> SignalCacheService::get(const std::string& key, Tier& tier, Generation& generation) {
+    auto now = std::chrono::steady_clock::now();
+    generation.local = epoch_.load();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = local_.find(key);
+        if (it != local_.end()) {
+            if (it->second.expiresAt > now) {
+                localHits_++;
+                tier = Tier::Local;
+                return *it->second.value;
+            }
+            local_.erase(it);
+        }
+    }
+
+    auto& cache = CacheService::getInstance();
+    auto cached = cache.getJson(key);
+    if (cached) {
+        redisHits_++;
+        tier = Tier::Redis;
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Pas de réalimentation si une invalidation a eu lieu depuis la lecture
+        if (epoch_.load() == generation.local) {
+            evictLocked(now);
+            local_[key] = {std::make_shared<const Json::Value>(*cached),
+                           now + std::chrono::seconds(localTtlSeconds_)};
+        }
+        return cached;
+    }
+
+    generation.shared = cache.get(GENERATION_KEY);
+    misses_++;
+    tier = Tier::None;
+    return std::nullopt;
+}
+
+void SignalCacheService::put(const std::string& key, const Json::Value& result, const Generation& generation) {
+    auto& cache = CacheService::getInstance();
+    if (epoch_.load() != generation.local || cache.get(GENERATION_KEY) != generation.shared) {
+        staleDrops_++;
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Invalidation survenue pendant la relecture de la génération partagée
+        if (epoch_.load() != generation.local) {
+            staleDrops_++;
+            return;
+        }
+        evictLocked(now);
+        local_[key] = {std::make_shared<const Json::Value>(result),
+                       now + std::chrono::seconds(localTtlSeconds_)};
+    }
+    cache.setJson(key, result, redisTtlSeconds_);
+}
+
+void SignalCacheService::bumpGeneration() {
+    epoch_++;
+    CacheService::getInstance().incr(GENERATION_KEY);
+}
+
+// Appelé sous verrou : purge des entrées expirées, puis du plus ancien dixième si toujours plein
+// (éviction par lot pour ne pas reparcourir la map à chaque insertion)
+void SignalCacheService::evictLocked(std::chrono::steady_clock::time_point now) {
+    if (local_.size() < maxLocalEntries_) return;
+
+    for (auto it = local_.begin(); it != local_.end();) {
+        if (it->second.expiresAt <= now) it = local_.erase(it);
+        else ++it;
+    }
+    if (local_.size() < maxLocalEntries_) return;
+
+    std::vector<std::map<std::string, LocalEntry>::iterator> entries;
+    entries.reserve(local_.size());
+    for (auto it = local_.begin(); it != local_.end(); ++it) entries.push_back(it);
+
+    size_t batch = std::max<size_t>(1, entries.size() / 10);
+    std::nth_element(entries.begin(), entries.begin() + (batch - 1), entries.end(),
+        [](const auto& a, const auto& b) { return a->second.expiresAt < b->second.expiresAt; });
+    for (size_t i = 0; i < batch; ++i) local_.erase(entries[i]);
+}
+
+// ============================================================================
+// INVALIDATION
+// ============================================================================
+size_t SignalCacheService::invalidateAround(double lat, double lon, double radiusMeters) {
+    size_t removed = invalidateAround(std::vector<std::pair<double, double>>{{lon, lat}}, radiusMeters);
+    LOG_INFO << "🗑️ Signal cache invalidated around (" << lat << ", " << lon << "), r=" << radiusMeters
+             << " m: " << removed << " local entries";
+    return removed;
+}
+
+size_t SignalCacheService::invalidateAround(const std::vector<std::pair<double, double>>& positions,
+                                            double radiusMeters) {
+    std::set<std::string> prefixes;
+    for (const auto& [lon, lat] : positions) {
+        for (auto& gh : Geohash::coveringCells(lat, lon, radiusMeters, INVALIDATION_PRECISION)) {
+            prefixes.insert(std::move(gh));
+        }
+    }
+    if (prefixes.empty()) return 0;
+
+    bumpGeneration();
+    size_t removed = 0;
+    {
+        // Les clés L1 commençant par "signal:<gh5>" sont contiguës dans la map ordonnée
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& gh : prefixes) {
+            std::string prefix = "signal:" + gh;
+            auto it = local_.lower_bound(prefix);
+            while (it != local_.end() && it->first.compare(0, prefix.size(), prefix) == 0) {
+                it = local_.erase(it);
+                removed++;
+            }
+        }
+    }
+
+    for (const auto& gh : prefixes) {
+        CacheService::getInstance().delPattern("signal:" + gh + "*");
+    }
+
+    invalidations_++;
+    return removed;
+}
+
+void SignalCacheService::invalidateAll() {
+    bumpGeneration();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        local_.clear();
+    }
+    CacheService::getInstance().delPattern("signal:*");
+    invalidations_++;
+}
+
+Json::Value SignalCacheService::getStats() {
+    Json::Value stats;
+    stats["precision"] = precision_;
+    stats["local_ttl_s"] = localTtlSeconds_;
+    stats["redis_ttl_s"] = redisTtlSeconds_;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats["local_entries"] = static_cast<Json::UInt64>(local_.size());
+    }
+    stats["local_hits"] = static_cast<Json::UInt64>(localHits_.load());
+    stats["redis_hits"] = static_cast<Json::UInt64>(redisHits_.load());
+    stats["misses"] = static_cast<Json::UInt64>(misses_.load());
+    stats["invalidations"] = static_cast<Json::UInt64>(invalidations_.load());
+    // Résultats calculés avant une invalidation, non mis en cache
+    stats["stale_drops"] = static_cast<Json::UInt64>(staleDrops_.load());
+    return stats;
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <drogon/drogon.h>
+#include <json/json.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Cache des résultats de simulation de signal (/api/simulation/check)
+ *
+ * Les positions sont quantifiées en cellules geohash (précision 7 par défaut,
+ * ~150 m) : deux clics dans la même cellule partagent le même résultat.
+ *
+ * Deux niveaux :
+ * - L1 en mémoire (map ordonnée, TTL court) : invalidation par préfixe en O(log n)
+ * - L2 Redis via CacheService (partagé entre instances, TTL plus long)
+ *
+ * Clé : signal:<geohash>:op:<id|all>:tech:<tech|all>
+ */
+class SignalCacheService {
+public:
+    enum class Tier { None, Local, Redis };
+
+    static SignalCacheService& getInstance();
+
+    // Précision geohash des cellules (custom_config.simulation.cache.precision)
+    int precision() const { return precision_; }
+
+    std::string makeKey(const std::string& cell, std::optional<int> operatorId,
+                        const std::optional<std::string>& technology) const;
+
+    /**
+     * Génération du cache, relevée par get() avant le calcul d'un résultat manquant
+     *
+     * - local : époque de l'instance, incrémentée par chaque invalidation
+     * - shared : compteur Redis partagé entre instances (GENERATION_KEY)
+     * put() ignore un résultat dont le calcul a commencé avant une invalidation :
+     * il peut avoir lu les antennes d'avant la modification.
+     */
+    struct Generation {
+        uint64_t local = 0;
+        std::optional<std::string> shared;
+    };
+
+    // Recherche L1 puis L2 (un hit Redis réalimente le L1) ; relève la génération
+    std::optional<Json::Value> get(const std::string& key, Tier& tier, Generation& generation);
+    void put(const std::string& key, const Json::Value& result, const Generation& generation);
+
+    /**
+     * Invalide les cellules à moins de radiusMeters d'un point
+     * (antenne ajoutée, déplacée, supprimée ou modifiée)
+     *
+     * Les préfixes geohash de précision 5 couvrant le cercle sont purgés
+     * dans les deux niveaux. Retourne le nombre d'entrées L1 supprimées.
+     */
+    size_t invalidateAround(double lat, double lon, double radiusMeters);
+
+    // Même invalidation pour plusieurs positions (lon, lat) : préfixes dédoublonnés,
+    // une seule purge Redis par préfixe (changements d'antennes du ChangeFeedService)
+    size_t invalidateAround(const std::vector<std::pair<double, double>>& positions, double radiusMeters);
+    void invalidateAll();
+
+    Json::Value getStats();
+
+private:
+    SignalCacheService();
+
+    struct LocalEntry {
+        std::shared_ptr<const Json::Value> value;
+        std::chrono::steady_clock::time_point expiresAt;
+    };
+
+    // Précision des préfixes d'invalidation (~4,9 km)
+    static constexpr int INVALIDATION_PRECISION = 5;
+    // Hors du préfixe "signal:" : jamais supprimée par les purges
+    static constexpr const char* GENERATION_KEY = "signal_cache:generation";
+
+    // Nouvelle génération, avant toute purge (les calculs en vol n'écriront pas)
+    void bumpGeneration();
+
+    void evictLocked(std::chrono::steady_clock::time_point now);
+
+    int precision_;
+    int localTtlSeconds_;
+    int redisTtlSeconds_;
+    size_t maxLocalEntries_;
+
+    std::mutex mutex_;
+    std::map<std::string, LocalEntry> local_;
+
+    std::atomic<uint64_t> localHits_{0};
+    std::atomic<uint64_t> redisHits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> invalidations_{0};
+    std::atomic<uint64_t> epoch_{0};
+    std::atomic<uint64_t> staleDrops_{0};
+};
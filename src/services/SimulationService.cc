@@ -1,20 +1,10 @@
 #include "SimulationService.h"
+#include "../utils/RadioModel.h"
 #include <cmath>
 
 using namespace drogon;
 using namespace drogon::orm;
 
-// Fréquences standards utilisées pour les calculs de simulation
-const double FREQ_4G = 2600.0; // MHz
-const double FREQ_5G = 3500.0; // MHz
-
-// Puissance d'émission effective (EIRP) en dBm pour chaque technologie
-const double POWER_4G = 46.0; // ~40 Watts
-const double POWER_5G = 50.0; // ~100 Watts
-
-// Atténuation moyenne causée par les obstacles en béton/brique
-const double OBSTACLE_LOSS = 25.0; // dB
-
 void SimulationService::checkSignalAtPosition(double lat, double lon,
                                               std::optional<int> operatorId,
                                               std::optional<std::string> technology,
@@ -42,7 +32,8 @@ void SimulationService::checkSignalAtPosition(double lat, double lon,
                 )
             ) as blocked
         FROM antenna a
-        WHERE ST_DWithin(a.geom::geography, ST_SetSRID(ST_MakePoint($1, $2), 4326)::geography, 5000)
+        WHERE ST_DWithin(a.geom::geography, ST_SetSRID(ST_MakePoint($1, $2), 4326)::geography, )" +
+        std::to_string(static_cast<int>(SEARCH_RADIUS_M)) + R"()
     )";
 
     // Ajouter les filtres selon les paramètres
@@ -65,27 +56,15 @@ void SimulationService::checkSignalAtPosition(double lat, double lon,
                 report.distance_km = row["dist_km"].as<double>();
                 report.has_obstacle = row["blocked"].as<bool>();
 
-                // Sélection des paramètres radio selon la technologie
-                double freq = (report.technology == "5G") ? FREQ_5G : FREQ_4G;
-                double tx_power = (report.technology == "5G") ? POWER_5G : POWER_4G;
-
-                // Calcul de la perte en espace libre selon la formule standard
-                // FSPL = 20*log10(distance) + 20*log10(fréquence) + 32.45
-                double fspl = 20 * log10(report.distance_km) + 20 * log10(freq) + 32.45;
-
-                // Calcul de la puissance reçue avant pénalités
-                double rx_power = tx_power - fspl;
-
-                // Application de la pénalité si un obstacle bloque la ligne de vue
-                if (report.has_obstacle) {
-                    rx_power -= OBSTACLE_LOSS;
-                }
+                // Puissance reçue selon le modèle FSPL (paramètres radio par technologie)
+                // avec pénalité si un obstacle bloque la ligne de vue
+                double rx_power = RadioModel::receivedPower(report.technology, report.distance_km, report.has_obstacle);
 
                 report.signal_strength_dbm = round(rx_power * 100) / 100; // Arrondi à 2 décimales
                 report.signal_quality = getQualityLabel(report.signal_strength_dbm);
 
                 // Filtrage des signaux trop faibles (< -120 dBm = seuil de détection)
-                if (report.signal_strength_dbm > -120.0) {
+                if (report.signal_strength_dbm > RadioModel::DETECTION_THRESHOLD_DBM) {
                     reports.push_back(report);
                 }
             }
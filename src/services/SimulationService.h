@@ -29,6 +29,9 @@ struct SignalReport {
 
 class SimulationService {
 public:
+    // Rayon de recherche des antennes autour du point simulé (mètres)
+    static constexpr double SEARCH_RADIUS_M = 5000.0;
+
     // Calcule le signal pour un point GPS donné
     static void checkSignalAtPosition(double lat, double lon,
                                       std::optional<int> operatorId,
@@ -0,0 +1,333 @@
+#include "ViewshedService.h"
+#include "../utils/ErrorHandler.h"
+#include "../utils/GeoUtils.h"
+#include "../utils/RadioModel.h"
+#include "../utils/Parallel.h"
+#include "../utils/PgCopy.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace {
+    std::atomic<bool> recomputeRunning{false};
+    std::mutex statusMutex;
+    Json::Value lastRun(Json::nullValue);
+
+    void recordRun(const Json::Value& stats) {
+        std::lock_guard<std::mutex> lock(statusMutex);
+        lastRun = stats;
+    }
+
+    struct Target {
+        int id;
+        double lon;
+        double lat;
+        double radius;
+    };
+
+    // Cellules de l'index d'obstacles (~1,1 km)
+    constexpr double OBSTACLE_CELL_DEG = 0.01;
+}
+
+// ============================================================================
+// LANCER DE RAYONS
+// ============================================================================
+Ring ViewshedService::castViewshed(double lon, double lat, double radiusMeters,
+                                   const std::vector<const Shape*>& obstacles,
+                                   int rays, double simplifyTolerance)
+{
+    const double step = 2 * GeoUtils::PI / rays;
+    LocalFrame frame(lon, lat);
+    const Point2 origin{0.0, 0.0};
+
+    std::vector<double> cosTable(rays), sinTable(rays);
+    for (int k = 0; k < rays; ++k) {
+        cosTable[k] = std::cos(k * step);
+        sinTable[k] = std::sin(k * step);
+    }
+
+    // Distance du premier obstacle sur chaque rayon
+    std::vector<double> firstHit(rays, std::numeric_limits<double>::infinity());
+
+    // Seuls les rayons compris dans le secteur angulaire du segment sont testés
+    auto castEdge = [&](const Point2& p, const Point2& q) {
+        if (Geometry::distanceToSegment(origin, p, q) >= radiusMeters) return;
+
+        double ap = std::atan2(p.y, p.x);
+        double aq = std::atan2(q.y, q.x);
+        double delta = aq - ap;
+        if (delta > GeoUtils::PI) delta -= 2 * GeoUtils::PI;
+        if (delta <= -GeoUtils::PI) delta += 2 * GeoUtils::PI;
+        double lower = delta >= 0 ? ap : aq;
+        double upper = lower + std::fabs(delta);
+
+        double ex = q.x - p.x, ey = q.y - p.y;
+        long first = static_cast<long>(std::ceil(lower / step));
+        long last = static_cast<long>(std::floor(upper / step));
+        for (long i = first; i <= last; ++i) {
+            int k = static_cast<int>(((i % rays) + rays) % rays);
+            double denom = cosTable[k] * ey - sinTable[k] * ex;
+            if (std::fabs(denom) < 1e-12) continue; // Rayon parallèle au segment
+            double t = (p.x * ey - p.y * ex) / denom;
+            if (t > 0 && t < firstHit[k]) firstHit[k] = t;
+        }
+    };
+
+    auto castPath = [&](const std::vector<Point2>& path) {
+        for (size_t i = 1; i < path.size(); ++i) {
+            castEdge(path[i - 1], path[i]);
+        }
+    };
+
+    std::vector<Point2> local;
+    for (const Shape* shape : obstacles) {
+        for (const auto& poly : shape->polygons) {
+            Polygon2 lp;
+            lp.rings.reserve(poly.rings.size());
+            for (const auto& ring : poly.rings) {
+                local.clear();
+                for (const auto& pt : ring) local.push_back(frame.toLocal(pt));
+                lp.rings.push_back(local);
+            }
+            // Antenne posée sur (ou dans) l'obstacle : il ne masque rien
+            if (Geometry::pointInPolygon(origin, lp)) continue;
+            for (const auto& ring : lp.rings) castPath(ring);
+        }
+        for (const auto& line : shape->lines) {
+            local.clear();
+            for (const auto& pt : line) local.push_back(frame.toLocal(pt));
+            castPath(local);
+        }
+    }
+
+    // Portée derrière un obstacle : FSPL en 20·log10(d), la pénalité se traduit en facteur de distance
+    const double obstructedReach = radiusMeters * std::pow(10.0, -RadioModel::OBSTACLE_LOSS / 20.0);
+
+    Ring ring;
+    ring.reserve(rays + 1);
+    for (int k = 0; k < rays; ++k) {
+        double reach = radiusMeters;
+        if (firstHit[k] < radiusMeters) {
+            reach = std::max(firstHit[k], obstructedReach);
+        }
+        ring.push_back({reach * cosTable[k], reach * sinTable[k]});
+    }
+    ring.push_back(ring.front());
+
+    ring = Geometry::simplifyRing(ring, simplifyTolerance);
+    for (auto& pt : ring) pt = frame.toLonLat(pt);
+    return ring;
+}
+
+// ============================================================================
+// PRÉCALCUL DES EMPREINTES
+// ============================================================================
+bool ViewshedService::recompute(
+    bool fullRebuild,
+    std::function<void(const Json::Value&, const std::string&)> callback)
+{
+    bool expected = false;
+    if (!recomputeRunning.compare_exchange_strong(expected, true)) {
+        return false;
+    }
+
+    const auto& config = app().getCustomConfig()["viewshed"];
+    int rays = std::max(16, config.get("rays", 360).asInt());
+    double simplifyRatio = config.get("simplify_ratio", 0.01).asDouble();
+
+    auto client = app().getDbClient();
+    std::string connInfo = client->connectionInfo();
+
+    Parallel::runInBackground([callback, fullRebuild, rays, simplifyRatio, client, connInfo]() {
+        auto startedAt = std::chrono::steady_clock::now();
+        Json::Value stats;
+        stats["mode"] = fullRebuild ? "full" : "dirty";
+        stats["started_at"] = trantor::Date::now().toFormattedString(false);
+        stats["rays"] = rays;
+
+        try {
+            // Horodatage de référence : une antenne re-marquée pendant le calcul reste à recalculer
+            double snapshotEpoch = client->execSqlSync(
+                "SELECT extract(epoch FROM clock_timestamp())::double precision AS t")[0]["t"].as<double>();
+
+            std::string targetFilter = fullRebuild
+                ? "a.status = 'active'"
+                : "a.status = 'active' AND a.viewshed_dirty_at IS NOT NULL";
+
+            // ========== ANTENNES À TRAITER ==========
+            auto antennaRows = client->execSqlSync(
+                "SELECT a.id, a.coverage_radius, ST_X(a.geom::geometry) AS lon, ST_Y(a.geom::geometry) AS lat "
+                "FROM antenna a WHERE " + targetFilter);
+
+            std::vector<Target> targets;
+            targets.reserve(antennaRows.size());
+            for (auto row : antennaRows) {
+                targets.push_back({row["id"].as<int>(), row["lon"].as<double>(),
+                                   row["lat"].as<double>(), row["coverage_radius"].as<double>()});
+            }
+            stats["antennas"] = static_cast<Json::UInt64>(targets.size());
+
+            if (targets.empty()) {
+                stats["obstacles"] = 0;
+                stats["updated"] = 0;
+                stats["duration_ms"] = 0;
+                recordRun(stats);
+                recomputeRunning = false;
+                callback(stats, "");
+                return;
+            }
+
+            // ========== OBSTACLES À PORTÉE ==========
+            std::string obstacleSql = fullRebuild
+                ? "SELECT ST_AsGeoJSON(o.geom, 7) AS geojson FROM obstacle o"
+                : "SELECT ST_AsGeoJSON(o.geom, 7) AS geojson FROM obstacle o "
+                  "WHERE EXISTS (SELECT 1 FROM antenna a WHERE " + targetFilter +
+                  " AND ST_DWithin(o.geom::geography, a.geom::geography, a.coverage_radius))";
+            auto obstacleRows = client->execSqlSync(obstacleSql);
+
+            std::vector<std::string> rawObstacles;
+            rawObstacles.reserve(obstacleRows.size());
+            for (auto row : obstacleRows) {
+                if (!row["geojson"].isNull()) rawObstacles.push_back(row["geojson"].as<std::string>());
+            }
+
+            // Parsing GeoJSON en parallèle (chaque thread écrit ses propres cases)
+            std::vector<Shape> shapes(rawObstacles.size());
+            std::vector<char> valid(rawObstacles.size(), 0);
+            Parallel::forRange(rawObstacles.size(), [&](size_t begin, size_t end) {
+                Json::CharReaderBuilder builder;
+                std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+                for (size_t i = begin; i < end; ++i) {
+                    Json::Value geom;
+                    std::string errs;
+                    const auto& s = rawObstacles[i];
+                    if (reader->parse(s.c_str(), s.c_str() + s.size(), &geom, &errs)) {
+                        valid[i] = Geometry::fromGeoJson(geom, shapes[i]) ? 1 : 0;
+                    }
+                }
+            });
+
+            BoxIndex obstacleIndex(OBSTACLE_CELL_DEG);
+            for (size_t i = 0; i < shapes.size(); ++i) {
+                if (valid[i]) {
+                    obstacleIndex.insert(i, shapes[i].minX, shapes[i].minY, shapes[i].maxX, shapes[i].maxY);
+                }
+            }
+            stats["obstacles"] = static_cast<Json::UInt64>(shapes.size());
+
+            // ========== LANCER DE RAYONS (parallèle) ==========
+            size_t workers = Parallel::workerCount();
+            std::vector<std::string> buffers(workers);
+            std::atomic<size_t> slot{0};
+
+            Parallel::forRange(targets.size(), [&](size_t begin, size_t end) {
+                auto& out = buffers[slot++ % workers];
+                std::vector<const Shape*> candidates;
+                for (size_t i = begin; i < end; ++i) {
+                    const auto& t = targets[i];
+                    double dLat = GeoUtils::metersToDegreesLat(t.radius);
+                    double dLon = GeoUtils::metersToDegreesLon(t.radius, t.lat);
+
+                    candidates.clear();
+                    for (size_t idx : obstacleIndex.query(t.lon - dLon, t.lat - dLat, t.lon + dLon, t.lat + dLat)) {
+                        const auto& s = shapes[idx];
+                        if (s.maxX < t.lon - dLon || s.minX > t.lon + dLon ||
+                            s.maxY < t.lat - dLat || s.minY > t.lat + dLat) continue;
+                        candidates.push_back(&s);
+                    }
+
+                    Ring ring = castViewshed(t.lon, t.lat, t.radius, candidates, rays, t.radius * simplifyRatio);
+                    out += std::to_string(t.id);
+                    out += '\t';
+                    out += Geometry::ringToWkt(ring);
+                    out += '\n';
+                }
+            });
+
+            // ========== PERSISTANCE ==========
+            // COPY dans une table temporaire puis UPDATE ensembliste
+            char cutoff[64];
+            std::snprintf(cutoff, sizeof(cutoff), "to_timestamp(%.6f)", snapshotEpoch);
+
+            PgCopy copy(connInfo);
+            copy.exec("BEGIN");
+            copy.exec("CREATE TEMP TABLE viewshed_load (antenna_id INTEGER, wkt TEXT) ON COMMIT DROP");
+            copy.begin("COPY viewshed_load (antenna_id, wkt) FROM STDIN");
+            for (const auto& buf : buffers) {
+                copy.putLine(buf);
+            }
+            long rows = copy.end();
+            copy.exec(std::string(
+                "UPDATE antenna a "
+                "SET viewshed_geom = ST_Multi(ST_CollectionExtract(ST_MakeValid(ST_GeomFromText(v.wkt, 4326)), 3)), "
+                "    viewshed_dirty_at = NULL "
+                "FROM viewshed_load v "
+                "WHERE a.id = v.antenna_id "
+                "AND (a.viewshed_dirty_at IS NULL OR a.viewshed_dirty_at < ") + cutoff + ")");
+            copy.exec("COMMIT");
+            // Couvertures en cache : le trigger de antenna marque les tuiles touchées,
+            // leur recalcul purge les blocs correspondants
+
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - startedAt).count();
+            stats["updated"] = static_cast<Json::Int64>(rows);
+            stats["duration_ms"] = static_cast<Json::Int64>(elapsed);
+
+            LOG_INFO << "🏔️ Viewsheds recomputed (" << (fullRebuild ? "full" : "dirty") << "): "
+                     << targets.size() << " antennas, " << shapes.size() << " obstacles in "
+                     << elapsed << " ms";
+
+            recordRun(stats);
+            recomputeRunning = false;
+            callback(stats, "");
+        } catch (const DrogonDbException& e) {
+            auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+            ErrorHandler::logError("ViewshedService::recompute", errorDetails);
+            stats["error"] = errorDetails.userMessage;
+            recordRun(stats);
+            recomputeRunning = false;
+            callback(Json::Value(), errorDetails.userMessage);
+        } catch (const std::exception& e) {
+            auto errorDetails = ErrorHandler::analyzePostgresError(e.what());
+            ErrorHandler::logError("ViewshedService::recompute", errorDetails);
+            stats["error"] = errorDetails.userMessage;
+            recordRun(stats);
+            recomputeRunning = false;
+            callback(Json::Value(), errorDetails.userMessage);
+        }
+    });
+
+    return true;
+}
+
+void ViewshedService::scheduleRefresh() {
+    double interval = app().getCustomConfig()["viewshed"].get("refresh_interval_s", 300.0).asDouble();
+    if (interval <= 0) return;
+
+    app().getLoop()->runEvery(interval, []() {
+        // Ignoré si un recalcul (manuel ou précédent) est encore en cours
+        recompute(false, [](const Json::Value& stats, const std::string& err) {
+            if (!err.empty()) {
+                LOG_ERROR << "Scheduled viewshed refresh failed: " << err;
+            }
+        });
+    });
+    LOG_INFO << "🏔️ Viewshed refresh scheduled every " << interval << " s";
+}
+
+Json::Value ViewshedService::getStatus() {
+    Json::Value status;
+    status["running"] = recomputeRunning.load();
+    {
+        std::lock_guard<std::mutex> lock(statusMutex);
+        status["last_run"] = lastRun;
+    }
+    return status;
+}
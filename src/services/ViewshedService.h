@@ -0,0 +1,47 @@
+#pragma once
+#include "../utils/Geometry.h"
+#include <drogon/drogon.h>
+#include <vector>
+#include <string>
+#include <functional>
+
+class ViewshedService {
+public:
+    // ========== LANCER DE RAYONS ==========
+    /**
+     * Empreinte de couverture d'une antenne tenant compte des obstacles
+     *
+     * `rays` rayons sont lancés depuis l'antenne jusqu'à coverage_radius.
+     * Au-delà du premier obstacle rencontré, la portée est réduite selon
+     * la pénalité RadioModel::OBSTACLE_LOSS (même modèle que la simulation) :
+     * en espace libre, -25 dB équivalent à une portée divisée par 10^(25/20).
+     * Les obstacles contenant l'antenne (antenne en toiture) sont ignorés.
+     *
+     * @param obstacles - Obstacles candidats (coordonnées lon/lat)
+     * @param simplifyTolerance - Tolérance Douglas-Peucker en mètres (0 = aucune)
+     * @return Anneau fermé en lon/lat
+     */
+    static Ring castViewshed(double lon, double lat, double radiusMeters,
+                             const std::vector<const Shape*>& obstacles,
+                             int rays, double simplifyTolerance);
+
+    // ========== PRÉCALCUL (job batch) ==========
+    /**
+     * Recalcule la colonne antenna.viewshed_geom
+     *
+     * - fullRebuild = false : uniquement les antennes marquées par les triggers
+     *   (antenne déplacée / rayon modifié, obstacle ajouté / modifié / supprimé à portée)
+     * - fullRebuild = true : toutes les antennes actives
+     *
+     * Le job tourne en arrière-plan ; le callback reçoit les statistiques d'exécution.
+     * Retourne false si un recalcul est déjà en cours.
+     */
+    static bool recompute(bool fullRebuild,
+                          std::function<void(const Json::Value&, const std::string&)> callback);
+
+    // Recalcul périodique des antennes marquées (custom_config.viewshed.refresh_interval_s)
+    static void scheduleRefresh();
+
+    // État du dernier recalcul (pour monitoring)
+    static Json::Value getStatus();
+};
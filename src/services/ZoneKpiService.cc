@@ -0,0 +1,610 @@
+#include "ZoneKpiService.h"
+#include "AntenneService.h"
+#include "CacheService.h"
+#include "../utils/CoverageRaster.h"
+#include "../utils/ErrorHandler.h"
+#include "../utils/Geometry.h"
+#include "../utils/Parallel.h"
+#include "../utils/PgCopy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace {
+    std::atomic<bool> recomputeRunning{false};
+    std::mutex statusMutex;
+    Json::Value lastRun(Json::nullValue);
+
+    void recordRun(const Json::Value& stats) {
+        std::lock_guard<std::mutex> lock(statusMutex);
+        lastRun = stats;
+    }
+
+    // Zone administrative ; seules les feuilles (sans enfant administratif) sont rastérisées
+    struct KpiZone {
+        int id;
+        int parent = -1;                  // Indice du parent dans la liste, -1 = racine
+        double density;                   // habitants/km², repli hors cellules density_zone
+        bool leaf;
+        std::vector<Polygon2> polygons;   // Feuilles uniquement (lon/lat)
+        double minLon = 0, minLat = 0, maxLon = 0, maxLat = 0;
+    };
+
+    struct KpiAntenna {
+        int operator_id;
+        std::string technology;
+        double lon, lat;
+    };
+
+    // Polygones d'une variante (opérateur, technologie) dans une tuile
+    struct TileCoverage {
+        size_t tile;                      // Indice de la tuile dans le lot
+        size_t variant;
+        std::vector<Polygon2> polygons;
+    };
+
+    // Cellule de population (rectangle de la grille density_zone)
+    struct DensityCell {
+        double minLon, minLat, maxLon, maxLat;
+        double density;
+    };
+
+    // Cumuls d'un thread : par zone, puis par zone × variante (indice zone * variantes + variante)
+    struct Accumulator {
+        std::vector<double> area, population;
+        std::vector<double> coveredArea, coveredPopulation;
+        std::vector<int> antennas;
+
+        Accumulator(size_t zones, size_t variants)
+            : area(zones, 0), population(zones, 0),
+              coveredArea(zones * variants, 0), coveredPopulation(zones * variants, 0),
+              antennas(zones * variants, 0) {}
+    };
+
+    int64_t tileKey(int x, int y) {
+        return (static_cast<int64_t>(x) << 32) | static_cast<uint32_t>(y);
+    }
+
+    std::string sqlQuote(const std::string& s) {
+        std::string out = "'";
+        for (char c : s) {
+            if (c == '\'') out += '\'';
+            out += c;
+        }
+        return out + "'";
+    }
+
+    Polygon2 toPixels(const TileProjection& proj, const Polygon2& poly) {
+        Polygon2 local;
+        for (const auto& ring : poly.rings) {
+            Ring r;
+            r.reserve(ring.size());
+            for (const auto& p : ring) r.push_back(proj.toPixel(p.x, p.y));
+            local.rings.push_back(std::move(r));
+        }
+        return local;
+    }
+
+    // Une tuile : rasters zone / population partagés, puis un masque par variante couverte
+    void accumulateTile(int x, int y, int size,
+                        const std::vector<KpiZone>& zones, const std::vector<size_t>& leaves,
+                        const std::vector<DensityCell>& cells,
+                        const std::vector<const TileCoverage*>& coverage,
+                        const std::vector<const KpiAntenna*>& antennas,
+                        const std::map<std::pair<int, std::string>, size_t>& variantIndex,
+                        Accumulator& acc) {
+        const size_t variants = variantIndex.size();
+        TileProjection proj(AntenneService::COVERAGE_TILE_ZOOM, x, y, size);
+        const size_t pixels = static_cast<size_t>(size) * size;
+
+        // ========== RASTER DES ZONES ==========
+        std::vector<int32_t> zoneIds(pixels, -1);
+        std::vector<CoverageRaster::Span> spans;
+        bool any = false;
+        for (size_t z : leaves) {
+            for (const auto& poly : zones[z].polygons) {
+                spans.clear();
+                CoverageRaster::polygonSpans(toPixels(proj, poly), size, size, spans);
+                for (const auto& s : spans) {
+                    std::fill(zoneIds.begin() + static_cast<size_t>(s.row) * size + s.x0,
+                              zoneIds.begin() + static_cast<size_t>(s.row) * size + s.x1 + 1,
+                              static_cast<int32_t>(z));
+                    any = true;
+                }
+            }
+        }
+        if (!any) return;
+
+        // ========== RASTER DE POPULATION ==========
+        std::vector<float> density(pixels, -1.0f);
+        for (const auto& c : cells) {
+            Point2 nw = proj.toPixel(c.minLon, c.maxLat);
+            Point2 se = proj.toPixel(c.maxLon, c.minLat);
+            int x0 = std::max(0, static_cast<int>(std::ceil(nw.x - 0.5)));
+            int x1 = std::min(size - 1, static_cast<int>(std::floor(se.x - 0.5)));
+            int y0 = std::max(0, static_cast<int>(std::ceil(nw.y - 0.5)));
+            int y1 = std::min(size - 1, static_cast<int>(std::floor(se.y - 0.5)));
+            for (int row = y0; row <= y1; ++row) {
+                for (int col = x0; col <= x1; ++col) {
+                    density[static_cast<size_t>(row) * size + col] = static_cast<float>(c.density);
+                }
+            }
+        }
+
+        // Surface d'un pixel (km²) : ne dépend que de la ligne en Web Mercator
+        std::vector<double> rowArea(size);
+        for (int row = 0; row < size; ++row) {
+            double side = proj.pixelMeters(row);
+            rowArea[row] = side * side / 1e6;
+        }
+
+        std::vector<double> population(pixels, 0);
+        for (int row = 0; row < size; ++row) {
+            for (int col = 0; col < size; ++col) {
+                size_t i = static_cast<size_t>(row) * size + col;
+                int32_t z = zoneIds[i];
+                if (z < 0) continue;
+                double d = density[i] >= 0 ? density[i] : zones[z].density;
+                population[i] = rowArea[row] * d;
+                acc.area[z] += rowArea[row];
+                acc.population[z] += population[i];
+            }
+        }
+
+        // ========== MASQUES DE COUVERTURE ==========
+        for (const auto* tc : coverage) {
+            CoverageRaster mask(size, size);
+            spans.clear();
+            for (const auto& poly : tc->polygons) {
+                CoverageRaster::polygonSpans(toPixels(proj, poly), size, size, spans);
+            }
+            if (!mask.fill(spans)) continue;
+
+            for (int row = 0; row < size; ++row) {
+                for (int col = 0; col < size; ++col) {
+                    size_t i = static_cast<size_t>(row) * size + col;
+                    int32_t z = zoneIds[i];
+                    if (z < 0 || !mask.get(col, row)) continue;
+                    size_t k = static_cast<size_t>(z) * variants + tc->variant;
+                    acc.coveredArea[k] += rowArea[row];
+                    acc.coveredPopulation[k] += population[i];
+                }
+            }
+        }
+
+        // ========== ANTENNES ==========
+        // Zone de l'antenne lue dans le raster : pas de point-dans-polygone par antenne
+        for (const auto* a : antennas) {
+            Point2 p = proj.toPixel(a->lon, a->lat);
+            int col = static_cast<int>(std::floor(p.x));
+            int row = static_cast<int>(std::floor(p.y));
+            if (col < 0 || row < 0 || col >= size || row >= size) continue;
+            int32_t z = zoneIds[static_cast<size_t>(row) * size + col];
+            if (z < 0) continue;
+            const std::pair<int, std::string> keys[] = {
+                {-1, "*"}, {a->operator_id, "*"}, {-1, a->technology}, {a->operator_id, a->technology}};
+            for (const auto& key : keys) {
+                auto it = variantIndex.find(key);
+                if (it != variantIndex.end()) acc.antennas[static_cast<size_t>(z) * variants + it->second]++;
+            }
+        }
+    }
+}
+
+// ============================================================================
+// RECALCUL DES INDICATEURS
+// ============================================================================
+bool ZoneKpiService::recompute(std::function<void(const Json::Value&, const std::string&)> callback) {
+    bool expected = false;
+    if (!recomputeRunning.compare_exchange_strong(expected, true)) {
+        return false;
+    }
+
+    const auto& config = app().getCustomConfig()["zone_kpi"];
+    int rasterSize = std::max(64, config.get("raster_size", 256).asInt());
+    int batchTiles = std::max(1, config.get("batch_tiles", 64).asInt());
+    double tolerance = config.get("simplify_tolerance", 0.0005).asDouble();
+
+    std::string adminTypes;
+    const Json::Value& types = config["admin_types"];
+    if (types.isArray() && !types.empty()) {
+        for (const auto& t : types) {
+            if (!adminTypes.empty()) adminTypes += ", ";
+            adminTypes += sqlQuote(t.asString());
+        }
+    } else {
+        adminTypes = "'country', 'region', 'province', 'commune'";
+    }
+
+    auto client = app().getDbClient();
+    std::string connInfo = client->connectionInfo();
+
+    Parallel::runInBackground([callback, rasterSize, batchTiles, tolerance, adminTypes, client, connInfo]() {
+        auto startedAt = std::chrono::steady_clock::now();
+        Json::Value stats;
+        stats["started_at"] = trantor::Date::now().toFormattedString(false);
+        stats["raster_size"] = rasterSize;
+
+        try {
+            // ========== ZONES ADMINISTRATIVES ==========
+            auto zoneRows = client->execSqlSync(R"(
+                WITH admin AS (
+                    SELECT id, parent_id, density, geom FROM zone WHERE type::text IN ()" + adminTypes + R"()
+                )
+                SELECT a.id, a.parent_id, COALESCE(a.density, 0) AS density,
+                       CASE WHEN EXISTS (SELECT 1 FROM admin c WHERE c.parent_id = a.id) THEN NULL
+                            ELSE ST_AsGeoJSON(ST_SimplifyPreserveTopology(a.geom, $1), 6) END AS geojson
+                FROM admin a
+            )", tolerance);
+
+            std::vector<KpiZone> zones(zoneRows.size());
+            std::vector<std::string> rawGeoms(zoneRows.size());
+            std::unordered_map<int, size_t> zoneById;
+            std::vector<int> parentIds(zoneRows.size(), 0);
+            for (size_t i = 0; i < zoneRows.size(); ++i) {
+                auto row = zoneRows[i];
+                zones[i].id = row["id"].as<int>();
+                zones[i].density = row["density"].as<double>();
+                zones[i].leaf = !row["geojson"].isNull();
+                if (zones[i].leaf) rawGeoms[i] = row["geojson"].as<std::string>();
+                if (!row["parent_id"].isNull()) parentIds[i] = row["parent_id"].as<int>();
+                zoneById[zones[i].id] = i;
+            }
+            for (size_t i = 0; i < zones.size(); ++i) {
+                auto it = zoneById.find(parentIds[i]);
+                if (it != zoneById.end()) zones[i].parent = static_cast<int>(it->second);
+            }
+
+            // Parsing GeoJSON des feuilles en parallèle (chaque thread écrit ses propres cases)
+            Parallel::forRange(zones.size(), [&](size_t begin, size_t end) {
+                Json::CharReaderBuilder builder;
+                std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+                for (size_t i = begin; i < end; ++i) {
+                    const auto& s = rawGeoms[i];
+                    Json::Value geom;
+                    std::string errs;
+                    Shape shape;
+                    if (!s.empty() && reader->parse(s.c_str(), s.c_str() + s.size(), &geom, &errs) &&
+                        Geometry::fromGeoJson(geom, shape)) {
+                        zones[i].polygons = std::move(shape.polygons);
+                        zones[i].minLon = shape.minX;
+                        zones[i].minLat = shape.minY;
+                        zones[i].maxLon = shape.maxX;
+                        zones[i].maxLat = shape.maxY;
+                    }
+                }
+            });
+
+            BoxIndex leafIndex(0.25);
+            std::vector<int64_t> tileKeys;
+            size_t leafCount = 0;
+            for (size_t i = 0; i < zones.size(); ++i) {
+                const auto& z = zones[i];
+                if (z.polygons.empty()) continue;
+                leafCount++;
+                leafIndex.insert(i, z.minLon, z.minLat, z.maxLon, z.maxLat);
+                auto range = AntenneService::coverageTileRange(z.minLat, z.minLon, z.maxLat, z.maxLon);
+                for (int ty = range.minY; ty <= range.maxY; ++ty) {
+                    for (int tx = range.minX; tx <= range.maxX; ++tx) tileKeys.push_back(tileKey(tx, ty));
+                }
+            }
+            std::sort(tileKeys.begin(), tileKeys.end());
+            tileKeys.erase(std::unique(tileKeys.begin(), tileKeys.end()), tileKeys.end());
+            stats["zones"] = static_cast<Json::UInt64>(zones.size());
+            stats["leaf_zones"] = static_cast<Json::UInt64>(leafCount);
+            stats["tiles"] = static_cast<Json::UInt64>(tileKeys.size());
+
+            // ========== VARIANTES (filtres présents dans les tuiles de couverture) ==========
+            std::map<std::pair<int, std::string>, size_t> variantIndex{{{-1, "*"}, 0}};
+            for (auto row : client->execSqlSync("SELECT DISTINCT operator_id, technology FROM coverage_tile")) {
+                variantIndex.try_emplace({row["operator_id"].as<int>(), row["technology"].as<std::string>()},
+                                         variantIndex.size());
+            }
+            const size_t variants = variantIndex.size();
+            std::vector<std::pair<int, std::string>> variantKeys(variants);
+            for (const auto& [key, idx] : variantIndex) variantKeys[idx] = key;
+            stats["variants"] = static_cast<Json::UInt64>(variants);
+
+            // ========== ANTENNES ACTIVES (par tuile) ==========
+            auto antennaRows = client->execSqlSync(
+                "SELECT COALESCE(operator_id, 0) AS operator_id, technology::text AS technology, "
+                "ST_X(geom) AS lon, ST_Y(geom) AS lat FROM antenna WHERE status = 'active'");
+            std::vector<KpiAntenna> antennas;
+            antennas.reserve(antennaRows.size());
+            for (auto row : antennaRows) {
+                antennas.push_back({row["operator_id"].as<int>(), row["technology"].as<std::string>(),
+                                    row["lon"].as<double>(), row["lat"].as<double>()});
+            }
+            std::unordered_map<int64_t, std::vector<const KpiAntenna*>> antennasByTile;
+            for (const auto& a : antennas) {
+                auto t = AntenneService::coverageTileRange(a.lat, a.lon, a.lat, a.lon);
+                antennasByTile[tileKey(t.minX, t.minY)].push_back(&a);
+            }
+
+            // ========== RASTÉRISATION (lots de tuiles, tuiles en parallèle) ==========
+            size_t workers = Parallel::workerCount();
+            std::vector<Accumulator> accumulators(workers, Accumulator(zones.size(), variants));
+            size_t cellCount = 0;
+
+            for (size_t first = 0; first < tileKeys.size(); first += batchTiles) {
+                size_t count = std::min(tileKeys.size() - first, static_cast<size_t>(batchTiles));
+                std::string values;
+                for (size_t i = 0; i < count; ++i) {
+                    int64_t key = tileKeys[first + i];
+                    if (i > 0) values += ", ";
+                    values += "(" + std::to_string(i) + ", " + std::to_string(key >> 32) + ", " +
+                              std::to_string(static_cast<uint32_t>(key)) + ")";
+                }
+                std::string envelope = "ST_Transform(ST_TileEnvelope(" +
+                                       std::to_string(AntenneService::COVERAGE_TILE_ZOOM) + ", t.x, t.y), 4326)";
+
+                auto coverageRows = client->execSqlSync(
+                    "SELECT t.i, c.operator_id, c.technology, ST_AsGeoJSON(c.geom, 7) AS geojson "
+                    "FROM (VALUES " + values + ") AS t(i, x, y) "
+                    "JOIN coverage_tile c ON c.x = t.x AND c.y = t.y");
+                auto cellRows = client->execSqlSync(
+                    "SELECT t.i, ST_XMin(dz.geom) AS min_lon, ST_YMin(dz.geom) AS min_lat, "
+                    "       ST_XMax(dz.geom) AS max_lon, ST_YMax(dz.geom) AS max_lat, dz.density "
+                    "FROM (VALUES " + values + ") AS t(i, x, y) "
+                    "JOIN zone dz ON dz.type = 'density_zone' AND dz.density IS NOT NULL "
+                    "            AND dz.geom && " + envelope);
+
+                std::vector<std::vector<DensityCell>> cells(count);
+                for (auto row : cellRows) {
+                    cells[static_cast<size_t>(row["i"].as<int>())].push_back({
+                        row["min_lon"].as<double>(), row["min_lat"].as<double>(),
+                        row["max_lon"].as<double>(), row["max_lat"].as<double>(),
+                        row["density"].as<double>()});
+                }
+                cellCount += cellRows.size();
+
+                std::vector<TileCoverage> coverage(coverageRows.size());
+                std::vector<std::string> rawCoverage(coverageRows.size());
+                for (size_t r = 0; r < coverageRows.size(); ++r) {
+                    auto row = coverageRows[r];
+                    coverage[r].tile = static_cast<size_t>(row["i"].as<int>());
+                    coverage[r].variant = variantIndex.at({row["operator_id"].as<int>(),
+                                                           row["technology"].as<std::string>()});
+                    rawCoverage[r] = row["geojson"].as<std::string>();
+                }
+                Parallel::forRange(coverage.size(), [&](size_t begin, size_t end) {
+                    Json::CharReaderBuilder builder;
+                    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+                    for (size_t r = begin; r < end; ++r) {
+                        const auto& s = rawCoverage[r];
+                        Json::Value geom;
+                        std::string errs;
+                        Shape shape;
+                        if (reader->parse(s.c_str(), s.c_str() + s.size(), &geom, &errs) &&
+                            Geometry::fromGeoJson(geom, shape)) {
+                            coverage[r].polygons = std::move(shape.polygons);
+                        }
+                    }
+                });
+                std::vector<std::vector<const TileCoverage*>> coverageByTile(count);
+                for (const auto& tc : coverage) coverageByTile[tc.tile].push_back(&tc);
+
+                std::atomic<size_t> slot{0};
+                Parallel::forRange(count, [&](size_t begin, size_t end) {
+                    auto& acc = accumulators[slot++ % workers];
+                    std::vector<size_t> leaves;
+                    static const std::vector<const KpiAntenna*> noAntennas;
+                    for (size_t i = begin; i < end; ++i) {
+                        int64_t key = tileKeys[first + i];
+                        int x = static_cast<int>(key >> 32);
+                        int y = static_cast<int>(static_cast<uint32_t>(key));
+                        TileProjection proj(AntenneService::COVERAGE_TILE_ZOOM, x, y, rasterSize);
+                        Point2 nw = proj.toLonLat({0, 0});
+                        Point2 se = proj.toLonLat({static_cast<double>(rasterSize), static_cast<double>(rasterSize)});
+
+                        leaves.clear();
+                        for (size_t idx : leafIndex.query(nw.x, se.y, se.x, nw.y)) {
+                            const auto& z = zones[idx];
+                            if (z.maxLon < nw.x || z.minLon > se.x || z.maxLat < se.y || z.minLat > nw.y) continue;
+                            leaves.push_back(idx);
+                        }
+                        if (leaves.empty()) continue;
+
+                        auto it = antennasByTile.find(key);
+                        accumulateTile(x, y, rasterSize, zones, leaves, cells[i], coverageByTile[i],
+                                       it != antennasByTile.end() ? it->second : noAntennas,
+                                       variantIndex, acc);
+                    }
+                });
+            }
+            stats["density_cells"] = static_cast<Json::UInt64>(cellCount);
+
+            // ========== AGRÉGATION (threads, puis feuilles -> ancêtres) ==========
+            Accumulator total(zones.size(), variants);
+            for (const auto& acc : accumulators) {
+                for (size_t z = 0; z < zones.size(); ++z) {
+                    if (acc.area[z] == 0) continue;
+                    // Remontée de la hiérarchie (profondeur bornée : parent_id cyclique ignoré)
+                    int cur = static_cast<int>(z);
+                    for (int depth = 0; cur >= 0 && depth < 16; ++depth, cur = zones[cur].parent) {
+                        total.area[cur] += acc.area[z];
+                        total.population[cur] += acc.population[z];
+                        for (size_t v = 0; v < variants; ++v) {
+                            total.coveredArea[cur * variants + v] += acc.coveredArea[z * variants + v];
+                            total.coveredPopulation[cur * variants + v] += acc.coveredPopulation[z * variants + v];
+                            total.antennas[cur * variants + v] += acc.antennas[z * variants + v];
+                        }
+                    }
+                }
+            }
+
+            // ========== PERSISTANCE ==========
+            // COPY dans une table temporaire puis remplacement complet dans la même transaction
+            PgCopy copy(connInfo);
+            copy.exec("BEGIN");
+            copy.exec("CREATE TEMP TABLE zone_kpi_load (zone_id INTEGER, operator_id INTEGER, technology TEXT, "
+                      "area_km2 DOUBLE PRECISION, covered_area_km2 DOUBLE PRECISION, population DOUBLE PRECISION, "
+                      "covered_population DOUBLE PRECISION, antenna_count INTEGER) ON COMMIT DROP");
+            copy.begin("COPY zone_kpi_load (zone_id, operator_id, technology, area_km2, covered_area_km2, "
+                       "population, covered_population, antenna_count) FROM STDIN");
+            char buf[256];
+            for (size_t z = 0; z < zones.size(); ++z) {
+                if (total.area[z] == 0) continue;
+                for (size_t v = 0; v < variants; ++v) {
+                    size_t k = z * variants + v;
+                    int n = std::snprintf(buf, sizeof(buf), "%d\t%d\t%s\t%.4f\t%.4f\t%.1f\t%.1f\t%d\n",
+                                          zones[z].id, variantKeys[v].first, variantKeys[v].second.c_str(),
+                                          total.area[z], total.coveredArea[k], total.population[z],
+                                          total.coveredPopulation[k], total.antennas[k]);
+                    copy.putLine(std::string(buf, n));
+                }
+            }
+            long rows = copy.end();
+            copy.exec("DELETE FROM zone_coverage_kpi");
+            copy.exec("INSERT INTO zone_coverage_kpi (zone_id, operator_id, technology, area_km2, covered_area_km2, "
+                      "population, covered_population, antenna_count) "
+                      "SELECT l.zone_id, l.operator_id, l.technology, l.area_km2, LEAST(l.covered_area_km2, l.area_km2), "
+                      "       l.population, LEAST(l.covered_population, l.population), l.antenna_count "
+                      "FROM zone_kpi_load l JOIN zone z ON z.id = l.zone_id");
+            copy.exec("COMMIT");
+
+            CacheService::getInstance().delPattern("zones:kpis:*");
+
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - startedAt).count();
+            stats["rows"] = static_cast<Json::Int64>(rows);
+            stats["duration_ms"] = static_cast<Json::Int64>(elapsed);
+
+            LOG_INFO << "📊 Zone KPIs recomputed: " << zones.size() << " zones, " << tileKeys.size()
+                     << " tiles, " << variants << " variants in " << elapsed << " ms";
+
+            recordRun(stats);
+            recomputeRunning = false;
+            callback(stats, "");
+        } catch (const DrogonDbException& e) {
+            auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+            ErrorHandler::logError("ZoneKpiService::recompute", errorDetails);
+            stats["error"] = errorDetails.userMessage;
+            recordRun(stats);
+            recomputeRunning = false;
+            callback(Json::Value(), errorDetails.userMessage);
+        } catch (const std::exception& e) {
+            auto errorDetails = ErrorHandler::analyzePostgresError(e.what());
+            ErrorHandler::logError("ZoneKpiService::recompute", errorDetails);
+            stats["error"] = errorDetails.userMessage;
+            recordRun(stats);
+            recomputeRunning = false;
+            callback(Json::Value(), errorDetails.userMessage);
+        }
+    });
+
+    return true;
+}
+
+void ZoneKpiService::scheduleRefresh() {
+    const Json::Value& config = app().getCustomConfig()["zone_kpi"];
+    double interval = config.get("refresh_interval_s", 86400.0).asDouble();
+    double delay = config.get("startup_delay_s", 60.0).asDouble();
+    if (interval <= 0) return;
+
+    auto run = []() {
+        // Ignoré si un recalcul (manuel ou précédent) est encore en cours
+        recompute([](const Json::Value& stats, const std::string& err) {
+            if (!err.empty()) {
+                LOG_ERROR << "Scheduled zone KPI refresh failed: " << err;
+            }
+        });
+    };
+    // Premier calcul après le recalcul initial des tuiles de couverture
+    app().getLoop()->runAfter(delay, run);
+    app().getLoop()->runEvery(interval, run);
+    LOG_INFO << "📊 Zone KPI refresh scheduled every " << interval << " s";
+}
+
+Json::Value ZoneKpiService::getStatus() {
+    Json::Value status;
+    status["running"] = recomputeRunning.load();
+    {
+        std::lock_guard<std::mutex> lock(statusMutex);
+        status["last_run"] = lastRun;
+    }
+    return status;
+}
+
+// ============================================================================
+// LECTURE
+// ============================================================================
+void ZoneKpiService::getZoneKpis(
+    int zoneId, std::optional<int> operatorId, std::optional<std::string> technology,
+    std::function<void(const Json::Value&, bool, const std::string&)> callback)
+{
+    auto client = app().getDbClient();
+    std::string sql = R"(
+        SELECT z.id, z.name, z.type::text AS type, z.parent_id, z.density,
+               k.operator_id, o.name AS operator_name, k.technology,
+               k.area_km2, k.covered_area_km2, k.area_pct::float8 AS area_pct,
+               k.population, k.covered_population, k.population_pct::float8 AS population_pct,
+               k.antenna_count, k.computed_at::text AS computed_at
+        FROM zone z
+        LEFT JOIN zone_coverage_kpi k ON k.zone_id = z.id
+        LEFT JOIN operator o ON o.id = k.operator_id
+        WHERE z.id = $1
+        ORDER BY k.operator_id, k.technology
+    )";
+
+    client->execSqlAsync(sql,
+        [callback, operatorId, technology](const Result& r) {
+            if (r.empty()) {
+                callback(Json::Value(), false, "");
+                return;
+            }
+
+            Json::Value result;
+            auto first = r[0];
+            result["zone"]["id"] = first["id"].as<int>();
+            result["zone"]["name"] = first["name"].as<std::string>();
+            result["zone"]["type"] = first["type"].as<std::string>();
+            result["zone"]["density"] = first["density"].isNull() ? 0.0 : first["density"].as<double>();
+            if (!first["parent_id"].isNull()) result["zone"]["parent_id"] = first["parent_id"].as<int>();
+            result["computed_at"] = first["computed_at"].isNull()
+                ? Json::Value(Json::nullValue) : Json::Value(first["computed_at"].as<std::string>());
+
+            Json::Value kpis(Json::arrayValue);
+            for (auto row : r) {
+                if (row["operator_id"].isNull()) continue; // Zone sans indicateur (pas encore calculée)
+                int op = row["operator_id"].as<int>();
+                std::string tech = row["technology"].as<std::string>();
+                if (operatorId && *operatorId != op) continue;
+                if (technology && *technology != tech) continue;
+
+                Json::Value k;
+                k["operator_id"] = op;
+                if (!row["operator_name"].isNull()) k["operator_name"] = row["operator_name"].as<std::string>();
+                k["technology"] = tech;
+                k["area_km2"] = row["area_km2"].as<double>();
+                k["covered_area_km2"] = row["covered_area_km2"].as<double>();
+                k["area_pct"] = row["area_pct"].isNull()
+                    ? Json::Value(Json::nullValue) : Json::Value(row["area_pct"].as<double>());
+                k["population"] = row["population"].as<double>();
+                k["covered_population"] = row["covered_population"].as<double>();
+                k["population_pct"] = row["population_pct"].isNull()
+                    ? Json::Value(Json::nullValue) : Json::Value(row["population_pct"].as<double>());
+                k["antenna_count"] = row["antenna_count"].as<int>();
+                kpis.append(k);
+            }
+            result["kpis"] = kpis;
+            callback(result, true, "");
+        },
+        [callback](const DrogonDbException& e) {
+            auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+            ErrorHandler::logError("ZoneKpiService::getZoneKpis", errorDetails);
+            callback(Json::Value(), false, errorDetails.userMessage);
+        },
+        zoneId);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <drogon/drogon.h>
+#include <json/json.h>
+#include <functional>
+#include <optional>
+#include <string>
+
+/**
+ * Indicateurs de couverture par zone administrative (table zone_coverage_kpi)
+ *
+ * Pour chaque zone et chaque filtre des tuiles de couverture (tous, opérateur,
+ * technologie, opérateur × technologie) : surface et population totales et
+ * couvertes, antennes actives dans la zone.
+ *
+ * Calcul par rastérisation, tuile de couverture par tuile de couverture (zoom
+ * AntenneService::COVERAGE_TILE_ZOOM), en parallèle :
+ * - Raster d'identifiants des zones feuilles (communes, ou niveau le plus fin
+ *   disponible), construit une fois par tuile et partagé par tous les filtres
+ * - Raster de population : cellules density_zone (~250 m), à défaut densité
+ *   de la zone feuille
+ * - Masques de couverture rastérisés depuis coverage_tile
+ * Les zones parentes (province, région, pays) cumulent leurs feuilles.
+ */
+class ZoneKpiService {
+public:
+    /**
+     * Recalcule tous les indicateurs (remplacement complet, une transaction)
+     *
+     * Le job tourne en arrière-plan ; le callback reçoit les statistiques d'exécution.
+     * Retourne false si un recalcul est déjà en cours.
+     */
+    static bool recompute(std::function<void(const Json::Value&, const std::string&)> callback);
+
+    // Recalcul périodique (custom_config.zone_kpi.refresh_interval_s)
+    static void scheduleRefresh();
+
+    // État du dernier recalcul (pour monitoring)
+    static Json::Value getStatus();
+
+    /**
+     * Indicateurs d'une zone, filtrables par opérateur (-1 = tous) et technologie ('*' = toutes)
+     * Callback : (résultat, trouvé, erreur) ; trouvé = false si la zone n'existe pas
+     */
+    static void getZoneKpis(int zoneId, std::optional<int> operatorId, std::optional<std::string> technology,
+                            std::function<void(const Json::Value&, bool, const std::string&)> callback);
+};
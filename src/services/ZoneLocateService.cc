@@ -0,0 +1,171 @@
+#include "ZoneLocateService.h"
+#include "ZoneSnapshotService.h"
+#include "../utils/Parallel.h"
+#include "../utils/PreparedPolygon.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace {
+    struct IndexedZone {
+        int id = 0;
+        int parentId = 0;
+        std::string name;
+        std::string type;
+        PreparedPolygon shape{std::vector<Polygon2>{}};
+    };
+
+    // Zones d'un type et index d'emprises (positions dans Snapshot::zones)
+    struct TypeLevel {
+        std::string type;
+        BoxIndex index{0.25};
+    };
+
+    struct Snapshot {
+        std::string version;
+        std::string loadedAt;
+        std::vector<IndexedZone> zones;
+        std::unordered_map<int, size_t> byId;
+        std::vector<TypeLevel> levels;      // Du type le plus fin au plus large
+        size_t edges = 0;
+    };
+
+    // Paramètres lus au démarrage (custom_config.zone_locate) ; ordre = du plus fin au plus large
+    bool enabled = false;
+    std::vector<std::string> types;
+
+    std::mutex stateMutex;
+    std::shared_ptr<const Snapshot> snapshot;
+
+    std::atomic<uint64_t> lookups{0};
+    std::atomic<uint64_t> reloads{0};
+
+    // Profondeur maximale de la chaîne parent_id (protection contre un cycle)
+    constexpr int MAX_DEPTH = 16;
+
+    // Nouvel instantané des zones : préparation des polygones et index d'emprises
+    void build(const ZoneSnapshotService::SnapshotPtr& source) {
+        auto startedAt = std::chrono::steady_clock::now();
+
+        std::vector<const ZoneSnapshotService::Zone*> selected;
+        for (const auto& zone : source->zones) {
+            if (std::find(types.begin(), types.end(), zone.type) != types.end()) selected.push_back(&zone);
+        }
+
+        auto snap = std::make_shared<Snapshot>();
+        snap->zones.resize(selected.size());
+        Parallel::forRange(selected.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const auto& zone = *selected[i];
+                auto& z = snap->zones[i];
+                z.id = zone.id;
+                z.parentId = zone.parentId;
+                z.name = zone.name;
+                z.type = zone.type;
+                if (!zone.shape.polygons.empty()) z.shape = PreparedPolygon(zone.shape.polygons);
+            }
+        });
+
+        for (const auto& t : types) snap->levels.push_back(TypeLevel{t});
+        for (size_t i = 0; i < snap->zones.size(); ++i) {
+            const auto& z = snap->zones[i];
+            snap->byId[z.id] = i;
+            snap->edges += z.shape.edgeCount();
+            if (z.shape.empty()) continue;
+            for (auto& level : snap->levels) {
+                if (level.type == z.type) {
+                    level.index.insert(i, z.shape.minX(), z.shape.minY(), z.shape.maxX(), z.shape.maxY());
+                    break;
+                }
+            }
+        }
+        snap->version = source->version;
+        snap->loadedAt = trantor::Date::now().toFormattedString(false);
+
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            snapshot = snap;
+        }
+        reloads++;
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startedAt).count();
+        LOG_INFO << "📍 Zone locate index loaded: " << snap->zones.size() << " zones, "
+                 << snap->edges << " edges in " << elapsed << " ms";
+    }
+}
+
+void ZoneLocateService::start() {
+    const auto& config = app().getCustomConfig()["zone_locate"];
+    enabled = config.get("enabled", true).asBool();
+    if (!enabled) return;
+
+    types = ZoneSnapshotService::configuredTypes(config, {"commune", "province", "region", "country"}, "Zone locate");
+    if (types.empty()) {
+        enabled = false;
+        return;
+    }
+    ZoneSnapshotService::subscribe(types, build);
+    LOG_INFO << "📍 Zone locate enabled (" << types.size() << " type(s))";
+}
+
+bool ZoneLocateService::locate(double lat, double lon, std::vector<LocatedZone>& chain) {
+    chain.clear();
+    if (!enabled) return false;
+
+    std::shared_ptr<const Snapshot> snap;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        snap = snapshot;
+    }
+    if (!snap) return false;
+    lookups++;
+
+    // Zone la plus fine contenant le point
+    const IndexedZone* hit = nullptr;
+    for (const auto& level : snap->levels) {
+        for (size_t i : level.index.at(lon, lat)) {
+            if (snap->zones[i].shape.contains(lon, lat)) {
+                hit = &snap->zones[i];
+                break;
+            }
+        }
+        if (hit) break;
+    }
+
+    // Puis ses parents (zones chargées uniquement)
+    for (int depth = 0; hit && depth < MAX_DEPTH; ++depth) {
+        chain.push_back({hit->id, hit->name, hit->type});
+        auto it = snap->byId.find(hit->parentId);
+        hit = (hit->parentId != 0 && it != snap->byId.end()) ? &snap->zones[it->second] : nullptr;
+    }
+    return true;
+}
+
+Json::Value ZoneLocateService::getStatus() {
+    Json::Value status;
+    status["enabled"] = enabled;
+    status["lookups"] = static_cast<Json::UInt64>(lookups.load());
+    status["reloads"] = static_cast<Json::UInt64>(reloads.load());
+
+    Json::Value typeList(Json::arrayValue);
+    for (const auto& t : types) typeList.append(t);
+    status["types"] = typeList;
+    status["snapshot"] = ZoneSnapshotService::getStatus();
+
+    std::lock_guard<std::mutex> lock(stateMutex);
+    if (snapshot) {
+        status["data_version"] = snapshot->version;
+        status["loaded_at"] = snapshot->loadedAt;
+        status["zones"] = static_cast<Json::UInt64>(snapshot->zones.size());
+        status["edges"] = static_cast<Json::UInt64>(snapshot->edges);
+    }
+    return status;
+}
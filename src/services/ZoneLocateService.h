@@ -0,0 +1,40 @@
+#pragma once
+#include <drogon/drogon.h>
+#include <json/json.h>
+#include <string>
+#include <vector>
+
+/**
+ * Géocodage inverse en mémoire : point -> zone la plus fine qui le contient + ses parents
+ *
+ * Remplace les sous-requêtes ST_Intersects : les zones des types configurés sont
+ * lues dans l'instantané partagé (ZoneSnapshotService, géométrie complète déjà
+ * parsée), indexées par emprise (BoxIndex) et
+ * préparées pour le test point-dans-polygone (cf. PreparedPolygon). Une requête
+ * parcourt les types du plus fin au plus large (custom_config.zone_locate.types)
+ * puis remonte la chaîne parent_id.
+ *
+ * - Reconstruit à chaque nouvel instantané, l'ancien index répond jusqu'à la bascule
+ * - Index pas encore prêt : locate() retourne false
+ */
+class ZoneLocateService {
+public:
+    struct LocatedZone {
+        int id;
+        std::string name;
+        std::string type;
+    };
+
+    // Abonnement à l'instantané des zones (custom_config.zone_locate)
+    static void start();
+
+    /**
+     * Chaîne des zones contenant le point, de la plus fine à la racine (vide : hors zones)
+     *
+     * @return false si l'index n'est pas (encore) disponible
+     */
+    static bool locate(double lat, double lon, std::vector<LocatedZone>& chain);
+
+    // Version, zones indexées, arêtes préparées, requêtes servies (pour monitoring)
+    static Json::Value getStatus();
+};
@@ -0,0 +1,154 @@
+#include "ZoneSearchService.h"
+#include "CacheService.h"
+#include "ZoneSnapshotService.h"
+#include "../utils/ZoneSearchIndex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace {
+    struct Snapshot {
+        std::string version;
+        std::string loadedAt;
+        ZoneSearchIndex index;
+
+        explicit Snapshot(std::vector<ZoneSearchIndex::Entry> entries) : index(std::move(entries)) {}
+    };
+
+    // Paramètres lus au démarrage (custom_config.zone_search) ; l'ordre des types fait le classement
+    bool enabled = false;
+    std::vector<std::string> types;
+
+    std::mutex stateMutex;
+    std::shared_ptr<const Snapshot> snapshot;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> fallbacks{0};
+    std::atomic<uint64_t> reloads{0};
+
+    // Nouvel instantané des zones : normalisation et indexation des noms
+    void build(const ZoneSnapshotService::SnapshotPtr& source) {
+        auto startedAt = std::chrono::steady_clock::now();
+
+        Json::StreamWriterBuilder writer;
+        writer["indentation"] = "";
+        std::vector<ZoneSearchIndex::Entry> entries;
+        for (const auto& zone : source->zones) {
+            auto rank = std::find(types.begin(), types.end(), zone.type) - types.begin();
+            if (rank == static_cast<std::ptrdiff_t>(types.size())) continue;
+
+            ZoneSearchIndex::Entry e;
+            e.name = zone.name;
+            e.type = zone.type;
+            e.typeRank = static_cast<int>(rank);
+            e.population = zone.population;
+
+            Json::Value item;
+            item["id"] = zone.id;
+            item["name"] = e.name;
+            item["type"] = e.type;
+            item["density"] = zone.density;
+            item["parent_id"] = zone.parentId;
+            item["population"] = static_cast<Json::Int64>(e.population);
+            Json::Value bbox(Json::arrayValue);
+            if (!zone.shape.empty()) {
+                bbox.append(zone.shape.minX);
+                bbox.append(zone.shape.minY);
+                bbox.append(zone.shape.maxX);
+                bbox.append(zone.shape.maxY);
+            }
+            item["bbox"] = bbox;
+            e.json = Json::writeString(writer, item);
+            entries.push_back(std::move(e));
+        }
+
+        auto snap = std::make_shared<Snapshot>(std::move(entries));
+        snap->version = source->version;
+        snap->loadedAt = trantor::Date::now().toFormattedString(false);
+
+        bool firstLoad;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            firstLoad = (snapshot == nullptr);
+            snapshot = snap;
+        }
+        reloads++;
+
+        // Recherches SQL mises en cache avant le chargement : ancienne version
+        if (!firstLoad) {
+            CacheService::getInstance().delPattern("zones:search:*");
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startedAt).count();
+        LOG_INFO << "🔎 Zone search index loaded: " << snap->index.size() << " zones in "
+                 << elapsed << " ms";
+    }
+}
+
+void ZoneSearchService::start() {
+    const auto& config = app().getCustomConfig()["zone_search"];
+    enabled = config.get("enabled", true).asBool();
+    if (!enabled) return;
+
+    types = ZoneSnapshotService::configuredTypes(config, {"country", "region", "province", "commune"}, "Zone search");
+    if (types.empty()) {
+        enabled = false;
+        return;
+    }
+    ZoneSnapshotService::subscribe(types, build);
+    LOG_INFO << "🔎 Zone search enabled (" << types.size() << " type(s))";
+}
+
+bool ZoneSearchService::search(const std::string& type, const std::string& query, int limit, std::string& out) {
+    if (!enabled) return false;
+
+    std::shared_ptr<const Snapshot> snap;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        snap = snapshot;
+    }
+    if (!snap || (!type.empty() && std::find(types.begin(), types.end(), type) == types.end())) {
+        fallbacks++;
+        return false;
+    }
+    hits++;
+
+    out = "[";
+    bool first = true;
+    for (const auto* e : snap->index.search(query, type, static_cast<size_t>(std::max(limit, 0)))) {
+        if (!first) out += ',';
+        out += e->json;
+        first = false;
+    }
+    out += ']';
+    return true;
+}
+
+Json::Value ZoneSearchService::getStatus() {
+    Json::Value status;
+    status["enabled"] = enabled;
+    status["hits"] = static_cast<Json::UInt64>(hits.load());
+    status["sql_fallbacks"] = static_cast<Json::UInt64>(fallbacks.load());
+    status["reloads"] = static_cast<Json::UInt64>(reloads.load());
+
+    Json::Value typeList(Json::arrayValue);
+    for (const auto& t : types) typeList.append(t);
+    status["types"] = typeList;
+    status["snapshot"] = ZoneSnapshotService::getStatus();
+
+    std::lock_guard<std::mutex> lock(stateMutex);
+    if (snapshot) {
+        status["data_version"] = snapshot->version;
+        status["loaded_at"] = snapshot->loadedAt;
+        status["zones"] = static_cast<Json::UInt64>(snapshot->index.size());
+    }
+    return status;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <drogon/drogon.h>
+#include <json/json.h>
+#include <string>
+
+/**
+ * Autocomplétion des noms de zones en mémoire pour /api/zones/search
+ *
+ * Remplace name ILIKE '%query%' (parcours complet de la table à chaque frappe) :
+ * les zones des types configurés sont lues dans l'instantané partagé
+ * (ZoneSnapshotService), noms normalisés
+ * (accents français, variantes arabes) et indexés par trigrammes et débuts de mots
+ * (cf. ZoneSearchIndex). Chaque élément de réponse, emprise [minLon, minLat,
+ * maxLon, maxLat] comprise, est sérialisé au chargement.
+ *
+ * - Classement : correspondance en début de nom / de mot, type (ordre de la
+ *   configuration), population (densité × surface) décroissante
+ * - Reconstruit à chaque nouvel instantané, l'ancien index répond jusqu'à la bascule
+ * - Index pas encore prêt ou type non indexé : l'appelant se rabat sur SQL
+ */
+class ZoneSearchService {
+public:
+    // Abonnement à l'instantané des zones (custom_config.zone_search)
+    static void start();
+
+    /**
+     * Tableau JSON des zones dont le nom contient la requête (type vide = tous les types indexés)
+     *
+     * @return false si l'index n'est pas prêt ou si le type n'y est pas chargé
+     */
+    static bool search(const std::string& type, const std::string& query, int limit, std::string& out);
+
+    // Version, zones indexées, hits / replis SQL (pour monitoring)
+    static Json::Value getStatus();
+};
@@ -1,13 +1,82 @@
 #include "ZoneService.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
 using namespace drogon;
 using namespace drogon::orm;
 
-// Récupération des zones par type
-void ZoneService::getByType(const std::string& type, std::function<void(const std::vector<ZoneModel>&, const std::string&)> callback) {
-    auto client = app().getDbClient();
-    std::string sql = "SELECT id, name, type, density, parent_id, ST_AsText(geom) as wkt FROM zone WHERE type = $1::zone_type ORDER BY name";
+namespace {
+    // Exports en streaming en cours (chacun tient un lot en mémoire et une requête par lot)
+    std::atomic<int> activeGeoJsonStreams{0};
 
-    client->execSqlAsync(sql, [callback](const Result &r) {
+    // Export GeoJSON en cours (streamAllGeoJSON) : position dans la table et sortie
+    struct GeoJsonStream {
+        std::function<bool(const std::string&)> write;
+        std::function<void(std::function<void(bool)>)> whenDrained;
+        std::function<void(const std::string&)> done;
+        int batchRows = 200;
+        int lastId = std::numeric_limits<int>::min();   // Pagination par clé (id du dernier envoyé)
+        Json::StreamWriterBuilder writer;
+        bool first = true;
+    };
+
+    // Lot suivant : une requête indexée par lot (aucune connexion tenue entre deux lots),
+    // un morceau par lot, fin de collection au premier lot incomplet. Le lot suivant
+    // n'est lu qu'une fois le morceau précédent écrit vers le client (whenDrained)
+    void fetchBatch(const std::shared_ptr<GeoJsonStream>& stream) {
+        std::string sql = R"(
+            SELECT id, name, density, ST_AsGeoJSON(geom) AS geojson
+            FROM zone
+            WHERE id > $1
+            ORDER BY id
+            LIMIT $2
+        )";
+        app().getDbClient()->execSqlAsync(sql,
+            [stream](const Result& r) {
+                std::string chunk;
+                for (auto row : r) {
+                    Json::Value props;
+                    props["id"] = row["id"].as<int>();
+                    props["name"] = row["name"].as<std::string>();
+                    props["density"] = row["density"].isNull() ? 0.0 : row["density"].as<double>();
+
+                    // Géométrie recopiée telle quelle (déjà du GeoJSON)
+                    if (!stream->first) chunk += ',';
+                    chunk += R"({"type":"Feature","properties":)";
+                    chunk += Json::writeString(stream->writer, props);
+                    chunk += R"(,"geometry":)";
+                    chunk += row["geojson"].isNull() ? "null" : row["geojson"].as<std::string>();
+                    chunk += '}';
+                    stream->first = false;
+                    stream->lastId = row["id"].as<int>();
+                }
+
+                bool last = r.size() < static_cast<size_t>(stream->batchRows);
+                if (last) chunk += "]}";
+                if (!chunk.empty() && !stream->write(chunk)) {
+                    stream->done("");   // Client déconnecté
+                    return;
+                }
+                if (last) {
+                    stream->done("");
+                    return;
+                }
+                stream->whenDrained([stream](bool ok) {
+                    if (ok) {
+                        fetchBatch(stream);
+                    } else {
+                        stream->done("client stopped reading");
+                    }
+                });
+            },
+            [stream](const DrogonDbException& e) {
+                LOG_ERROR << "Error streaming zones GeoJSON: " << e.base().what();
+                stream->done(e.base().what());
+            },
+            stream->lastId, stream->batchRows);
+    }
+
+    std::vector<ZoneModel> toZones(const Result& r, const char* wktColumn) {
         std::vector<ZoneModel> list;
         for (auto row : r) {
             ZoneModel z;
@@ -16,11 +85,45 @@ void ZoneService::getByType(const std::string& type, std::function<void(const st
             z.type = row["type"].as<std::string>();
             z.density = row["density"].as<double>();
             z.parent_id = row["parent_id"].isNull() ? 0 : row["parent_id"].as<int>();
-            z.wkt_geometry = row["wkt"].as<std::string>();
+            z.wkt_geometry = row[wktColumn].as<std::string>();
             list.push_back(z);
         }
-        callback(list, "");
-    }, [callback](const DrogonDbException &e) { callback({}, e.base().what()); }, type);
+        return list;
+    }
+}
+
+ZoneService::Viewport ZoneService::clipBox(double minLat, double minLon, double maxLat, double maxLon) {
+    double ratio = app().getCustomConfig()["zone_viewport"].get("margin_ratio", 0.1).asDouble();
+    double dLon = (maxLon - minLon) * ratio;
+    double dLat = (maxLat - minLat) * ratio;
+    return {std::max(-180.0, minLon - dLon), std::max(-90.0, minLat - dLat),
+            std::min(180.0, maxLon + dLon), std::min(90.0, maxLat + dLat)};
+}
+
+// Récupération des zones par type
+void ZoneService::getByType(const std::string& type, const std::optional<Viewport>& viewport,
+                            std::function<void(const std::vector<ZoneModel>&, const std::string&)> callback) {
+    auto client = app().getDbClient();
+    auto onError = [callback](const DrogonDbException &e) { callback({}, e.base().what()); };
+
+    if (!viewport) {
+        std::string sql = "SELECT id, name, type, density, parent_id, ST_AsText(geom) as wkt FROM zone WHERE type = $1::zone_type ORDER BY name";
+        client->execSqlAsync(sql, [callback](const Result &r) { callback(toZones(r, "wkt"), ""); }, onError, type);
+        return;
+    }
+
+    // Filtre GIST (&&) puis découpage : seule la partie visible (+ marge) est sérialisée
+    std::string sql = R"(
+        SELECT z.id, z.name, z.type, z.density, z.parent_id, ST_AsText(c.geom) as wkt
+        FROM zone z
+        CROSS JOIN LATERAL (SELECT ST_ClipByBox2D(z.geom, ST_MakeEnvelope($2, $3, $4, $5, 4326)) AS geom) c
+        WHERE z.type = $1::zone_type
+          AND z.geom && ST_MakeEnvelope($2, $3, $4, $5, 4326)
+          AND NOT ST_IsEmpty(c.geom)
+        ORDER BY z.name
+    )";
+    client->execSqlAsync(sql, [callback](const Result &r) { callback(toZones(r, "wkt"), ""); }, onError,
+                         type, viewport->minLon, viewport->minLat, viewport->maxLon, viewport->maxLat);
 }
 
 // Récupération de toutes les zones en GeoJSON
@@ -66,7 +169,32 @@ void ZoneService::getAllGeoJSON(std::function<void(const Json::Value&, const std
     });
 }
 
+std::shared_ptr<void> ZoneService::reserveGeoJsonStream() {
+    int limit = std::max(1, app().getCustomConfig()["zone_geojson"].get("max_concurrent_streams", 2).asInt());
+    if (++activeGeoJsonStreams > limit) {
+        --activeGeoJsonStreams;
+        return nullptr;
+    }
+    return std::shared_ptr<void>(nullptr, [](void*) { --activeGeoJsonStreams; });
+}
+
+// Même collection que getAllGeoJSON, par lots à la vitesse du client (cf. ZoneService.h)
+void ZoneService::streamAllGeoJSON(std::function<bool(const std::string&)> write,
+                                   std::function<void(std::function<void(bool)>)> whenDrained,
+                                   std::function<void(const std::string&)> done) {
+    auto stream = std::make_shared<GeoJsonStream>();
+    stream->write = std::move(write);
+    stream->whenDrained = std::move(whenDrained);
+    stream->done = std::move(done);
+    stream->batchRows = std::max(1, app().getCustomConfig()["zone_geojson"].get("batch_rows", 200).asInt());
+    stream->writer["indentation"] = "";
 
+    if (!stream->write(R"({"type":"FeatureCollection","features":[)")) {
+        stream->done("");
+        return;
+    }
+    fetchBatch(stream);
+}
 
 // ============================================================================
 // NOUVEAU : SIMPLIFICATION GÉOMÉTRIQUE (Sprint 2 - Optimization)
@@ -85,17 +213,48 @@ void ZoneService::getAllGeoJSON(std::function<void(const Json::Value&, const std
  * 
  * @param type Type de zone (country, region, province, commune, etc.)
  * @param zoom Niveau de zoom Leaflet (0-18)
+ * @param viewport Emprise de découpage (optionnelle, cf. clipBox)
  * @param callback Retourne les zones avec géométries simplifiées ou erreur
  */
 void ZoneService::getByTypeSimplified(
     const std::string& type, 
     int zoom,
+    const std::optional<Viewport>& viewport,
     std::function<void(const std::vector<ZoneModel>&, const std::string&)> callback) 
 {
     auto client = app().getDbClient();
     
     // Calculer la tolérance de simplification selon le zoom
     double tolerance = calculateSimplificationTolerance(zoom);
+
+    auto onResult = [callback, tolerance, zoom](const Result& r) {
+        std::vector<ZoneModel> list = toZones(r, "wkt");
+        LOG_INFO << "Fetched " << list.size() << " zones (type: " << (list.empty() ? "N/A" : list[0].type)
+                 << ", zoom: " << zoom << ", tolerance: " << tolerance << ")";
+        callback(list, "");
+    };
+    auto onError = [callback](const DrogonDbException& e) {
+        LOG_ERROR << "Error fetching simplified zones: " << e.base().what();
+        callback({}, e.base().what());
+    };
+
+    if (viewport) {
+        // Filtre GIST (&&), simplification puis découpage à la vue (+ marge)
+        std::string sql = R"(
+            SELECT z.id, z.name, z.type, z.density, z.parent_id, ST_AsText(c.geom) as wkt
+            FROM zone z
+            CROSS JOIN LATERAL (
+                SELECT ST_ClipByBox2D(ST_Simplify(z.geom, $2, true), ST_MakeEnvelope($3, $4, $5, $6, 4326)) AS geom
+            ) c
+            WHERE z.type = $1::zone_type
+              AND z.geom && ST_MakeEnvelope($3, $4, $5, $6, 4326)
+              AND NOT ST_IsEmpty(c.geom)
+            ORDER BY z.name
+        )";
+        client->execSqlAsync(sql, onResult, onError, type, tolerance,
+                             viewport->minLon, viewport->minLat, viewport->maxLon, viewport->maxLat);
+        return;
+    }
     
     // Requête SQL avec ST_Simplify
     // preserve_collapsed = true pour garder les petites géométries
@@ -112,33 +271,7 @@ void ZoneService::getByTypeSimplified(
         ORDER BY name
     )";
     
-    client->execSqlAsync(
-        sql,
-        [callback, tolerance, zoom](const Result& r) {
-            std::vector<ZoneModel> list;
-            for (auto row : r) {
-                ZoneModel z;
-                z.id = row["id"].as<int>();
-                z.name = row["name"].as<std::string>();
-                z.type = row["type"].as<std::string>();
-                z.density = row["density"].as<double>();
-                z.parent_id = row["parent_id"].isNull() ? 0 : row["parent_id"].as<int>();
-                z.wkt_geometry = row["wkt"].as<std::string>();
-                list.push_back(z);
-            }
-            
-            LOG_INFO << "Fetched " << list.size() << " zones (type: " << (list.empty() ? "N/A" : list[0].type)
-                     << ", zoom: " << zoom << ", tolerance: " << tolerance << ")";
-            
-            callback(list, "");
-        },
-        [callback](const DrogonDbException& e) {
-            LOG_ERROR << "Error fetching simplified zones: " << e.base().what();
-            callback({}, e.base().what());
-        },
-        type, 
-        tolerance
-    );
+    client->execSqlAsync(sql, onResult, onError, type, tolerance);
 }
 
 /**
@@ -151,19 +284,32 @@ void ZoneService::getByTypeSimplified(
  * @return Tolérance en degrés pour ST_Simplify
  */
 double ZoneService::calculateSimplificationTolerance(int zoom) {
-    // Tolérance adaptative selon le zoom
-    // Valeurs en degrés (SRID 4326)
+    return toleranceForLevel(simplificationLevel(zoom));
+}
+
+int ZoneService::simplificationLevel(int zoom) {
     if (zoom <= 6) {
-        return 0.01;      // ~1.1 km - Zoom monde/continents
+        return 0;         // Zoom monde/continents
     } else if (zoom <= 10) {
-        return 0.005;     // ~550 m - Zoom pays/régions
+        return 1;         // Zoom pays/régions
     } else if (zoom <= 14) {
-        return 0.001;     // ~111 m - Zoom villes
+        return 2;         // Zoom villes
     } else {
-        return 0.0001;    // ~11 m - Zoom quartiers (détails préservés)
+        return 3;         // Zoom quartiers (détails préservés)
     }
 }
 
+double ZoneService::toleranceForLevel(int level) {
+    // Valeurs en degrés (SRID 4326)
+    static constexpr double tolerances[SIMPLIFICATION_LEVELS] = {
+        0.01,     // ~1.1 km
+        0.005,    // ~550 m
+        0.001,    // ~111 m
+        0.0001    // ~11 m
+    };
+    return tolerances[std::max(0, std::min(SIMPLIFICATION_LEVELS - 1, level))];
+}
+
 // ============================================================================
 // NOUVEAU: RECHERCHE DE ZONES (Sprint - Optimization Modal)
 // ============================================================================
@@ -202,7 +348,7 @@ void ZoneService::searchZones(
                 parent_id,
                 ST_AsText(ST_Envelope(geom)) as bbox_wkt
             FROM zone 
-            WHERE type = $1::zone_type 
+            WHERE ($1 = '' OR type::text = $1)
             ORDER BY name
             LIMIT $2
         )";
@@ -241,7 +387,7 @@ void ZoneService::searchZones(
                 parent_id,
                 ST_AsText(ST_Envelope(geom)) as bbox_wkt
             FROM zone 
-            WHERE type = $1::zone_type 
+            WHERE ($1 = '' OR type::text = $1)
               AND name ILIKE $2
             ORDER BY name
             LIMIT $3
@@ -4,19 +4,57 @@
 #include <vector>
 #include <string>
 #include <functional>
+#include <optional>
 
 class ZoneService {
 public:
-    static void getByType(const std::string& type, std::function<void(const std::vector<ZoneModel>&, const std::string&)> callback);
+    // Emprise de découpage (degrés) : vue courante élargie d'une marge
+    struct Viewport {
+        double minLon, minLat, maxLon, maxLat;
+    };
+    // Vue élargie de custom_config.zone_viewport.margin_ratio de sa taille de chaque côté
+    static Viewport clipBox(double minLat, double minLon, double maxLat, double maxLon);
+
+    // viewport : seules les zones qui l'intersectent (index GIST), géométries découpées
+    static void getByType(const std::string& type, const std::optional<Viewport>& viewport,
+                          std::function<void(const std::vector<ZoneModel>&, const std::string&)> callback);
     
     // Sprint 2: Simplification géométrique selon le zoom
-    static void getByTypeSimplified(const std::string& type, int zoom, 
+    static void getByTypeSimplified(const std::string& type, int zoom, const std::optional<Viewport>& viewport,
                                     std::function<void(const std::vector<ZoneModel>&, const std::string&)> callback);
     
     static void getAllGeoJSON(std::function<void(const Json::Value&, const std::string&)> callback);
+
+    /**
+     * FeatureCollection de toutes les zones, écrite morceau par morceau
+     *
+     * Lue par lots (custom_config.zone_geojson.batch_rows), pagination par clé sur id :
+     * chaque lot est une requête indépendante, aucune connexion du pool n'est tenue
+     * entre deux lots. La géométrie ST_AsGeoJSON est recopiée telle quelle, sans parsing.
+     *
+     * Contrôle de flux : après chaque morceau, le lot suivant n'est lu que lorsque
+     * whenDrained rappelle avec true (morceau écrit vers le client). Au plus un lot
+     * en mémoire par export, quel que soit le débit du client ; false arrête l'export.
+     *
+     * @param write       Reçoit chaque morceau ; retourne false si le client est parti (arrêt)
+     * @param whenDrained Rappelle une fois la sortie vidée (true) ou le client perdu (false)
+     * @param done        Appelé une fois à la fin (erreur vide = collection complète envoyée)
+     */
+    static void streamAllGeoJSON(std::function<bool(const std::string&)> write,
+                                 std::function<void(std::function<void(bool)>)> whenDrained,
+                                 std::function<void(const std::string&)> done);
+
+    // Place d'export en streaming (custom_config.zone_geojson.max_concurrent_streams,
+    // 2 par défaut) ; nullptr si toutes sont prises. Rendue à la destruction du jeton.
+    static std::shared_ptr<void> reserveGeoJsonStream();
     static void searchZones(const std::string& type, const std::string& query, int limit, 
                            std::function<void(const std::vector<ZoneModel>&, const std::string&)> callback);
 
+    // Paliers de simplification : un palier par plage de zoom (cf. calculateSimplificationTolerance)
+    static constexpr int SIMPLIFICATION_LEVELS = 4;
+    static int simplificationLevel(int zoom);
+    static double toleranceForLevel(int level);
+
 private:
     // Utilitaire pour calculer la tolérance de simplification selon le zoom
     static double calculateSimplificationTolerance(int zoom);
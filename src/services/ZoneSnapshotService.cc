@@ -0,0 +1,177 @@
+#include "ZoneSnapshotService.h"
+#include "../utils/ErrorHandler.h"
+#include "../utils/Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace {
+    std::vector<std::function<void(const ZoneSnapshotService::SnapshotPtr&)>> subscribers;
+    std::vector<std::string> types;   // Union des types des abonnés
+
+    std::mutex stateMutex;
+    ZoneSnapshotService::SnapshotPtr snapshot;
+
+    std::atomic<bool> started{false};
+    std::atomic<bool> reloading{false};
+    std::atomic<uint64_t> reloads{0};
+
+    bool isTypeName(const std::string& s) {
+        return !s.empty() && std::all_of(s.begin(), s.end(), [](char c) {
+            return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+        });
+    }
+
+    void reload(const std::string& version) {
+        if (reloading.exchange(true)) return;
+
+        std::string typeList;
+        for (const auto& t : types) {
+            if (!typeList.empty()) typeList += ", ";
+            typeList += "'" + t + "'";
+        }
+
+        // Géométrie complète : chaque abonné en dérive ce qu'il lui faut (paliers, emprises...)
+        std::string sql = R"(
+            SELECT id, name, type::text AS type, density, parent_id,
+                   COALESCE(density, 0) * ST_Area(geom::geography) / 1e6 AS population,
+                   ST_AsText(geom) AS wkt
+            FROM zone
+            WHERE type::text IN ()" + typeList + R"()
+            ORDER BY name, id
+        )";
+
+        app().getDbClient()->execSqlAsync(sql,
+            [version](const Result& r) {
+                // Parsing hors des threads I/O, puis construction des index des abonnés
+                auto rows = std::make_shared<Result>(r);
+                Parallel::runInBackground([version, rows]() {
+                    auto startedAt = std::chrono::steady_clock::now();
+
+                    auto snap = std::make_shared<ZoneSnapshotService::Snapshot>();
+                    snap->zones.resize(rows->size());
+                    Parallel::forRange(rows->size(), [&](size_t begin, size_t end) {
+                        for (size_t i = begin; i < end; ++i) {
+                            auto row = (*rows)[i];
+                            auto& z = snap->zones[i];
+                            z.id = row["id"].as<int>();
+                            z.parentId = row["parent_id"].isNull() ? 0 : row["parent_id"].as<int>();
+                            z.name = row["name"].as<std::string>();
+                            z.type = row["type"].as<std::string>();
+                            z.density = row["density"].isNull() ? 0.0 : row["density"].as<double>();
+                            z.population = row["population"].isNull() ? 0.0 : row["population"].as<double>();
+                            if (!row["wkt"].isNull()) Geometry::fromWkt(row["wkt"].as<std::string>(), z.shape);
+                        }
+                    });
+                    snap->version = version;
+                    snap->loadedAt = trantor::Date::now().toFormattedString(false);
+
+                    {
+                        std::lock_guard<std::mutex> lock(stateMutex);
+                        snapshot = snap;
+                    }
+                    reloads++;
+
+                    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - startedAt).count();
+                    LOG_INFO << "🗺️ Zone snapshot loaded: " << snap->zones.size() << " zones (version "
+                             << version << ") in " << elapsed << " ms";
+
+                    for (const auto& build : subscribers) build(snap);
+                    reloading = false;
+                });
+            },
+            [](const DrogonDbException& e) {
+                auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+                ErrorHandler::logError("ZoneSnapshotService::reload", errorDetails);
+                reloading = false;
+            });
+    }
+}
+
+std::vector<std::string> ZoneSnapshotService::configuredTypes(const Json::Value& config,
+                                                              const std::vector<std::string>& defaults,
+                                                              const std::string& owner) {
+    const Json::Value& list = config["types"];
+    if (!list.isArray() || list.empty()) return defaults;
+
+    std::vector<std::string> out;
+    for (const auto& t : list) {
+        if (isTypeName(t.asString())) {
+            out.push_back(t.asString());
+        } else {
+            LOG_WARN << owner << ": ignored zone type '" << t.asString() << "'";
+        }
+    }
+    return out;
+}
+
+void ZoneSnapshotService::subscribe(const std::vector<std::string>& subscriberTypes,
+                                    std::function<void(const SnapshotPtr&)> build) {
+    if (started) {
+        LOG_ERROR << "ZoneSnapshotService::subscribe called after start(), ignored";
+        return;
+    }
+    for (const auto& t : subscriberTypes) {
+        if (std::find(types.begin(), types.end(), t) == types.end()) types.push_back(t);
+    }
+    subscribers.push_back(std::move(build));
+}
+
+void ZoneSnapshotService::start() {
+    if (subscribers.empty() || started.exchange(true)) return;
+
+    double pollInterval = app().getCustomConfig()["zone_snapshot"].get("poll_interval_s", 60.0).asDouble();
+
+    checkVersion();
+    if (pollInterval > 0) {
+        app().getLoop()->runEvery(pollInterval, []() { checkVersion(); });
+    }
+    LOG_INFO << "🗺️ Zone snapshot enabled (" << subscribers.size() << " subscriber(s), "
+             << types.size() << " type(s), version poll every " << pollInterval << " s)";
+}
+
+void ZoneSnapshotService::checkVersion() {
+    if (!started || reloading) return;
+
+    std::string sql = "SELECT version::text AS version FROM zone_data_version";
+
+    app().getDbClient()->execSqlAsync(sql,
+        [](const Result& r) {
+            std::string version = r.empty() ? "" : r[0]["version"].as<std::string>();
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                if (snapshot && snapshot->version == version) return;
+            }
+            reload(version);
+        },
+        [](const DrogonDbException& e) {
+            auto errorDetails = ErrorHandler::analyzePostgresError(e.base().what());
+            ErrorHandler::logError("ZoneSnapshotService::checkVersion", errorDetails);
+        });
+}
+
+Json::Value ZoneSnapshotService::getStatus() {
+    Json::Value status;
+    status["enabled"] = started.load();
+    status["reloading"] = reloading.load();
+    status["reloads"] = static_cast<Json::UInt64>(reloads.load());
+    status["subscribers"] = static_cast<Json::UInt64>(subscribers.size());
+
+    Json::Value typeList(Json::arrayValue);
+    for (const auto& t : types) typeList.append(t);
+    status["types"] = typeList;
+
+    std::lock_guard<std::mutex> lock(stateMutex);
+    if (snapshot) {
+        status["data_version"] = snapshot->version;
+        status["loaded_at"] = snapshot->loadedAt;
+        status["zones"] = static_cast<Json::UInt64>(snapshot->zones.size());
+    }
+    return status;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "../utils/Geometry.h"
+#include <drogon/drogon.h>
+#include <json/json.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Instantané versionné de la table zone, partagé par les index en mémoire
+ * (ZoneStoreService, ZoneSearchService, ZoneLocateService)
+ *
+ * - Version des données : zone_data_version (tenue par triggers, migration 009),
+ *   une seule lecture par sondage pour tous les abonnés
+ * - Changement de version : une seule requête pour l'union des types des abonnés,
+ *   géométries complètes parsées une fois ; chaque abonné construit ensuite son index
+ *   en arrière-plan à partir de l'instantané, l'ancien répond jusqu'à sa bascule
+ */
+class ZoneSnapshotService {
+public:
+    struct Zone {
+        int id = 0;
+        int parentId = 0;          // 0 = racine
+        std::string name;
+        std::string type;
+        double density = 0;
+        double population = 0;     // Densité × surface (km²)
+        Shape shape;               // Géométrie complète en degrés, emprise comprise (vide si nulle)
+    };
+
+    struct Snapshot {
+        std::string version;
+        std::string loadedAt;
+        std::vector<Zone> zones;   // Types des abonnés, triées par nom
+    };
+
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+    /**
+     * Types de zones d'une section de configuration (custom_config.<section>.types)
+     *
+     * Identifiants simples uniquement (insérés dans le SQL) ; les autres sont ignorés
+     * avec un avertissement. Liste absente ou vide : defaults.
+     */
+    static std::vector<std::string> configuredTypes(const Json::Value& config,
+                                                    const std::vector<std::string>& defaults,
+                                                    const std::string& owner);
+
+    /**
+     * Abonnement (avant start()) : build est appelé hors des threads I/O avec chaque
+     * nouvel instantané ; les abonnés ne retiennent que leurs types
+     */
+    static void subscribe(const std::vector<std::string>& types,
+                          std::function<void(const SnapshotPtr&)> build);
+
+    // Chargement initial + sondage de version (custom_config.zone_snapshot), si au moins un abonné
+    static void start();
+
+    // Compare la version courante de la table et recharge si elle a changé
+    static void checkVersion();
+
+    // Version, zones chargées, abonnés, rechargements (pour monitoring)
+    static Json::Value getStatus();
+};
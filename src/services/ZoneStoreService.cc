@@ -0,0 +1,354 @@
+#include "ZoneStoreService.h"
+#include "ZoneService.h"
+#include "ZoneSnapshotService.h"
+#include "../models/Zone.h"
+#include "../utils/ArcTopology.h"
+#include "../utils/Geometry.h"
+#include "../utils/Parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <vector>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace {
+    using Body = std::shared_ptr<const CacheService::CompressedEntry>;
+    using Bodies = std::array<Body, ZoneService::SIMPLIFICATION_LEVELS>;
+
+    // Zone et ses géométries simplifiées (une par palier), pour les requêtes découpées
+    struct StoredZone {
+        ZoneModel model;           // Sans wkt_geometry
+        std::array<std::vector<Polygon2>, ZoneService::SIMPLIFICATION_LEVELS> levels;
+        double minLon = 0, minLat = 0, maxLon = 0, maxLat = 0;
+    };
+
+    struct TypeZones {
+        std::vector<StoredZone> zones;   // Triées par nom (ordre du chemin SQL)
+        BoxIndex index{0.5};
+    };
+
+    struct Snapshot {
+        std::string version;
+        std::string loadedAt;
+        size_t zones = 0;
+        size_t rawBytes = 0;       // Réponses JSON non compressées
+        size_t storedBytes = 0;    // Réponses telles que stockées
+        std::map<std::string, Bodies> bodies;   // Par type
+        std::map<std::string, TypeZones> byType;
+        std::map<std::string, Bodies> topologies;   // TopoJSON par type et palier
+        size_t topoRawBytes = 0;
+        size_t topoStoredBytes = 0;
+    };
+
+    // Paramètres lus au démarrage (custom_config.zone_store)
+    bool enabled = false;
+    bool topology = true;
+    std::vector<std::string> types;
+
+    std::mutex stateMutex;
+    std::shared_ptr<const Snapshot> snapshot;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> fallbacks{0};
+    std::atomic<uint64_t> reloads{0};
+
+    // Douglas-Peucker anneau par anneau (anneaux dégénérés conservés, comme ST_Simplify(..., true))
+    std::vector<Polygon2> simplifyPolygons(const std::vector<Polygon2>& polygons, double tolerance) {
+        std::vector<Polygon2> out(polygons.size());
+        for (size_t p = 0; p < polygons.size(); ++p) {
+            for (const auto& ring : polygons[p].rings) {
+                out[p].rings.push_back(Geometry::simplifyRing(ring, tolerance));
+            }
+        }
+        return out;
+    }
+
+    // Nouvel instantané des zones : paliers simplifiés, réponses et topologies précalculées
+    void build(const ZoneSnapshotService::SnapshotPtr& source) {
+        auto startedAt = std::chrono::steady_clock::now();
+
+        // Zones groupées par type, dans l'ordre des noms (ordre de l'instantané)
+        std::map<std::string, std::vector<size_t>> byType;
+        for (size_t i = 0; i < source->zones.size(); ++i) {
+            const auto& type = source->zones[i].type;
+            if (std::find(types.begin(), types.end(), type) != types.end()) byType[type].push_back(i);
+        }
+
+        auto snap = std::make_shared<Snapshot>();
+        std::vector<std::pair<std::string, int>> jobs;
+        for (const auto& [type, list] : byType) {
+            snap->byType[type].zones.resize(list.size());
+            snap->zones += list.size();
+            for (int level = 0; level < ZoneService::SIMPLIFICATION_LEVELS; ++level) {
+                jobs.emplace_back(type, level);
+            }
+        }
+
+        // Une réponse (type × palier) par tâche : simplification, sérialisation puis compression,
+        // géométries du palier conservées pour les requêtes découpées
+        std::vector<Body> built(jobs.size());
+        std::vector<size_t> rawSizes(jobs.size(), 0);
+        Parallel::forRange(jobs.size(), [&](size_t begin, size_t end) {
+            Json::StreamWriterBuilder writer;
+            writer["indentation"] = "";
+            for (size_t j = begin; j < end; ++j) {
+                const auto& [type, level] = jobs[j];
+                auto& stored = snap->byType.at(type).zones;
+                double tolerance = ZoneService::toleranceForLevel(level);
+                std::string body = "[";
+                bool first = true;
+                const auto& list = byType.at(type);
+                for (size_t k = 0; k < list.size(); ++k) {
+                    const auto& zone = source->zones[list[k]];
+                    ZoneModel z;
+                    z.id = zone.id;
+                    z.name = zone.name;
+                    z.type = type;
+                    z.density = zone.density;
+                    z.parent_id = zone.parentId;
+                    stored[k].levels[level] = simplifyPolygons(zone.shape.polygons, tolerance);
+                    if (!stored[k].levels[level].empty()) {
+                        z.wkt_geometry = Geometry::polygonsToWkt(stored[k].levels[level]);
+                    }
+                    if (!first) body += ',';
+                    body += Json::writeString(writer, z.toJson());
+                    first = false;
+
+                    if (level == ZoneService::SIMPLIFICATION_LEVELS - 1) {
+                        z.wkt_geometry.clear();
+                        stored[k].model = z;
+                        stored[k].minLon = zone.shape.minX;
+                        stored[k].minLat = zone.shape.minY;
+                        stored[k].maxLon = zone.shape.maxX;
+                        stored[k].maxLat = zone.shape.maxY;
+                    }
+                }
+                body += ']';
+                rawSizes[j] = body.size();
+                built[j] = std::make_shared<const CacheService::CompressedEntry>(CacheService::compress(body));
+            }
+        });
+
+        // TopoJSON : une topologie d'arcs partagés par type, encodée à chaque palier
+        std::vector<std::string> typeNames;
+        for (const auto& [type, list] : byType) typeNames.push_back(type);
+        std::vector<Bodies> topoBuilt(topology ? typeNames.size() : 0);
+        std::vector<size_t> topoRaw(topoBuilt.size(), 0);
+        Parallel::forRange(topoBuilt.size(), [&](size_t begin, size_t end) {
+            Json::StreamWriterBuilder writer;
+            writer["indentation"] = "";
+            for (size_t t = begin; t < end; ++t) {
+                const auto& list = byType.at(typeNames[t]);
+                const auto& stored = snap->byType.at(typeNames[t]).zones;
+                std::vector<std::vector<Polygon2>> features(list.size());
+                std::vector<std::string> members(list.size());
+                for (size_t k = 0; k < list.size(); ++k) {
+                    features[k] = source->zones[list[k]].shape.polygons;
+                    const auto& z = stored[k].model;
+                    Json::Value props;
+                    props["name"] = z.name;
+                    props["type"] = z.type;
+                    props["density"] = z.density;
+                    props["parent_id"] = z.parent_id;
+                    members[k] = "\"id\":" + std::to_string(z.id) + ",\"properties\":" +
+                                 Json::writeString(writer, props);
+                }
+                ArcTopology topo(features);
+                for (int level = 0; level < ZoneService::SIMPLIFICATION_LEVELS; ++level) {
+                    double tolerance = ZoneService::toleranceForLevel(level);
+                    std::string body = topo.toTopoJson(typeNames[t], members, tolerance, tolerance / 4);
+                    topoRaw[t] += body.size();
+                    topoBuilt[t][level] = std::make_shared<const CacheService::CompressedEntry>(
+                        CacheService::compress(body));
+                }
+            }
+        });
+        for (size_t t = 0; t < topoBuilt.size(); ++t) {
+            snap->topologies[typeNames[t]] = topoBuilt[t];
+            snap->topoRawBytes += topoRaw[t];
+            for (const auto& body : topoBuilt[t]) snap->topoStoredBytes += body->body.size();
+        }
+
+        for (auto& [type, tz] : snap->byType) {
+            for (size_t k = 0; k < tz.zones.size(); ++k) {
+                const auto& z = tz.zones[k];
+                if (!z.levels.back().empty()) tz.index.insert(k, z.minLon, z.minLat, z.maxLon, z.maxLat);
+            }
+        }
+        snap->version = source->version;
+        snap->loadedAt = trantor::Date::now().toFormattedString(false);
+        for (size_t j = 0; j < jobs.size(); ++j) {
+            snap->bodies[jobs[j].first][jobs[j].second] = built[j];
+            snap->rawBytes += rawSizes[j];
+            snap->storedBytes += built[j]->body.size();
+        }
+
+        bool firstLoad;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            firstLoad = (snapshot == nullptr);
+            snapshot = snap;
+        }
+        reloads++;
+
+        // Les réponses SQL mises en cache décrivent l'ancienne version
+        if (!firstLoad) {
+            CacheService::getInstance().delPattern("zones:type:*");
+            CacheService::getInstance().delPattern("zones:search:*");
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startedAt).count();
+        LOG_INFO << "🗂️ Zone store loaded: " << snap->zones << " zones, " << byType.size()
+                 << " type(s), " << snap->rawBytes / 1024 << " KB -> " << snap->storedBytes / 1024
+                 << " KB in " << elapsed << " ms";
+    }
+}
+
+void ZoneStoreService::start() {
+    const auto& config = app().getCustomConfig()["zone_store"];
+    enabled = config.get("enabled", true).asBool();
+    if (!enabled) return;
+    topology = config.get("topology", true).asBool();
+
+    types = ZoneSnapshotService::configuredTypes(config, {"country", "region", "province", "commune"}, "Zone store");
+    if (types.empty()) {
+        enabled = false;
+        return;
+    }
+    ZoneSnapshotService::subscribe(types, build);
+    LOG_INFO << "🗂️ Zone store enabled (" << types.size() << " type(s))";
+}
+
+std::shared_ptr<const CacheService::CompressedEntry> ZoneStoreService::getSimplified(const std::string& type, int zoom) {
+    if (!enabled) return nullptr;
+
+    std::shared_ptr<const Snapshot> snap;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        snap = snapshot;
+    }
+    if (!snap || std::find(types.begin(), types.end(), type) == types.end()) {
+        fallbacks++;
+        return nullptr;
+    }
+
+    hits++;
+    auto it = snap->bodies.find(type);
+    if (it == snap->bodies.end()) {
+        // Type chargé mais sans aucune zone : même réponse que SQL
+        static const auto empty = std::make_shared<const CacheService::CompressedEntry>(
+            CacheService::CompressedEntry{"identity", "[]"});
+        return empty;
+    }
+    return it->second[ZoneService::simplificationLevel(zoom)];
+}
+
+std::shared_ptr<const CacheService::CompressedEntry> ZoneStoreService::getTopology(const std::string& type, int zoom) {
+    if (!enabled || !topology) return nullptr;
+
+    std::shared_ptr<const Snapshot> snap;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        snap = snapshot;
+    }
+    if (!snap || std::find(types.begin(), types.end(), type) == types.end()) {
+        fallbacks++;
+        return nullptr;
+    }
+
+    hits++;
+    auto it = snap->topologies.find(type);
+    if (it == snap->topologies.end()) {
+        // Type chargé mais sans aucune zone : topologie vide
+        static const auto empty = std::make_shared<const CacheService::CompressedEntry>(
+            CacheService::CompressedEntry{"identity",
+                R"({"type":"Topology","objects":{},"arcs":[]})"});
+        return empty;
+    }
+    return it->second[ZoneService::simplificationLevel(zoom)];
+}
+
+bool ZoneStoreService::getSimplifiedInBox(const std::string& type, int zoom,
+                                          const ZoneService::Viewport& viewport, std::string& out) {
+    if (!enabled) return false;
+
+    std::shared_ptr<const Snapshot> snap;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        snap = snapshot;
+    }
+    if (!snap || std::find(types.begin(), types.end(), type) == types.end()) {
+        fallbacks++;
+        return false;
+    }
+    hits++;
+
+    out = "[";
+    auto it = snap->byType.find(type);
+    if (it != snap->byType.end()) {
+        const auto& tz = it->second;
+        const int level = ZoneService::simplificationLevel(zoom);
+
+        // Index d'emprises, puis ordre des noms (indices triés = ordre du chemin SQL)
+        auto candidates = tz.index.query(viewport.minLon, viewport.minLat, viewport.maxLon, viewport.maxLat);
+        std::sort(candidates.begin(), candidates.end());
+
+        Json::StreamWriterBuilder writer;
+        writer["indentation"] = "";
+        bool first = true;
+        for (size_t k : candidates) {
+            const auto& z = tz.zones[k];
+            if (z.maxLon < viewport.minLon || z.minLon > viewport.maxLon ||
+                z.maxLat < viewport.minLat || z.minLat > viewport.maxLat) continue;
+
+            ZoneModel model = z.model;
+            bool inside = z.minLon >= viewport.minLon && z.maxLon <= viewport.maxLon &&
+                          z.minLat >= viewport.minLat && z.maxLat <= viewport.maxLat;
+            if (inside) {
+                model.wkt_geometry = Geometry::polygonsToWkt(z.levels[level]);
+            } else {
+                auto clipped = Geometry::clipPolygons(z.levels[level], viewport.minLon, viewport.minLat,
+                                                      viewport.maxLon, viewport.maxLat);
+                if (clipped.empty()) continue;
+                model.wkt_geometry = Geometry::polygonsToWkt(clipped);
+            }
+            if (!first) out += ',';
+            out += Json::writeString(writer, model.toJson());
+            first = false;
+        }
+    }
+    out += ']';
+    return true;
+}
+
+Json::Value ZoneStoreService::getStatus() {
+    Json::Value status;
+    status["enabled"] = enabled;
+    status["hits"] = static_cast<Json::UInt64>(hits.load());
+    status["sql_fallbacks"] = static_cast<Json::UInt64>(fallbacks.load());
+    status["reloads"] = static_cast<Json::UInt64>(reloads.load());
+
+    Json::Value typeList(Json::arrayValue);
+    for (const auto& t : types) typeList.append(t);
+    status["types"] = typeList;
+    status["snapshot"] = ZoneSnapshotService::getStatus();
+
+    std::lock_guard<std::mutex> lock(stateMutex);
+    if (snapshot) {
+        status["data_version"] = snapshot->version;
+        status["loaded_at"] = snapshot->loadedAt;
+        status["zones"] = static_cast<Json::UInt64>(snapshot->zones);
+        status["raw_bytes"] = static_cast<Json::UInt64>(snapshot->rawBytes);
+        status["stored_bytes"] = static_cast<Json::UInt64>(snapshot->storedBytes);
+        status["topojson_raw_bytes"] = static_cast<Json::UInt64>(snapshot->topoRawBytes);
+        status["topojson_stored_bytes"] = static_cast<Json::UInt64>(snapshot->topoStoredBytes);
+    }
+    return status;
+}
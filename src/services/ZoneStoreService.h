@@ -0,0 +1,53 @@
+#pragma once
+#include "CacheService.h"
+#include "ZoneService.h"
+#include <drogon/drogon.h>
+#include <memory>
+#include <string>
+
+/**
+ * Magasin en mémoire des géométries de zones pour /api/zones/type/{type}/simplified
+ *
+ * Remplace ST_Simplify à chaque défaut de cache : les zones des types configurés
+ * sont lues dans l'instantané partagé (ZoneSnapshotService), simplifiées en mémoire
+ * à chacun des paliers de ZoneService::simplificationLevel, et chaque réponse
+ * (type × palier) est sérialisée puis compressée d'avance. Une requête ne fait plus
+ * qu'une copie mémoire. Reconstruit à chaque nouvel instantané.
+ * - TopoJSON : topologie d'arcs partagés construite une fois par type (cf. ArcTopology),
+ *   frontières communes envoyées une fois et simplifiées sans interstices
+ * - Requête avec vue : index d'emprises et découpage en mémoire des géométries du palier
+ * - Type non chargé (density_zone...) ou magasin pas encore prêt : l'appelant se rabat sur SQL
+ */
+class ZoneStoreService {
+public:
+    // Abonnement à l'instantané des zones (custom_config.zone_store)
+    static void start();
+
+    /**
+     * Réponse précalculée (tableau JSON de ZoneModel, même format que le chemin SQL)
+     *
+     * @return nullptr si le magasin n'est pas prêt ou si le type n'y est pas chargé
+     */
+    static std::shared_ptr<const CacheService::CompressedEntry> getSimplified(const std::string& type, int zoom);
+
+    /**
+     * Même couche en TopoJSON (custom_config.zone_store.topology) : arcs partagés
+     * simplifiés une fois par palier, coordonnées quantifiées (pas = tolérance / 4)
+     * et codées en deltas, propriétés id / name / type / density / parent_id
+     *
+     * @return nullptr si le magasin n'est pas prêt ou si le type n'y est pas chargé
+     */
+    static std::shared_ptr<const CacheService::CompressedEntry> getTopology(const std::string& type, int zoom);
+
+    /**
+     * Zones du type qui intersectent la vue, géométries du palier découpées à la vue
+     * (même format, WKT en MULTIPOLYGON) ; zones entièrement hors de la vue omises
+     *
+     * @return false si le magasin n'est pas prêt ou si le type n'y est pas chargé
+     */
+    static bool getSimplifiedInBox(const std::string& type, int zoom, const ZoneService::Viewport& viewport,
+                                   std::string& out);
+
+    // Version, zones chargées, volume des réponses, hits / replis SQL (pour monitoring)
+    static Json::Value getStatus();
+};
@@ -0,0 +1,236 @@
+#ifndef ARC_TOPOLOGY_H
+#define ARC_TOPOLOGY_H
+
+#include "Geometry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Topologie d'arcs partagés d'un ensemble de multipolygones (principe de TopoJSON)
+//
+// Les sommets sont calés sur une grille fine (snap, en degrés). Une jonction est un
+// sommet atteint par des anneaux qui n'y ont pas les mêmes voisins ; chaque anneau
+// est coupé en arcs à ses jonctions et un arc déjà rencontré, dans un sens ou dans
+// l'autre, est réutilisé. Une frontière commune n'est donc stockée qu'une fois, et
+// la simplification arc par arc (extrémités fixes) la modifie à l'identique pour
+// les deux voisins : pas d'interstices entre zones, quel que soit le palier.
+class ArcTopology {
+public:
+    // Référence d'arc : i, ou ~i pour l'arc i parcouru à l'envers (convention TopoJSON)
+    using RingArcs = std::vector<int>;
+    using PolygonArcs = std::vector<RingArcs>;
+
+    explicit ArcTopology(const std::vector<std::vector<Polygon2>>& features, double snap = 1e-7)
+        : snap_(snap), features_(features.size())
+    {
+        // Anneaux calés sur la grille, ouverts (dernier sommet != premier), sans doublons consécutifs
+        struct OpenRing {
+            size_t feature;
+            size_t polygon;
+            std::vector<uint64_t> points;
+        };
+        std::vector<OpenRing> rings;
+        for (size_t f = 0; f < features.size(); ++f) {
+            for (const auto& poly : features[f]) {
+                size_t polygon = features_[f].size();
+                bool hasOuter = false;
+                for (size_t r = 0; r < poly.rings.size(); ++r) {
+                    std::vector<uint64_t> points;
+                    points.reserve(poly.rings[r].size());
+                    for (const auto& p : poly.rings[r]) {
+                        uint64_t k = pack(std::llround(p.x / snap_), std::llround(p.y / snap_));
+                        if (points.empty() || points.back() != k) points.push_back(k);
+                    }
+                    while (points.size() > 1 && points.back() == points.front()) points.pop_back();
+                    if (points.size() < 3) {
+                        if (r == 0) break;   // Contour extérieur dégénéré : polygone ignoré
+                        continue;
+                    }
+                    hasOuter = true;
+                    rings.push_back({f, polygon, std::move(points)});
+                }
+                if (hasOuter) features_[f].emplace_back();
+            }
+        }
+
+        // Jonctions : sommet revu avec d'autres voisins (précédent, suivant) que la première fois
+        struct Neighbors { uint64_t a, b; };
+        std::unordered_map<uint64_t, Neighbors> seen;
+        std::unordered_set<uint64_t> junctions;
+        for (const auto& ring : rings) {
+            const auto& pts = ring.points;
+            size_t n = pts.size();
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t prev = pts[(i + n - 1) % n], next = pts[(i + 1) % n];
+                auto [it, inserted] = seen.emplace(pts[i], Neighbors{prev, next});
+                if (!inserted) {
+                    const auto& nb = it->second;
+                    if (!((nb.a == prev && nb.b == next) || (nb.a == next && nb.b == prev))) {
+                        junctions.insert(pts[i]);
+                    }
+                }
+            }
+        }
+
+        // Découpage aux jonctions, arcs dédupliqués
+        for (auto& ring : rings) {
+            const auto& pts = ring.points;
+            size_t n = pts.size();
+            RingArcs refs;
+
+            size_t start = n;
+            for (size_t i = 0; i < n && start == n; ++i) {
+                if (junctions.count(pts[i])) start = i;
+            }
+            if (start == n) {
+                // Sans jonction : un arc fermé, commençant au plus petit sommet (rotation canonique)
+                size_t first = static_cast<size_t>(std::min_element(pts.begin(), pts.end()) - pts.begin());
+                std::vector<uint64_t> arc;
+                arc.reserve(n + 1);
+                for (size_t i = 0; i <= n; ++i) arc.push_back(pts[(first + i) % n]);
+                refs.push_back(addArc(std::move(arc)));
+            } else {
+                std::vector<uint64_t> arc = {pts[start]};
+                for (size_t i = 1; i <= n; ++i) {
+                    uint64_t p = pts[(start + i) % n];
+                    arc.push_back(p);
+                    if (i == n || junctions.count(p)) {
+                        refs.push_back(addArc(std::move(arc)));
+                        arc = {p};
+                    }
+                }
+            }
+            features_[ring.feature][ring.polygon].push_back(std::move(refs));
+        }
+    }
+
+    size_t arcCount() const { return arcs_.size(); }
+
+    // Arcs en degrés, simplifiés par Douglas-Peucker (extrémités conservées)
+    std::vector<std::vector<Point2>> arcs(double tolerance) const {
+        std::vector<std::vector<Point2>> out(arcs_.size());
+        for (size_t a = 0; a < arcs_.size(); ++a) {
+            std::vector<Point2> line;
+            line.reserve(arcs_[a].size());
+            for (uint64_t k : arcs_[a]) line.push_back(unpack(k));
+            bool closed = line.size() > 1 && arcs_[a].front() == arcs_[a].back();
+            out[a] = closed ? Geometry::simplifyRing(line, tolerance) : Geometry::simplifyLine(line, tolerance);
+        }
+        return out;
+    }
+
+    /**
+     * Document TopoJSON : un objet GeometryCollection de MultiPolygon
+     *
+     * members[f] : membres JSON ajoutés à la géométrie f (ex. "id":1,"properties":{...})
+     * Coordonnées quantifiées au pas quantStep (degrés) et codées en deltas.
+     */
+    std::string toTopoJson(const std::string& objectName, const std::vector<std::string>& members,
+                           double tolerance, double quantStep) const {
+        auto lines = arcs(tolerance);
+
+        double minX = 0, minY = 0, maxX = 0, maxY = 0;
+        bool any = false;
+        for (const auto& line : lines) {
+            for (const auto& p : line) {
+                if (!any) { minX = maxX = p.x; minY = maxY = p.y; any = true; }
+                minX = std::min(minX, p.x); maxX = std::max(maxX, p.x);
+                minY = std::min(minY, p.y); maxY = std::max(maxY, p.y);
+            }
+        }
+
+        char buf[128];
+        std::string out = R"({"type":"Topology")";
+        int n = std::snprintf(buf, sizeof(buf), R"(,"bbox":[%.7f,%.7f,%.7f,%.7f])", minX, minY, maxX, maxY);
+        out.append(buf, n);
+        n = std::snprintf(buf, sizeof(buf), R"(,"transform":{"scale":[%.10g,%.10g],"translate":[%.7f,%.7f]})",
+                          quantStep, quantStep, minX, minY);
+        out.append(buf, n);
+
+        out += R"(,"objects":{")" + objectName + R"(":{"type":"GeometryCollection","geometries":[)";
+        for (size_t f = 0; f < features_.size(); ++f) {
+            if (f > 0) out += ',';
+            out += features_[f].empty() ? R"({"type":null)" : R"({"type":"MultiPolygon","arcs":[)";
+            for (size_t p = 0; p < features_[f].size(); ++p) {
+                out += p == 0 ? "[" : ",[";
+                const auto& rings = features_[f][p];
+                for (size_t r = 0; r < rings.size(); ++r) {
+                    out += r == 0 ? "[" : ",[";
+                    for (size_t i = 0; i < rings[r].size(); ++i) {
+                        if (i > 0) out += ',';
+                        out += std::to_string(rings[r][i]);
+                    }
+                    out += ']';
+                }
+                out += ']';
+            }
+            if (!features_[f].empty()) out += ']';
+            if (f < members.size() && !members[f].empty()) out += ',' + members[f];
+            out += '}';
+        }
+        out += "]}}";
+
+        // Arcs : première position absolue, puis deltas non nuls
+        out += R"(,"arcs":[)";
+        for (size_t a = 0; a < lines.size(); ++a) {
+            if (a > 0) out += ',';
+            out += '[';
+            long long px = 0, py = 0;
+            size_t written = 0;
+            for (const auto& p : lines[a]) {
+                long long x = std::llround((p.x - minX) / quantStep);
+                long long y = std::llround((p.y - minY) / quantStep);
+                if (written > 0 && x == px && y == py) continue;
+                n = std::snprintf(buf, sizeof(buf), written == 0 ? "[%lld,%lld]" : ",[%lld,%lld]",
+                                  written == 0 ? x : x - px, written == 0 ? y : y - py);
+                out.append(buf, n);
+                px = x;
+                py = y;
+                ++written;
+            }
+            if (written == 1) out += ",[0,0]";   // Arc réduit à un point : 2 positions minimum
+            out += ']';
+        }
+        out += "]}";
+        return out;
+    }
+
+private:
+    double snap_;
+    std::vector<std::vector<PolygonArcs>> features_;   // Par feature : polygones -> anneaux -> arcs
+    std::vector<std::vector<uint64_t>> arcs_;           // Sommets calés sur la grille
+    std::unordered_map<uint64_t, std::vector<int>> byEnds_;
+
+    static uint64_t pack(long long x, long long y) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+
+    Point2 unpack(uint64_t k) const {
+        auto x = static_cast<int32_t>(static_cast<uint32_t>(k >> 32));
+        auto y = static_cast<int32_t>(static_cast<uint32_t>(k));
+        return {x * snap_, y * snap_};
+    }
+
+    // Arc existant (même suite de sommets, dans un sens ou dans l'autre) ou nouvel arc
+    int addArc(std::vector<uint64_t>&& arc) {
+        uint64_t lo = std::min(arc.front(), arc.back()), hi = std::max(arc.front(), arc.back());
+        auto& candidates = byEnds_[lo * 0x9E3779B97F4A7C15ULL ^ hi];
+        for (int idx : candidates) {
+            const auto& c = arcs_[idx];
+            if (c.size() != arc.size()) continue;
+            if (std::equal(c.begin(), c.end(), arc.begin())) return idx;
+            if (std::equal(c.rbegin(), c.rend(), arc.begin())) return ~idx;
+        }
+        int idx = static_cast<int>(arcs_.size());
+        arcs_.push_back(std::move(arc));
+        candidates.push_back(idx);
+        return idx;
+    }
+};
+
+#endif // ARC_TOPOLOGY_H
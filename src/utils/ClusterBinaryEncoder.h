@@ -0,0 +1,191 @@
+#ifndef CLUSTER_BINARY_ENCODER_H
+#define CLUSTER_BINARY_ENCODER_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Format binaire colonnaire des clusters (alternative compacte au GeoJSON)
+//
+// Little-endian, colonnes alignées sur 4 octets : décodables côté client par
+// des vues typées (Int32Array, Float32Array...) sans copie. Comme FlatBuffers,
+// une table d'offsets décrit les sections : on peut en ajouter sans casser
+// les lecteurs existants.
+//
+//   En-tête (24 octets)
+//     0  char[4]   magic "ACLB"
+//     4  uint16    version
+//     6  uint16    nombre de sections S
+//     8  uint32    nombre de features n
+//    12  uint32    nombre d'antennes représentées (somme des point_count)
+//    16  int32     échelle des coordonnées (degrés * scale)
+//    20  uint32    réservé
+//   Table des sections : S x (uint32 offset, uint32 longueur en octets)
+//
+//   Sections (indices fixes, cf. Section)
+//     LON, LAT          int32[n]    coordonnées quantifiées
+//     POINT_COUNT       uint32[n]
+//     AVG_RADIUS        float32[n]  mètres
+//     ANTENNA_ID        int32[n]    id de l'antenne isolée, 0 pour un cluster
+//     LEAF_BEGIN        uint32[n]   cluster_id = "k<metadata.cluster_level>.<leaf_begin>.<metadata.data_version>"
+//     STATUS_COUNTS     uint32[n x |STATUS_DICT|]    comptes par feature (ligne par feature)
+//     TECH_COUNTS       uint32[n x |TECH_DICT|]
+//     OPERATOR_COUNTS   uint32[n x |OPERATOR_DICT|]
+//     STATUS_DICT       chaînes     uint32 nombre, puis (uint8 longueur, octets UTF-8)
+//     TECH_DICT         chaînes
+//     OPERATOR_DICT     int32[k]
+//     METADATA          JSON UTF-8
+//
+// La taille ne dépend que du nombre de features visibles : les membres d'un
+// cluster s'obtiennent à la demande (/api/antennas/clusters/{id}/leaves).
+class ClusterBinaryEncoder {
+public:
+    static constexpr const char* CONTENT_TYPE = "application/vnd.antennes.clusters+binary";
+    static constexpr uint16_t VERSION = 2;
+    static constexpr int32_t COORD_SCALE = 10000000; // 1e-7 degré (~1 cm)
+
+    enum Section : uint16_t {
+        LON, LAT, POINT_COUNT, AVG_RADIUS,
+        ANTENNA_ID, LEAF_BEGIN,
+        STATUS_COUNTS, TECH_COUNTS, OPERATOR_COUNTS,
+        STATUS_DICT, TECH_DICT, OPERATOR_DICT,
+        METADATA,
+        SECTION_COUNT
+    };
+
+    void addFeature(double lon, double lat, uint32_t pointCount, double avgRadius,
+                    int32_t antennaId, uint32_t leafBegin) {
+        lon_.push_back(quantize(lon));
+        lat_.push_back(quantize(lat));
+        pointCount_.push_back(pointCount);
+        avgRadius_.push_back(static_cast<float>(avgRadius));
+        antennaId_.push_back(antennaId);
+        leafBegin_.push_back(leafBegin);
+        total_ += pointCount;
+    }
+
+    // Comptes de la dernière feature ajoutée
+    void addStatusCount(const std::string& status, uint32_t count) {
+        statusCounts_.emplace_back(lastFeature(), index(statusDict_, statusIndex_, status), count);
+    }
+    void addTechnologyCount(const std::string& technology, uint32_t count) {
+        techCounts_.emplace_back(lastFeature(), index(techDict_, techIndex_, technology), count);
+    }
+    void addOperatorCount(int operatorId, uint32_t count) {
+        operatorCounts_.emplace_back(lastFeature(), index(operatorDict_, operatorIndex_, operatorId), count);
+    }
+
+    size_t featureCount() const { return lon_.size(); }
+
+    std::string encode(const std::string& metadataJson) const {
+        const uint32_t n = static_cast<uint32_t>(lon_.size());
+
+        std::vector<std::string> sections(SECTION_COUNT);
+        sections[LON] = raw(lon_);
+        sections[LAT] = raw(lat_);
+        sections[POINT_COUNT] = raw(pointCount_);
+        sections[AVG_RADIUS] = raw(avgRadius_);
+        sections[ANTENNA_ID] = raw(antennaId_);
+        sections[LEAF_BEGIN] = raw(leafBegin_);
+        sections[STATUS_COUNTS] = raw(matrix(statusCounts_, n, statusDict_.size()));
+        sections[TECH_COUNTS] = raw(matrix(techCounts_, n, techDict_.size()));
+        sections[OPERATOR_COUNTS] = raw(matrix(operatorCounts_, n, operatorDict_.size()));
+        sections[STATUS_DICT] = strings(statusDict_);
+        sections[TECH_DICT] = strings(techDict_);
+        sections[OPERATOR_DICT] = raw(operatorDict_);
+        sections[METADATA] = metadataJson;
+
+        // En-tête + table des sections, puis sections alignées sur 4 octets
+        std::string out;
+        out.append("ACLB", 4);
+        append<uint16_t>(out, VERSION);
+        append<uint16_t>(out, SECTION_COUNT);
+        append<uint32_t>(out, n);
+        append<uint32_t>(out, static_cast<uint32_t>(total_));
+        append<int32_t>(out, COORD_SCALE);
+        append<uint32_t>(out, 0);
+
+        size_t tableAt = out.size();
+        out.resize(tableAt + SECTION_COUNT * 8);
+        for (size_t s = 0; s < sections.size(); ++s) {
+            out.resize((out.size() + 3) & ~size_t(3), '\0');
+            uint32_t offset = static_cast<uint32_t>(out.size());
+            uint32_t length = static_cast<uint32_t>(sections[s].size());
+            std::memcpy(&out[tableAt + s * 8], &offset, 4);
+            std::memcpy(&out[tableAt + s * 8 + 4], &length, 4);
+            out += sections[s];
+        }
+        return out;
+    }
+
+private:
+    // (feature, index dans le dictionnaire, compte)
+    using Count = std::tuple<uint32_t, uint32_t, uint32_t>;
+
+    static int32_t quantize(double deg) {
+        return static_cast<int32_t>(std::lround(deg * COORD_SCALE));
+    }
+
+    uint32_t lastFeature() const {
+        return static_cast<uint32_t>(lon_.size() - 1);
+    }
+
+    template <typename T>
+    static uint32_t index(std::vector<T>& dict, std::map<T, uint32_t>& positions, const T& value) {
+        auto it = positions.find(value);
+        if (it != positions.end()) return it->second;
+        uint32_t idx = static_cast<uint32_t>(dict.size());
+        dict.push_back(value);
+        positions.emplace(value, idx);
+        return idx;
+    }
+
+    // Matrice dense n x width (le dictionnaire n'est complet qu'après la dernière feature)
+    static std::vector<uint32_t> matrix(const std::vector<Count>& counts, uint32_t n, size_t width) {
+        std::vector<uint32_t> out(n * width, 0);
+        for (const auto& [feature, column, count] : counts) {
+            out[feature * width + column] = count;
+        }
+        return out;
+    }
+
+    template <typename T>
+    static void append(std::string& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static std::string raw(const std::vector<T>& column) {
+        return std::string(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(T));
+    }
+
+    static std::string strings(const std::vector<std::string>& dict) {
+        std::string out;
+        append<uint32_t>(out, static_cast<uint32_t>(dict.size()));
+        for (const auto& s : dict) {
+            size_t len = s.size() < 255 ? s.size() : 255;
+            out += static_cast<char>(len);
+            out.append(s, 0, len);
+        }
+        return out;
+    }
+
+    std::vector<int32_t> lon_, lat_;
+    std::vector<uint32_t> pointCount_;
+    std::vector<float> avgRadius_;
+    std::vector<int32_t> antennaId_;
+    std::vector<uint32_t> leafBegin_;
+    uint64_t total_ = 0;
+
+    std::vector<Count> statusCounts_, techCounts_, operatorCounts_;
+    std::vector<std::string> statusDict_, techDict_;
+    std::map<std::string, uint32_t> statusIndex_, techIndex_;
+    std::vector<int32_t> operatorDict_;
+    std::map<int32_t, uint32_t> operatorIndex_;
+};
+
+#endif
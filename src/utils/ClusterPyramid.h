@@ -0,0 +1,198 @@
+#ifndef CLUSTER_PYRAMID_H
+#define CLUSTER_PYRAMID_H
+
+#include "KdTree.h"
+#include "GeoUtils.h"
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+
+// Pyramide de clusters par niveau de zoom (principe de supercluster)
+//
+// Le niveau maxZoom + 1 contient les points bruts. Chaque niveau z est obtenu
+// en regroupant gloutonnement les éléments du niveau z + 1 situés à moins de
+// radiusPx pixels (à l'échelle du zoom z) ; chaque niveau est indexé par un
+// KD-tree. Une requête bbox + zoom est un simple parcours de KD-tree.
+//
+// Les clusters sont hiérarchiques : en ordonnant les points en profondeur,
+// les feuilles de tout cluster occupent une plage contiguë [leafBegin, leafBegin + count)
+// de leafOrder(), quel que soit le niveau.
+class ClusterPyramid {
+public:
+    struct Input {
+        double lon;
+        double lat;
+        double radius;      // Agrégé en moyenne par cluster
+        uint32_t source;    // Position dans le jeu de données d'origine
+    };
+
+    struct Node {
+        double x;           // Position de regroupement (Mercator normalisé [0, 1], pondérée)
+        double y;
+        double sumLon;      // Sommes sur les feuilles (centroïde = moyenne des positions)
+        double sumLat;
+        double sumRadius;
+        uint32_t count;
+        uint32_t leafBegin;
+        int32_t parent;     // Cluster englobant au niveau inférieur (-1 au niveau 0)
+
+        bool isCluster() const { return count > 1; }
+        double lon() const { return sumLon / count; }
+        double lat() const { return sumLat / count; }
+        double avgRadius() const { return sumRadius / count; }
+    };
+
+    ClusterPyramid(const std::vector<Input>& points, int maxZoom, double radiusPx, double extent = 512.0)
+        : maxZoom_(maxZoom), radiusPx_(radiusPx)
+    {
+        levels_.resize(maxZoom + 2);
+
+        // Niveau des points bruts
+        auto& leaves = levels_[maxZoom + 1];
+        leaves.nodes.reserve(points.size());
+        for (const auto& p : points) {
+            leaves.nodes.push_back({lngX(p.lon), latY(p.lat), p.lon, p.lat, p.radius, 1, p.source, -1});
+        }
+        index(leaves);
+
+        // Regroupement niveau par niveau, du plus détaillé au plus global
+        for (int z = maxZoom; z >= 0; --z) {
+            double r = radiusPx / (extent * std::ldexp(1.0, z));
+            clusterLevel(levels_[z + 1], levels_[z], r);
+            index(levels_[z]);
+        }
+
+        assignLeafRanges();
+    }
+
+    int maxZoom() const { return maxZoom_; }
+    double radiusPx() const { return radiusPx_; }
+    size_t pointCount() const { return leafOrder_.size(); }
+
+    // Niveau de la pyramide pour un zoom carte (au-delà de maxZoom : points bruts)
+    int levelFor(int zoom) const {
+        return std::max(0, std::min(zoom, maxZoom_ + 1));
+    }
+
+    const std::vector<Node>& nodes(int level) const { return levels_[level].nodes; }
+
+    // Position source de la k-ième feuille (ordre en profondeur)
+    uint32_t leaf(uint32_t k) const { return leafOrder_[k]; }
+
+    // Visite les nœuds du niveau correspondant au zoom dans la bbox (degrés)
+    template <typename Visit>
+    void query(int zoom, double minLon, double minLat, double maxLon, double maxLat, Visit&& visit) const {
+        queryMercator(zoom, lngX(minLon), latY(maxLat), lngX(maxLon), latY(minLat), std::forward<Visit>(visit));
+    }
+
+    // Même requête en coordonnées Mercator normalisées (tuiles)
+    template <typename Visit>
+    void queryMercator(int zoom, double minX, double minY, double maxX, double maxY, Visit&& visit) const {
+        const auto& level = levels_[levelFor(zoom)];
+        level.tree.range(minX, minY, maxX, maxY,
+            [&](uint32_t id) { visit(level.nodes[id]); });
+    }
+
+    // Nombre de nœuds d'un niveau dans la bbox (degrés), compté jusqu'à limit + 1 au plus
+    size_t count(int level, double minLon, double minLat, double maxLon, double maxLat, size_t limit) const {
+        return levels_[level].tree.count(lngX(minLon), latY(maxLat), lngX(maxLon), latY(minLat), limit);
+    }
+
+    // Projection Web Mercator normalisée
+    static double lngX(double lon) {
+        return lon / 360.0 + 0.5;
+    }
+
+    static double latY(double lat) {
+        double s = std::sin(lat * GeoUtils::PI / 180.0);
+        double y = 0.5 - 0.25 * std::log((1 + s) / (1 - s)) / GeoUtils::PI;
+        return y < 0 ? 0 : (y > 1 ? 1 : y);
+    }
+
+private:
+    struct Level {
+        std::vector<Node> nodes;
+        KdTree tree;
+    };
+
+    static void index(Level& level) {
+        std::vector<KdTree::Item> items;
+        items.reserve(level.nodes.size());
+        for (size_t i = 0; i < level.nodes.size(); ++i) {
+            items.push_back({level.nodes[i].x, level.nodes[i].y, static_cast<uint32_t>(i)});
+        }
+        level.tree = KdTree(std::move(items));
+    }
+
+    // Regroupement glouton : chaque élément non traité absorbe ses voisins non traités
+    static void clusterLevel(Level& from, Level& to, double r) {
+        std::vector<char> done(from.nodes.size(), 0);
+        to.nodes.reserve(from.nodes.size() / 2);
+
+        for (size_t i = 0; i < from.nodes.size(); ++i) {
+            if (done[i]) continue;
+            done[i] = 1;
+
+            Node& seed = from.nodes[i];
+            Node cluster = seed;
+            cluster.parent = -1;
+            double wx = seed.x * seed.count;
+            double wy = seed.y * seed.count;
+            int32_t clusterId = static_cast<int32_t>(to.nodes.size());
+            seed.parent = clusterId;
+
+            from.tree.within(seed.x, seed.y, r, [&](uint32_t j) {
+                if (done[j]) return;
+                done[j] = 1;
+                Node& n = from.nodes[j];
+                n.parent = clusterId;
+                wx += n.x * n.count;
+                wy += n.y * n.count;
+                cluster.sumLon += n.sumLon;
+                cluster.sumLat += n.sumLat;
+                cluster.sumRadius += n.sumRadius;
+                cluster.count += n.count;
+            });
+
+            cluster.x = wx / cluster.count;
+            cluster.y = wy / cluster.count;
+            to.nodes.push_back(cluster);
+        }
+    }
+
+    // Plages de feuilles : niveau 0 dans l'ordre, puis chaque enfant à la suite de ses frères
+    void assignLeafRanges() {
+        uint32_t cursor = 0;
+        for (auto& n : levels_[0].nodes) {
+            n.leafBegin = cursor;
+            cursor += n.count;
+        }
+
+        std::vector<uint32_t> sources;
+        for (size_t z = 1; z < levels_.size(); ++z) {
+            auto& parents = levels_[z - 1].nodes;
+            std::vector<uint32_t> next(parents.size());
+            for (size_t p = 0; p < parents.size(); ++p) next[p] = parents[p].leafBegin;
+
+            bool leafLevel = (z == levels_.size() - 1);
+            if (leafLevel) sources.resize(cursor);
+
+            for (auto& n : levels_[z].nodes) {
+                uint32_t begin = next[n.parent];
+                next[n.parent] += n.count;
+                if (leafLevel) sources[begin] = n.leafBegin; // leafBegin = position source au niveau brut
+                n.leafBegin = begin;
+            }
+        }
+        leafOrder_ = std::move(sources);
+    }
+
+    int maxZoom_;
+    double radiusPx_;
+    std::vector<Level> levels_;
+    std::vector<uint32_t> leafOrder_;
+};
+
+#endif
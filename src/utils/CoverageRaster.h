@@ -0,0 +1,388 @@
+#ifndef COVERAGE_RASTER_H
+#define COVERAGE_RASTER_H
+
+#include "Geometry.h"
+#include "GeoUtils.h"
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+
+// Masque binaire de couverture d'une tuile (1 bit par pixel, lignes de mots 64 bits)
+//
+// Remplace l'union vectorielle (ST_Union + ST_MakeValid) des empreintes :
+// - Chaque empreinte est réduite à des segments horizontaux de pixels (spans),
+//   calculés une fois puis appliqués par OU à tous les masques concernés
+// - Remplissage mot par mot : coût proportionnel à la surface, indépendant
+//   du recouvrement entre empreintes
+// - trace() reconstruit des polygones valides par marching squares
+// - downsample() / packed() / orPacked() : pyramide de masques réduits par OU,
+//   assemblés sans union vectorielle (blocs de couverture)
+//
+// Coordonnées en pixels de la tuile : x vers l'est, y vers le sud, le centre
+// du pixel (i, j) est en (i + 0.5, j + 0.5).
+class CoverageRaster {
+public:
+    struct Span {
+        int row;
+        int x0;   // Premier pixel rempli
+        int x1;   // Dernier pixel rempli (inclus)
+    };
+
+    CoverageRaster(int width, int height)
+        : width_(width), height_(height), words_((width + 63) / 64),
+          bits_(static_cast<size_t>(words_) * height, 0) {}
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    bool empty() const {
+        for (uint64_t w : bits_) {
+            if (w) return false;
+        }
+        return true;
+    }
+
+    bool get(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width_ || y >= height_) return false;
+        return (bits_[static_cast<size_t>(y) * words_ + (x >> 6)] >> (x & 63)) & 1;
+    }
+
+    // ========== DÉCOUPAGE EN SPANS ==========
+    // Disque de centre (cx, cy) et de rayon r (pixels) : pixels dont le centre est dans le disque
+    static void diskSpans(double cx, double cy, double r, int width, int height, std::vector<Span>& out) {
+        int rowMin = std::max(0, static_cast<int>(std::ceil(cy - r - 0.5)));
+        int rowMax = std::min(height - 1, static_cast<int>(std::floor(cy + r - 0.5)));
+        for (int row = rowMin; row <= rowMax; ++row) {
+            double dy = row + 0.5 - cy;
+            double half = std::sqrt(std::max(0.0, r * r - dy * dy));
+            pushSpan(row, cx - half, cx + half, width, out);
+        }
+    }
+
+    // Polygone (anneaux extérieur et trous, pixels) : règle pair-impair sur les centres de pixels
+    static void polygonSpans(const Polygon2& poly, int width, int height, std::vector<Span>& out) {
+        double minY = 1e300, maxY = -1e300;
+        for (const auto& ring : poly.rings) {
+            for (const auto& p : ring) {
+                minY = std::min(minY, p.y);
+                maxY = std::max(maxY, p.y);
+            }
+        }
+        int rowMin = std::max(0, static_cast<int>(std::ceil(minY - 0.5)));
+        int rowMax = std::min(height - 1, static_cast<int>(std::floor(maxY - 0.5)));
+
+        std::vector<double> crossings;
+        for (int row = rowMin; row <= rowMax; ++row) {
+            double yc = row + 0.5;
+            crossings.clear();
+            for (const auto& ring : poly.rings) {
+                size_t n = ring.size();
+                for (size_t i = 0, j = n - 1; i < n; j = i++) {
+                    const auto& a = ring[i];
+                    const auto& b = ring[j];
+                    if ((a.y > yc) != (b.y > yc)) {
+                        crossings.push_back(a.x + (yc - a.y) * (b.x - a.x) / (b.y - a.y));
+                    }
+                }
+            }
+            std::sort(crossings.begin(), crossings.end());
+            for (size_t k = 0; k + 1 < crossings.size(); k += 2) {
+                pushSpan(row, crossings[k], crossings[k + 1], width, out);
+            }
+        }
+    }
+
+    // OU des spans dans le masque ; retourne true si au moins un pixel est couvert
+    bool fill(const std::vector<Span>& spans) {
+        for (const auto& s : spans) fillSpan(s.row, s.x0, s.x1);
+        return !spans.empty();
+    }
+
+    // ========== RÉDUCTION ET ASSEMBLAGE ==========
+    // Masque width x height dont chaque pixel est le OU des pixels source qu'il recouvre
+    // (couverture conservatrice : un pixel partiellement couvert l'est entièrement)
+    CoverageRaster downsample(int width, int height) const {
+        CoverageRaster out(width, height);
+        std::vector<uint64_t> row(words_);
+        for (int j = 0; j < height; ++j) {
+            int y0 = static_cast<int>(static_cast<int64_t>(j) * height_ / height);
+            int y1 = std::min(height_ - 1, static_cast<int>((static_cast<int64_t>(j + 1) * height_ + height - 1) / height) - 1);
+            std::fill(row.begin(), row.end(), 0);
+            for (int y = y0; y <= std::max(y0, y1); ++y) {
+                const uint64_t* line = &bits_[static_cast<size_t>(y) * words_];
+                for (int w = 0; w < words_; ++w) row[w] |= line[w];
+            }
+            for (int i = 0; i < width; ++i) {
+                int x0 = static_cast<int>(static_cast<int64_t>(i) * width_ / width);
+                int x1 = std::min(width_ - 1, static_cast<int>((static_cast<int64_t>(i + 1) * width_ + width - 1) / width) - 1);
+                if (anyBit(row.data(), x0, std::max(x0, x1))) out.fillSpan(j, i, i);
+            }
+        }
+        return out;
+    }
+
+    // Taille de packed() : un bit par pixel, lignes contiguës
+    static size_t packedSize(int width, int height) {
+        return (static_cast<size_t>(width) * height + 7) / 8;
+    }
+
+    // Bit k = y * width + x, octet k / 8, bit de poids k % 8
+    std::string packed() const {
+        std::string out(packedSize(width_, height_), '\0');
+        size_t k = 0;
+        for (int y = 0; y < height_; ++y) {
+            for (int x = 0; x < width_; ++x, ++k) {
+                if (get(x, y)) out[k >> 3] = static_cast<char>(out[k >> 3] | (1 << (k & 7)));
+            }
+        }
+        return out;
+    }
+
+    // OU d'un masque packed() de width x height pixels, coin haut-gauche en (x0, y0),
+    // borné à ce masque ; retourne false si bits est trop court
+    bool orPacked(int x0, int y0, int width, int height, const std::string& bits) {
+        if (bits.size() < packedSize(width, height)) return false;
+        auto bit = [&bits](size_t k) { return (static_cast<unsigned char>(bits[k >> 3]) >> (k & 7)) & 1; };
+        for (int y = 0; y < height; ++y) {
+            int row = y0 + y;
+            if (row < 0 || row >= height_) continue;
+            size_t base = static_cast<size_t>(y) * width;
+            for (int x = 0; x < width;) {
+                if (!bit(base + x)) { ++x; continue; }
+                int start = x;
+                while (x < width && bit(base + x)) ++x;
+                int a = std::max(0, x0 + start), b = std::min(width_ - 1, x0 + x - 1);
+                if (a <= b) fillSpan(row, a, b);
+            }
+        }
+        return true;
+    }
+
+    // ========== VECTORISATION (marching squares) ==========
+    // Échantillons = centres de pixels, hors masque = vide : les contours sont fermés.
+    // Sommets au milieu des arêtes entre échantillons ; le rempli est à gauche du sens
+    // de parcours (repère x, y pris tel quel), donc contour extérieur d'aire signée > 0
+    // et trou d'aire < 0. Cas selle : diagonales pleines séparées (connexité 4),
+    // chaque sommet n'appartient qu'à un anneau : polygones simples et disjoints.
+    std::vector<Polygon2> trace() const {
+        // Coordonnées doublées (entières) des milieux d'arêtes
+        const int64_t stride = 2 * static_cast<int64_t>(width_) + 4;
+        auto key = [stride](int64_t x2, int64_t y2) { return y2 * stride + x2; };
+
+        std::unordered_map<int64_t, int64_t> next;
+        auto link = [&](int64_t from, int64_t to) { next[from] = to; };
+
+        for (int cy = -1; cy < height_; ++cy) {
+            for (int cx = -1; cx < width_; ++cx) {
+                int code = (get(cx, cy) << 3) | (get(cx + 1, cy) << 2) |
+                           (get(cx + 1, cy + 1) << 1) | get(cx, cy + 1);
+                if (code == 0 || code == 15) continue;
+
+                int64_t T = key(2 * cx + 2, 2 * cy + 1);
+                int64_t B = key(2 * cx + 2, 2 * cy + 3);
+                int64_t L = key(2 * cx + 1, 2 * cy + 2);
+                int64_t R = key(2 * cx + 3, 2 * cy + 2);
+
+                switch (code) {
+                    case 1:  link(L, B); break;
+                    case 2:  link(B, R); break;
+                    case 3:  link(L, R); break;
+                    case 4:  link(R, T); break;
+                    case 5:  link(L, B); link(R, T); break;
+                    case 6:  link(B, T); break;
+                    case 7:  link(L, T); break;
+                    case 8:  link(T, L); break;
+                    case 9:  link(T, B); break;
+                    case 10: link(T, L); link(B, R); break;
+                    case 11: link(T, R); break;
+                    case 12: link(R, L); break;
+                    case 13: link(R, B); break;
+                    case 14: link(B, L); break;
+                }
+            }
+        }
+
+        // Chaînage des segments en anneaux fermés
+        std::vector<Ring> outers, holes;
+        std::vector<double> outerAreas;
+        while (!next.empty()) {
+            int64_t start = next.begin()->first;
+            Ring ring;
+            int64_t current = start;
+            while (true) {
+                auto it = next.find(current);
+                if (it == next.end()) break;
+                ring.push_back({static_cast<double>(current % stride) / 2.0,
+                                static_cast<double>(current / stride) / 2.0});
+                current = it->second;
+                next.erase(it);
+            }
+            if (ring.size() < 3) continue;
+            ring.push_back(ring.front());
+
+            double area = signedArea(ring);
+            if (area > 0) {
+                outers.push_back(std::move(ring));
+                outerAreas.push_back(area);
+            } else {
+                holes.push_back(std::move(ring));
+            }
+        }
+
+        std::vector<Polygon2> polygons(outers.size());
+        for (size_t i = 0; i < outers.size(); ++i) {
+            polygons[i].rings.push_back(std::move(outers[i]));
+        }
+
+        // Chaque trou va au plus petit contour extérieur qui le contient
+        for (auto& hole : holes) {
+            size_t best = polygons.size();
+            for (size_t i = 0; i < polygons.size(); ++i) {
+                if (best < polygons.size() && outerAreas[i] >= outerAreas[best]) continue;
+                if (Geometry::pointInRing(hole.front(), polygons[i].rings[0])) best = i;
+            }
+            if (best < polygons.size()) polygons[best].rings.push_back(std::move(hole));
+        }
+        return polygons;
+    }
+
+    /**
+     * Douglas-Peucker d'un anneau issu de trace(), sommets situés sur le cadre du
+     * masque conservés (seuls les sommets alignés le long d'un même côté sont retirés)
+     *
+     * Le cadre passe exactement entre deux pixels : deux masques contigus tracent leur
+     * frontière commune sur la même ligne, aux mêmes sommets. La conserver telle quelle
+     * garantit que des blocs / tuiles voisins se raccordent sans interstice ni chevauchement.
+     */
+    Ring simplifyTraced(const Ring& ring, double tolerance) const {
+        if (ring.size() < 4) return ring;
+        auto side = [this](const Point2& p) {
+            if (p.x <= 0) return 1;
+            if (p.x >= width_) return 2;
+            if (p.y <= 0) return 3;
+            if (p.y >= height_) return 4;
+            return 0;
+        };
+
+        const size_t n = ring.size() - 1;   // Anneau fermé : dernier point = premier
+        size_t first = n;
+        for (size_t i = 0; i < n; ++i) {
+            if (side(ring[i])) { first = i; break; }
+        }
+        if (first == n) return Geometry::simplifyRing(ring, tolerance);
+
+        // Tronçons intérieurs entre deux sommets du cadre : extrémités fixes
+        Ring kept;
+        std::vector<Point2> run = {ring[first]};
+        for (size_t k = 1; k <= n; ++k) {
+            const Point2& p = ring[(first + k) % n];
+            run.push_back(p);
+            if (!side(p)) continue;
+            auto simplified = Geometry::simplifyLine(run, tolerance);
+            kept.insert(kept.end(), simplified.begin(), simplified.end() - 1);
+            run.assign(1, p);
+        }
+
+        // Sommets du cadre intermédiaires sur un même côté : même ligne, retirés
+        Ring out;
+        const size_t m = kept.size();
+        for (size_t i = 0; i < m; ++i) {
+            int s = side(kept[i]);
+            if (s && side(kept[(i + m - 1) % m]) == s && side(kept[(i + 1) % m]) == s) continue;
+            out.push_back(kept[i]);
+        }
+        if (out.size() < 3) return ring;
+        out.push_back(out.front());
+        return out;
+    }
+
+    // Aire signée (formule du lacet) d'un anneau fermé
+    static double signedArea(const Ring& ring) {
+        double sum = 0;
+        for (size_t i = 1; i < ring.size(); ++i) {
+            sum += ring[i - 1].x * ring[i].y - ring[i].x * ring[i - 1].y;
+        }
+        return sum / 2.0;
+    }
+
+private:
+    // Au moins un bit à 1 dans [x0, x1] d'une ligne de mots
+    static bool anyBit(const uint64_t* line, int x0, int x1) {
+        int w0 = x0 >> 6, w1 = x1 >> 6;
+        uint64_t head = ~0ULL << (x0 & 63);
+        uint64_t tail = ~0ULL >> (63 - (x1 & 63));
+        if (w0 == w1) return line[w0] & head & tail;
+        if (line[w0] & head) return true;
+        for (int w = w0 + 1; w < w1; ++w) {
+            if (line[w]) return true;
+        }
+        return line[w1] & tail;
+    }
+
+    // Pixels dont le centre est dans [left, right], bornés à la tuile
+    static void pushSpan(int row, double left, double right, int width, std::vector<Span>& out) {
+        int x0 = std::max(0, static_cast<int>(std::ceil(left - 0.5)));
+        int x1 = std::min(width - 1, static_cast<int>(std::floor(right - 0.5)));
+        if (x0 <= x1) out.push_back({row, x0, x1});
+    }
+
+    // Mots partiels aux extrémités, mots pleins entre les deux (boucle vectorisable)
+    void fillSpan(int row, int x0, int x1) {
+        uint64_t* line = &bits_[static_cast<size_t>(row) * words_];
+        int w0 = x0 >> 6, w1 = x1 >> 6;
+        uint64_t head = ~0ULL << (x0 & 63);
+        uint64_t tail = ~0ULL >> (63 - (x1 & 63));
+        if (w0 == w1) {
+            line[w0] |= head & tail;
+            return;
+        }
+        line[w0] |= head;
+        for (int w = w0 + 1; w < w1; ++w) line[w] = ~0ULL;
+        line[w1] |= tail;
+    }
+
+    int width_;
+    int height_;
+    int words_;
+    std::vector<uint64_t> bits_;
+};
+
+// Web Mercator -> pixels d'une tuile XYZ (z, x, y) rastérisée sur size x size pixels
+struct TileProjection {
+    double scale;     // Taille du monde en pixels
+    double originX;
+    double originY;
+
+    TileProjection(int z, int x, int y, int size)
+        : scale(std::ldexp(static_cast<double>(size), z)),
+          originX(static_cast<double>(x) * size), originY(static_cast<double>(y) * size) {}
+
+    Point2 toPixel(double lon, double lat) const {
+        double c = std::max(-85.0511, std::min(85.0511, lat)) * GeoUtils::PI / 180.0;
+        return {(lon + 180.0) / 360.0 * scale - originX,
+                (1.0 - std::log(std::tan(c) + 1.0 / std::cos(c)) / GeoUtils::PI) / 2.0 * scale - originY};
+    }
+
+    Point2 toLonLat(const Point2& p) const {
+        double n = GeoUtils::PI * (1.0 - 2.0 * (p.y + originY) / scale);
+        return {(p.x + originX) / scale * 360.0 - 180.0, std::atan(std::sinh(n)) * 180.0 / GeoUtils::PI};
+    }
+
+    // Projection conforme : un cercle au sol reste un cercle, de rayon mis à l'échelle de sa latitude
+    double metersToPixels(double meters, double lat) const {
+        double cosLat = std::max(0.01, std::cos(lat * GeoUtils::PI / 180.0));
+        return meters * scale / (360.0 * GeoUtils::METERS_PER_DEGREE_LAT * cosLat);
+    }
+
+    // Côté au sol (mètres) d'un pixel de la ligne row
+    double pixelMeters(int row) const {
+        double lat = toLonLat({0, row + 0.5}).y;
+        return 360.0 * GeoUtils::METERS_PER_DEGREE_LAT * std::cos(lat * GeoUtils::PI / 180.0) / scale;
+    }
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef DENSITY_HISTOGRAM_H
+#define DENSITY_HISTOGRAM_H
+
+#include "KdTree.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Histogramme de densité multi-résolution des antennes
+//
+// Pour chaque taille de cellule (degrés), l'ensemble des cellules occupées est
+// indexé par un KD-tree. Le nombre de cellules occupées d'une bbox est exactement
+// le nombre de features que produirait un regroupement sur cette grille : on peut
+// donc choisir la grille la plus fine qui respecte un budget de features, pour un
+// coût borné par ce budget (comptage interrompu au-delà).
+class DensityHistogram {
+public:
+    DensityHistogram(const std::vector<std::pair<double, double>>& lonLat, const std::vector<double>& cellSizes)
+        : cellSizes_(cellSizes)
+    {
+        levels_.reserve(cellSizes.size());
+        for (double size : cellSizes) {
+            std::vector<std::pair<int64_t, int64_t>> cells;
+            cells.reserve(lonLat.size());
+            for (const auto& [lon, lat] : lonLat) {
+                cells.emplace_back(std::llround(lon / size), std::llround(lat / size));
+            }
+            std::sort(cells.begin(), cells.end());
+            cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+            std::vector<KdTree::Item> items;
+            items.reserve(cells.size());
+            for (size_t i = 0; i < cells.size(); ++i) {
+                items.push_back({cells[i].first * size, cells[i].second * size, static_cast<uint32_t>(i)});
+            }
+            levels_.emplace_back(std::move(items));
+        }
+    }
+
+    int levels() const { return static_cast<int>(levels_.size()); }
+    double cellSize(int level) const { return cellSizes_[level]; }
+    size_t cellCount(int level) const { return levels_[level].size(); }
+
+    // Cellules occupées dont l'emprise touche la bbox (comptées jusqu'à limit + 1)
+    size_t occupiedCells(int level, double minLon, double minLat, double maxLon, double maxLat, size_t limit) const {
+        double half = cellSizes_[level] / 2;
+        return levels_[level].count(minLon - half, minLat - half, maxLon + half, maxLat + half, limit);
+    }
+
+    // Niveau le plus fin (indices croissants = grilles plus fines) dont la bbox tient dans le budget ;
+    // le plus grossier si même celui-ci le dépasse
+    int finestWithin(double minLon, double minLat, double maxLon, double maxLat, size_t budget) const {
+        int chosen = 0;
+        for (int level = 0; level < levels(); ++level) {
+            if (occupiedCells(level, minLon, minLat, maxLon, maxLat, budget) > budget) break;
+            chosen = level;
+        }
+        return chosen;
+    }
+
+private:
+    std::vector<double> cellSizes_;
+    std::vector<KdTree> levels_;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef GEO_UTILS_H
+#define GEO_UTILS_H
+
+#include <cmath>
+
+// Utilitaires géodésiques pour les calculs en mémoire (SRID 4326)
+// Approximations sphériques suffisantes à l'échelle d'une cellule radio
+class GeoUtils {
+public:
+    static constexpr double EARTH_RADIUS_M = 6371008.8;
+    static constexpr double METERS_PER_DEGREE_LAT = 111320.0;
+    static constexpr double PI = 3.14159265358979323846;
+
+    static double toRadians(double deg) {
+        return deg * PI / 180.0;
+    }
+
+    static double toDegrees(double rad) {
+        return rad * 180.0 / PI;
+    }
+
+    // Distance orthodromique (formule de Haversine) en mètres
+    static double haversineMeters(double lat1, double lon1, double lat2, double lon2) {
+        double dLat = toRadians(lat2 - lat1);
+        double dLon = toRadians(lon2 - lon1);
+        double a = std::sin(dLat / 2) * std::sin(dLat / 2) +
+                   std::cos(toRadians(lat1)) * std::cos(toRadians(lat2)) *
+                   std::sin(dLon / 2) * std::sin(dLon / 2);
+        return 2 * EARTH_RADIUS_M * std::asin(std::sqrt(std::fmin(1.0, a)));
+    }
+
+    // Conversion d'une distance en mètres vers des degrés de latitude
+    static double metersToDegreesLat(double meters) {
+        return meters / METERS_PER_DEGREE_LAT;
+    }
+
+    // Conversion d'une distance en mètres vers des degrés de longitude à une latitude donnée
+    static double metersToDegreesLon(double meters, double atLatitude) {
+        double cosLat = std::cos(toRadians(atLatitude));
+        return meters / (METERS_PER_DEGREE_LAT * std::fmax(cosLat, 1e-6));
+    }
+
+    // Point atteint depuis (lat, lon) en suivant un azimut (degrés, 0 = nord) sur une distance en mètres
+    static void destinationPoint(double lat, double lon, double bearingDeg, double meters,
+                                 double& outLat, double& outLon) {
+        double delta = meters / EARTH_RADIUS_M;
+        double theta = toRadians(bearingDeg);
+        double phi1 = toRadians(lat);
+        double lambda1 = toRadians(lon);
+
+        double phi2 = std::asin(std::sin(phi1) * std::cos(delta) +
+                                std::cos(phi1) * std::sin(delta) * std::cos(theta));
+        double lambda2 = lambda1 + std::atan2(std::sin(theta) * std::sin(delta) * std::cos(phi1),
+                                              std::cos(delta) - std::sin(phi1) * std::sin(phi2));
+        outLat = toDegrees(phi2);
+        outLon = toDegrees(lambda2);
+    }
+};
+
+#endif
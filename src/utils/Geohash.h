@@ -0,0 +1,110 @@
+#ifndef GEOHASH_H
+#define GEOHASH_H
+
+#include "GeoUtils.h"
+#include <string>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// Encodage geohash (base 32) pour quantifier des positions en cellules
+//
+// Un préfixe de longueur p désigne une cellule contenant toutes les cellules
+// plus fines qui le prolongent : l'invalidation d'une zone se fait par préfixe.
+// Ordres de grandeur : p=5 ~4,9 x 4,9 km, p=6 ~1,2 x 0,6 km, p=7 ~153 x 153 m
+class Geohash {
+public:
+    static std::string encode(double lat, double lon, int precision) {
+        static const char BASE32[] = "0123456789bcdefghjkmnpqrstuvwxyz";
+        double latMin = -90.0, latMax = 90.0;
+        double lonMin = -180.0, lonMax = 180.0;
+        bool evenBit = true; // Les bits pairs codent la longitude
+        int bit = 0, ch = 0;
+
+        std::string hash;
+        hash.reserve(precision);
+        while (static_cast<int>(hash.size()) < precision) {
+            if (evenBit) {
+                double mid = (lonMin + lonMax) / 2;
+                if (lon >= mid) { ch = (ch << 1) | 1; lonMin = mid; }
+                else            { ch = ch << 1;       lonMax = mid; }
+            } else {
+                double mid = (latMin + latMax) / 2;
+                if (lat >= mid) { ch = (ch << 1) | 1; latMin = mid; }
+                else            { ch = ch << 1;       latMax = mid; }
+            }
+            evenBit = !evenBit;
+            if (++bit == 5) {
+                hash += BASE32[ch];
+                bit = 0;
+                ch = 0;
+            }
+        }
+        return hash;
+    }
+
+    // Centre de la cellule désignée par le hash
+    static void decodeCenter(const std::string& hash, double& lat, double& lon) {
+        static const std::string BASE32 = "0123456789bcdefghjkmnpqrstuvwxyz";
+        double latMin = -90.0, latMax = 90.0;
+        double lonMin = -180.0, lonMax = 180.0;
+        bool evenBit = true;
+
+        for (char c : hash) {
+            auto value = BASE32.find(c);
+            if (value == std::string::npos) break;
+            for (int b = 4; b >= 0; --b) {
+                int bitValue = (static_cast<int>(value) >> b) & 1;
+                if (evenBit) {
+                    double mid = (lonMin + lonMax) / 2;
+                    if (bitValue) lonMin = mid; else lonMax = mid;
+                } else {
+                    double mid = (latMin + latMax) / 2;
+                    if (bitValue) latMin = mid; else latMax = mid;
+                }
+                evenBit = !evenBit;
+            }
+        }
+        lat = (latMin + latMax) / 2;
+        lon = (lonMin + lonMax) / 2;
+    }
+
+    // Dimensions d'une cellule en degrés
+    static void cellSize(int precision, double& dLat, double& dLon) {
+        int bits = 5 * precision;
+        int lonBits = (bits + 1) / 2;
+        int latBits = bits / 2;
+        dLat = 180.0 / std::ldexp(1.0, latBits);
+        dLon = 360.0 / std::ldexp(1.0, lonBits);
+    }
+
+    // Cellules de précision `precision` intersectant le carré englobant le cercle (lat, lon, radius)
+    static std::vector<std::string> coveringCells(double lat, double lon, double radiusMeters, int precision) {
+        double dLat, dLon;
+        cellSize(precision, dLat, dLon);
+
+        double rLat = GeoUtils::metersToDegreesLat(radiusMeters);
+        double rLon = GeoUtils::metersToDegreesLon(radiusMeters, lat);
+        double minLat = std::max(-90.0, lat - rLat), maxLat = std::min(90.0, lat + rLat);
+        double minLon = std::max(-180.0, lon - rLon), maxLon = std::min(180.0, lon + rLon);
+
+        long iLat0 = static_cast<long>(std::floor((minLat + 90.0) / dLat));
+        long iLat1 = static_cast<long>(std::floor((maxLat + 90.0) / dLat));
+        long iLon0 = static_cast<long>(std::floor((minLon + 180.0) / dLon));
+        long iLon1 = static_cast<long>(std::floor((maxLon + 180.0) / dLon));
+
+        std::vector<std::string> cells;
+        for (long i = iLat0; i <= iLat1; ++i) {
+            double cLat = std::min(90.0 - dLat / 2, -90.0 + (i + 0.5) * dLat);
+            for (long j = iLon0; j <= iLon1; ++j) {
+                double cLon = std::min(180.0 - dLon / 2, -180.0 + (j + 0.5) * dLon);
+                cells.push_back(encode(cLat, cLon, precision));
+            }
+        }
+        std::sort(cells.begin(), cells.end());
+        cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+        return cells;
+    }
+};
+
+#endif
@@ -0,0 +1,494 @@
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include <json/json.h>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+
+// Géométrie plane minimale pour les calculs en mémoire
+//
+// Les coordonnées sont soit en degrés (x = lon, y = lat), soit en mètres
+// dans un repère local centré sur un point de référence (voir LocalFrame).
+struct Point2 {
+    double x;
+    double y;
+};
+
+using Ring = std::vector<Point2>;
+
+// Polygone : rings[0] = contour extérieur, rings[1..] = trous
+struct Polygon2 {
+    std::vector<Ring> rings;
+};
+
+// Géométrie GeoJSON aplatie : parties surfaciques + parties linéaires
+struct Shape {
+    std::vector<Polygon2> polygons;
+    std::vector<std::vector<Point2>> lines;
+    double minX = 0, minY = 0, maxX = 0, maxY = 0;
+
+    bool empty() const { return polygons.empty() && lines.empty(); }
+};
+
+// Projection équirectangulaire locale (précision suffisante sur quelques dizaines de km)
+class LocalFrame {
+public:
+    LocalFrame(double refLon, double refLat)
+        : refLon_(refLon), refLat_(refLat),
+          kx_(111320.0 * std::cos(refLat * 3.14159265358979323846 / 180.0)), ky_(111320.0) {}
+
+    Point2 toLocal(const Point2& lonLat) const {
+        return {(lonLat.x - refLon_) * kx_, (lonLat.y - refLat_) * ky_};
+    }
+
+    Point2 toLonLat(const Point2& local) const {
+        return {refLon_ + local.x / kx_, refLat_ + local.y / ky_};
+    }
+
+private:
+    double refLon_;
+    double refLat_;
+    double kx_;
+    double ky_;
+};
+
+class Geometry {
+public:
+    // ========== PARSING GEOJSON ==========
+    // Polygon, MultiPolygon, LineString, MultiLineString, GeometryCollection.
+    // Les points sont ignorés (aucune emprise). Retourne false si rien n'est exploitable.
+    static bool fromGeoJson(const Json::Value& geom, Shape& out) {
+        out = Shape();
+        appendGeoJson(geom, out);
+        if (out.empty()) return false;
+        computeBounds(out);
+        return true;
+    }
+
+    // ========== PARSING WKT ==========
+    // POLYGON et MULTIPOLYGON (sortie de ST_AsText) ; les autres types sont ignorés
+    static bool fromWkt(const std::string& wkt, Shape& out) {
+        out = Shape();
+        const char* p = wkt.c_str();
+        while (*p == ' ') ++p;
+        bool multi;
+        if (wkt.compare(p - wkt.c_str(), 12, "MULTIPOLYGON") == 0) {
+            multi = true;
+            p += 12;
+        } else if (wkt.compare(p - wkt.c_str(), 7, "POLYGON") == 0) {
+            multi = false;
+            p += 7;
+        } else {
+            return false;
+        }
+
+        auto skip = [&p]() { while (*p == ' ') ++p; };
+        // (x y, x y, ...) -> anneau ; p positionné après la parenthèse fermante
+        auto parseRingText = [&](Ring& ring) {
+            skip();
+            if (*p != '(') return false;
+            ++p;
+            while (true) {
+                char* end;
+                double x = std::strtod(p, &end);
+                if (end == p) return false;
+                p = end;
+                double y = std::strtod(p, &end);
+                if (end == p) return false;
+                p = end;
+                ring.push_back({x, y});
+                skip();
+                if (*p == ',') { ++p; continue; }
+                if (*p == ')') { ++p; return true; }
+                return false;
+            }
+        };
+        auto parsePolygonText = [&]() {
+            skip();
+            if (*p != '(') return false;
+            ++p;
+            Polygon2 poly;
+            while (true) {
+                Ring ring;
+                if (!parseRingText(ring)) return false;
+                if (ring.size() >= 4) poly.rings.push_back(std::move(ring));
+                skip();
+                if (*p == ',') { ++p; continue; }
+                if (*p == ')') { ++p; break; }
+                return false;
+            }
+            if (!poly.rings.empty()) out.polygons.push_back(std::move(poly));
+            return true;
+        };
+
+        skip();
+        if (multi) {
+            if (*p != '(') return false;
+            ++p;
+            while (true) {
+                if (!parsePolygonText()) return false;
+                skip();
+                if (*p == ',') { ++p; continue; }
+                if (*p == ')') break;
+                return false;
+            }
+        } else if (!parsePolygonText()) {
+            return false;
+        }
+        if (out.empty()) return false;
+        computeBounds(out);
+        return true;
+    }
+
+    // ========== PRÉDICATS ==========
+    // Test pair-impair (ray casting) sur un anneau
+    static bool pointInRing(const Point2& p, const Ring& ring) {
+        bool inside = false;
+        size_t n = ring.size();
+        for (size_t i = 0, j = n - 1; i < n; j = i++) {
+            const auto& a = ring[i];
+            const auto& b = ring[j];
+            if ((a.y > p.y) != (b.y > p.y) &&
+                p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x) {
+                inside = !inside;
+            }
+        }
+        return inside;
+    }
+
+    static bool pointInPolygon(const Point2& p, const Polygon2& poly) {
+        if (poly.rings.empty() || !pointInRing(p, poly.rings[0])) return false;
+        for (size_t i = 1; i < poly.rings.size(); ++i) {
+            if (pointInRing(p, poly.rings[i])) return false;
+        }
+        return true;
+    }
+
+    // Distance d'un point au segment [a, b]
+    static double distanceToSegment(const Point2& p, const Point2& a, const Point2& b) {
+        double dx = b.x - a.x, dy = b.y - a.y;
+        double len2 = dx * dx + dy * dy;
+        double t = len2 > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / len2 : 0.0;
+        t = std::max(0.0, std::min(1.0, t));
+        double px = a.x + t * dx - p.x, py = a.y + t * dy - p.y;
+        return std::sqrt(px * px + py * py);
+    }
+
+    // ========== SIMPLIFICATION (Douglas-Peucker) ==========
+    // Anneau fermé (premier point == dernier point) ; le résultat reste fermé
+    static Ring simplifyRing(const Ring& ring, double tolerance) {
+        if (ring.size() <= 4 || tolerance <= 0) return ring;
+
+        std::vector<bool> keep(ring.size(), false);
+        keep.front() = keep.back() = true;
+
+        // Un anneau fermé dégénère en segment nul : on coupe au point le plus éloigné du départ
+        size_t far = 0;
+        double farDist = -1;
+        for (size_t i = 1; i + 1 < ring.size(); ++i) {
+            double dx = ring[i].x - ring[0].x, dy = ring[i].y - ring[0].y;
+            double d = dx * dx + dy * dy;
+            if (d > farDist) { farDist = d; far = i; }
+        }
+        keep[far] = true;
+
+        std::vector<std::pair<size_t, size_t>> stack = {{0, far}, {far, ring.size() - 1}};
+        while (!stack.empty()) {
+            auto [first, last] = stack.back();
+            stack.pop_back();
+            double maxDist = 0;
+            size_t index = first;
+            for (size_t i = first + 1; i < last; ++i) {
+                double d = distanceToSegment(ring[i], ring[first], ring[last]);
+                if (d > maxDist) { maxDist = d; index = i; }
+            }
+            if (maxDist > tolerance) {
+                keep[index] = true;
+                stack.push_back({first, index});
+                stack.push_back({index, last});
+            }
+        }
+
+        Ring out;
+        for (size_t i = 0; i < ring.size(); ++i) {
+            if (keep[i]) out.push_back(ring[i]);
+        }
+        if (out.size() < 4) return ring; // Triangle minimum
+        return out;
+    }
+
+    // Ligne ouverte : extrémités conservées (arcs partagés simplifiés à l'identique)
+    static std::vector<Point2> simplifyLine(const std::vector<Point2>& line, double tolerance) {
+        if (line.size() <= 2 || tolerance <= 0) return line;
+
+        std::vector<bool> keep(line.size(), false);
+        keep.front() = keep.back() = true;
+
+        std::vector<std::pair<size_t, size_t>> stack = {{0, line.size() - 1}};
+        while (!stack.empty()) {
+            auto [first, last] = stack.back();
+            stack.pop_back();
+            double maxDist = 0;
+            size_t index = first;
+            for (size_t i = first + 1; i < last; ++i) {
+                double d = distanceToSegment(line[i], line[first], line[last]);
+                if (d > maxDist) { maxDist = d; index = i; }
+            }
+            if (maxDist > tolerance) {
+                keep[index] = true;
+                stack.push_back({first, index});
+                stack.push_back({index, last});
+            }
+        }
+
+        std::vector<Point2> out;
+        for (size_t i = 0; i < line.size(); ++i) {
+            if (keep[i]) out.push_back(line[i]);
+        }
+        return out;
+    }
+
+    // ========== DÉCOUPAGE PAR RECTANGLE (Sutherland-Hodgman) ==========
+    // Anneau fermé découpé par [minX, maxX] x [minY, maxY] ; vide s'il est hors du rectangle.
+    // Comme ST_ClipByBox2D, le résultat peut longer le bord du rectangle (arêtes
+    // dégénérées) : adapté à l'affichage, pas aux calculs topologiques.
+    static Ring clipRing(const Ring& ring, double minX, double minY, double maxX, double maxY) {
+        Ring current(ring.begin(), ring.end() - (ring.size() > 1 ? 1 : 0));
+        // Bords : 0 = gauche, 1 = droite, 2 = bas, 3 = haut
+        for (int edge = 0; edge < 4 && !current.empty(); ++edge) {
+            auto inside = [&](const Point2& p) {
+                switch (edge) {
+                    case 0: return p.x >= minX;
+                    case 1: return p.x <= maxX;
+                    case 2: return p.y >= minY;
+                    default: return p.y <= maxY;
+                }
+            };
+            auto cross = [&](const Point2& a, const Point2& b) {
+                double t;
+                switch (edge) {
+                    case 0: t = (minX - a.x) / (b.x - a.x); return Point2{minX, a.y + t * (b.y - a.y)};
+                    case 1: t = (maxX - a.x) / (b.x - a.x); return Point2{maxX, a.y + t * (b.y - a.y)};
+                    case 2: t = (minY - a.y) / (b.y - a.y); return Point2{a.x + t * (b.x - a.x), minY};
+                    default: t = (maxY - a.y) / (b.y - a.y); return Point2{a.x + t * (b.x - a.x), maxY};
+                }
+            };
+            Ring next;
+            next.reserve(current.size() + 4);
+            for (size_t i = 0; i < current.size(); ++i) {
+                const Point2& a = current[i];
+                const Point2& b = current[(i + 1) % current.size()];
+                bool inA = inside(a), inB = inside(b);
+                if (inA) next.push_back(a);
+                if (inA != inB) next.push_back(cross(a, b));
+            }
+            current = std::move(next);
+        }
+        if (current.size() < 3) return Ring();
+        current.push_back(current.front());
+        return current;
+    }
+
+    // Polygones découpés par le rectangle ; parties entièrement hors du rectangle retirées
+    static std::vector<Polygon2> clipPolygons(const std::vector<Polygon2>& polygons,
+                                              double minX, double minY, double maxX, double maxY) {
+        std::vector<Polygon2> out;
+        for (const auto& poly : polygons) {
+            if (poly.rings.empty()) continue;
+            Polygon2 clipped;
+            for (size_t r = 0; r < poly.rings.size(); ++r) {
+                Ring ring = clipRing(poly.rings[r], minX, minY, maxX, maxY);
+                if (ring.empty()) {
+                    if (r == 0) break;   // Contour extérieur hors du rectangle : polygone retiré
+                    continue;
+                }
+                clipped.rings.push_back(std::move(ring));
+            }
+            if (!clipped.rings.empty()) out.push_back(std::move(clipped));
+        }
+        return out;
+    }
+
+    // ========== SÉRIALISATION ==========
+    // POLYGON((lon lat, ...)) ; anneau en degrés, supposé fermé
+    static std::string ringToWkt(const Ring& ring) {
+        std::string wkt = "POLYGON((";
+        char buf[64];
+        for (size_t i = 0; i < ring.size(); ++i) {
+            int n = std::snprintf(buf, sizeof(buf), i == 0 ? "%.7f %.7f" : ",%.7f %.7f",
+                                  ring[i].x, ring[i].y);
+            wkt.append(buf, n);
+        }
+        wkt += "))";
+        return wkt;
+    }
+
+    // MULTIPOLYGON(((...),(trou)),((...))) ; anneaux en degrés, supposés fermés
+    static std::string polygonsToWkt(const std::vector<Polygon2>& polygons) {
+        std::string wkt = "MULTIPOLYGON(";
+        char buf[64];
+        for (size_t p = 0; p < polygons.size(); ++p) {
+            if (p > 0) wkt += ',';
+            wkt += '(';
+            const auto& rings = polygons[p].rings;
+            for (size_t r = 0; r < rings.size(); ++r) {
+                wkt += r == 0 ? "(" : ",(";
+                for (size_t i = 0; i < rings[r].size(); ++i) {
+                    int n = std::snprintf(buf, sizeof(buf), i == 0 ? "%.7f %.7f" : ",%.7f %.7f",
+                                          rings[r][i].x, rings[r][i].y);
+                    wkt.append(buf, n);
+                }
+                wkt += ')';
+            }
+            wkt += ')';
+        }
+        wkt += ')';
+        return wkt;
+    }
+
+    // {"type":"MultiPolygon","coordinates":[...]} ; anneaux en degrés, supposés fermés
+    static std::string polygonsToGeoJson(const std::vector<Polygon2>& polygons) {
+        std::string json = R"({"type":"MultiPolygon","coordinates":[)";
+        char buf[64];
+        for (size_t p = 0; p < polygons.size(); ++p) {
+            if (p > 0) json += ',';
+            json += '[';
+            const auto& rings = polygons[p].rings;
+            for (size_t r = 0; r < rings.size(); ++r) {
+                json += r == 0 ? "[" : ",[";
+                for (size_t i = 0; i < rings[r].size(); ++i) {
+                    int n = std::snprintf(buf, sizeof(buf), i == 0 ? "[%.7f,%.7f]" : ",[%.7f,%.7f]",
+                                          rings[r][i].x, rings[r][i].y);
+                    json.append(buf, n);
+                }
+                json += ']';
+            }
+            json += ']';
+        }
+        json += "]}";
+        return json;
+    }
+
+private:
+    static Ring parseRing(const Json::Value& coords) {
+        Ring ring;
+        ring.reserve(coords.size());
+        for (const auto& c : coords) {
+            if (c.isArray() && c.size() >= 2) {
+                ring.push_back({c[0].asDouble(), c[1].asDouble()});
+            }
+        }
+        return ring;
+    }
+
+    static void appendPolygon(const Json::Value& coords, Shape& out) {
+        Polygon2 poly;
+        for (const auto& r : coords) {
+            Ring ring = parseRing(r);
+            if (ring.size() >= 4) poly.rings.push_back(std::move(ring));
+        }
+        if (!poly.rings.empty()) out.polygons.push_back(std::move(poly));
+    }
+
+    static void appendGeoJson(const Json::Value& geom, Shape& out) {
+        if (!geom.isObject()) return;
+        std::string type = geom.get("type", "").asString();
+        const Json::Value& coords = geom["coordinates"];
+
+        if (type == "Polygon") {
+            appendPolygon(coords, out);
+        } else if (type == "MultiPolygon") {
+            for (const auto& p : coords) appendPolygon(p, out);
+        } else if (type == "LineString") {
+            auto line = parseRing(coords);
+            if (line.size() >= 2) out.lines.push_back(std::move(line));
+        } else if (type == "MultiLineString") {
+            for (const auto& l : coords) {
+                auto line = parseRing(l);
+                if (line.size() >= 2) out.lines.push_back(std::move(line));
+            }
+        } else if (type == "GeometryCollection") {
+            for (const auto& g : geom["geometries"]) appendGeoJson(g, out);
+        }
+    }
+
+    static void computeBounds(Shape& s) {
+        bool first = true;
+        auto extend = [&](const Point2& p) {
+            if (first) {
+                s.minX = s.maxX = p.x;
+                s.minY = s.maxY = p.y;
+                first = false;
+                return;
+            }
+            s.minX = std::min(s.minX, p.x);
+            s.maxX = std::max(s.maxX, p.x);
+            s.minY = std::min(s.minY, p.y);
+            s.maxY = std::max(s.maxY, p.y);
+        };
+        for (const auto& poly : s.polygons)
+            for (const auto& ring : poly.rings)
+                for (const auto& p : ring) extend(p);
+        for (const auto& line : s.lines)
+            for (const auto& p : line) extend(p);
+    }
+};
+
+// Index d'emprises sur grille uniforme (degrés)
+//
+// Chaque élément est référencé dans toutes les cellules couvertes par son
+// emprise ; une requête rectangle ne parcourt que les cellules concernées.
+class BoxIndex {
+public:
+    explicit BoxIndex(double cellSizeDegrees) : cell_(cellSizeDegrees) {}
+
+    void insert(size_t index, double minX, double minY, double maxX, double maxY) {
+        for (int x = cellOf(minX); x <= cellOf(maxX); ++x) {
+            for (int y = cellOf(minY); y <= cellOf(maxY); ++y) {
+                cells_[key(x, y)].push_back(index);
+            }
+        }
+    }
+
+    // Indices dont une cellule intersecte le rectangle, triés et sans doublon
+    // (emprises non re-testées). Coût proportionnel aux références parcourues,
+    // pas à la taille de l'index ; sans état mutable : appelable depuis plusieurs threads
+    std::vector<size_t> query(double minX, double minY, double maxX, double maxY) const {
+        std::vector<size_t> out;
+        for (int x = cellOf(minX); x <= cellOf(maxX); ++x) {
+            for (int y = cellOf(minY); y <= cellOf(maxY); ++y) {
+                auto it = cells_.find(key(x, y));
+                if (it == cells_.end()) continue;
+                out.insert(out.end(), it->second.begin(), it->second.end());
+            }
+        }
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+        return out;
+    }
+
+    // Indices référencés par la cellule du point (une seule cellule : ni doublon ni allocation)
+    const std::vector<size_t>& at(double x, double y) const {
+        static const std::vector<size_t> none;
+        auto it = cells_.find(key(cellOf(x), cellOf(y)));
+        return it == cells_.end() ? none : it->second;
+    }
+
+private:
+    int cellOf(double v) const { return static_cast<int>(std::floor(v / cell_)); }
+
+    static int64_t key(int x, int y) {
+        return (static_cast<int64_t>(x) << 32) ^ static_cast<uint32_t>(y);
+    }
+
+    double cell_;
+    std::unordered_map<int64_t, std::vector<size_t>> cells_;
+};
+
+#endif
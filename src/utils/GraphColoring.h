@@ -0,0 +1,176 @@
+#ifndef GRAPH_COLORING_H
+#define GRAPH_COLORING_H
+
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Graphe non orienté au format CSR (Compressed Sparse Row)
+// Les voisins du sommet v sont adjacency[offsets[v] .. offsets[v+1])
+struct CsrGraph {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> adjacency;
+
+    size_t vertexCount() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    uint32_t degree(uint32_t v) const { return offsets[v + 1] - offsets[v]; }
+
+    // Construction à partir d'une liste d'arêtes (u, v) sans doublons
+    static CsrGraph fromEdges(size_t vertexCount, const std::vector<std::pair<uint32_t, uint32_t>>& edges) {
+        CsrGraph g;
+        g.offsets.assign(vertexCount + 1, 0);
+        for (const auto& e : edges) {
+            g.offsets[e.first + 1]++;
+            g.offsets[e.second + 1]++;
+        }
+        for (size_t v = 0; v < vertexCount; ++v) {
+            g.offsets[v + 1] += g.offsets[v];
+        }
+        g.adjacency.resize(g.offsets[vertexCount]);
+        std::vector<uint32_t> cursor(g.offsets.begin(), g.offsets.end() - 1);
+        for (const auto& e : edges) {
+            g.adjacency[cursor[e.first]++] = e.second;
+            g.adjacency[cursor[e.second]++] = e.first;
+        }
+        return g;
+    }
+};
+
+// Coloration de graphe parallèle spéculative (Gebremedhin-Manne)
+//
+// Chaque tour : 1) coloration provisoire en parallèle de la liste de travail
+// (lectures concurrentes des couleurs voisines), 2) détection des conflits en
+// parallèle, 3) seuls les sommets en conflit repartent au tour suivant.
+// Les sommets "fixés" (déjà colorés lors d'un plan précédent) ne changent jamais,
+// ce qui permet une recoloration incrémentale des seuls sommets ajoutés.
+class GraphColoring {
+public:
+    static constexpr int32_t UNCOLORED = -1;
+
+    struct Stats {
+        int rounds = 0;
+        size_t recolored = 0;          // Sommets colorés par cet appel
+        size_t residualConflicts = 0;  // Sommets sans couleur libre dans leur palette
+        int32_t maxColor = -1;
+    };
+
+    /**
+     * @param graph - Graphe CSR
+     * @param colors - Couleurs en entrée/sortie (UNCOLORED pour les sommets à colorer)
+     * @param paletteSize - Nombre de couleurs disponibles par sommet (ex: 504 PCI en LTE)
+     * @param fixed - true si la couleur du sommet ne doit pas être modifiée
+     */
+    static Stats colorSpeculative(const CsrGraph& graph,
+                                  std::vector<int32_t>& colors,
+                                  const std::vector<int32_t>& paletteSize,
+                                  const std::vector<bool>& fixed) {
+        Stats stats;
+        size_t n = graph.vertexCount();
+        std::vector<std::atomic<int32_t>> shared(n);
+        for (size_t v = 0; v < n; ++v) {
+            shared[v].store(colors[v], std::memory_order_relaxed);
+        }
+
+        // Liste de travail initiale : sommets non fixés, plus fort degré en premier
+        std::vector<uint32_t> worklist;
+        for (uint32_t v = 0; v < n; ++v) {
+            if (!fixed[v]) worklist.push_back(v);
+        }
+        std::stable_sort(worklist.begin(), worklist.end(), [&graph](uint32_t a, uint32_t b) {
+            return graph.degree(a) > graph.degree(b);
+        });
+        stats.recolored = worklist.size();
+
+        // Sommets saturés (aucune couleur libre) : couleur la moins conflictuelle, sortis de la boucle
+        std::vector<uint8_t> saturated(n, 0);
+        std::atomic<size_t> saturatedCount{0};
+
+        while (!worklist.empty()) {
+            stats.rounds++;
+
+            // Phase 1 : coloration provisoire
+            Parallel::forRange(worklist.size(), [&](size_t begin, size_t end) {
+                std::vector<uint32_t> stamp;
+                std::vector<uint32_t> usage;
+                uint32_t mark = 0;
+                for (size_t k = begin; k < end; ++k) {
+                    uint32_t v = worklist[k];
+                    size_t palette = static_cast<size_t>(std::max<int32_t>(paletteSize[v], 1));
+                    if (stamp.size() < palette) {
+                        stamp.assign(palette, 0);
+                        usage.assign(palette, 0);
+                        mark = 0;
+                    }
+                    ++mark;
+                    for (uint32_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+                        int32_t c = shared[graph.adjacency[e]].load(std::memory_order_relaxed);
+                        if (c >= 0 && static_cast<size_t>(c) < palette) {
+                            if (stamp[c] != mark) {
+                                stamp[c] = mark;
+                                usage[c] = 0;
+                            }
+                            usage[c]++;
+                        }
+                    }
+
+                    int32_t chosen = UNCOLORED;
+                    for (size_t c = 0; c < palette; ++c) {
+                        if (stamp[c] != mark) {
+                            chosen = static_cast<int32_t>(c);
+                            break;
+                        }
+                    }
+                    if (chosen == UNCOLORED) {
+                        // Palette épuisée : couleur la moins utilisée par les voisins
+                        uint32_t best = UINT32_MAX;
+                        for (size_t c = 0; c < palette; ++c) {
+                            if (usage[c] < best) {
+                                best = usage[c];
+                                chosen = static_cast<int32_t>(c);
+                            }
+                        }
+                        saturated[v] = 1;
+                        saturatedCount++;
+                    }
+                    shared[v].store(chosen, std::memory_order_relaxed);
+                }
+            });
+
+            // Phase 2 : détection des conflits (le plus petit indice garde sa couleur)
+            std::vector<uint32_t> next;
+            std::mutex nextMutex;
+            Parallel::forRange(worklist.size(), [&](size_t begin, size_t end) {
+                std::vector<uint32_t> local;
+                for (size_t k = begin; k < end; ++k) {
+                    uint32_t v = worklist[k];
+                    if (saturated[v]) continue;
+                    int32_t cv = shared[v].load(std::memory_order_relaxed);
+                    for (uint32_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+                        uint32_t u = graph.adjacency[e];
+                        if (shared[u].load(std::memory_order_relaxed) != cv) continue;
+                        if (fixed[u] || saturated[u] || u < v) {
+                            local.push_back(v);
+                            break;
+                        }
+                    }
+                }
+                std::lock_guard<std::mutex> lock(nextMutex);
+                next.insert(next.end(), local.begin(), local.end());
+            });
+
+            worklist.swap(next);
+        }
+
+        stats.residualConflicts = saturatedCount.load();
+        for (size_t v = 0; v < n; ++v) {
+            colors[v] = shared[v].load(std::memory_order_relaxed);
+            stats.maxColor = std::max(stats.maxColor, colors[v]);
+        }
+        return stats;
+    }
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef KD_TREE_H
+#define KD_TREE_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+// KD-tree statique 2D (construit une fois, interrogé en lecture seule)
+//
+// Les points sont triés en place par médianes successives (axe alterné) :
+// pas de nœuds alloués, l'arbre est implicite dans le tableau. Les feuilles
+// de moins de NODE_SIZE points sont parcourues linéairement.
+// Lecture concurrente sans verrou une fois construit.
+class KdTree {
+public:
+    struct Item {
+        double x;
+        double y;
+        uint32_t id;  // Position de l'élément dans le vecteur source
+    };
+
+    KdTree() = default;
+
+    explicit KdTree(std::vector<Item> items) : items_(std::move(items)) {
+        if (!items_.empty()) sortRange(0, items_.size() - 1, 0);
+    }
+
+    size_t size() const { return items_.size(); }
+
+    // Visite les éléments contenus dans le rectangle [minX, maxX] x [minY, maxY]
+    template <typename Visit>
+    void range(double minX, double minY, double maxX, double maxY, Visit&& visit) const {
+        rangeItems(minX, minY, maxX, maxY, [&](const Item& it) { visit(it.id); return true; });
+    }
+
+    // Nombre d'éléments du rectangle, parcours interrompu au-delà de limit (résultat <= limit + 1)
+    size_t count(double minX, double minY, double maxX, double maxY, size_t limit) const {
+        size_t n = 0;
+        rangeItems(minX, minY, maxX, maxY, [&](const Item&) { return ++n <= limit; });
+        return n;
+    }
+
+    // Visite les éléments à distance euclidienne <= r de (x, y)
+    template <typename Visit>
+    void within(double x, double y, double r, Visit&& visit) const {
+        double r2 = r * r;
+        rangeItems(x - r, y - r, x + r, y + r, [&](const Item& it) {
+            double dx = it.x - x, dy = it.y - y;
+            if (dx * dx + dy * dy <= r2) visit(it.id);
+            return true;
+        });
+    }
+
+private:
+    static constexpr size_t NODE_SIZE = 64;
+
+    // visit retourne false pour interrompre le parcours
+    template <typename Visit>
+    void rangeItems(double minX, double minY, double maxX, double maxY, Visit&& visit) const {
+        if (items_.empty()) return;
+        struct Frame { size_t left, right; int axis; };
+        std::vector<Frame> stack = {{0, items_.size() - 1, 0}};
+
+        while (!stack.empty()) {
+            Frame f = stack.back();
+            stack.pop_back();
+
+            if (f.right - f.left <= NODE_SIZE) {
+                for (size_t i = f.left; i <= f.right; ++i) {
+                    const auto& it = items_[i];
+                    if (it.x >= minX && it.x <= maxX && it.y >= minY && it.y <= maxY && !visit(it)) return;
+                }
+                continue;
+            }
+
+            size_t m = (f.left + f.right) >> 1;
+            const auto& it = items_[m];
+            if (it.x >= minX && it.x <= maxX && it.y >= minY && it.y <= maxY && !visit(it)) return;
+
+            double v = f.axis == 0 ? it.x : it.y;
+            double lo = f.axis == 0 ? minX : minY;
+            double hi = f.axis == 0 ? maxX : maxY;
+            if (lo <= v && m > f.left) stack.push_back({f.left, m - 1, 1 - f.axis});
+            if (hi >= v) stack.push_back({m + 1, f.right, 1 - f.axis});
+        }
+    }
+
+    void sortRange(size_t left, size_t right, int axis) {
+        if (right - left > NODE_SIZE) {
+            size_t m = (left + right) >> 1;
+            std::nth_element(items_.begin() + left, items_.begin() + m, items_.begin() + right + 1,
+                [axis](const Item& a, const Item& b) { return axis == 0 ? a.x < b.x : a.y < b.y; });
+            if (m > left) sortRange(left, m - 1, 1 - axis);
+            sortRange(m + 1, right, 1 - axis);
+        }
+    }
+
+    std::vector<Item> items_;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef LEAF_COUNTS_H
+#define LEAF_COUNTS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Comptes par statut / technologie / opérateur des feuilles d'une pyramide de
+// clusters, en sommes préfixes
+//
+// Les feuilles d'un nœud occupant une plage contiguë de l'ordre de la pyramide
+// (ClusterPyramid::leaf), sa répartition est une différence de deux lignes :
+// O(nombre de modalités) par nœud au lieu d'un parcours de ses feuilles.
+struct LeafCounts {
+    // Répartition d'une plage de feuilles (modalités présentes uniquement, triées)
+    struct Breakdown {
+        std::vector<std::pair<std::string, uint32_t>> status;
+        std::vector<std::pair<std::string, uint32_t>> technology;
+        std::vector<std::pair<int, uint32_t>> op;
+    };
+
+    std::vector<std::string> statuses;
+    std::vector<std::string> technologies;
+    std::vector<int> operators;
+    size_t width = 0;                   // statuses + technologies + operators
+    std::vector<uint32_t> prefix;       // (feuilles + 1) x width, ligne k = feuilles [0, k)
+
+    // leafAt(k) : élément de la k-ième feuille (membres status, technology, operator_id)
+    template <typename LeafAt>
+    LeafCounts(uint32_t leafCount, LeafAt&& leafAt) {
+        std::map<std::string, size_t> statusIndex, techIndex;
+        std::map<int, size_t> opIndex;
+        for (uint32_t k = 0; k < leafCount; ++k) {
+            const auto& a = leafAt(k);
+            statusIndex.emplace(a.status, 0);
+            techIndex.emplace(a.technology, 0);
+            opIndex.emplace(a.operator_id, 0);
+        }
+        for (auto& [key, i] : statusIndex) { i = width++; statuses.push_back(key); }
+        for (auto& [key, i] : techIndex) { i = width++; technologies.push_back(key); }
+        for (auto& [key, i] : opIndex) { i = width++; operators.push_back(key); }
+
+        prefix.assign((static_cast<size_t>(leafCount) + 1) * width, 0);
+        for (uint32_t k = 0; k < leafCount; ++k) {
+            const auto& a = leafAt(k);
+            const uint32_t* row = &prefix[k * width];
+            uint32_t* next = &prefix[(k + 1) * width];
+            std::copy(row, row + width, next);
+            next[statusIndex[a.status]]++;
+            next[techIndex[a.technology]]++;
+            next[opIndex[a.operator_id]]++;
+        }
+    }
+
+    // Répartition des feuilles [begin, end)
+    Breakdown range(uint32_t begin, uint32_t end) const {
+        Breakdown b;
+        const uint32_t* first = &prefix[static_cast<size_t>(begin) * width];
+        const uint32_t* last = &prefix[static_cast<size_t>(end) * width];
+        size_t c = 0;
+        for (const auto& key : statuses) {
+            if (uint32_t n = last[c] - first[c]) b.status.emplace_back(key, n);
+            ++c;
+        }
+        for (const auto& key : technologies) {
+            if (uint32_t n = last[c] - first[c]) b.technology.emplace_back(key, n);
+            ++c;
+        }
+        for (int key : operators) {
+            if (uint32_t n = last[c] - first[c]) b.op.emplace_back(key, n);
+            ++c;
+        }
+        return b;
+    }
+};
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef MVT_ENCODER_H
+#define MVT_ENCODER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Encodeur Mapbox Vector Tile 2.1 (protobuf écrit à la main, sans libprotobuf)
+//
+// Seuls les messages nécessaires sont produits :
+//   Tile    { repeated Layer layers = 3; }
+//   Layer   { version = 15; name = 1; features = 2; keys = 3; values = 4; extent = 5; }
+//   Feature { id = 1; tags = 2 (packed); type = 3; geometry = 4 (packed); }
+//   Value   { string = 1; double = 3; int64 = 4; bool = 7; }
+class MvtEncoder {
+public:
+    using Value = std::variant<std::string, double, int64_t, bool>;
+    using Properties = std::vector<std::pair<std::string, Value>>;
+
+    // Couche d'une tuile : clés et valeurs dédupliquées, coordonnées en unités de tuile
+    class Layer {
+    public:
+        explicit Layer(std::string name, uint32_t extent = 4096)
+            : name_(std::move(name)), extent_(extent) {}
+
+        uint32_t extent() const { return extent_; }
+        size_t featureCount() const { return featureCount_; }
+
+        // Point en coordonnées tuile (0..extent, hors tuile autorisé dans le buffer)
+        // id = 0 : feature sans identifiant
+        void addPoint(uint64_t id, int32_t x, int32_t y, const Properties& properties) {
+            std::string tags;
+            for (const auto& [key, value] : properties) {
+                writeVarint(tags, keyIndex(key));
+                writeVarint(tags, valueIndex(value));
+            }
+
+            std::string geometry;
+            writeVarint(geometry, command(MOVE_TO, 1));
+            writeVarint(geometry, zigzag(x));
+            writeVarint(geometry, zigzag(y));
+
+            std::string feature;
+            if (id != 0) {
+                writeTag(feature, 1, WIRE_VARINT);
+                writeVarint(feature, id);
+            }
+            writeBytes(feature, 2, tags);
+            writeTag(feature, 3, WIRE_VARINT);
+            writeVarint(feature, GEOM_POINT);
+            writeBytes(feature, 4, geometry);
+
+            writeBytes(features_, 2, feature);
+            featureCount_++;
+        }
+
+        // Message Layer sérialisé
+        std::string encode() const {
+            std::string out;
+            writeTag(out, 15, WIRE_VARINT);
+            writeVarint(out, 2);
+            writeBytes(out, 1, name_);
+            out += features_;
+            for (const auto& k : keys_) writeBytes(out, 3, k);
+            for (const auto& v : values_) writeBytes(out, 4, v);
+            writeTag(out, 5, WIRE_VARINT);
+            writeVarint(out, extent_);
+            return out;
+        }
+
+    private:
+        uint32_t keyIndex(const std::string& key) {
+            auto it = keyIndex_.find(key);
+            if (it != keyIndex_.end()) return it->second;
+            uint32_t idx = static_cast<uint32_t>(keys_.size());
+            keys_.push_back(key);
+            keyIndex_.emplace(key, idx);
+            return idx;
+        }
+
+        // Les valeurs sont dédupliquées sur leur encodage protobuf
+        uint32_t valueIndex(const Value& value) {
+            std::string encoded = encodeValue(value);
+            auto it = valueIndex_.find(encoded);
+            if (it != valueIndex_.end()) return it->second;
+            uint32_t idx = static_cast<uint32_t>(values_.size());
+            values_.push_back(encoded);
+            valueIndex_.emplace(std::move(encoded), idx);
+            return idx;
+        }
+
+        static std::string encodeValue(const Value& value) {
+            std::string out;
+            if (auto s = std::get_if<std::string>(&value)) {
+                writeBytes(out, 1, *s);
+            } else if (auto d = std::get_if<double>(&value)) {
+                writeTag(out, 3, WIRE_FIXED64);
+                uint64_t bits;
+                std::memcpy(&bits, d, sizeof(bits));
+                for (int i = 0; i < 8; ++i) out += static_cast<char>((bits >> (8 * i)) & 0xFF);
+            } else if (auto n = std::get_if<int64_t>(&value)) {
+                writeTag(out, 4, WIRE_VARINT);
+                writeVarint(out, static_cast<uint64_t>(*n));
+            } else if (auto b = std::get_if<bool>(&value)) {
+                writeTag(out, 7, WIRE_VARINT);
+                writeVarint(out, *b ? 1 : 0);
+            }
+            return out;
+        }
+
+        std::string name_;
+        uint32_t extent_;
+        size_t featureCount_ = 0;
+        std::string features_;
+        std::vector<std::string> keys_;
+        std::vector<std::string> values_;
+        std::unordered_map<std::string, uint32_t> keyIndex_;
+        std::unordered_map<std::string, uint32_t> valueIndex_;
+    };
+
+    // Message Tile : concaténation des couches non vides
+    static std::string encodeTile(const std::vector<Layer>& layers) {
+        std::string out;
+        for (const auto& layer : layers) {
+            if (layer.featureCount() == 0) continue;
+            writeBytes(out, 3, layer.encode());
+        }
+        return out;
+    }
+
+private:
+    static constexpr uint32_t WIRE_VARINT = 0;
+    static constexpr uint32_t WIRE_FIXED64 = 1;
+    static constexpr uint32_t WIRE_BYTES = 2;
+    static constexpr uint32_t GEOM_POINT = 1;
+    static constexpr uint32_t MOVE_TO = 1;
+
+    static void writeVarint(std::string& out, uint64_t v) {
+        while (v >= 0x80) {
+            out += static_cast<char>((v & 0x7F) | 0x80);
+            v >>= 7;
+        }
+        out += static_cast<char>(v);
+    }
+
+    static void writeTag(std::string& out, uint32_t field, uint32_t wireType) {
+        writeVarint(out, (field << 3) | wireType);
+    }
+
+    static void writeBytes(std::string& out, uint32_t field, const std::string& bytes) {
+        writeTag(out, field, WIRE_BYTES);
+        writeVarint(out, bytes.size());
+        out += bytes;
+    }
+
+    static uint32_t command(uint32_t id, uint32_t count) {
+        return (id & 0x7) | (count << 3);
+    }
+
+    static uint32_t zigzag(int32_t v) {
+        return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+    }
+};
+
+#endif
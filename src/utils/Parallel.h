@@ -0,0 +1,52 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <trantor/utils/ConcurrentTaskQueue.h>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// Outils de calcul parallèle pour les traitements batch (hors boucles I/O Drogon)
+class Parallel {
+public:
+    // Nombre de threads utilisés pour les boucles parallèles
+    static size_t workerCount() {
+        unsigned hw = std::thread::hardware_concurrency();
+        return hw == 0 ? 2 : hw;
+    }
+
+    // Découpe [0, count) en plages contiguës traitées chacune par un thread
+    static void forRange(size_t count, const std::function<void(size_t begin, size_t end)>& body) {
+        if (count == 0) return;
+        size_t threads = std::min(workerCount(), count);
+        if (threads <= 1) {
+            body(0, count);
+            return;
+        }
+
+        size_t chunk = (count + threads - 1) / threads;
+        std::vector<std::thread> pool;
+        pool.reserve(threads);
+        for (size_t t = 0; t < threads; ++t) {
+            size_t begin = t * chunk;
+            size_t end = std::min(count, begin + chunk);
+            if (begin >= end) break;
+            pool.emplace_back([&body, begin, end]() { body(begin, end); });
+        }
+        for (auto& th : pool) th.join();
+    }
+
+    // File de tâches partagée pour les jobs longs (reconstruction d'index, batchs)
+    // Évite de bloquer les threads I/O de Drogon pendant les calculs CPU
+    static trantor::ConcurrentTaskQueue& backgroundQueue() {
+        static trantor::ConcurrentTaskQueue queue(2, "background_jobs");
+        return queue;
+    }
+
+    static void runInBackground(std::function<void()> task) {
+        backgroundQueue().runTaskInQueue(std::move(task));
+    }
+};
+
+#endif
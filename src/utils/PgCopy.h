@@ -0,0 +1,93 @@
+#ifndef PG_COPY_H
+#define PG_COPY_H
+
+#include <libpq-fe.h>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+// Chargement en masse via COPY ... FROM STDIN (libpq)
+//
+// Le DbClient Drogon ne sait pas piloter le protocole COPY : les jobs batch
+// ouvrent une connexion dédiée avec la même chaîne de connexion que le pool.
+// À utiliser uniquement depuis un thread de travail (appels bloquants).
+class PgCopy {
+public:
+    explicit PgCopy(const std::string& connInfo) : conn_(PQconnectdb(connInfo.c_str())) {
+        if (PQstatus(conn_) != CONNECTION_OK) {
+            std::string err = PQerrorMessage(conn_);
+            PQfinish(conn_);
+            conn_ = nullptr;
+            throw std::runtime_error("COPY connection failed: " + err);
+        }
+    }
+
+    ~PgCopy() {
+        if (conn_) PQfinish(conn_);
+    }
+
+    PgCopy(const PgCopy&) = delete;
+    PgCopy& operator=(const PgCopy&) = delete;
+
+    // Exécute une commande simple (BEGIN, DELETE, COMMIT...)
+    void exec(const std::string& sql) {
+        PGresult* res = PQexec(conn_, sql.c_str());
+        ExecStatusType status = PQresultStatus(res);
+        PQclear(res);
+        if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
+            throw std::runtime_error(PQerrorMessage(conn_));
+        }
+    }
+
+    // Démarre un COPY <table> (<colonnes>) FROM STDIN (format texte, séparateur tabulation)
+    void begin(const std::string& copySql) {
+        PGresult* res = PQexec(conn_, copySql.c_str());
+        ExecStatusType status = PQresultStatus(res);
+        PQclear(res);
+        if (status != PGRES_COPY_IN) {
+            throw std::runtime_error(PQerrorMessage(conn_));
+        }
+    }
+
+    // Ajoute une ligne déjà formatée (colonnes séparées par '\t', terminée par '\n')
+    void putLine(const std::string& line) {
+        buffer_ += line;
+        if (buffer_.size() >= FLUSH_THRESHOLD) flush();
+    }
+
+    // Termine le COPY et retourne le nombre de lignes chargées
+    long end() {
+        flush();
+        if (PQputCopyEnd(conn_, nullptr) != 1) {
+            throw std::runtime_error(PQerrorMessage(conn_));
+        }
+        long rows = 0;
+        PGresult* res;
+        while ((res = PQgetResult(conn_)) != nullptr) {
+            if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+                std::string err = PQerrorMessage(conn_);
+                PQclear(res);
+                throw std::runtime_error(err);
+            }
+            rows = std::atol(PQcmdTuples(res));
+            PQclear(res);
+        }
+        return rows;
+    }
+
+private:
+    static constexpr size_t FLUSH_THRESHOLD = 1 << 20; // 1 Mo par envoi
+
+    void flush() {
+        if (buffer_.empty()) return;
+        if (PQputCopyData(conn_, buffer_.data(), static_cast<int>(buffer_.size())) != 1) {
+            throw std::runtime_error(PQerrorMessage(conn_));
+        }
+        buffer_.clear();
+    }
+
+    PGconn* conn_;
+    std::string buffer_;
+};
+
+#endif
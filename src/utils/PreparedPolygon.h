@@ -0,0 +1,106 @@
+#ifndef PREPARED_POLYGON_H
+#define PREPARED_POLYGON_H
+
+#include "Geometry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Multipolygone préparé pour des tests point-dans-polygone répétés
+//
+// Les arêtes de tous les anneaux (contours et trous) sont réparties en bandes
+// horizontales : un test ne parcourt que les arêtes de la bande du point. Dans
+// chaque bande, les arêtes sont rangées en colonnes (x de départ, y des deux
+// extrémités, inverse de la pente) et la parité des croisements est calculée
+// sans branchement, boucle que le compilateur vectorise.
+//
+// Règle pair-impair sur l'ensemble des anneaux : valable pour des polygones
+// valides (parties disjointes, trous inclus dans leur contour).
+class PreparedPolygon {
+public:
+    explicit PreparedPolygon(const std::vector<Polygon2>& polygons) {
+        size_t edgeCount = 0;
+        bool first = true;
+        for (const auto& poly : polygons) {
+            for (const auto& ring : poly.rings) {
+                for (const auto& p : ring) {
+                    if (first) { minX_ = maxX_ = p.x; minY_ = maxY_ = p.y; first = false; }
+                    minX_ = std::min(minX_, p.x); maxX_ = std::max(maxX_, p.x);
+                    minY_ = std::min(minY_, p.y); maxY_ = std::max(maxY_, p.y);
+                }
+                if (ring.size() > 1) edgeCount += ring.size() - 1;
+            }
+        }
+        if (edgeCount == 0) return;
+        edgeCount_ = edgeCount;
+
+        // ~16 arêtes par bande en moyenne
+        bandCount_ = std::clamp<size_t>(edgeCount / 16, 1, 4096);
+        bandHeight_ = (maxY_ - minY_) / bandCount_;
+        if (bandHeight_ <= 0) bandHeight_ = 1;
+        bands_.resize(bandCount_);
+
+        for (const auto& poly : polygons) {
+            for (const auto& ring : poly.rings) {
+                for (size_t i = 0; i + 1 < ring.size(); ++i) {
+                    const auto& a = ring[i];
+                    const auto& b = ring[i + 1];
+                    if (a.y == b.y) continue;   // Horizontale : jamais croisée par la demi-droite
+                    double inv = (b.x - a.x) / (b.y - a.y);
+                    size_t lo = bandOf(std::min(a.y, b.y));
+                    size_t hi = bandOf(std::max(a.y, b.y));
+                    for (size_t band = lo; band <= hi; ++band) {
+                        auto& e = bands_[band];
+                        e.ax.push_back(a.x);
+                        e.ay.push_back(a.y);
+                        e.by.push_back(b.y);
+                        e.inv.push_back(inv);
+                    }
+                }
+            }
+        }
+    }
+
+    bool empty() const { return bands_.empty(); }
+    size_t edgeCount() const { return edgeCount_; }
+    double minX() const { return minX_; }
+    double minY() const { return minY_; }
+    double maxX() const { return maxX_; }
+    double maxY() const { return maxY_; }
+
+    bool contains(double x, double y) const {
+        if (bands_.empty() || x < minX_ || x > maxX_ || y < minY_ || y > maxY_) return false;
+        const auto& e = bands_[bandOf(y)];
+        const size_t n = e.ax.size();
+        const double* ax = e.ax.data();
+        const double* ay = e.ay.data();
+        const double* by = e.by.data();
+        const double* inv = e.inv.data();
+        unsigned crossings = 0;
+        for (size_t i = 0; i < n; ++i) {
+            crossings += static_cast<unsigned>((ay[i] > y) != (by[i] > y)) &
+                         static_cast<unsigned>(x < ax[i] + (y - ay[i]) * inv[i]);
+        }
+        return (crossings & 1u) != 0;
+    }
+
+private:
+    struct Band {
+        std::vector<double> ax, ay, by, inv;
+    };
+
+    double minX_ = 0, minY_ = 0, maxX_ = 0, maxY_ = 0;
+    size_t edgeCount_ = 0;
+    size_t bandCount_ = 0;
+    double bandHeight_ = 1;
+    std::vector<Band> bands_;
+
+    size_t bandOf(double y) const {
+        double b = std::floor((y - minY_) / bandHeight_);
+        if (b < 0) return 0;
+        return std::min(static_cast<size_t>(b), bandCount_ - 1);
+    }
+};
+
+#endif // PREPARED_POLYGON_H
@@ -0,0 +1,48 @@
+#ifndef RADIO_MODEL_H
+#define RADIO_MODEL_H
+
+#include <string>
+#include <cmath>
+
+// Modèle radio partagé (simulation de signal, matrice d'interférences)
+// Propagation en espace libre (FSPL) avec pénalité forfaitaire par obstacle
+class RadioModel {
+public:
+    // Fréquences standards utilisées pour les calculs de simulation
+    static constexpr double FREQ_4G = 2600.0; // MHz
+    static constexpr double FREQ_5G = 3500.0; // MHz
+
+    // Puissance d'émission effective (EIRP) en dBm pour chaque technologie
+    static constexpr double POWER_4G = 46.0; // ~40 Watts
+    static constexpr double POWER_5G = 50.0; // ~100 Watts
+
+    // Atténuation moyenne causée par les obstacles en béton/brique
+    static constexpr double OBSTACLE_LOSS = 25.0; // dB
+
+    // Seuil de détection en dessous duquel un signal est ignoré
+    static constexpr double DETECTION_THRESHOLD_DBM = -120.0;
+
+    static double frequencyFor(const std::string& technology) {
+        return (technology == "5G") ? FREQ_5G : FREQ_4G;
+    }
+
+    static double txPowerFor(const std::string& technology) {
+        return (technology == "5G") ? POWER_5G : POWER_4G;
+    }
+
+    // FSPL = 20*log10(distance) + 20*log10(fréquence) + 32.45
+    static double freeSpacePathLoss(double distanceKm, double freqMhz) {
+        return 20 * std::log10(distanceKm) + 20 * std::log10(freqMhz) + 32.45;
+    }
+
+    // Puissance reçue (dBm) à une distance donnée d'un émetteur
+    static double receivedPower(const std::string& technology, double distanceKm, bool hasObstacle) {
+        double rx = txPowerFor(technology) - freeSpacePathLoss(distanceKm, frequencyFor(technology));
+        if (hasObstacle) {
+            rx -= OBSTACLE_LOSS;
+        }
+        return rx;
+    }
+};
+
+#endif
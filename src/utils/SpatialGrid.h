@@ -0,0 +1,70 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "GeoUtils.h"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cmath>
+#include <functional>
+
+// Grille spatiale uniforme pour les recherches de voisinage en mémoire
+//
+// Chaque point est rangé dans une cellule de taille `cellSizeMeters`.
+// Une recherche dans un rayon <= cellSizeMeters n'examine que les 3x3
+// cellules autour du point au lieu de parcourir tout le jeu de données.
+class SpatialGrid {
+public:
+    struct Entry {
+        size_t index;   // Position de l'élément dans le vecteur source
+        double lat;
+        double lon;
+    };
+
+    // refLatitude : latitude de référence pour convertir les mètres en degrés de longitude
+    SpatialGrid(double cellSizeMeters, double refLatitude)
+        : cellLat_(GeoUtils::metersToDegreesLat(cellSizeMeters)),
+          cellLon_(GeoUtils::metersToDegreesLon(cellSizeMeters, refLatitude)) {}
+
+    void insert(size_t index, double lat, double lon) {
+        cells_[key(cellX(lon), cellY(lat))].push_back({index, lat, lon});
+    }
+
+    // Parcourt les éléments situés à moins de radiusMeters du point (distance Haversine)
+    void forEachWithin(double lat, double lon, double radiusMeters,
+                       const std::function<void(const Entry&, double distanceMeters)>& visit) const {
+        int spanX = static_cast<int>(std::ceil(GeoUtils::metersToDegreesLon(radiusMeters, lat) / cellLon_));
+        int spanY = static_cast<int>(std::ceil(GeoUtils::metersToDegreesLat(radiusMeters) / cellLat_));
+        int cx = cellX(lon);
+        int cy = cellY(lat);
+
+        for (int x = cx - spanX; x <= cx + spanX; ++x) {
+            for (int y = cy - spanY; y <= cy + spanY; ++y) {
+                auto it = cells_.find(key(x, y));
+                if (it == cells_.end()) continue;
+                for (const auto& e : it->second) {
+                    double d = GeoUtils::haversineMeters(lat, lon, e.lat, e.lon);
+                    if (d <= radiusMeters) {
+                        visit(e, d);
+                    }
+                }
+            }
+        }
+    }
+
+    size_t cellCount() const { return cells_.size(); }
+
+private:
+    int cellX(double lon) const { return static_cast<int>(std::floor(lon / cellLon_)); }
+    int cellY(double lat) const { return static_cast<int>(std::floor(lat / cellLat_)); }
+
+    static int64_t key(int x, int y) {
+        return (static_cast<int64_t>(x) << 32) ^ static_cast<uint32_t>(y);
+    }
+
+    double cellLat_;
+    double cellLon_;
+    std::unordered_map<int64_t, std::vector<Entry>> cells_;
+};
+
+#endif
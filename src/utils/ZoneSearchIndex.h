@@ -0,0 +1,200 @@
+#ifndef ZONE_SEARCH_INDEX_H
+#define ZONE_SEARCH_INDEX_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Index de recherche des noms de zones (autocomplétion)
+//
+// Les noms sont normalisés par fold() : minuscules, accents français retirés,
+// voyelles brèves, tatweel et variantes de l'alif arabes unifiées, ponctuation
+// ramenée à un espace. Puis :
+// - requêtes de 3 caractères ou plus : index inversé de trigrammes, intersection
+//   des listes en partant de la plus courte, vérification par sous-chaîne
+// - requêtes plus courtes : débuts de mots triés, recherche dichotomique du préfixe
+// Classement : début du nom, puis début d'un mot, puis ailleurs ; à égalité,
+// rang du type (pays avant communes), population décroissante, ordre d'insertion.
+class ZoneSearchIndex {
+public:
+    struct Entry {
+        std::string type;
+        int typeRank = 0;       // Plus petit = plus haut dans les résultats
+        double population = 0;
+        std::string json;       // Élément de réponse sérialisé d'avance
+        std::string name;
+    };
+
+    // Entrées dans l'ordre de départage final (ordre des noms en pratique)
+    explicit ZoneSearchIndex(std::vector<Entry> entries) : entries_(std::move(entries)) {
+        folded_.reserve(entries_.size());
+        for (uint32_t i = 0; i < entries_.size(); ++i) {
+            folded_.push_back(fold(entries_[i].name));
+            const auto& f = folded_.back();
+            for (size_t k = 0; k + 3 <= f.size(); ++k) {
+                auto& postings = trigrams_[trigramKey(f, k)];
+                if (postings.empty() || postings.back() != i) postings.push_back(i);
+            }
+            for (size_t k = 0; k < f.size(); ++k) {
+                if (f[k] != U' ' && (k == 0 || f[k - 1] == U' ')) wordStarts_.emplace_back(i, static_cast<uint32_t>(k));
+            }
+        }
+        std::sort(wordStarts_.begin(), wordStarts_.end(), [this](const auto& a, const auto& b) {
+            return suffix(a) < suffix(b);
+        });
+    }
+
+    size_t size() const { return entries_.size(); }
+
+    // Au plus limit entrées du type (vide = tous) dont le nom contient la requête
+    std::vector<const Entry*> search(const std::string& query, const std::string& type, size_t limit) const {
+        std::u32string q = fold(query);
+        std::vector<uint32_t> candidates;
+
+        if (q.empty()) {
+            candidates.resize(entries_.size());
+            for (uint32_t i = 0; i < candidates.size(); ++i) candidates[i] = i;
+        } else if (q.size() < 3) {
+            std::u32string_view prefix(q);
+            auto it = std::lower_bound(wordStarts_.begin(), wordStarts_.end(), prefix,
+                [this](const auto& ws, std::u32string_view p) { return suffix(ws) < p; });
+            for (; it != wordStarts_.end() && suffix(*it).substr(0, prefix.size()) == prefix; ++it) {
+                candidates.push_back(it->first);
+            }
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        } else {
+            std::vector<const std::vector<uint32_t>*> lists;
+            for (size_t k = 0; k + 3 <= q.size(); ++k) {
+                auto it = trigrams_.find(trigramKey(q, k));
+                if (it == trigrams_.end()) return {};
+                lists.push_back(&it->second);
+            }
+            std::sort(lists.begin(), lists.end(), [](auto a, auto b) { return a->size() < b->size(); });
+            candidates = *lists[0];
+            for (size_t l = 1; l < lists.size() && !candidates.empty(); ++l) {
+                std::vector<uint32_t> kept;
+                std::set_intersection(candidates.begin(), candidates.end(),
+                                      lists[l]->begin(), lists[l]->end(), std::back_inserter(kept));
+                candidates.swap(kept);
+            }
+        }
+
+        // (qualité de correspondance, rang du type, -population, indice)
+        std::vector<std::tuple<int, int, double, uint32_t>> ranked;
+        for (uint32_t i : candidates) {
+            const auto& e = entries_[i];
+            if (!type.empty() && e.type != type) continue;
+            int quality = matchQuality(folded_[i], q);
+            if (quality < 0) continue;
+            ranked.emplace_back(quality, e.typeRank, -e.population, i);
+        }
+        size_t n = std::min(limit, ranked.size());
+        std::partial_sort(ranked.begin(), ranked.begin() + n, ranked.end());
+
+        std::vector<const Entry*> out;
+        out.reserve(n);
+        for (size_t k = 0; k < n; ++k) out.push_back(&entries_[std::get<3>(ranked[k])]);
+        return out;
+    }
+
+    // Forme normalisée d'un nom UTF-8 (espaces simples, sans espace en tête ni en fin)
+    static std::u32string fold(const std::string& utf8) {
+        std::u32string out;
+        out.reserve(utf8.size());
+        auto emit = [&out](char32_t c) {
+            if (c == U' ' && (out.empty() || out.back() == U' ')) return;
+            out.push_back(c);
+        };
+
+        size_t i = 0;
+        while (i < utf8.size()) {
+            unsigned char b = static_cast<unsigned char>(utf8[i]);
+            char32_t c;
+            size_t len;
+            if (b < 0x80) { c = b; len = 1; }
+            else if ((b >> 5) == 0x6) { c = b & 0x1F; len = 2; }
+            else if ((b >> 4) == 0xE) { c = b & 0x0F; len = 3; }
+            else if ((b >> 3) == 0x1E) { c = b & 0x07; len = 4; }
+            else { ++i; continue; }   // Octet invalide ignoré
+            if (i + len > utf8.size()) break;
+            bool valid = true;
+            for (size_t k = 1; k < len; ++k) {
+                unsigned char cont = static_cast<unsigned char>(utf8[i + k]);
+                if ((cont >> 6) != 0x2) { valid = false; break; }
+                c = (c << 6) | (cont & 0x3F);
+            }
+            if (!valid) { ++i; continue; }
+            i += len;
+
+            if (c < 0x80) {
+                if (c >= 'A' && c <= 'Z') emit(c - 'A' + 'a');
+                else if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) emit(c);
+                else emit(U' ');
+            } else if (c >= 0xC0 && c <= 0xFF) {
+                // Latin-1 : lettres accentuées -> lettre de base
+                static const char* latin1 =
+                    "aaaaaaaceeeeiiii" "dnooooo ouuuuyts"   // U+00C0 - U+00DF
+                    "aaaaaaaceeeeiiii" "dnooooo ouuuuyty";  // U+00E0 - U+00FF
+                char base = latin1[c - 0xC0];
+                if (c == 0xC6 || c == 0xE6) { emit(U'a'); emit(U'e'); }
+                else if (c == 0xDF) { emit(U's'); emit(U's'); }
+                else emit(static_cast<char32_t>(base));
+            } else if (c == 0x152 || c == 0x153) {
+                emit(U'o'); emit(U'e');
+            } else if (c < 0xC0 || (c >= 0x2000 && c <= 0x206F) || c == 0x60C || c == 0x61B || c == 0x61F) {
+                emit(U' ');   // Ponctuation Latin-1, générale et arabe
+            } else if ((c >= 0x64B && c <= 0x65F) || c == 0x670 || c == 0x640) {
+                // Voyelles brèves, shadda, sukun, tatweel : ignorés
+            } else if (c == 0x622 || c == 0x623 || c == 0x625 || c == 0x671) {
+                emit(0x627);  // Variantes de l'alif
+            } else if (c == 0x629) {
+                emit(0x647);  // Tā' marbūṭa -> hā'
+            } else if (c == 0x649 || c == 0x626) {
+                emit(0x64A);  // Alif maqṣūra, yā' hamza -> yā'
+            } else if (c == 0x624) {
+                emit(0x648);  // Wāw hamza -> wāw
+            } else if (c >= 0x660 && c <= 0x669) {
+                emit(U'0' + (c - 0x660));   // Chiffres arabes-indiens
+            } else {
+                emit(c);
+            }
+        }
+        if (!out.empty() && out.back() == U' ') out.pop_back();
+        return out;
+    }
+
+private:
+    std::vector<Entry> entries_;
+    std::vector<std::u32string> folded_;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> trigrams_;   // Listes triées
+    std::vector<std::pair<uint32_t, uint32_t>> wordStarts_;         // (entrée, position), triés par suffixe
+
+    // 3 points de code (21 bits chacun) sur un entier
+    static uint64_t trigramKey(const std::u32string& s, size_t k) {
+        return (static_cast<uint64_t>(s[k]) << 42) | (static_cast<uint64_t>(s[k + 1]) << 21) | s[k + 2];
+    }
+
+    std::u32string_view suffix(const std::pair<uint32_t, uint32_t>& ws) const {
+        return std::u32string_view(folded_[ws.first]).substr(ws.second);
+    }
+
+    // 0 = début du nom, 1 = début d'un mot, 2 = ailleurs, -1 = absent
+    static int matchQuality(const std::u32string& name, const std::u32string& q) {
+        if (q.empty()) return 0;
+        size_t pos = name.find(q);
+        if (pos == std::u32string::npos) return -1;
+        if (pos == 0) return 0;
+        for (; pos != std::u32string::npos; pos = name.find(q, pos + 1)) {
+            if (name[pos - 1] == U' ') return 1;
+        }
+        return 2;
+    }
+};
+
+#endif // ZONE_SEARCH_INDEX_H
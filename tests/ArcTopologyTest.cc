@@ -0,0 +1,156 @@
+#include "TestCheck.h"
+#include "ArcTopology.h"
+#include "CoverageRaster.h"
+
+#include <algorithm>
+#include <json/json.h>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    const double QUANT = 1e-7;
+
+    // Frontière commune sinueuse de (1, 0) à (1, 1)
+    std::vector<Point2> border() {
+        std::vector<Point2> line;
+        for (int k = 0; k <= 20; ++k) {
+            double wiggle = 0.02 * std::sin(k * GeoUtils::PI / 20) * (k % 2 ? 1 : -1);
+            line.push_back({1 + wiggle, k / 20.0});
+        }
+        return line;
+    }
+
+    // Deux carrés voisins par la frontière sinueuse (anneaux dans le sens direct) + un îlot
+    std::vector<std::vector<Polygon2>> features() {
+        auto line = border();
+        Ring west = {{0, 0}};
+        west.insert(west.end(), line.begin(), line.end());
+        west.push_back({0, 1});
+        west.push_back({0, 0});
+
+        Ring east = {{1, 0}, {2, 0}, {2, 1}};
+        east.insert(east.end(), line.rbegin(), line.rend());
+
+        Ring island = {{5, 5}, {6, 5}, {6, 6}, {5, 6}, {5, 5}};
+        return {{{{west}}}, {{{east}}}, {{{island}}}};
+    }
+
+    Json::Value parse(const std::string& text) {
+        Json::CharReaderBuilder builder;
+        std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+        Json::Value root;
+        std::string errors;
+        CHECK(reader->parse(text.data(), text.data() + text.size(), &root, &errors));
+        return root;
+    }
+
+    // Anneaux de chaque feature reconstitués à partir des arcs (deltas quantifiés)
+    std::vector<std::vector<Ring>> decode(const Json::Value& topo) {
+        double scale = topo["transform"]["scale"][0].asDouble();
+        double tx = topo["transform"]["translate"][0].asDouble();
+        double ty = topo["transform"]["translate"][1].asDouble();
+
+        std::vector<std::vector<Point2>> arcs;
+        for (const auto& arc : topo["arcs"]) {
+            std::vector<Point2> line;
+            long long x = 0, y = 0;
+            for (const auto& p : arc) {
+                x += p[0].asInt64();
+                y += p[1].asInt64();
+                line.push_back({tx + x * scale, ty + y * scale});
+            }
+            arcs.push_back(line);
+        }
+
+        std::vector<std::vector<Ring>> out;
+        for (const auto& geometry : topo["objects"]["zones"]["geometries"]) {
+            std::vector<Ring> rings;
+            for (const auto& polygon : geometry["arcs"]) {
+                for (const auto& refs : polygon) {
+                    Ring ring;
+                    for (const auto& ref : refs) {
+                        int i = ref.asInt();
+                        std::vector<Point2> line = arcs[i >= 0 ? i : ~i];
+                        if (i < 0) std::reverse(line.begin(), line.end());
+                        // Arcs consécutifs : la fin de l'un est le début du suivant
+                        ring.insert(ring.end(), line.begin() + (ring.empty() ? 0 : 1), line.end());
+                    }
+                    rings.push_back(ring);
+                }
+            }
+            out.push_back(rings);
+        }
+        return out;
+    }
+
+    std::set<std::pair<long long, long long>> vertices(const Ring& ring, bool borderOnly) {
+        std::set<std::pair<long long, long long>> out;
+        for (const auto& p : ring) {
+            if (borderOnly && (p.x < 0.9 || p.x > 1.1)) continue;
+            out.insert({std::llround(p.x / QUANT), std::llround(p.y / QUANT)});
+        }
+        return out;
+    }
+
+    // Frontière commune stockée une fois : 2 arcs par carré dont 1 partagé, 1 arc fermé pour l'îlot
+    void testSharedArcs() {
+        auto input = features();
+        ArcTopology topology(input);
+        CHECK(topology.arcCount() == 4);
+
+        Json::Value topo = parse(topology.toTopoJson("zones", {R"("id":1)", R"("id":2)", ""}, 0, QUANT));
+        const auto& geometries = topo["objects"]["zones"]["geometries"];
+        CHECK(geometries.size() == 3);
+        CHECK(geometries[0]["id"].asInt() == 1);
+        CHECK(geometries[2]["type"].asString() == "MultiPolygon");
+
+        // Sans simplification : anneaux fermés, mêmes sommets et même aire que l'entrée
+        auto rings = decode(topo);
+        CHECK(rings.size() == 3);
+        for (size_t f = 0; f < rings.size() && f < input.size(); ++f) {
+            CHECK(rings[f].size() == 1);
+            if (rings[f].size() != 1) continue;
+            const Ring& ring = rings[f][0];
+            const Ring& original = input[f][0].rings[0];
+            CHECK(vertices(ring, false) == vertices(original, false));
+            CHECK(std::fabs(ring.front().x - ring.back().x) < QUANT && std::fabs(ring.front().y - ring.back().y) < QUANT);
+            CHECK_NEAR(CoverageRaster::signedArea(ring), CoverageRaster::signedArea(original), 1e-6);
+        }
+    }
+
+    // Simplification : la frontière reste identique des deux côtés (pas d'interstice)
+    void testSimplifiedBorder() {
+        auto input = features();
+        ArcTopology topology(input);
+        auto rings = decode(parse(topology.toTopoJson("zones", {}, 0.03, QUANT)));
+        CHECK(rings.size() == 3);
+        if (rings.size() != 3) return;
+
+        auto west = vertices(rings[0][0], true);
+        auto east = vertices(rings[1][0], true);
+        CHECK(west == east);
+        CHECK(west.size() >= 2 && west.size() < border().size());
+        CHECK(west.count({std::llround(1 / QUANT), 0}) == 1);
+        CHECK(west.count({std::llround(1 / QUANT), std::llround(1 / QUANT)}) == 1);
+    }
+
+    // Anneaux dégénérés ignorés, feature vide conservée (géométrie nulle)
+    void testDegenerate() {
+        std::vector<std::vector<Polygon2>> input = {{{{{{0, 0}, {1, 1}, {0, 0}}}}}, {}};
+        ArcTopology topology(input);
+        CHECK(topology.arcCount() == 0);
+        Json::Value topo = parse(topology.toTopoJson("zones", {}, 0, QUANT));
+        CHECK(topo["objects"]["zones"]["geometries"].size() == 2);
+        CHECK(topo["objects"]["zones"]["geometries"][0]["type"].isNull());
+    }
+}
+
+int main() {
+    testSharedArcs();
+    testSimplifiedBorder();
+    testDegenerate();
+    return TestCheck::report("ArcTopology");
+}
@@ -0,0 +1,189 @@
+#include "TestCheck.h"
+#include "CoverageRaster.h"
+
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+    CoverageRaster disk(int width, int height, double cx, double cy, double r) {
+        CoverageRaster raster(width, height);
+        std::vector<CoverageRaster::Span> spans;
+        CoverageRaster::diskSpans(cx, cy, r, width, height, spans);
+        raster.fill(spans);
+        return raster;
+    }
+
+    // Pixels dont le centre est dans les polygones (règle pair-impair, comme le remplissage)
+    CoverageRaster rasterize(const std::vector<Polygon2>& polygons, int width, int height) {
+        CoverageRaster raster(width, height);
+        for (const auto& poly : polygons) {
+            std::vector<CoverageRaster::Span> spans;
+            CoverageRaster::polygonSpans(poly, width, height, spans);
+            raster.fill(spans);
+        }
+        return raster;
+    }
+
+    bool samePixels(const CoverageRaster& a, const CoverageRaster& b) {
+        if (a.width() != b.width() || a.height() != b.height()) return false;
+        for (int y = 0; y < a.height(); ++y) {
+            for (int x = 0; x < a.width(); ++x) {
+                if (a.get(x, y) != b.get(x, y)) return false;
+            }
+        }
+        return true;
+    }
+
+    void testDiskSpans() {
+        CoverageRaster raster = disk(100, 100, 50, 50, 20);
+        for (int y = 0; y < 100; ++y) {
+            for (int x = 0; x < 100; ++x) {
+                double dx = x + 0.5 - 50, dy = y + 0.5 - 50;
+                CHECK(raster.get(x, y) == (dx * dx + dy * dy <= 400));
+            }
+        }
+        CHECK(!raster.empty());
+        CHECK(!raster.get(-1, 0) && !raster.get(100, 0));
+    }
+
+    // trace() puis re-remplissage : exactement les mêmes pixels
+    void testTraceRoundTrip() {
+        CoverageRaster raster = disk(130, 90, 40, 45, 30);
+        std::vector<CoverageRaster::Span> spans;
+        CoverageRaster::diskSpans(100, 30, 18, 130, 90, spans);
+        raster.fill(spans);
+
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> px(0, 129), py(0, 89);
+        for (int i = 0; i < 300; ++i) {
+            int x = px(rng), y = py(rng);
+            raster.fill({{y, x, x}});
+        }
+
+        auto polygons = raster.trace();
+        CHECK(!polygons.empty());
+        CHECK(samePixels(rasterize(polygons, 130, 90), raster));
+        for (const auto& poly : polygons) {
+            CHECK(CoverageRaster::signedArea(poly.rings[0]) > 0);
+            for (size_t r = 1; r < poly.rings.size(); ++r) {
+                CHECK(CoverageRaster::signedArea(poly.rings[r]) < 0);
+            }
+        }
+    }
+
+    // Anneau (disque troué) : un contour extérieur et un trou
+    void testTraceHole() {
+        CoverageRaster outer = disk(64, 64, 32, 32, 25);
+        CoverageRaster inner = disk(64, 64, 32, 32, 10);
+        CoverageRaster ring(64, 64);
+        for (int y = 0; y < 64; ++y) {
+            for (int x = 0; x < 64; ++x) {
+                if (outer.get(x, y) && !inner.get(x, y)) ring.fill({{y, x, x}});
+            }
+        }
+        auto polygons = ring.trace();
+        CHECK(polygons.size() == 1);
+        if (polygons.size() == 1) CHECK(polygons[0].rings.size() == 2);
+        CHECK(samePixels(rasterize(polygons, 64, 64), ring));
+    }
+
+    // Cas selle : deux pixels en diagonale restent deux polygones disjoints
+    void testTraceSaddle() {
+        CoverageRaster raster(2, 2);
+        raster.fill({{0, 0, 0}, {1, 1, 1}});
+        auto polygons = raster.trace();
+        CHECK(polygons.size() == 2);
+        CHECK(samePixels(rasterize(polygons, 2, 2), raster));
+    }
+
+    // Chaque pixel réduit est le OU des pixels source qu'il recouvre
+    void testDownsample() {
+        CoverageRaster raster = disk(200, 120, 70, 60, 33);
+        for (auto size : {std::pair<int, int>{50, 30}, {64, 40}, {7, 5}, {1, 1}}) {
+            CoverageRaster small = raster.downsample(size.first, size.second);
+            CHECK(small.width() == size.first && small.height() == size.second);
+            for (int j = 0; j < small.height(); ++j) {
+                for (int i = 0; i < small.width(); ++i) {
+                    bool any = false;
+                    for (int y = 0; y < raster.height(); ++y) {
+                        for (int x = 0; x < raster.width(); ++x) {
+                            // Recouvrement des intervalles [x, x+1) et [i, i+1) ramenés à la même échelle
+                            bool overlapX = static_cast<long>(x) * small.width() < static_cast<long>(i + 1) * raster.width() &&
+                                            static_cast<long>(i) * raster.width() < static_cast<long>(x + 1) * small.width();
+                            bool overlapY = static_cast<long>(y) * small.height() < static_cast<long>(j + 1) * raster.height() &&
+                                            static_cast<long>(j) * raster.height() < static_cast<long>(y + 1) * small.height();
+                            if (overlapX && overlapY && raster.get(x, y)) any = true;
+                        }
+                    }
+                    CHECK(small.get(i, j) == any);
+                }
+            }
+        }
+    }
+
+    void testPackedRoundTrip() {
+        CoverageRaster tile = disk(100, 70, 30, 40, 25);
+        std::string bits = tile.packed();
+        CHECK(bits.size() == CoverageRaster::packedSize(100, 70));
+        CHECK(CoverageRaster::packedSize(3, 3) == 2);
+
+        // Deux copies côte à côte, la seconde débordant du masque (bornée)
+        CoverageRaster block(160, 90);
+        CHECK(block.orPacked(0, 10, 100, 70, bits));
+        CHECK(block.orPacked(100, 0, 100, 70, bits));
+        for (int y = 0; y < 90; ++y) {
+            for (int x = 0; x < 160; ++x) {
+                bool expected = (x < 100 && tile.get(x, y - 10)) || tile.get(x - 100, y);
+                CHECK(block.get(x, y) == expected);
+            }
+        }
+        CHECK(!block.orPacked(0, 0, 100, 70, bits.substr(1)));
+    }
+
+    // Deux masques contigus d'un même disque : frontière commune aux mêmes sommets
+    // après simplification, quelle que soit la tolérance
+    void testSimplifiedSeam() {
+        CoverageRaster full = disk(128, 128, 60, 64, 45);
+        CoverageRaster left(64, 128), right(64, 128);
+        for (int y = 0; y < 128; ++y) {
+            for (int x = 0; x < 128; ++x) {
+                if (full.get(x, y)) (x < 64 ? left : right).fill({{y, x % 64, x % 64}});
+            }
+        }
+
+        for (double tolerance : {0.5, 2.0, 8.0}) {
+            std::set<std::pair<double, double>> fromLeft, fromRight;
+            for (const auto& poly : left.trace()) {
+                for (const auto& ring : poly.rings) {
+                    Ring simplified = left.simplifyTraced(ring, tolerance);
+                    CHECK(simplified.size() >= 4 && simplified.size() <= ring.size());
+                    for (const auto& p : simplified) {
+                        if (p.x >= 64) fromLeft.insert({p.x, p.y});
+                    }
+                }
+            }
+            for (const auto& poly : right.trace()) {
+                for (const auto& ring : poly.rings) {
+                    for (const auto& p : right.simplifyTraced(ring, tolerance)) {
+                        if (p.x <= 0) fromRight.insert({p.x + 64, p.y});
+                    }
+                }
+            }
+            CHECK(!fromLeft.empty());
+            CHECK(fromLeft == fromRight);
+        }
+    }
+}
+
+int main() {
+    testDiskSpans();
+    testTraceRoundTrip();
+    testTraceHole();
+    testTraceSaddle();
+    testDownsample();
+    testPackedRoundTrip();
+    testSimplifiedSeam();
+    return TestCheck::report("CoverageRaster");
+}
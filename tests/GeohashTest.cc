@@ -0,0 +1,67 @@
+#include "TestCheck.h"
+#include "Geohash.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+    // Valeur de référence publiée (geohash.org)
+    void testEncodeReference() {
+        CHECK(Geohash::encode(57.64911, 10.40744, 11) == "u4pruydqqvj");
+        CHECK(Geohash::encode(48.8566, 2.3522, 7) == "u09tvw0");
+        CHECK(Geohash::encode(48.8566, 2.3522, 5) == "u09tv");
+    }
+
+    // Le centre décodé est dans la cellule du point encodé
+    void testDecodeCenter() {
+        const double points[][2] = {{48.8566, 2.3522}, {-33.8688, 151.2093}, {0.0001, -0.0001}, {89.9, 179.9}};
+        for (const auto& p : points) {
+            for (int precision = 1; precision <= 9; ++precision) {
+                std::string cell = Geohash::encode(p[0], p[1], precision);
+                double lat, lon, dLat, dLon;
+                Geohash::decodeCenter(cell, lat, lon);
+                Geohash::cellSize(precision, dLat, dLon);
+                CHECK(std::fabs(lat - p[0]) <= dLat / 2);
+                CHECK(std::fabs(lon - p[1]) <= dLon / 2);
+                CHECK(Geohash::encode(lat, lon, precision) == cell);
+            }
+        }
+    }
+
+    void testCellSize() {
+        double dLat, dLon;
+        Geohash::cellSize(1, dLat, dLon);
+        CHECK_NEAR(dLat, 45.0, 1e-12);
+        CHECK_NEAR(dLon, 45.0, 1e-12);
+        Geohash::cellSize(7, dLat, dLon);
+        CHECK_NEAR(dLat, 180.0 / (1 << 17), 1e-15);
+        CHECK_NEAR(dLon, 360.0 / (1 << 18), 1e-15);
+    }
+
+    // Toute position à moins du rayon tombe dans une des cellules retournées
+    void testCoveringCells() {
+        const double lat = 48.8566, lon = 2.3522, radius = 5000;
+        auto cells = Geohash::coveringCells(lat, lon, radius, 5);
+        CHECK(std::is_sorted(cells.begin(), cells.end()));
+        CHECK(std::adjacent_find(cells.begin(), cells.end()) == cells.end());
+
+        for (int k = 0; k < 360; k += 5) {
+            for (double f : {0.0, 0.5, 0.99}) {
+                double a = k * GeoUtils::PI / 180.0;
+                double pLat = lat + GeoUtils::metersToDegreesLat(f * radius * std::sin(a));
+                double pLon = lon + GeoUtils::metersToDegreesLon(f * radius * std::cos(a), lat);
+                std::string cell = Geohash::encode(pLat, pLon, 5);
+                CHECK(std::binary_search(cells.begin(), cells.end(), cell));
+            }
+        }
+    }
+}
+
+int main() {
+    testEncodeReference();
+    testDecodeCenter();
+    testCellSize();
+    testCoveringCells();
+    return TestCheck::report("Geohash");
+}
@@ -0,0 +1,104 @@
+#include "TestCheck.h"
+#include "GraphColoring.h"
+
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+    CsrGraph randomGraph(size_t n, size_t edgeCount, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(n - 1));
+        std::set<std::pair<uint32_t, uint32_t>> edges;
+        while (edges.size() < edgeCount) {
+            uint32_t u = pick(rng), v = pick(rng);
+            if (u == v) continue;
+            edges.insert({std::min(u, v), std::max(u, v)});
+        }
+        return CsrGraph::fromEdges(n, {edges.begin(), edges.end()});
+    }
+
+    size_t conflicts(const CsrGraph& g, const std::vector<int32_t>& colors) {
+        size_t count = 0;
+        for (uint32_t v = 0; v < g.vertexCount(); ++v) {
+            for (uint32_t e = g.offsets[v]; e < g.offsets[v + 1]; ++e) {
+                if (g.adjacency[e] > v && colors[g.adjacency[e]] == colors[v]) count++;
+            }
+        }
+        return count;
+    }
+
+    void testFromEdges() {
+        CsrGraph g = CsrGraph::fromEdges(4, {{0, 1}, {1, 2}, {1, 3}});
+        CHECK(g.vertexCount() == 4);
+        CHECK(g.degree(0) == 1 && g.degree(1) == 3 && g.degree(2) == 1 && g.degree(3) == 1);
+        std::set<uint32_t> neighbors(g.adjacency.begin() + g.offsets[1], g.adjacency.begin() + g.offsets[2]);
+        CHECK(neighbors == (std::set<uint32_t>{0, 2, 3}));
+    }
+
+    // Palette suffisante : coloration propre de tous les sommets, glouton borné par degré max + 1
+    void testProperColoring() {
+        CsrGraph g = randomGraph(3000, 15000, 1);
+        std::vector<int32_t> colors(g.vertexCount(), GraphColoring::UNCOLORED);
+        std::vector<int32_t> palette(g.vertexCount(), 504);
+        std::vector<bool> fixed(g.vertexCount(), false);
+
+        auto stats = GraphColoring::colorSpeculative(g, colors, palette, fixed);
+        CHECK(stats.recolored == g.vertexCount());
+        CHECK(stats.residualConflicts == 0);
+        CHECK(stats.rounds >= 1);
+        CHECK(conflicts(g, colors) == 0);
+
+        uint32_t maxDegree = 0;
+        for (uint32_t v = 0; v < g.vertexCount(); ++v) {
+            CHECK(colors[v] >= 0 && colors[v] < 504);
+            maxDegree = std::max(maxDegree, g.degree(v));
+        }
+        CHECK(stats.maxColor <= static_cast<int32_t>(maxDegree));
+    }
+
+    // Recoloration incrémentale : les sommets fixés gardent leur couleur
+    void testFixedVertices() {
+        CsrGraph g = randomGraph(2000, 8000, 2);
+        size_t n = g.vertexCount();
+        std::vector<int32_t> colors(n, GraphColoring::UNCOLORED);
+        std::vector<int32_t> palette(n, 64);
+        GraphColoring::colorSpeculative(g, colors, palette, std::vector<bool>(n, false));
+
+        std::vector<int32_t> previous = colors;
+        std::vector<bool> fixed(n, false);
+        for (size_t v = 0; v < n; ++v) {
+            fixed[v] = (v % 3 != 0);
+            if (!fixed[v]) colors[v] = GraphColoring::UNCOLORED;
+        }
+        auto stats = GraphColoring::colorSpeculative(g, colors, palette, fixed);
+        CHECK(stats.recolored == (n + 2) / 3);
+        CHECK(stats.residualConflicts == 0);
+        CHECK(conflicts(g, colors) == 0);
+        for (size_t v = 0; v < n; ++v) {
+            if (fixed[v]) CHECK(colors[v] == previous[v]);
+        }
+    }
+
+    // Palette épuisée (clique de 6, 4 couleurs) : au plus 4 sommets sans conflit, les autres signalés
+    void testSaturatedPalette() {
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        for (uint32_t u = 0; u < 6; ++u) {
+            for (uint32_t v = u + 1; v < 6; ++v) edges.push_back({u, v});
+        }
+        CsrGraph g = CsrGraph::fromEdges(6, edges);
+        std::vector<int32_t> colors(6, GraphColoring::UNCOLORED);
+        auto stats = GraphColoring::colorSpeculative(g, colors, std::vector<int32_t>(6, 4), std::vector<bool>(6, false));
+        CHECK(stats.residualConflicts >= 2);
+        for (int32_t c : colors) CHECK(c >= 0 && c < 4);
+    }
+}
+
+int main() {
+    testFromEdges();
+    testProperColoring();
+    testFixedVertices();
+    testSaturatedPalette();
+    return TestCheck::report("GraphColoring");
+}
@@ -0,0 +1,89 @@
+#include "TestCheck.h"
+#include "ClusterPyramid.h"
+#include "LeafCounts.h"
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Item {
+        std::string status;
+        std::string technology;
+        int operator_id;
+    };
+
+    template <typename Key>
+    std::vector<std::pair<Key, uint32_t>> sorted(const std::map<Key, uint32_t>& counts) {
+        return {counts.begin(), counts.end()};
+    }
+
+    void testSmallRange() {
+        std::vector<Item> items = {{"active", "4G", 1}, {"active", "5G", 2}, {"planned", "5G", 1}, {"active", "5G", 1}};
+        LeafCounts counts(static_cast<uint32_t>(items.size()), [&](uint32_t k) -> const Item& { return items[k]; });
+        CHECK(counts.width == 2 + 2 + 2);
+        CHECK(counts.prefix.size() == (items.size() + 1) * counts.width);
+
+        auto all = counts.range(0, 4);
+        CHECK(all.status == (std::vector<std::pair<std::string, uint32_t>>{{"active", 3}, {"planned", 1}}));
+        CHECK(all.technology == (std::vector<std::pair<std::string, uint32_t>>{{"4G", 1}, {"5G", 3}}));
+        CHECK(all.op == (std::vector<std::pair<int, uint32_t>>{{1, 3}, {2, 1}}));
+
+        // Modalités absentes de la plage omises
+        auto middle = counts.range(1, 3);
+        CHECK(middle.status == (std::vector<std::pair<std::string, uint32_t>>{{"active", 1}, {"planned", 1}}));
+        CHECK(middle.technology == (std::vector<std::pair<std::string, uint32_t>>{{"5G", 2}}));
+
+        auto none = counts.range(2, 2);
+        CHECK(none.status.empty() && none.technology.empty() && none.op.empty());
+    }
+
+    // Répartition de chaque nœud de la pyramide = décompte direct de ses feuilles
+    void testPyramidNodes() {
+        const char* statuses[] = {"active", "planned", "maintenance"};
+        const char* technologies[] = {"3G", "4G", "5G"};
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<double> lon(2.0, 2.6), lat(48.6, 49.0);
+        std::uniform_int_distribution<int> pick(0, 2), op(1, 5);
+
+        std::vector<Item> items;
+        std::vector<ClusterPyramid::Input> points;
+        for (uint32_t i = 0; i < 3000; ++i) {
+            items.push_back({statuses[pick(rng)], technologies[pick(rng)], op(rng)});
+            points.push_back({lon(rng), lat(rng), 1000.0, i});
+        }
+
+        ClusterPyramid pyramid(points, 14, 60.0);
+        CHECK(pyramid.pointCount() == items.size());
+        LeafCounts counts(static_cast<uint32_t>(pyramid.pointCount()), [&](uint32_t k) -> const Item& {
+            return items[pyramid.leaf(k)];
+        });
+
+        for (int level = 0; level <= pyramid.maxZoom() + 1; ++level) {
+            size_t covered = 0;
+            for (const auto& node : pyramid.nodes(level)) {
+                std::map<std::string, uint32_t> status, technology;
+                std::map<int, uint32_t> ops;
+                for (uint32_t k = node.leafBegin; k < node.leafBegin + node.count; ++k) {
+                    const Item& item = items[pyramid.leaf(k)];
+                    status[item.status]++;
+                    technology[item.technology]++;
+                    ops[item.operator_id]++;
+                }
+                auto b = counts.range(node.leafBegin, node.leafBegin + node.count);
+                CHECK(b.status == sorted(status));
+                CHECK(b.technology == sorted(technology));
+                CHECK(b.op == sorted(ops));
+                covered += node.count;
+            }
+            CHECK(covered == items.size());
+        }
+    }
+}
+
+int main() {
+    testSmallRange();
+    testPyramidNodes();
+    return TestCheck::report("LeafCounts");
+}
@@ -0,0 +1,75 @@
+#include "TestCheck.h"
+#include "PreparedPolygon.h"
+#include "GeoUtils.h"
+
+#include <random>
+#include <vector>
+
+namespace {
+    Ring square(double x0, double y0, double x1, double y1) {
+        return {{x0, y0}, {x1, y0}, {x1, y1}, {x0, y1}, {x0, y0}};
+    }
+
+    // Étoile à branches : assez d'arêtes pour plusieurs bandes
+    Ring star(double cx, double cy, double r0, double r1, int branches) {
+        Ring ring;
+        for (int k = 0; k < 2 * branches; ++k) {
+            double a = k * GeoUtils::PI / branches;
+            double r = (k % 2 == 0) ? r1 : r0;
+            ring.push_back({cx + r * std::cos(a), cy + r * std::sin(a)});
+        }
+        ring.push_back(ring.front());
+        return ring;
+    }
+
+    bool bruteContains(const std::vector<Polygon2>& polygons, double x, double y) {
+        for (const auto& poly : polygons) {
+            if (Geometry::pointInPolygon({x, y}, poly)) return true;
+        }
+        return false;
+    }
+
+    // Mêmes réponses que le test pair-impair direct sur des points aléatoires
+    void compareWithBruteForce(const std::vector<Polygon2>& polygons, double minX, double minY,
+                               double maxX, double maxY) {
+        PreparedPolygon prepared(polygons);
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> dx(minX, maxX), dy(minY, maxY);
+        for (int i = 0; i < 20000; ++i) {
+            double x = dx(rng), y = dy(rng);
+            CHECK(prepared.contains(x, y) == bruteContains(polygons, x, y));
+        }
+    }
+
+    void testSquareWithHole() {
+        std::vector<Polygon2> polygons = {{{square(0, 0, 10, 10), square(3, 3, 7, 7)}}};
+        PreparedPolygon prepared(polygons);
+        CHECK(prepared.contains(1, 1));
+        CHECK(prepared.contains(8.5, 5));
+        CHECK(!prepared.contains(5, 5));     // Trou
+        CHECK(!prepared.contains(-1, 5));    // Hors emprise
+        CHECK(!prepared.contains(5, 11));
+        compareWithBruteForce(polygons, -2, -2, 12, 12);
+    }
+
+    void testDisjointParts() {
+        std::vector<Polygon2> polygons = {
+            {{square(0, 0, 1, 1)}},
+            {{star(5, 5, 1, 3, 40)}},
+            {{square(-4, 8, -2, 9)}},
+        };
+        compareWithBruteForce(polygons, -5, -1, 9, 10);
+    }
+
+    void testEmpty() {
+        PreparedPolygon prepared(std::vector<Polygon2>{});
+        CHECK(!prepared.contains(0, 0));
+    }
+}
+
+int main() {
+    testSquareWithHole();
+    testDisjointParts();
+    testEmpty();
+    return TestCheck::report("PreparedPolygon");
+}
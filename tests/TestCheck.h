@@ -0,0 +1,37 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <cmath>
+#include <cstdio>
+
+// Vérifications minimales des tests unitaires (sans dépendance à un framework)
+//
+// Un échec est signalé sur stderr sans interrompre le test ; main() retourne
+// TestCheck::report(), non nul si au moins une vérification a échoué (ctest).
+namespace TestCheck {
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+
+    inline int report(const char* suite) {
+        if (failures() == 0) {
+            std::printf("%s: OK\n", suite);
+            return 0;
+        }
+        std::fprintf(stderr, "%s: %d check(s) failed\n", suite, failures());
+        return 1;
+    }
+}
+
+#define CHECK(cond)                                                                       \
+    do {                                                                                  \
+        if (!(cond)) {                                                                    \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++TestCheck::failures();                                                      \
+        }                                                                                 \
+    } while (0)
+
+#define CHECK_NEAR(a, b, eps) CHECK(std::fabs((a) - (b)) <= (eps))
+
+#endif